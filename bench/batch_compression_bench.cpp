@@ -0,0 +1,167 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <tlx/cmdline_parser.hpp>
+
+#include "recompression.hpp"
+
+int main(int argc, char *argv[]) {
+    std::vector<std::string> variants;
+    recomp::sequential_variants(variants);
+    recomp::parallel_variants(variants);
+    recomp::experimental_variants(variants);
+
+    tlx::CmdlineParser cmd;
+    cmd.set_description("Compresses many files concurrently and stores the rlslps using the given coder. The cores "
+                        "of a file are assigned by its size and the estimated memory of all running files is bounded.");
+    cmd.set_author("Christopher Osthues");
+
+    std::string path;
+    cmd.add_param_string("path", path, "The path to the directory containing the files");
+
+    std::string filenames;
+    cmd.add_param_string("filenames", filenames,
+                         "The files. Multiple files are separated with spaces and are enclosed by \"\". Example: \"file1 file2 file3\"");
+
+    std::string algo;
+    cmd.add_param_string("algorithm", algo,
+                         "The algorithm to compress the files with. The algorithms are: [\"" +
+                         recomp::util::variants_options(variants) + "\"]");
+
+    std::string coder;
+    cmd.add_param_string("coder", coder, "The coder to store the rlslp to file (plain | fixed | sorted | sorted_dr | huffman)");
+
+    std::string to_path;
+    cmd.add_param_string("to_path", to_path, "The path to the directory to store the rlslp files to");
+
+    size_t cores;
+    cmd.add_param_bytes("cores", cores, "The number of cores to use for all files");
+
+    std::string list;
+    cmd.add_string('l', "list", list, "A file containing further files (one per line, relative to path)");
+
+    size_t memory_limit = 0;
+    cmd.add_bytes('m', "memory", memory_limit,
+                  "The bound of the estimated memory of all running files in bytes (0 for unbounded)");
+
+    size_t bytes_per_core = 1 << 20;
+    cmd.add_bytes('b', "bytes-per-core", bytes_per_core, "The number of bytes of a file per assigned core");
+
+    size_t memory_per_byte = 32;
+    cmd.add_bytes('e', "memory-per-byte", memory_per_byte, "The estimated peak memory per byte of a file");
+
+    size_t prefix = 0;
+    cmd.add_bytes('p', "prefix", prefix, "The prefix of the files in bytes to read in");
+
+    std::string parhip;
+    cmd.add_string("parhip", parhip, "The executable for parhip");
+
+    std::string dir;
+    cmd.add_string("dir", dir, "The directory to store the partition of parhip to");
+
+    bool verify = false;
+    cmd.add_flag('v', "verify", verify,
+                 "Decode the stored rlslps and verify them by comparing windows of the derived text with the files");
+
+    if (!cmd.process(argc, argv)) {
+        return -1;
+    }
+
+    std::vector<std::string> files;
+    recomp::util::split(filenames, " ", files);
+    if (!list.empty()) {
+        std::ifstream in(list);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty()) {
+                files.push_back(line);
+            }
+        }
+    }
+
+    std::string batch = "batch";
+    if (!recomp::create_recompression(algo, batch, parhip, dir)) {
+        std::cerr << "No such algo " << algo << std::endl;
+        return -1;
+    }
+    if (recomp::coder::get_coder_extension(coder) == "unkown") {
+        std::cerr << "No such coder " << coder << std::endl;
+        return -1;
+    }
+
+    std::vector<size_t> sizes(files.size());
+    size_t total_size = 0;
+    for (size_t j = 0; j < files.size(); ++j) {
+        std::string file_name = path + files[j];
+        sizes[j] = recomp::util::file_size_in_bytes(file_name, prefix);
+        total_size += sizes[j];
+    }
+
+    recomp::batch_scheduler scheduler(cores, memory_limit);
+    scheduler.bytes_per_core = bytes_per_core;
+    scheduler.memory_per_byte = memory_per_byte;
+
+    std::mutex out_mutex;
+    const auto startTime = recomp::timer::now();
+    scheduler.run(sizes, [&](const recomp::batch_job& job) {
+        std::string file_name = path + files[job.id];
+        size_t pos = file_name.find_last_of('/');
+        std::string dataset;
+        if (pos != std::string::npos) {
+            dataset = file_name.substr(pos + 1);
+        } else {
+            dataset = file_name;
+        }
+        recomp::util::replace_all(dataset, "_", "\\_");
+
+        std::unique_ptr<recomp::recompression<recomp::var_t>> recomp = recomp::create_recompression(algo, dataset,
+                                                                                                    parhip, dir);
+
+        typedef recomp::recompression<recomp::var_t>::text_t text_t;
+        text_t text;
+        recomp::util::read_file(file_name, text, prefix);
+
+        recomp::rlslp<recomp::var_t> rlslp;
+        const auto startTimeJob = recomp::timer::now();
+        recomp->recomp(text, rlslp, recomp::CHAR_ALPHABET, job.cores);
+        const auto endTimeJob = recomp::timer::now();
+
+        text.resize(0);
+
+        std::string coder_file = to_path + files[job.id];
+        recomp::coder::encode(coder, coder_file, rlslp);
+        const auto endTimeStore = recomp::timer::now();
+
+        bool correct = true;
+        if (verify) {
+            recomp::rlslp<recomp::var_t> in_rlslp = recomp::coder::decode(coder, coder_file);
+            correct = recomp::verify_rlslp(in_rlslp, file_name, prefix, true, job.cores);
+        }
+
+        std::ifstream in_enc(coder_file + recomp::coder::get_coder_extension(coder),
+                             std::ios::binary | std::ios::ate);
+        std::lock_guard<std::mutex> guard(out_mutex);
+        std::cout << "RESULT algo=" << recomp->name << "_batch dataset=" << dataset << " coder=" << coder
+                  << " cores=" << job.cores << " size=" << job.size << " enc_size=" << in_enc.tellg()
+                  << " productions=" << rlslp.size() << " time="
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(endTimeJob - startTimeJob).count()
+                  << " store="
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(endTimeStore - endTimeJob).count()
+                  << std::endl;
+        if (!correct) {
+            std::cout << "Failure store " << dataset << std::endl;
+        }
+    });
+    const auto endTime = recomp::timer::now();
+    const auto timeSpan = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+
+    std::cout << "RESULT algo=" << algo << "_batch coder=" << coder << " files=" << files.size() << " cores=" << cores
+              << " memory=" << memory_limit << " size=" << total_size << " time=" << timeSpan << " mb_per_s="
+              << (timeSpan > 0 ? static_cast<double>(total_size) / 1000.0 / static_cast<double>(timeSpan) : 0.0)
+              << std::endl;
+}
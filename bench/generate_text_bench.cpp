@@ -0,0 +1,52 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <tlx/cmdline_parser.hpp>
+
+#include "recompression.hpp"
+
+
+int main(int argc, char *argv[]) {
+    tlx::CmdlineParser cmd;
+    cmd.set_description("Generates synthetic texts for the scaling experiments");
+    cmd.set_author("Christopher Osthues");
+
+    std::string spec;
+    cmd.add_param_string("spec", spec,
+                         "The text to generate. The parameters are separated by colons: [\"" +
+                         recomp::generator::generator_options() + "\"]");
+
+    size_t size;
+    cmd.add_param_bytes("size", size, "The length of the text");
+
+    std::string file_name;
+    cmd.add_param_string("file", file_name, "The file to write the text to");
+
+    size_t seed = recomp::counter_rng::DEFAULT_SEED;
+    cmd.add_bytes('s', "seed", seed, "The seed of the random symbols");
+
+    size_t cores = std::thread::hardware_concurrency();
+    cmd.add_bytes('c', "cores", cores, "The number of cores");
+
+    if (!cmd.process(argc, argv)) {
+        return -1;
+    }
+
+    std::string text;
+    if (!recomp::generator::generate(spec, text, size, seed, cores)) {
+        std::cerr << "No such text " << spec << std::endl;
+        return -1;
+    }
+
+    std::ofstream out(file_name, std::ios::out | std::ios::binary);
+    out.write(text.data(), text.size());
+    out.close();
+    if (!out) {
+        std::cerr << "Failed to write file " << file_name << std::endl;
+        return -1;
+    }
+    std::cout << "Generated " << recomp::generator::dataset_name(spec, size) << " to " << file_name << std::endl;
+    return 0;
+}
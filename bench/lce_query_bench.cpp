@@ -29,7 +29,7 @@ int main(int argc, char *argv[]) {
 
     std::string algorithms;
     cmd.add_param_string("algorithms", algorithms,
-                         "The algorithms to benchmark [\"recomp (parallel_lp) | naive | prezza | rmq\"]");
+                         "The algorithms to benchmark [\"recomp (parallel_lp) | iterative | naive | prezza | rmq\"]");
 
     size_t repeats;
     cmd.add_param_bytes("repeats", repeats, "The number of repeats to process");
@@ -55,10 +55,22 @@ int main(int argc, char *argv[]) {
     size_t prefix = 0;
     cmd.add_bytes('p', "prefix", prefix, "The prefix of the files in bytes to read in");
 
+    bool balance = false;
+    cmd.add_flag('b', "balance", balance,
+                 "Balances the rlslp such that its height is logarithmic in the length of the text before the queries");
+
+    std::string trace;
+    cmd.add_string('t', "trace", trace,
+                   "Records the phases and writes them to <trace>.json (Chrome trace format) and <trace>.csv");
+
     if (!cmd.process(argc, argv)) {
         return -1;
     }
 
+    if (!trace.empty()) {
+        recomp::tracer::enable();
+    }
+
     std::vector<std::string> files;
     recomp::util::split(filenames, " ", files);
 
@@ -127,6 +139,13 @@ int main(int argc, char *argv[]) {
             recompression.recomp(text, rlslp, recomp::CHAR_ALPHABET, 4);
         }
 
+        std::cout << "RESULT algo=height_distribution dataset=" << dataset << " productions=" << rlslp.size()
+                  << recomp::compute_height_distribution(rlslp) << std::endl;
+        if (balance && recomp::balance_rlslp(rlslp)) {
+            std::cout << "RESULT algo=balanced_height_distribution dataset=" << dataset << " productions="
+                      << rlslp.size() << recomp::compute_height_distribution(rlslp) << std::endl;
+        }
+
         std::string plain_text;
         recomp::util::read_text_file(file_name, plain_text, prefix);
 
@@ -163,6 +182,30 @@ int main(int argc, char *argv[]) {
                                   << lces[l] << " time="
                                   << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
                                   << std::endl;
+                    } else if (algo == "iterative") {
+                        recomp::lce_query::lce_engine<recomp::var_t> engine{rlslp};
+                        std::vector<size_t> latencies;
+                        latencies.reserve(accesses);
+                        const auto startTime = recomp::timer::now();
+                        for (size_t i = 0; i < accesses; ++i) {
+                            const auto startTimeQuery = recomp::timer::now();
+                            lces[l] += engine.query(indices[i], indices[(i + 1) % accesses]);
+                            const auto endTimeQuery = recomp::timer::now();
+                            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    endTimeQuery - startTimeQuery).count());
+                        }
+                        const auto endTime = recomp::timer::now();
+                        const auto timeSpan = endTime - startTime;
+                        std::sort(latencies.begin(), latencies.end());
+                        std::cout << "RESULT algo=iterative dataset=" << dataset << " queries=" << accesses
+                                  << " lce="
+                                  << lces[l] << " time="
+                                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                                  << " p50_ns=" << recomp::util::percentile(latencies, 50)
+                                  << " p90_ns=" << recomp::util::percentile(latencies, 90)
+                                  << " p99_ns=" << recomp::util::percentile(latencies, 99)
+                                  << " max_ns=" << recomp::util::percentile(latencies, 100)
+                                  << std::endl;
                     } else if (algo == "naive") {
                         const auto startTime = recomp::timer::now();
                         for (size_t i = 0; i < accesses; ++i) {
@@ -220,5 +263,9 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    if (!trace.empty()) {
+        recomp::tracer::write(trace);
+    }
+
     return 0;
 }
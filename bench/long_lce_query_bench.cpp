@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <chrono>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 #include <sdsl/suffix_arrays.hpp>
@@ -29,7 +30,7 @@ int main(int argc, char *argv[]) {
 
     std::string algorithms;
     cmd.add_param_string("algorithms", algorithms,
-                         "The algorithms to benchmark [\"recomp (parallel_lp) | naive | prezza | rmq\"]");
+                         "The algorithms to benchmark [\"recomp (parallel_lp) | fingerprint | iterative | naive | prezza | rmq\"]");
 
     size_t repeats;
     cmd.add_param_bytes("repeats", repeats, "The number of repeats to process");
@@ -55,6 +56,9 @@ int main(int argc, char *argv[]) {
     size_t prefix = 0;
     cmd.add_bytes('p', "prefix", prefix, "The prefix of the files in bytes to read in");
 
+    size_t cores = 4;
+    cmd.add_bytes('n', "cores", cores, "The number of cores to build the rlslp, the fingerprints and the queries with");
+
     if (!cmd.process(argc, argv)) {
         return -1;
     }
@@ -107,7 +111,7 @@ int main(int argc, char *argv[]) {
                 recomp::util::read_file(file_name, text, prefix);
 
                 recomp::parallel::parallel_lp_recompression<recomp::var_t> recompression;
-                recompression.recomp(text, rlslp, recomp::CHAR_ALPHABET, 4);
+                recompression.recomp(text, rlslp, recomp::CHAR_ALPHABET, cores);
             }
             std::cout << "Loaded" << std::endl;
         }
@@ -117,7 +121,18 @@ int main(int argc, char *argv[]) {
             recomp::util::read_file(file_name, text, prefix);
 
             recomp::parallel::parallel_lp_recompression<recomp::var_t> recompression;
-            recompression.recomp(text, rlslp, recomp::CHAR_ALPHABET, 4);
+            recompression.recomp(text, rlslp, recomp::CHAR_ALPHABET, cores);
+        }
+
+        std::unique_ptr<recomp::karp_rabin<recomp::var_t>> kr;
+        if (std::find(algos.begin(), algos.end(), "fingerprint") != algos.end()) {
+            const auto startTimeKR = recomp::timer::now();
+            kr.reset(new recomp::karp_rabin<recomp::var_t>(rlslp, cores));
+            const auto endTimeKR = recomp::timer::now();
+            const auto timeSpanKR = endTimeKR - startTimeKR;
+            std::cout << "RESULT algo=fingerprint_construction dataset=" << dataset << " production=" << rlslp.size()
+                      << " time=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanKR).count()
+                      << std::endl;
         }
 
         std::string plain_text;
@@ -142,7 +157,7 @@ int main(int argc, char *argv[]) {
                 return lcp[j] < lcp[i];
             };
 
-            ips4o::parallel::sort(idx.begin(), idx.end(), sort_cond, 4);
+            ips4o::parallel::sort(idx.begin(), idx.end(), sort_cond, cores);
 
             for (size_t i = 0, n = 0; i < indices.size(); i += 2) {
                 indices[i] = sa[idx[n]];
@@ -178,6 +193,42 @@ int main(int argc, char *argv[]) {
                                   << lces[l] << " time="
                                   << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
                                   << std::endl;
+                    } else if (algo == "fingerprint") {
+                        const auto startTime = recomp::timer::now();
+                        for (size_t i = 0; i < indices.size(); i+=2) {
+                            lces[l] += recomp::lce_query::lce_query_fingerprint(*kr, indices[i], indices[i + 1]);
+                        }
+                        const auto endTime = recomp::timer::now();
+                        const auto timeSpan = endTime - startTime;
+                        std::cout << "RESULT algo=fingerprint dataset=" << dataset << " queries=" << accesses
+                                  << " lce="
+                                  << lces[l] << " time="
+                                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                                  << std::endl;
+                    } else if (algo == "iterative") {
+                        recomp::lce_query::lce_engine<recomp::var_t> engine{rlslp};
+                        std::vector<size_t> latencies;
+                        latencies.reserve(accesses);
+                        const auto startTime = recomp::timer::now();
+                        for (size_t i = 0; i < indices.size(); i+=2) {
+                            const auto startTimeQuery = recomp::timer::now();
+                            lces[l] += engine.query(indices[i], indices[i + 1]);
+                            const auto endTimeQuery = recomp::timer::now();
+                            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    endTimeQuery - startTimeQuery).count());
+                        }
+                        const auto endTime = recomp::timer::now();
+                        const auto timeSpan = endTime - startTime;
+                        std::sort(latencies.begin(), latencies.end());
+                        std::cout << "RESULT algo=iterative dataset=" << dataset << " queries=" << accesses
+                                  << " lce="
+                                  << lces[l] << " time="
+                                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                                  << " p50_ns=" << recomp::util::percentile(latencies, 50)
+                                  << " p90_ns=" << recomp::util::percentile(latencies, 90)
+                                  << " p99_ns=" << recomp::util::percentile(latencies, 99)
+                                  << " max_ns=" << recomp::util::percentile(latencies, 100)
+                                  << std::endl;
                     } else if (algo == "naive") {
                         const auto startTime = recomp::timer::now();
                         for (size_t i = 0; i < indices.size(); i+=2) {
@@ -0,0 +1,475 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <tlx/cmdline_parser.hpp>
+
+// the kernels are protected members of the recompression classes
+#define protected public
+
+#include "recompression.hpp"
+
+#undef protected
+
+typedef recomp::parallel::parallel_recompression<recomp::var_t> parallel_t;
+typedef parallel_t::text_t text_t;
+typedef parallel_t::adj_list_t adj_list_t;
+typedef parallel_t::partition_t partition_t;
+
+volatile size_t sink = 0;
+
+/**
+ * @brief The statistics of the repetitions of a kernel in nanoseconds.
+ */
+struct micro_stats {
+    std::uint64_t min = 0;
+    std::uint64_t median = 0;
+    std::uint64_t mean = 0;
+    std::uint64_t p90 = 0;
+    std::uint64_t p99 = 0;
+    std::uint64_t max = 0;
+};
+
+/**
+ * @brief Runs the kernel @code{warmup + repetitions} times and computes the statistics of the timed repetitions. The
+ * setup is executed before every run and is not timed.
+ */
+micro_stats measure(size_t warmup, size_t repetitions, const std::function<void()>& setup,
+                    const std::function<void()>& run) {
+    std::vector<std::uint64_t> samples;
+    for (size_t r = 0; r < warmup + repetitions; ++r) {
+        setup();
+        const auto startTime = recomp::timer::now();
+        run();
+        const auto endTime = recomp::timer::now();
+        if (r >= warmup) {
+            samples.push_back(static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count()));
+        }
+    }
+    std::sort(samples.begin(), samples.end());
+
+    micro_stats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+    auto percentile = [&](double p) {
+        const auto rank = static_cast<size_t>(std::ceil(p * samples.size()));
+        return samples[std::max(rank, static_cast<size_t>(1)) - 1];
+    };
+    const size_t mid = samples.size() / 2;
+    stats.min = samples.front();
+    stats.median = (samples.size() % 2 == 0) ? (samples[mid - 1] + samples[mid]) / 2 : samples[mid];
+    std::uint64_t sum = 0;
+    for (const auto& sample : samples) {
+        sum += sample;
+    }
+    stats.mean = sum / samples.size();
+    stats.p90 = percentile(0.9);
+    stats.p99 = percentile(0.99);
+    stats.max = samples.back();
+    return stats;
+}
+
+struct micro_config {
+    std::string dataset;
+    size_t cores;
+    size_t warmup;
+    size_t repetitions;
+    std::vector<std::string> kernels;
+};
+
+bool selected(const micro_config& config, const std::string& kernel) {
+    return config.kernels.empty() ||
+           std::find(config.kernels.begin(), config.kernels.end(), kernel) != config.kernels.end();
+}
+
+void report(const micro_config& config, const std::string& kernel, const std::string& variant, size_t n,
+            size_t ops, const micro_stats& stats) {
+#ifdef BENCH
+    // the kernels print their own fields in the bench build
+    std::cout << std::endl;
+#endif
+    std::cout << "RESULT algo=micro_" << kernel << " variant=" << variant << " dataset=" << config.dataset
+              << " n=" << n << " cores=" << config.cores << " reps=" << config.repetitions << " ops=" << ops
+              << " min=" << stats.min << " median=" << stats.median << " mean=" << stats.mean << " p90=" << stats.p90
+              << " p99=" << stats.p99 << " max=" << stats.max
+              << " median_per_op=" << (ops > 0 ? stats.median / ops : 0) << std::endl;
+}
+
+void copy_text(const text_t& from, text_t& to) {
+    to.resize(from.size());
+    std::copy(from.begin(), from.end(), to.begin());
+}
+
+void copy_partition(const partition_t& from, partition_t& to) {
+    to.resize(from.size());
+    for (size_t i = 0; i < from.size(); ++i) {
+        to[i] = from[i];
+    }
+}
+
+template<typename recomp_t>
+void init_recomp(recomp_t& recomp, const micro_config& config) {
+    recomp.dataset = config.dataset;
+    recomp.cores = config.cores;
+    recomp.level = 1;
+}
+
+void minmax(const text_t& text, recomp::var_t& minimum, recomp::var_t& maximum) {
+    minimum = std::numeric_limits<recomp::var_t>::max();
+    maximum = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        minimum = std::min(minimum, text[i]);
+        maximum = std::max(maximum, text[i]);
+    }
+}
+
+/**
+ * @brief Benchmarks the adjacency list, the partitions and the directed cut of a variant on a text without blocks.
+ * The preparation of the partition is not timed.
+ */
+template<typename recomp_t, typename prepare_fn_t, typename partition_fn_t>
+void bench_pcomp_kernels(const micro_config& config, const std::string& variant, const text_t& text,
+                         prepare_fn_t prepare, partition_fn_t compute_partition, bool adj_list = true) {
+    recomp_t recomp;
+    init_recomp(recomp, config);
+    recomp::var_t minimum;
+    recomp::var_t maximum;
+    minmax(text, minimum, maximum);
+
+    text_t input;
+    copy_text(text, input);
+    adj_list_t adj(text.size() - 1);
+    if (adj_list && selected(config, "compute_adj_list")) {
+        auto stats = measure(config.warmup, config.repetitions, [] {}, [&] {
+            recomp.compute_adj_list(input, adj);
+        });
+        report(config, "compute_adj_list", variant, text.size(), 1, stats);
+    }
+
+    if (selected(config, "compute_partition")) {
+        partition_t partition(maximum - minimum + 1);
+        bool part_l = false;
+        auto stats = measure(config.warmup, config.repetitions, [&] {
+            copy_text(text, input);
+            prepare(recomp, input, partition);
+        }, [&] {
+            compute_partition(recomp, input, partition, part_l, minimum);
+        });
+        report(config, "compute_partition", variant, text.size(), 1, stats);
+    }
+
+    if (adj_list && selected(config, "directed_cut")) {
+        recomp.compute_adj_list(text, adj);
+        partition_t undirected(maximum - minimum + 1);
+        std::mt19937_64 gen(recomp.seed);
+        for (size_t i = 0; i < undirected.size(); ++i) {
+            undirected[i] = (gen() & 1) != 0;
+        }
+        partition_t partition;
+        bool part_l = false;
+        auto stats = measure(config.warmup, config.repetitions, [&] {
+            copy_partition(undirected, partition);
+        }, [&] {
+            recomp.directed_cut(text, partition, adj, part_l, minimum);
+        });
+        report(config, "directed_cut", variant, text.size(), 1, stats);
+    }
+}
+
+void bench_input(const micro_config& config, const text_t& text, size_t queries, size_t seed) {
+    if (text.size() < 4) {
+        std::cerr << "Text of " << config.dataset << " is too short" << std::endl;
+        return;
+    }
+    parallel_t parallel;
+    init_recomp(parallel, config);
+
+    // bcomp on the input, the other text kernels on the text without blocks like in the first pcomp
+    text_t text_b;
+    {
+        text_t input;
+        recomp::rlslp<recomp::var_t> rlslp;
+        recomp::recompression<recomp::var_t>::bv_t bv;
+        auto stats = measure(config.warmup, config.repetitions, [&] {
+            copy_text(text, input);
+            rlslp = recomp::rlslp<recomp::var_t>();
+            rlslp.terminals = recomp::CHAR_ALPHABET;
+            bv.clear();
+        }, [&] {
+            parallel.bcomp(input, rlslp, bv);
+        });
+        if (selected(config, "bcomp")) {
+            report(config, "bcomp", "parallel", text.size(), 1, stats);
+        }
+        copy_text(input, text_b);
+    }
+    if (text_b.size() < 4) {
+        std::cerr << "Text of " << config.dataset << " consists of few blocks only" << std::endl;
+        return;
+    }
+
+    typedef recomp::parallel::parallel_lp_recompression<recomp::var_t> lp_t;
+    typedef recomp::parallel::parallel_rnd_recompression<recomp::var_t> rnd_t;
+    typedef recomp::parallel::parallel_rnddir_recompression<recomp::var_t> rnddir_t;
+    typedef recomp::parallel::parallel_ls_recompression<recomp::var_t> ls_t;
+    typedef recomp::parallel::parallel_gr_recompression<recomp::var_t> gr_t;
+    auto no_prepare = [](parallel_t&, text_t&, partition_t&) {};
+    bench_pcomp_kernels<parallel_t>(config, "parallel", text_b, no_prepare,
+            [](parallel_t& r, text_t& t, partition_t& p, bool& l, recomp::var_t m) {
+        r.compute_partition(t, p, l, m);
+    });
+    bench_pcomp_kernels<lp_t>(config, "parallel_lp", text_b, no_prepare,
+            [](lp_t& r, text_t& t, partition_t& p, bool& l, recomp::var_t m) {
+        r.compute_partition(t, p, l, m);
+    });
+    bench_pcomp_kernels<rnd_t>(config, "parallel_rnd", text_b, no_prepare,
+            [](rnd_t& r, text_t& t, partition_t& p, bool& l, recomp::var_t m) {
+        r.compute_partition(t, p, l, m);
+    }, false);
+    bench_pcomp_kernels<rnddir_t>(config, "parallel_rnddir", text_b, no_prepare,
+            [](rnddir_t& r, text_t& t, partition_t& p, bool& l, recomp::var_t m) {
+        r.compute_partition(t, p, l, m);
+    }, false);
+    bench_pcomp_kernels<gr_t>(config, "parallel_gr", text_b, no_prepare,
+            [](gr_t& r, text_t& t, partition_t& p, bool& l, recomp::var_t m) {
+        r.compute_partition(t, p, l, m);
+    }, false);
+    // the local search works on the symbols mapped to their ranks
+    bench_pcomp_kernels<ls_t>(config, "parallel_ls", text_b,
+            [](ls_t& r, text_t& t, partition_t& p) {
+        recomp::var_t minimum;
+        recomp::var_t maximum;
+        minmax(t, minimum, maximum);
+        recomp::rlslp<recomp::var_t> rlslp;
+        rlslp.terminals = maximum + 1;
+        recomp::ui_vector<recomp::var_t> mapping;
+        r.compute_mapping(t, rlslp, mapping);
+        p.resize(mapping.size());
+    }, [](ls_t& r, text_t& t, partition_t& p, bool& l, recomp::var_t) {
+        r.compute_partition(t, p, l);
+    }, false);
+
+    if (selected(config, "compact")) {
+        // every third symbol is deleted like after a pair compression
+        const size_t n = text_b.size();
+        recomp::ui_vector<size_t> compact_bounds(config.cores + 1);
+        recomp::ui_vector<size_t> copy_bounds(config.cores + 1);
+        size_t count = 0;
+        for (size_t t = 0; t <= config.cores; ++t) {
+            compact_bounds[t] = t * n / config.cores;
+            copy_bounds[t] = compact_bounds[t] - (compact_bounds[t] + 1) / 3;
+        }
+        count = n - copy_bounds[config.cores];
+        text_t input;
+        auto stats = measure(config.warmup, config.repetitions, [&] {
+            copy_text(text_b, input);
+            for (size_t i = 1; i < n; i += 3) {
+                input[i] = parallel.DELETED;
+            }
+        }, [&] {
+            parallel.compact(input, compact_bounds, copy_bounds, count);
+        });
+        report(config, "compact", "parallel", n, 1, stats);
+    }
+
+    if (selected(config, "partitioned_radix_sort")) {
+        std::vector<std::pair<recomp::var_t, recomp::var_t>> pairs(text_b.size() - 1);
+        for (size_t i = 0; i + 1 < text_b.size(); ++i) {
+            pairs[i] = std::make_pair(text_b[i], text_b[i + 1]);
+        }
+        std::vector<std::pair<recomp::var_t, recomp::var_t>> input;
+        auto stats = measure(config.warmup, config.repetitions, [&] {
+            input = pairs;
+        }, [&] {
+            recomp::parallel::partitioned_radix_sort(input, config.cores);
+        });
+        report(config, "partitioned_radix_sort", "pairs", pairs.size(), 1, stats);
+    }
+
+    if (selected(config, "bitstream")) {
+        const std::string file_name = "micro_bench_" + std::to_string(seed) + ".tmp";
+        recomp::var_t minimum;
+        recomp::var_t maximum;
+        minmax(text_b, minimum, maximum);
+        const auto bits = recomp::util::bits_for(maximum);
+        auto stats = measure(config.warmup, config.repetitions, [] {}, [&] {
+            BitOStream ostream(file_name);
+            for (size_t i = 0; i < text_b.size(); ++i) {
+                ostream.write_int<recomp::var_t>(text_b[i], bits);
+            }
+            ostream.close();
+        });
+        report(config, "bitostream", "bits" + std::to_string(bits), text_b.size(), text_b.size(), stats);
+
+        stats = measure(config.warmup, config.repetitions, [] {}, [&] {
+            BitIStream istream(file_name);
+            size_t sum = 0;
+            for (size_t i = 0; i < text_b.size(); ++i) {
+                sum += istream.read_int<recomp::var_t>(bits);
+            }
+            istream.close();
+            sink = sink + sum;
+        });
+        report(config, "bitistream", "bits" + std::to_string(bits), text_b.size(), text_b.size(), stats);
+        std::remove(file_name.c_str());
+    }
+
+    if ((selected(config, "extract") || selected(config, "lce_query")) && queries > 0) {
+        std::string dataset = config.dataset;
+        auto recomp = recomp::create_recompression("parallel_ls", dataset, "", "");
+        text_t input;
+        copy_text(text, input);
+        recomp::rlslp<recomp::var_t> rlslp;
+        recomp->recomp(input, rlslp, recomp::CHAR_ALPHABET, config.cores);
+        const size_t n = text.size();
+
+        std::mt19937_64 gen(seed);
+        std::vector<std::pair<size_t, size_t>> positions(queries);
+        for (auto& pos : positions) {
+            pos = std::make_pair(gen() % n, gen() % n);
+        }
+
+        if (selected(config, "extract")) {
+            const size_t len = 64;
+            auto stats = measure(config.warmup, config.repetitions, [] {}, [&] {
+                size_t sum = 0;
+                for (const auto& pos : positions) {
+                    sum += rlslp.extract(pos.first, len).size();
+                }
+                sink = sink + sum;
+            });
+            report(config, "extract", "len" + std::to_string(len), n, queries, stats);
+        }
+        if (selected(config, "lce_query")) {
+            auto stats = measure(config.warmup, config.repetitions, [] {}, [&] {
+                size_t sum = 0;
+                for (const auto& pos : positions) {
+                    sum += recomp::lce_query::lce_query(rlslp, pos.first, pos.second);
+                }
+                sink = sink + sum;
+            });
+            report(config, "lce_query", "recursive", n, queries, stats);
+        }
+    }
+}
+
+/**
+ * @brief Generates a text of random symbols.
+ */
+void random_text(text_t& text, size_t n, size_t sigma, size_t seed) {
+    std::mt19937_64 gen(seed);
+    text.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        text[i] = static_cast<recomp::var_t>('a' + gen() % sigma);
+    }
+}
+
+/**
+ * @brief Generates a repetitive text of copies of a random block with a small fraction of mutated symbols.
+ */
+void repetitive_text(text_t& text, size_t n, size_t block, size_t seed) {
+    std::mt19937_64 gen(seed);
+    std::vector<recomp::var_t> base(block);
+    for (auto& c : base) {
+        c = static_cast<recomp::var_t>('a' + gen() % 4);
+    }
+    text.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        text[i] = (gen() % 1000 == 0) ? static_cast<recomp::var_t>('a' + gen() % 4) : base[i % block];
+    }
+}
+
+int main(int argc, char *argv[]) {
+    tlx::CmdlineParser cmd;
+    cmd.set_description("Microbenchmarks of the kernels of the recompression, the coders and the queries");
+    cmd.set_author("Christopher Osthues");
+
+    size_t cores;
+    cmd.add_param_bytes("cores", cores, "The number of cores");
+
+    std::string path;
+    cmd.add_string('d', "path", path, "The path to the directory containing the files");
+
+    std::string filenames;
+    cmd.add_string('f', "filenames", filenames,
+                   "The real inputs. Multiple files are separated with spaces and are enclosed by \"\". Example: \"file1 file2 file3\"");
+
+    size_t prefix = 0;
+    cmd.add_bytes('p', "prefix", prefix, "The prefix of the files in bytes to read in");
+
+    size_t size = 1 << 20;
+    cmd.add_bytes('n', "size", size, "The size of the synthetic inputs (0 to skip them)");
+
+    std::string kernels;
+    cmd.add_string('k', "kernels", kernels,
+                   "The kernels to run, separated by spaces (default all): [\"bcomp compute_adj_list compute_partition directed_cut compact partitioned_radix_sort bitstream extract lce_query\"]");
+
+    size_t warmup = 2;
+    cmd.add_bytes('w', "warmup", warmup, "The number of untimed runs before the repetitions");
+
+    size_t repetitions = 10;
+    cmd.add_bytes('r', "repetitions", repetitions, "The number of timed repetitions");
+
+    size_t queries = 10000;
+    cmd.add_bytes('q', "queries", queries, "The number of extract and lce queries per repetition");
+
+    size_t seed = 42;
+    cmd.add_bytes('s', "seed", seed, "The seed of the synthetic inputs and the queries");
+
+    if (!cmd.process(argc, argv)) {
+        return -1;
+    }
+
+    micro_config config;
+    config.cores = std::max(cores, static_cast<size_t>(1));
+    config.warmup = warmup;
+    config.repetitions = std::max(repetitions, static_cast<size_t>(1));
+    if (!kernels.empty()) {
+        recomp::util::split(kernels, " ", config.kernels);
+    }
+
+    if (size > 0) {
+        text_t text;
+        random_text(text, size, 4, seed);
+        config.dataset = "random4";
+        bench_input(config, text, queries, seed);
+
+        repetitive_text(text, size, 4096, seed);
+        config.dataset = "repetitive";
+        bench_input(config, text, queries, seed);
+    }
+
+    std::vector<std::string> files;
+    if (!filenames.empty()) {
+        recomp::util::split(filenames, " ", files);
+    }
+    for (const auto& file : files) {
+        std::string file_name = path + file;
+        size_t pos = file_name.find_last_of('/');
+        config.dataset = (pos != std::string::npos) ? file_name.substr(pos + 1) : file_name;
+        recomp::util::replace_all(config.dataset, "_", "\\_");
+
+        text_t text;
+        recomp::util::read_file(file_name, text, prefix);
+        bench_input(config, text, queries, seed);
+    }
+
+    return 0;
+}
@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <tlx/cmdline_parser.hpp>
+
+#include "recompression.hpp"
+
+
+int main(int argc, char *argv[]) {
+    tlx::CmdlineParser cmd;
+    cmd.set_description("Benchmark for runtime experiments of pattern matching on the rlslp");
+    cmd.set_author("Christopher Osthues");
+
+    std::string path;
+    cmd.add_param_string("path", path, "The path to the directory containing the files");
+
+    std::string filenames;
+    cmd.add_param_string("filenames", filenames,
+                         "The files. Multiple files are separated with spaces and are enclosed by \"\". Example: \"file1 file2 file3\"");
+
+    std::string algorithms;
+    cmd.add_param_string("algorithms", algorithms, "The algorithms to benchmark [\"recomp | index | naive\"]");
+
+    size_t repeats;
+    cmd.add_param_bytes("repeats", repeats, "The number of repeats to process");
+
+    size_t patterns;
+    cmd.add_param_bytes("patterns", patterns, "The number of patterns to search for");
+
+    size_t begin;
+    cmd.add_param_bytes("begin", begin, "The pattern length to begin with");
+
+    size_t end;
+    cmd.add_param_bytes("end", end, "The pattern length to end with");
+
+    size_t steps;
+    cmd.add_param_bytes("steps", steps, "The steps");
+
+    std::string z;
+    cmd.add_param_string("zeroes", z, "Read file with zero symbol (z) or without (w)");
+
+    std::string coder = "";
+    cmd.add_string('c', "coder", coder, "The coder to read the rlslp from file (plain | fixed | sorted)");
+
+    std::string rlslp_path = "";
+    cmd.add_string('r', "rlslp_path", rlslp_path, "The path to directory containing the rlslp file");
+
+    size_t prefix = 0;
+    cmd.add_bytes('p', "prefix", prefix, "The prefix of the files in bytes to read in");
+
+    std::string trace;
+    cmd.add_string('t', "trace", trace,
+                   "Records the phases and writes them to <trace>.json (Chrome trace format) and <trace>.csv");
+
+    if (!cmd.process(argc, argv)) {
+        return -1;
+    }
+
+    if (!trace.empty()) {
+        recomp::tracer::enable();
+    }
+
+    std::vector<std::string> files;
+    recomp::util::split(filenames, " ", files);
+
+    std::vector<std::string> algos;
+    recomp::util::split(algorithms, " ", algos);
+
+    std::srand(0);
+
+    for (size_t k = 0; k < files.size(); ++k) {
+        std::string file_name = path + files[k];
+
+        size_t pos = file_name.find_last_of('/');
+        std::string dataset;
+        if (pos != std::string::npos) {
+            dataset = file_name.substr(pos + 1);
+        } else {
+            dataset = file_name;
+        }
+
+        recomp::util::replace_all(dataset, "_", "\\_");
+
+        if (z == "w") {
+            file_name += "_wz";
+        }
+
+        recomp::rlslp<recomp::var_t> rlslp;
+        if (!coder.empty()) {
+            std::string coder_file;
+            if (!rlslp_path.empty()) {
+                coder_file = rlslp_path + files[k];
+                if (z == "w") {
+                    coder_file += "_wz";
+                }
+            } else {
+                coder_file = file_name;
+            }
+
+            std::cout << "Load" << std::endl;
+            rlslp = recomp::coder::decode(coder, coder_file);
+            if (rlslp.is_empty) {
+                std::cout << "Unknown coder '" + coder + "'. Generating rlslp with parallel_lp_recompression."
+                          << std::endl;
+            }
+            std::cout << "Loaded" << std::endl;
+        }
+        if (coder.empty() || rlslp.is_empty) {
+            typedef recomp::parallel::parallel_lp_recompression<recomp::var_t>::text_t text_t;
+            text_t text;
+            recomp::util::read_file(file_name, text, prefix);
+
+            recomp::parallel::parallel_lp_recompression<recomp::var_t> recompression;
+            recompression.recomp(text, rlslp, recomp::CHAR_ALPHABET, 4);
+        }
+
+        std::string plain_text;
+        recomp::util::read_text_file(file_name, plain_text, prefix);
+        size_t file_size = plain_text.size();
+
+        const auto startTimeMatcher = recomp::timer::now();
+        recomp::pattern_matching::pattern_matcher<recomp::var_t> matcher{rlslp};
+        const auto endTimeMatcher = recomp::timer::now();
+        const auto timeSpanMatcher = endTimeMatcher - startTimeMatcher;
+        std::cout << "RESULT algo=pattern_matcher dataset=" << dataset << " production=" << rlslp.size() << " time="
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanMatcher).count() << std::endl;
+
+        std::unique_ptr<recomp::index::grammar_index<recomp::var_t>> index;
+        if (std::find(algos.begin(), algos.end(), "index") != algos.end()) {
+            const auto startTimeIndex = recomp::timer::now();
+            index.reset(new recomp::index::grammar_index<recomp::var_t>(rlslp, 4));
+            const auto endTimeIndex = recomp::timer::now();
+            const auto timeSpanIndex = endTimeIndex - startTimeIndex;
+            std::cout << "RESULT algo=grammar_index dataset=" << dataset << " production=" << rlslp.size()
+                      << " time=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanIndex).count()
+                      << std::endl;
+        }
+
+        for (size_t m = begin; m <= end && m <= file_size; m += steps) {
+            std::vector<std::string> pats(patterns);
+            for (size_t i = 0; i < patterns; ++i) {
+                pats[i] = plain_text.substr(recomp::util::random_number(file_size - m + 1), m);
+            }
+
+            for (size_t repeat = 0; repeat < repeats; ++repeat) {
+                std::vector<size_t> counts(algos.size(), 0);
+                std::vector<size_t> occs(algos.size(), 0);
+                for (size_t l = 0; l < algos.size(); ++l) {
+                    std::cout << "Iteration: " << repeat << std::endl;
+                    std::string algo = algos[l];
+                    std::cout << "Using algo " << algo << std::endl;
+
+                    if (algo == "recomp") {
+                        const auto startTime = recomp::timer::now();
+                        for (size_t i = 0; i < patterns; ++i) {
+                            counts[l] += matcher.count(pats[i]);
+                        }
+                        const auto endTime = recomp::timer::now();
+                        const auto timeSpan = endTime - startTime;
+                        const auto startTimeLocate = recomp::timer::now();
+                        for (size_t i = 0; i < patterns; ++i) {
+                            occs[l] += matcher.find_occurrences(pats[i]).size();
+                        }
+                        const auto endTimeLocate = recomp::timer::now();
+                        const auto timeSpanLocate = endTimeLocate - startTimeLocate;
+                        std::cout << "RESULT algo=recompression dataset=" << dataset << " patterns=" << patterns
+                                  << " length=" << m << " occ=" << counts[l] << " count="
+                                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                                  << " locate="
+                                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanLocate).count()
+                                  << std::endl;
+                    } else if (algo == "index") {
+                        const auto startTime = recomp::timer::now();
+                        for (size_t i = 0; i < patterns; ++i) {
+                            counts[l] += index->count(pats[i]);
+                        }
+                        const auto endTime = recomp::timer::now();
+                        const auto timeSpan = endTime - startTime;
+                        const auto startTimeLocate = recomp::timer::now();
+                        for (size_t i = 0; i < patterns; ++i) {
+                            occs[l] += index->locate(pats[i]).size();
+                        }
+                        const auto endTimeLocate = recomp::timer::now();
+                        const auto timeSpanLocate = endTimeLocate - startTimeLocate;
+                        std::cout << "RESULT algo=grammar_index dataset=" << dataset << " patterns=" << patterns
+                                  << " length=" << m << " occ=" << counts[l] << " count="
+                                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                                  << " locate="
+                                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanLocate).count()
+                                  << std::endl;
+                    } else if (algo == "naive") {
+                        const auto startTime = recomp::timer::now();
+                        for (size_t i = 0; i < patterns; ++i) {
+                            occs[l] += recomp::pattern_matching::find_occurrences_naive(plain_text, pats[i]).size();
+                        }
+                        counts[l] = occs[l];
+                        const auto endTime = recomp::timer::now();
+                        const auto timeSpan = endTime - startTime;
+                        std::cout << "RESULT algo=naive dataset=" << dataset << " patterns=" << patterns
+                                  << " length=" << m << " occ=" << counts[l] << " locate="
+                                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                                  << std::endl;
+                    } else {
+                        std::cout << "No such algorithm '" << algo << "'." << std::endl;
+                        return -1;
+                    }
+                }
+                for (size_t l = 0; l < algos.size(); ++l) {
+                    if (counts[l] != occs[l] || (l + 1 < algos.size() && counts[l] != counts[l + 1])) {
+                        std::cout << "Failure: " << algos[l] << " " << counts[l] << " (" << occs[l] << ")";
+                        if (l + 1 < algos.size()) {
+                            std::cout << " != " << counts[l + 1] << " " << algos[l + 1];
+                        }
+                        std::cout << std::endl;
+                    }
+                }
+            }
+        }
+    }
+
+    if (!trace.empty()) {
+        recomp::tracer::write(trace);
+    }
+
+    return 0;
+}
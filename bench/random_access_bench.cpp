@@ -48,10 +48,22 @@ int main(int argc, char *argv[]) {
     size_t prefix = 0;
     cmd.add_bytes('p', "prefix", prefix, "The prefix of the files in bytes to read in");
 
+    bool balance = false;
+    cmd.add_flag('b', "balance", balance,
+                 "Balances the rlslp such that its height is logarithmic in the length of the text before the queries");
+
+    std::string trace;
+    cmd.add_string('t', "trace", trace,
+                   "Records the phases and writes them to <trace>.json (Chrome trace format) and <trace>.csv");
+
     if (!cmd.process(argc, argv)) {
         return -1;
     }
 
+    if (!trace.empty()) {
+        recomp::tracer::enable();
+    }
+
     std::vector<std::string> files;
     recomp::util::split(filenames, " ", files);
 
@@ -112,6 +124,13 @@ int main(int argc, char *argv[]) {
             recompression.recomp(text, rlslp, recomp::CHAR_ALPHABET, 4);
         }
 
+        std::cout << "RESULT algo=height_distribution dataset=" << dataset << " productions=" << rlslp.size()
+                  << recomp::compute_height_distribution(rlslp) << std::endl;
+        if (balance && recomp::balance_rlslp(rlslp)) {
+            std::cout << "RESULT algo=balanced_height_distribution dataset=" << dataset << " productions="
+                      << rlslp.size() << recomp::compute_height_distribution(rlslp) << std::endl;
+        }
+
         std::string plain_text;
         recomp::util::read_text_file(file_name, plain_text, prefix);
 
@@ -181,5 +200,9 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    if (!trace.empty()) {
+        recomp::tracer::write(trace);
+    }
+
     return 0;
 }
@@ -47,10 +47,21 @@ int main(int argc, char *argv[]) {
     std::string dir;
     cmd.add_string("dir", dir, "The directory to store the partition of parhip to");
 
+    size_t seed = recomp::counter_rng::DEFAULT_SEED;
+    cmd.add_bytes('s', "seed", seed, "The seed of the random partitions");
+
+    std::string trace;
+    cmd.add_string('t', "trace", trace,
+                   "Records the phases and writes them to <trace>.json (Chrome trace format) and <trace>.csv");
+
     if (!cmd.process(argc, argv)) {
         return -1;
     }
 
+    if (!trace.empty()) {
+        recomp::tracer::enable();
+    }
+
     std::vector<std::string> files;
     recomp::util::split(filenames, " ", files);
 
@@ -86,6 +97,7 @@ int main(int argc, char *argv[]) {
                     std::cerr << "No such algo " << algo << std::endl;
                     return -1;
                 }
+                recomp->seed = seed;
 
                 typedef recomp::recompression<recomp::var_t>::text_t text_t;
                 text_t text;
@@ -118,4 +130,8 @@ int main(int argc, char *argv[]) {
             }
         }
     }
+
+    if (!trace.empty()) {
+        recomp::tracer::write(trace);
+    }
 }
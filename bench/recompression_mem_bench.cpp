@@ -13,6 +13,11 @@
 #include "malloc_count.h"
 #endif
 
+#if defined(MALLOC_COUNT) && !defined(RECOMPRESSION_TRACK_MEMORY)
+void track_memory(void*, size_t current) {
+    recomp::memory_tracker::set_current(current);
+}
+#endif
 
 int main(int argc, char *argv[]) {
     std::vector<std::string> variants;
@@ -55,6 +60,11 @@ int main(int argc, char *argv[]) {
         return -1;
     }
 
+#if defined(MALLOC_COUNT) && !defined(RECOMPRESSION_TRACK_MEMORY)
+    // without the tracking allocator the phases are accounted with the memory measured by malloc_count
+    malloc_count_set_callback(track_memory, nullptr);
+#endif
+
     std::vector<std::string> files;
     recomp::util::split(filenames, " ", files);
 
@@ -84,6 +94,7 @@ int main(int argc, char *argv[]) {
 #ifdef MALLOC_COUNT
                 malloc_count_reset_peak();
 #endif
+                recomp::memory_tracker::reset();
 
                 std::unique_ptr<recomp::recompression<recomp::var_t>> recomp = recomp::create_recompression(algo, dataset, parhip, dir);
                 if (!recomp) {
@@ -108,6 +119,9 @@ int main(int argc, char *argv[]) {
                                           << " production=" << rlslp.size() << " terminals=" << rlslp.terminals << " level="
                                           << recomp->level << " cores=" << cores << " memory=" << malloc_count_peak() << std::endl;
 #endif // MALLOC_COUNT
+#if defined(MALLOC_COUNT) || defined(RECOMPRESSION_TRACK_MEMORY)
+                recomp::memory_tracker::print(std::cout, recomp->name, dataset);
+#endif
                 std::cout << "Time for " << algo << " recompression: "
                           << std::chrono::duration_cast<std::chrono::seconds>(timeSpan).count() << "[s]" << std::endl;
                 std::cout << "Time for " << algo << " recompression: "
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <tlx/cmdline_parser.hpp>
+
+#include "recompression.hpp"
+
+#ifdef MALLOC_COUNT
+#include "malloc_count.h"
+
+#ifndef RECOMPRESSION_TRACK_MEMORY
+void track_memory(void*, size_t current) {
+    recomp::memory_tracker::set_current(current);
+}
+#endif
+#endif
+
+
+int main(int argc, char *argv[]) {
+    std::vector<std::string> variants;
+    recomp::sequential_variants(variants);
+    recomp::parallel_variants(variants);
+    recomp::experimental_variants(variants);
+
+    tlx::CmdlineParser cmd;
+    cmd.set_description("Regression harness comparing the time, the peak memory and the size of the rlslp of all "
+                        "variants with a baseline");
+    cmd.set_author("Christopher Osthues");
+
+    std::string output;
+    cmd.add_param_string("output", output, "The JSON file to write the results to");
+
+    std::string baseline;
+    cmd.add_string('b', "baseline", baseline,
+                   "The JSON file of a previous run to compare with. The harness fails if a result regresses");
+
+    std::string algorithms;
+    cmd.add_string('a', "algorithms", algorithms,
+                   "The algorithms to run (default all but parallel_parhip). Multiple algorithms are separated by spaces and are enclosed by \"\". The algorithms are: [\"" +
+                   recomp::util::variants_options(variants) + "\"]");
+
+    std::string generate = "fibonacci thue_morse random:4 random:64 periodic:1000:4 repeats:1024:0.001 repeats:65536:0.0001";
+    cmd.add_string('g', "generate", generate,
+                   "The synthetic texts of the corpus. Multiple texts are separated by spaces. The texts are: [\"" +
+                   recomp::generator::generator_options() + "\"]");
+
+    size_t size = 1 << 20;
+    cmd.add_bytes('n', "size", size, "The length of the synthetic texts");
+
+    std::string path;
+    cmd.add_string('d', "path", path, "The path to the directory containing the files");
+
+    std::string filenames;
+    cmd.add_string('f', "filenames", filenames,
+                   "Files to add to the corpus. Multiple files are separated with spaces and are enclosed by \"\". Example: \"file1 file2 file3\"");
+
+    size_t prefix = 0;
+    cmd.add_bytes('p', "prefix", prefix, "The prefix of the files in bytes to read in");
+
+    size_t cores = std::thread::hardware_concurrency();
+    cmd.add_bytes('c', "cores", cores, "The number of cores");
+
+    size_t repeats = 3;
+    cmd.add_bytes('r', "repeats", repeats, "The number of repeats. The median time is reported");
+
+    size_t seed = recomp::counter_rng::DEFAULT_SEED;
+    cmd.add_bytes('s', "seed", seed, "The seed of the random partitions and the synthetic texts");
+
+    recomp::regression::thresholds limits;
+    cmd.add_double("time-threshold", limits.time, "The allowed relative increase of the time (default 0.1)");
+    cmd.add_double("memory-threshold", limits.memory, "The allowed relative increase of the memory (default 0.05)");
+    cmd.add_double("size-threshold", limits.size, "The allowed relative increase of the size of the rlslp (default 0)");
+
+    size_t min_time = limits.min_time_ms;
+    cmd.add_bytes("min-time", min_time, "The minimal increase of the time in ms to be a regression (default 10)");
+
+    if (!cmd.process(argc, argv)) {
+        return -1;
+    }
+    limits.min_time_ms = min_time;
+    repeats = std::max(repeats, static_cast<size_t>(1));
+
+#if defined(MALLOC_COUNT) && !defined(RECOMPRESSION_TRACK_MEMORY)
+    malloc_count_set_callback(track_memory, nullptr);
+#endif
+
+    std::vector<std::string> algos;
+    if (algorithms.empty()) {
+        std::copy_if(variants.begin(), variants.end(), std::back_inserter(algos), [](const std::string& variant) {
+            return variant != "parallel_parhip";
+        });
+    } else {
+        recomp::util::split(algorithms, " ", algos);
+    }
+
+    std::vector<std::string> files;
+    if (!filenames.empty()) {
+        recomp::util::split(filenames, " ", files);
+    }
+    const size_t n_files = files.size();
+    if (!generate.empty()) {
+        recomp::util::split(generate, " ", files);
+    }
+
+    typedef recomp::recompression<recomp::var_t>::text_t text_t;
+    std::vector<recomp::regression::result> results;
+    for (size_t j = 0; j < files.size(); ++j) {
+        const bool generated = j >= n_files;
+        std::string file_name = path + files[j];
+        std::string dataset;
+        std::string c_text;
+        if (generated) {
+            dataset = recomp::generator::dataset_name(files[j], size);
+            recomp::util::replace_all(dataset, "\\_", "_");
+            if (!recomp::generator::generate(files[j], c_text, size, seed, cores)) {
+                std::cerr << "No such text " << files[j] << std::endl;
+                return -1;
+            }
+        } else {
+            size_t pos = file_name.find_last_of('/');
+            dataset = (pos != std::string::npos) ? file_name.substr(pos + 1) : file_name;
+            recomp::util::read_text_file(file_name, c_text, prefix);
+        }
+
+        for (const auto& algo : algos) {
+            std::cout << "Using algo " << algo << " on " << dataset << std::endl;
+            std::string parhip;
+            std::string dir;
+            recomp::regression::result res;
+            res.algo = algo;
+            res.dataset = dataset;
+            res.cores = cores;
+
+            std::vector<std::uint64_t> times;
+            for (size_t repeat = 0; repeat < repeats; ++repeat) {
+                std::unique_ptr<recomp::recompression<recomp::var_t>> recomp = recomp::create_recompression(
+                        algo, dataset, parhip, dir);
+                if (!recomp) {
+                    std::cerr << "No such algo " << algo << std::endl;
+                    return -1;
+                }
+                recomp->seed = seed;
+
+                text_t text(c_text.size());
+                for (size_t i = 0; i < c_text.size(); ++i) {
+                    text[i] = static_cast<recomp::var_t>(static_cast<unsigned char>(c_text[i]));
+                }
+
+                recomp::rlslp<recomp::var_t> rlslp;
+                recomp::memory_tracker::reset();
+                const size_t memory_before = recomp::memory_tracker::current();
+                const auto startTime = recomp::timer::now();
+                recomp->recomp(text, rlslp, recomp::CHAR_ALPHABET, cores);
+                const auto endTime = recomp::timer::now();
+                times.push_back(static_cast<std::uint64_t>(
+                        std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count()));
+                res.memory_bytes = std::max(res.memory_bytes, recomp::memory_tracker::peak() - memory_before);
+
+                if (repeat == 0) {
+                    res.rlslp_size = rlslp.size();
+                    res.correct = rlslp.derive_text() == c_text;
+                }
+            }
+            std::sort(times.begin(), times.end());
+            res.time_ms = times[times.size() / 2];
+
+            std::cout << "RESULT algo=" << res.algo << " dataset=" << res.dataset << " cores=" << res.cores
+                      << " time=" << res.time_ms << " memory=" << res.memory_bytes << " rlslp_size="
+                      << res.rlslp_size << " correct=" << res.correct << std::endl;
+            results.push_back(res);
+        }
+    }
+
+    std::ofstream out(output);
+    recomp::regression::write_json(out, results);
+    out.close();
+    if (!out) {
+        std::cerr << "Failed to write " << output << std::endl;
+        return -1;
+    }
+
+    std::vector<recomp::regression::result> base;
+    if (!baseline.empty()) {
+        std::ifstream in(baseline);
+        if (!in || !recomp::regression::read_json(in, base)) {
+            std::cerr << "Failed to read baseline " << baseline << std::endl;
+            return -1;
+        }
+    }
+    auto findings = recomp::regression::compare(base, results, limits);
+    recomp::regression::print(std::cout, findings);
+    if (!findings.empty()) {
+        std::cout << findings.size() << " regressions" << std::endl;
+        return 1;
+    }
+    std::cout << "No regressions" << std::endl;
+    return 0;
+}
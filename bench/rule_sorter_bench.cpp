@@ -0,0 +1,137 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <tlx/cmdline_parser.hpp>
+
+#include "recompression.hpp"
+
+#ifdef MALLOC_COUNT
+#include "malloc_count.h"
+#endif
+
+template<typename variable_t>
+void copy_rlslp(const recomp::rlslp<variable_t>& from, recomp::rlslp<variable_t>& to) {
+    to.terminals = from.terminals;
+    to.root = from.root;
+    to.blocks = from.blocks;
+    to.is_empty = from.is_empty;
+    to.resize(from.size());
+    for (size_t i = 0; i < from.size(); ++i) {
+        to[i] = from[i];
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<std::string> variants;
+    recomp::sequential_variants(variants);
+    recomp::parallel_variants(variants);
+    recomp::experimental_variants(variants);
+
+    tlx::CmdlineParser cmd;
+    cmd.set_description("Benchmark for sorting the rules of the rlslp (sequential and parallel)");
+    cmd.set_author("Christopher Osthues");
+
+    std::string path;
+    cmd.add_param_string("path", path, "The path to the directory containing the files");
+
+    std::string filenames;
+    cmd.add_param_string("filenames", filenames,
+                         "The files. Multiple files are separated with spaces and are enclosed by \"\". Example: \"file1 file2 file3\"");
+
+    std::string algo;
+    cmd.add_param_string("algorithm", algo,
+                         "The algorithm to compute the rlslp with. The algorithms are: [\"" +
+                         recomp::util::variants_options(variants) + "\"]");
+
+    size_t cores;
+    cmd.add_param_bytes("cores", cores, "The maximal number of cores");
+
+    size_t repeats = 1;
+    cmd.add_bytes('r', "repeats", repeats, "The number of repeats");
+
+    size_t prefix = 0;
+    cmd.add_bytes('p', "prefix", prefix, "The prefix of the files in bytes to read in");
+
+    bool sequential = false;
+    cmd.add_flag('s', "sequential", sequential, "Also run the sequential sorter for comparison");
+
+    if (!cmd.process(argc, argv)) {
+        return -1;
+    }
+
+    std::vector<std::string> files;
+    recomp::util::split(filenames, " ", files);
+
+    for (size_t j = 0; j < files.size(); ++j) {
+        std::string file_name = path + files[j];
+        size_t pos = file_name.find_last_of('/');
+        std::string dataset;
+        if (pos != std::string::npos) {
+            dataset = file_name.substr(pos + 1);
+        } else {
+            dataset = file_name;
+        }
+        recomp::util::replace_all(dataset, "_", "\\_");
+
+        std::unique_ptr<recomp::recompression<recomp::var_t>> recomp = recomp::create_recompression(algo, dataset,
+                                                                                                    "", "");
+        if (!recomp) {
+            std::cerr << "No such algo " << algo << std::endl;
+            return -1;
+        }
+
+        typedef recomp::recompression<recomp::var_t>::text_t text_t;
+        text_t text;
+        recomp::util::read_file(file_name, text, prefix);
+        recomp::rlslp<recomp::var_t> rlslp;
+        recomp->recomp(text, rlslp, recomp::CHAR_ALPHABET, cores);
+        text.resize(0);
+
+        for (size_t repeat = 0; repeat < repeats; ++repeat) {
+            recomp::rlslp<recomp::var_t> exp_rlslp;
+            if (sequential) {
+                copy_rlslp(rlslp, exp_rlslp);
+#ifdef MALLOC_COUNT
+                malloc_count_reset_peak();
+                const size_t base = malloc_count_current();
+#endif
+                const auto startTime = recomp::timer::now();
+                recomp::sequential_sort_rlslp_rules(exp_rlslp);
+                const auto endTime = recomp::timer::now();
+                std::cout << "RESULT algo=sequential_sort_rlslp_rules dataset=" << dataset << " cores=1"
+                          << " productions=" << rlslp.size() << " time="
+                          << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count()
+#ifdef MALLOC_COUNT
+                          << " memory=" << (malloc_count_peak() - base)
+#endif
+                          << std::endl;
+            }
+
+            for (size_t c = 1; c <= cores; c *= 2) {
+                recomp::rlslp<recomp::var_t> sorted;
+                copy_rlslp(rlslp, sorted);
+#ifdef MALLOC_COUNT
+                malloc_count_reset_peak();
+                const size_t base = malloc_count_current();
+#endif
+                const auto startTime = recomp::timer::now();
+                recomp::sort_rlslp_rules(sorted, c);
+                const auto endTime = recomp::timer::now();
+                std::cout << "RESULT algo=sort_rlslp_rules dataset=" << dataset << " cores=" << c
+                          << " productions=" << rlslp.size() << " time="
+                          << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count()
+#ifdef MALLOC_COUNT
+                          << " memory=" << (malloc_count_peak() - base)
+#endif
+                          << std::endl;
+
+                if (sequential && !(sorted == exp_rlslp)) {
+                    std::cout << "Failure sort" << std::endl;
+                }
+            }
+        }
+    }
+}
@@ -32,7 +32,7 @@ int main(int argc, char *argv[]) {
                          recomp::util::variants_options(variants) + "\"]");
 
     std::string coder;
-    cmd.add_param_string("coder", coder, "The coder to store the rlslp to file (plain | fixed | sorted)");
+    cmd.add_param_string("coder", coder, "The coder to store the rlslp to file (plain | fixed | sorted | sorted_dr | huffman)");
 
     std::string to_path;
     cmd.add_param_string("to_path", to_path, "The path to the directory to store the rlslp file to");
@@ -52,10 +52,32 @@ int main(int argc, char *argv[]) {
     std::string dir;
     cmd.add_string("dir", dir, "The directory to store the partition of parhip to");
 
+    bool verify = false;
+    cmd.add_flag('v', "verify", verify,
+                 "Verify the rlslps by comparing windows of the derived text with the file instead of deriving the "
+                 "whole text");
+
+    bool optimize = false;
+    cmd.add_flag('o', "optimize", optimize,
+                 "Optimizes the rlslp before storing it, i.e. prunes unreachable rules, merges equivalent rules and "
+                 "inlines rules used once");
+
+    size_t repair_rounds = 0;
+    cmd.add_bytes("repair", repair_rounds,
+                  "The number of rounds of RePair on the right-hand sides during the optimization (default 0)");
+
+    std::string trace;
+    cmd.add_string('t', "trace", trace,
+                   "Records the phases and writes them to <trace>.json (Chrome trace format) and <trace>.csv");
+
     if (!cmd.process(argc, argv)) {
         return -1;
     }
 
+    if (!trace.empty()) {
+        recomp::tracer::enable();
+    }
+
     std::vector<std::string> files;
     recomp::util::split(filenames, " ", files);
 
@@ -107,14 +129,26 @@ int main(int argc, char *argv[]) {
                       << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count() << "[ms]"
                       << std::endl;
 
-            std::string res = rlslp.derive_text();
+            if (optimize || repair_rounds > 0) {
+                recomp::optimizer_config config;
+                config.repair_rounds = repair_rounds;
+                recomp::optimize_rlslp(rlslp, config, cores);
+            }
+
             std::string c_text;
-            if (z == "z") {
-                recomp::util::read_text_file(file_name, c_text, prefix);
+            bool correct;
+            if (verify) {
+                correct = recomp::verify_rlslp(rlslp, file_name, prefix, z == "z", cores);
             } else {
-                recomp::util::read_text_file_without_zeroes(file_name, c_text, prefix);
+                std::string res = rlslp.derive_text();
+                if (z == "z") {
+                    recomp::util::read_text_file(file_name, c_text, prefix);
+                } else {
+                    recomp::util::read_text_file_without_zeroes(file_name, c_text, prefix);
+                }
+                correct = res == c_text;
             }
-            if (res == c_text) {
+            if (correct) {
                 std::cout << "Correct extract" << std::endl;
             } else {
                 std::cout << "Failure extract" << std::endl;
@@ -139,13 +173,18 @@ int main(int argc, char *argv[]) {
                       << in_enc.tellg() << " productions=" << rlslp.size() << std::endl;
             in_enc.close();
 
-            if (rlslp == in_rlslp && rlslp.derive_text() == in_rlslp.derive_text()) {
+            if (verify) {
+                correct = rlslp == in_rlslp && recomp::verify_rlslp(in_rlslp, file_name, prefix, z == "z", cores);
+            } else {
+                correct = rlslp == in_rlslp && rlslp.derive_text() == in_rlslp.derive_text();
+            }
+            if (correct) {
                 std::cout << "Correct store" << std::endl;
             } else {
                 std::cout << "Failure store" << std::endl;
             }
 
-            if (coder == "sorted" || coder == "sorted_dr") {
+            if (coder == "sorted" || coder == "sorted_dr" || coder == "huffman") {
                 recomp::sort_rlslp_rules(rlslp);
 
                 if (rlslp.blocks > 0) {
@@ -166,7 +205,12 @@ int main(int argc, char *argv[]) {
                     }
                 }
 
-                if (rlslp.derive_text() == c_text) {
+                if (verify) {
+                    correct = recomp::verify_rlslp(rlslp, file_name, prefix, z == "z", cores);
+                } else {
+                    correct = rlslp.derive_text() == c_text;
+                }
+                if (correct) {
                     std::cout << "Correct store" << std::endl;
                 } else {
                     std::cout << "Failure store" << std::endl;
@@ -174,4 +218,8 @@ int main(int argc, char *argv[]) {
             }
         }
     }
+
+    if (!trace.empty()) {
+        recomp::tracer::write(trace);
+    }
 }
@@ -52,76 +52,158 @@ int main(int argc, char *argv[]) {
     std::string dir;
     cmd.add_string("dir", dir, "The directory to store the partition of parhip to");
 
+    size_t seed = recomp::counter_rng::DEFAULT_SEED;
+    cmd.add_bytes('s', "seed", seed, "The seed of the random partitions");
+
+    std::string schedule = "static";
+    cmd.add_string("schedule", schedule,
+                   "The schedule of the parallel loops (static | work_stealing | both). With both every run is "
+                   "repeated with both schedules");
+
+    size_t min_round_work = 0;
+    cmd.add_bytes('w', "min-round-work", min_round_work,
+                  "The minimal number of symbols per thread in a round. Shorter rounds use fewer threads (0 to use "
+                  "all cores in every round)");
+
+    bool single_region = false;
+    cmd.add_flag('r', "single-region", single_region,
+                 "Runs all rounds of parallel and parallel_rnd in one parallel region with barriers between the phases");
+
     bool mult = false;
     cmd.add_flag('m', "mult", mult, "True if the begin shall be multiplied by the steps, false to add it");
 
+    std::string trace;
+    cmd.add_string('t', "trace", trace,
+                   "Records the phases and writes them to <trace>.json (Chrome trace format) and <trace>.csv");
+
+    std::string generate;
+    cmd.add_string('g', "generate", generate,
+                   "Synthetic texts to use in addition to the files (use \"\" as filenames to only use them). Multiple texts are separated by spaces. The texts are: [\"" +
+                   recomp::generator::generator_options() + "\"]");
+
+    size_t size = 1 << 24;
+    cmd.add_bytes('n', "size", size, "The length of the synthetic texts");
+
+    size_t text_seed = recomp::counter_rng::DEFAULT_SEED;
+    cmd.add_bytes("text-seed", text_seed, "The seed of the synthetic texts");
+
     if (!cmd.process(argc, argv)) {
         return -1;
     }
 
+    if (!trace.empty()) {
+        recomp::tracer::enable();
+    }
+
     std::vector<std::string> files;
-    recomp::util::split(filenames, " ", files);
+    if (!filenames.empty()) {
+        recomp::util::split(filenames, " ", files);
+    }
+    const size_t n_files = files.size();
+    if (!generate.empty()) {
+        recomp::util::split(generate, " ", files);
+    }
 
     std::vector<std::string> algos;
     recomp::util::split(algorithms, " ", algos);
 
+    std::vector<recomp::loop_schedule_t> schedules;
+    if (schedule == "static" || schedule == "both") {
+        schedules.push_back(recomp::STATIC);
+    }
+    if (schedule == "work_stealing" || schedule == "both") {
+        schedules.push_back(recomp::WORK_STEALING);
+    }
+    if (schedules.empty()) {
+        std::cerr << "No such schedule " << schedule << std::endl;
+        return -1;
+    }
+
     for (size_t j = 0; j < files.size(); ++j) {
         for (size_t step = begin; step <= cores;) {
             for (size_t repeat = 0; repeat < repeats; ++repeat) {
-                for (size_t i = 0; i < algos.size(); ++i) {
-                    std::cout << "Iteration: " << repeat << std::endl;
-                    std::string algo = algos[i];
-                    std::cout << "Using algo " << algo << std::endl;
-                    std::cout << "Using " << step << " cores" << std::endl;
-
-                    std::string file_name = path;
-                    file_name += files[j];
-
-                    size_t pos = file_name.find_last_of('/');
-                    std::string dataset;
-                    if (pos != std::string::npos) {
-                        dataset = file_name.substr(pos + 1);
-                    } else {
-                        dataset = file_name;
-                    }
-
-                    recomp::util::replace_all(dataset, "_", "\\_");
-
-                    std::unique_ptr<recomp::recompression<recomp::var_t>> recomp = recomp::create_recompression(
-                            algo, dataset, parhip, dir);
-                    if (!recomp) {
-                        std::cerr << "No such algo " << algo << std::endl;
-                        return -1;
-                    }
-
-                    typedef recomp::recompression<recomp::var_t>::text_t text_t;
-                    text_t text;
-                    recomp::util::read_file(file_name, text, prefix);
-
-                    recomp::rlslp<recomp::var_t> rlslp;
-
-                    const auto startTime = recomp::timer::now();
-
-                    recomp->recomp(text, rlslp, recomp::CHAR_ALPHABET, step);
-                    const auto endTime = recomp::timer::now();
-                    const auto timeSpan = endTime - startTime;
-                    std::cout << "Time for " << algo << " recompression: "
-                              << std::chrono::duration_cast<std::chrono::seconds>(timeSpan).count() << "[s]"
-                              << std::endl;
-                    std::cout << "Time for " << algo << " recompression: "
-                              << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count() << "[ms]"
-                              << std::endl;
-
-                    std::string res = rlslp.derive_text();
-                    rlslp.resize(1);
-                    // rlslp.shrink_to_fit();
-
-                    std::string c_text;
-                    recomp::util::read_text_file(file_name, c_text, prefix);
-                    if (res == c_text) {
-                        std::cout << "Correct" << std::endl;
-                    } else {
-                        std::cout << "Failure" << std::endl;
+                for (const auto loop_schedule : schedules) {
+                    for (size_t i = 0; i < algos.size(); ++i) {
+                        std::cout << "Iteration: " << repeat << std::endl;
+                        std::string algo = algos[i];
+                        std::cout << "Using algo " << algo << std::endl;
+                        std::cout << "Using " << step << " cores" << std::endl;
+                        std::cout << "Using schedule " << recomp::to_string(loop_schedule) << std::endl;
+
+                        const bool generated = j >= n_files;
+                        std::string file_name = path;
+                        file_name += files[j];
+
+                        size_t pos = file_name.find_last_of('/');
+                        std::string dataset;
+                        if (generated) {
+                            dataset = recomp::generator::dataset_name(files[j], size);
+                        } else if (pos != std::string::npos) {
+                            dataset = file_name.substr(pos + 1);
+                        } else {
+                            dataset = file_name;
+                        }
+
+                        if (!generated) {
+                            recomp::util::replace_all(dataset, "_", "\\_");
+                        }
+
+                        std::unique_ptr<recomp::recompression<recomp::var_t>> recomp = recomp::create_recompression(
+                                algo, dataset, parhip, dir);
+                        if (!recomp) {
+                            std::cerr << "No such algo " << algo << std::endl;
+                            return -1;
+                        }
+                        recomp->seed = seed;
+                        recomp->loop_schedule = loop_schedule;
+                        recomp->min_round_work = min_round_work;
+                        recomp->single_region = single_region;
+
+                        typedef recomp::recompression<recomp::var_t>::text_t text_t;
+                        text_t text;
+                        if (generated) {
+                            if (!recomp::generator::generate(files[j], text, size, text_seed, cores)) {
+                                std::cerr << "No such text " << files[j] << std::endl;
+                                return -1;
+                            }
+                        } else {
+                            recomp::util::read_file(file_name, text, prefix);
+                        }
+
+                        recomp::rlslp<recomp::var_t> rlslp;
+
+                        const auto startTime = recomp::timer::now();
+
+                        recomp->recomp(text, rlslp, recomp::CHAR_ALPHABET, step);
+                        const auto endTime = recomp::timer::now();
+                        const auto timeSpan = endTime - startTime;
+                        std::cout << "Time for " << algo << " recompression: "
+                                  << std::chrono::duration_cast<std::chrono::seconds>(timeSpan).count() << "[s]"
+                                  << std::endl;
+                        std::cout << "Time for " << algo << " recompression: "
+                                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count() << "[ms]"
+                                  << std::endl;
+                        std::cout << "RESULT algo=" << algo << " dataset=" << dataset << " cores=" << step
+                                  << " schedule=" << recomp::to_string(loop_schedule)
+                                  << " single_region=" << single_region << " time="
+                                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                                  << std::endl;
+
+                        std::string res = rlslp.derive_text();
+                        rlslp.resize(1);
+                        // rlslp.shrink_to_fit();
+
+                        std::string c_text;
+                        if (generated) {
+                            recomp::generator::generate(files[j], c_text, size, text_seed, cores);
+                        } else {
+                            recomp::util::read_text_file(file_name, c_text, prefix);
+                        }
+                        if (res == c_text) {
+                            std::cout << "Correct" << std::endl;
+                        } else {
+                            std::cout << "Failure" << std::endl;
+                        }
                     }
                 }
             }
@@ -145,4 +227,8 @@ int main(int argc, char *argv[]) {
 //            }
         }
     }
+
+    if (!trace.empty()) {
+        recomp::tracer::write(trace);
+    }
 }
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <tlx/cmdline_parser.hpp>
+
+#include "recompression.hpp"
+
+
+/**
+ * @brief Runs the recompression with the given type of non-terminals on the unpacked and on the bit-packed text and
+ * reports the time, the memory of the unpacked text, the bit-packed input and the rlslp, the time to encode and decode
+ * the rlslp and the time of random lce queries.
+ *
+ * @return @code{false} if the algorithm does not exist or the rlslp is not correct, @code{true} otherwise
+ */
+template<typename variable_t>
+bool bench(const std::string& algo, const std::string& file_name, std::string& dataset, const std::string& coder,
+           const std::string& c_text, size_t cores, size_t queries, size_t prefix, bool verify) {
+    const size_t width = sizeof(variable_t) * 8;
+    std::string parhip;
+    std::string dir;
+    std::unique_ptr<recomp::recompression<variable_t>> recomp =
+            recomp::create_recompression<variable_t>(algo, dataset, parhip, dir);
+    if (!recomp) {
+        std::cerr << "No such algo " << algo << std::endl;
+        return false;
+    }
+
+    typedef typename recomp::recompression<variable_t>::text_t text_t;
+    text_t text;
+    recomp::util::read_file(file_name, text, prefix);
+    const size_t text_size = text.size();
+    const size_t text_bytes = text.size() * sizeof(variable_t);
+
+    recomp::rlslp<variable_t> rlslp;
+    const auto startTime = recomp::timer::now();
+    recomp->recomp(text, rlslp, recomp::CHAR_ALPHABET, cores);
+    const auto endTime = recomp::timer::now();
+    const auto timeSpan = endTime - startTime;
+
+    std::unique_ptr<recomp::recompression<variable_t>> packed_recomp =
+            recomp::create_recompression<variable_t>(algo, dataset, parhip, dir);
+    recomp::packed_vector<variable_t> packed;
+    size_t packed_bytes = 0;
+    {
+        text_t input;
+        recomp::util::read_file(file_name, input, prefix);
+        packed.pack(input, recomp::packed_vector<variable_t>::width_for(recomp::CHAR_ALPHABET - 1), cores);
+        packed_bytes = packed.bytes();
+    }
+    recomp::rlslp<variable_t> packed_rlslp;
+    const auto startTimePacked = recomp::timer::now();
+    packed_recomp->recomp(packed, packed_rlslp, recomp::CHAR_ALPHABET, cores);
+    const auto endTimePacked = recomp::timer::now();
+    const auto timeSpanPacked = endTimePacked - startTimePacked;
+    if (!(packed_rlslp == rlslp)) {
+        std::cout << "Failure" << std::endl;
+        return false;
+    }
+
+    const auto startTimeEnc = recomp::timer::now();
+    recomp::coder::encode<variable_t>(coder, file_name + "_" + std::to_string(width), rlslp);
+    const auto endTimeEnc = recomp::timer::now();
+    const auto timeSpanEnc = endTimeEnc - startTimeEnc;
+
+    const auto startTimeDec = recomp::timer::now();
+    recomp::rlslp<variable_t> in_rlslp = recomp::coder::decode<variable_t>(coder, file_name + "_" + std::to_string(width));
+    const auto endTimeDec = recomp::timer::now();
+    const auto timeSpanDec = endTimeDec - startTimeDec;
+
+    std::srand(0);  // same queries for all widths
+    std::vector<std::pair<size_t, size_t>> positions(queries);
+    for (size_t i = 0; i < queries; ++i) {
+        positions[i] = std::make_pair(recomp::util::random_number(text_size),
+                                      recomp::util::random_number(text_size));
+    }
+    size_t lce_sum = 0;
+    const auto startTimeLce = recomp::timer::now();
+    for (const auto& pos : positions) {
+        lce_sum += recomp::lce_query::lce_query(in_rlslp, pos.first, pos.second);
+    }
+    const auto endTimeLce = recomp::timer::now();
+    const auto timeSpanLce = endTimeLce - startTimeLce;
+
+    std::cout << "RESULT algo=" << algo << " dataset=" << dataset << " width=" << width << " cores=" << cores
+              << " time=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+              << " production=" << rlslp.size() << " text_bytes=" << text_bytes
+              << " packed_time=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanPacked).count()
+              << " packed_width=" << static_cast<size_t>(packed.width()) << " packed_text_bytes=" << packed_bytes
+              << " rlslp_bytes=" << rlslp.size() * sizeof(recomp::non_terminal<variable_t>)
+              << " enc=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanEnc).count()
+              << " dec=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanDec).count()
+              << " queries=" << queries << " lce_sum=" << lce_sum
+              << " lce=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanLce).count() << std::endl;
+
+    std::string file = file_name + "_" + std::to_string(width) + recomp::coder::get_coder_extension(coder);
+    remove(file.c_str());
+
+    const bool correct = verify ? recomp::verify_rlslp(in_rlslp, file_name, prefix, true, cores)
+                                : in_rlslp.derive_text() == c_text;
+    if (!correct) {
+        std::cout << "Failure" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<std::string> variants;
+    recomp::sequential_variants(variants);
+    recomp::parallel_variants(variants);
+
+    tlx::CmdlineParser cmd;
+    cmd.set_description("Benchmark comparing 32 bit and 64 bit non-terminals");
+    cmd.set_author("Christopher Osthues");
+
+    std::string path;
+    cmd.add_param_string("path", path, "The path to the directory containing the files");
+
+    std::string filenames;
+    cmd.add_param_string("filenames", filenames,
+                         "The files. Multiple files are separated with spaces and are enclosed by \"\". Example: \"file1 file2 file3\"");
+
+    std::string algorithms;
+    cmd.add_param_string("algorithms", algorithms,
+                         "The algorithms to benchmark. Multiple algorithms are also separated by \"\" like the file names. The algorithms are: [\"" +
+                         recomp::util::variants_options(variants) + "\"]");
+
+    size_t cores;
+    cmd.add_param_bytes("cores", cores, "The number of cores");
+
+    size_t repeats;
+    cmd.add_param_bytes("repeats", repeats, "The number of repeats to process");
+
+    std::string coder = "fixed";
+    cmd.add_string('c', "coder", coder, "The coder to encode the rlslp with (plain | fixed | sorted | sorted_dr | huffman)");
+
+    size_t queries = 100000;
+    cmd.add_bytes('q', "queries", queries, "The number of random lce queries");
+
+    size_t prefix = 0;
+    cmd.add_bytes('p', "prefix", prefix, "The prefix of the files in bytes to read in");
+
+    bool verify = false;
+    cmd.add_flag('v', "verify", verify,
+                 "Verify the rlslps by comparing windows of the derived text with the file instead of deriving the "
+                 "whole text");
+
+    if (!cmd.process(argc, argv)) {
+        return -1;
+    }
+
+    std::vector<std::string> files;
+    recomp::util::split(filenames, " ", files);
+
+    std::vector<std::string> algos;
+    recomp::util::split(algorithms, " ", algos);
+
+    for (size_t j = 0; j < files.size(); ++j) {
+        std::string file_name = path;
+        file_name += files[j];
+
+        size_t pos = file_name.find_last_of('/');
+        std::string dataset;
+        if (pos != std::string::npos) {
+            dataset = file_name.substr(pos + 1);
+        } else {
+            dataset = file_name;
+        }
+        recomp::util::replace_all(dataset, "_", "\\_");
+
+        std::string c_text;
+        if (!verify) {
+            recomp::util::read_text_file(file_name, c_text, prefix);
+        }
+
+        for (size_t repeat = 0; repeat < repeats; ++repeat) {
+            for (const auto& algo : algos) {
+                std::cout << "Iteration: " << repeat << std::endl;
+                std::cout << "Using algo " << algo << std::endl;
+
+                if (!bench<std::uint32_t>(algo, file_name, dataset, coder, c_text, cores, queries, prefix, verify) ||
+                    !bench<std::uint64_t>(algo, file_name, dataset, coder, c_text, cores, queries, prefix, verify)) {
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
@@ -52,12 +52,29 @@ int main(int argc, char *argv[]) {
     std::string dir;
     cmd.add_string("dir", dir, "The directory to store the partition of parhip to");
 
+    size_t seed = recomp::counter_rng::DEFAULT_SEED;
+    cmd.add_bytes('s', "seed", seed, "The seed of the random partitions");
+
+    std::string generate;
+    cmd.add_string('g', "generate", generate,
+                   "Synthetic texts to use in addition to the files (use \"\" as filenames to only use them). Multiple texts are separated by spaces. The texts are: [\"" +
+                   recomp::generator::generator_options() + "\"]");
+
+    size_t text_seed = recomp::counter_rng::DEFAULT_SEED;
+    cmd.add_bytes("text-seed", text_seed, "The seed of the synthetic texts");
+
     if (!cmd.process(argc, argv)) {
         return -1;
     }
 
     std::vector<std::string> files;
-    recomp::util::split(filenames, " ", files);
+    if (!filenames.empty()) {
+        recomp::util::split(filenames, " ", files);
+    }
+    const size_t n_files = files.size();
+    if (!generate.empty()) {
+        recomp::util::split(generate, " ", files);
+    }
 
     std::vector<std::string> algos;
     recomp::util::split(algorithms, " ", algos);
@@ -71,28 +88,41 @@ int main(int argc, char *argv[]) {
                     std::cout << "Using algo " << algo << std::endl;
                     std::cout << "Using " << step << " cores" << std::endl;
 
+                    const bool generated = j >= n_files;
                     std::string file_name = path;
                     file_name += files[j];
 
                     size_t pos = file_name.find_last_of('/');
                     std::string dataset;
-                    if (pos != std::string::npos) {
+                    if (generated) {
+                        dataset = recomp::generator::dataset_name(files[j], file_size);
+                    } else if (pos != std::string::npos) {
                         dataset = file_name.substr(pos + 1);
                     } else {
                         dataset = file_name;
                     }
 
-                    recomp::util::replace_all(dataset, "_", "\\_");
+                    if (!generated) {
+                        recomp::util::replace_all(dataset, "_", "\\_");
+                    }
 
                     std::unique_ptr<recomp::recompression<recomp::var_t>> recomp = recomp::create_recompression(algo, dataset, parhip, dir);
                     if (!recomp) {
                         std::cerr << "No such algo " << algo << std::endl;
                         return -1;
                     }
+                    recomp->seed = seed;
 
                     typedef recomp::recompression<recomp::var_t>::text_t text_t;
                     text_t text;
-                    recomp::util::read_file_fill(file_name, text, file_size);
+                    if (generated) {
+                        if (!recomp::generator::generate(files[j], text, file_size, text_seed, cores)) {
+                            std::cerr << "No such text " << files[j] << std::endl;
+                            return -1;
+                        }
+                    } else {
+                        recomp::util::read_file_fill(file_name, text, file_size);
+                    }
 
                     recomp::rlslp<recomp::var_t> rlslp;
 
@@ -113,7 +143,11 @@ int main(int argc, char *argv[]) {
                     // rlslp.shrink_to_fit();
 
                     std::string c_text;
-                    recomp::util::read_text_file_fill(file_name, c_text, file_size);
+                    if (generated) {
+                        recomp::generator::generate(files[j], c_text, file_size, text_seed, cores);
+                    } else {
+                        recomp::util::read_text_file_fill(file_name, c_text, file_size);
+                    }
                     if (res == c_text) {
                         std::cout << "Correct" << std::endl;
                     } else {
@@ -12,7 +12,23 @@ set(SOURCES
         src/recompression/parallel_rnd_recompression.cpp
         src/recompression/parallel_rnddir_recompression.cpp
         src/recompression/lce_query.cpp
+        src/recompression/karp_rabin.cpp
+        src/recompression/pattern_matching.cpp
+        src/recompression/grammar_index.cpp
+        src/recompression/packed_vector.cpp
+        src/recompression/parallel_loop.cpp
+        src/recompression/bit_partition.cpp
+        src/recompression/random.cpp
+        src/recompression/run_detection.cpp
         src/recompression/radix_sort.cpp
+        src/recompression/batch_scheduler.cpp
+        src/recompression/rlslp_verifier.cpp
+        src/recompression/grammar_optimizer.cpp
+        src/recompression/grammar_balancer.cpp
+        src/recompression/memory_tracker.cpp
+        src/recompression/trace.cpp
+        src/recompression/text_generator.cpp
+        src/recompression/regression.cpp
         src/recompression/experimental/parallel_order_great_recompression.cpp
         src/recompression/parallel_ls_recompression.cpp
         src/recompression/experimental/parallel_ls3_recompression.cpp
@@ -21,6 +37,7 @@ set(SOURCES
         src/recompression/parallel_gr_recompression.cpp
         src/recompression/experimental/parallel_gr_alternate_recompression.cpp
         src/recompression/hash_recompression.cpp
+        src/recompression/append_recompression.cpp
         src/recompression/defs.cpp
         src/recompression/coders/rlslp_rule_sorter.cpp
         src/recompression/coders/coder.cpp
@@ -28,6 +45,9 @@ set(SOURCES
         src/recompression/coders/plain_fixed_rlslp_coder.cpp
         src/recompression/coders/sorted_rlslp_dr_coder.cpp
         src/recompression/coders/sorted_rlslp_coder.cpp
+        src/recompression/coders/grammar_index_coder.cpp
+        src/recompression/coders/huffman_code.cpp
+        src/recompression/coders/huffman_rlslp_coder.cpp
         src/recompression/io/bitostream.cpp
         src/recompression/io/bitistream.cpp
         src/recompression.cpp
@@ -38,10 +58,26 @@ set(HEADERS
         include/recompression/experimental/parallel_lock_recompression.hpp
         include/recompression/defs.hpp
         include/recompression/lce_query.hpp
+        include/recompression/karp_rabin.hpp
+        include/recompression/pattern_matching.hpp
+        include/recompression/grammar_index.hpp
         include/recompression/rlslp.hpp
         include/recompression/recompression.hpp
         include/recompression/parallel_recompression.hpp
+        include/recompression/packed_vector.hpp
+        include/recompression/parallel_loop.hpp
+        include/recompression/bit_partition.hpp
+        include/recompression/random.hpp
+        include/recompression/run_detection.hpp
         include/recompression/radix_sort.hpp
+        include/recompression/batch_scheduler.hpp
+        include/recompression/rlslp_verifier.hpp
+        include/recompression/grammar_optimizer.hpp
+        include/recompression/grammar_balancer.hpp
+        include/recompression/memory_tracker.hpp
+        include/recompression/trace.hpp
+        include/recompression/text_generator.hpp
+        include/recompression/regression.hpp
         include/recompression/experimental/parallel_order_less_recompression.hpp
         include/recompression/experimental/parallel_gr2_recompression.hpp
         include/recompression/experimental/parallel_parhip_recompression.hpp
@@ -55,12 +91,16 @@ set(HEADERS
         include/recompression/experimental/parallel_gr_alternate_recompression.hpp
         include/recompression/fast_recompression.hpp
         include/recompression/hash_recompression.hpp
+        include/recompression/append_recompression.hpp
         include/recompression/util.hpp
         include/recompression/experimental/parallel_order_great_recompression.hpp
         include/recompression/coders/plain_rlslp_coder.hpp
         include/recompression/coders/plain_fixed_rlslp_coder.hpp
         include/recompression/coders/sorted_rlslp_dr_coder.hpp
         include/recompression/coders/sorted_rlslp_coder.hpp
+        include/recompression/coders/grammar_index_coder.hpp
+        include/recompression/coders/huffman_code.hpp
+        include/recompression/coders/huffman_rlslp_coder.hpp
         include/recompression/coders/rlslp_rule_sorter.hpp
         include/recompression/coders/coder.hpp
         include/recompression/io/bitistream.hpp
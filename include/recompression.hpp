@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <iostream>
 #include <memory>
+#include <string>
 
 #include "recompression/defs.hpp"
 #include "recompression/recompression.hpp"
@@ -10,12 +13,29 @@
 #include "recompression/experimental/parallel_lock_recompression.hpp"
 #include "recompression/experimental/parallel_gr2_recompression.hpp"
 #include "recompression/hash_recompression.hpp"
+#include "recompression/append_recompression.hpp"
 #include "recompression/parallel_lp_recompression.hpp"
 #include "recompression/parallel_recompression.hpp"
 #include "recompression/parallel_rnd_recompression.hpp"
 #include "recompression/parallel_rnddir_recompression.hpp"
+#include "recompression/karp_rabin.hpp"
 #include "recompression/lce_query.hpp"
+#include "recompression/pattern_matching.hpp"
+#include "recompression/grammar_index.hpp"
+#include "recompression/packed_vector.hpp"
+#include "recompression/parallel_loop.hpp"
+#include "recompression/bit_partition.hpp"
+#include "recompression/random.hpp"
+#include "recompression/run_detection.hpp"
 #include "recompression/radix_sort.hpp"
+#include "recompression/batch_scheduler.hpp"
+#include "recompression/rlslp_verifier.hpp"
+#include "recompression/grammar_optimizer.hpp"
+#include "recompression/grammar_balancer.hpp"
+#include "recompression/memory_tracker.hpp"
+#include "recompression/trace.hpp"
+#include "recompression/text_generator.hpp"
+#include "recompression/regression.hpp"
 #include "recompression/rlslp.hpp"
 #include "recompression/util.hpp"
 #include "recompression/experimental/parallel_gr_alternate_recompression.hpp"
@@ -32,6 +52,9 @@
 #include "recompression/coders/plain_fixed_rlslp_coder.hpp"
 #include "recompression/coders/sorted_rlslp_coder.hpp"
 #include "recompression/coders/sorted_rlslp_dr_coder.hpp"
+#include "recompression/coders/grammar_index_coder.hpp"
+#include "recompression/coders/huffman_code.hpp"
+#include "recompression/coders/huffman_rlslp_coder.hpp"
 #include "recompression/coders/rlslp_rule_sorter.hpp"
 
 namespace recomp {
@@ -39,6 +62,7 @@ namespace recomp {
 void sequential_variants(std::vector<std::string>& variants) {
     variants.emplace_back("fast_seq");
     variants.emplace_back("hash");
+    variants.emplace_back("append");
 }
 
 void parallel_variants(std::vector<std::string>& variants) {
@@ -62,6 +86,82 @@ void experimental_variants(std::vector<std::string>& variants) {
     variants.emplace_back("parallel_parhip");
 }
 
+/**
+ * @brief Parses the configuration of the local search from the name of a parallel_ls variant.
+ *
+ * The name has the form parallel_ls[k][_rc[c]][_eps<e>][_ms<t>] where k is the maximum number of passes, _rc selects
+ * the residue class mode with c classes (Jacobi otherwise), e is the minimal gain of the cut per pass relative to the
+ * number of pairs and t is the time budget per level in milliseconds. E.g. parallel_ls10_rc4_eps0.001.
+ *
+ * Malformed options (e.g. parallel_ls1.5 or parallel_ls_rcx) are reported on stderr.
+ *
+ * @param name The name of the variant
+ * @param config[out] The configuration
+ * @return @code{true} if the name is a valid parallel_ls variant, @code{false} otherwise
+ */
+inline bool parse_local_search_config(const std::string& name, parallel::local_search_config& config) {
+    const std::string prefix = "parallel_ls";
+    if (name.find(prefix) != 0) {
+        return false;
+    }
+    auto invalid = [&](const std::string& option, const std::string& reason) {
+        std::cerr << "Invalid option '" << option << "' of " << name << ": " << reason << std::endl;
+        return false;
+    };
+    // digits only, the value must fit into size_t
+    auto parse_number = [](const std::string& str, size_t& value) {
+        if (str.empty() || str.size() > 19 || str.find_first_not_of("0123456789") != std::string::npos) {
+            return false;
+        }
+        value = std::stoull(str);
+        return true;
+    };
+    // digits with at most one decimal point
+    auto parse_decimal = [](const std::string& str, double& value) {
+        if (str.find_first_not_of("0123456789.") != std::string::npos ||
+            str.find_first_of("0123456789") == std::string::npos ||
+            std::count(str.begin(), str.end(), '.') > 1) {
+            return false;
+        }
+        value = std::stod(str);
+        return true;
+    };
+    std::vector<std::string> options;
+    util::split(name.substr(prefix.size()), "_", options);
+    for (size_t i = 0; i < options.size(); ++i) {
+        const std::string& option = options[i];
+        size_t value = 0;
+        if (i == 0) {
+            if (!option.empty()) {
+                if (!parse_number(option, value)) {
+                    return invalid(option, "the number of passes must be a non-negative integer");
+                }
+                config.passes = value;
+            }
+        } else if (option.find("rc") == 0) {
+            config.mode = parallel::local_search_config::RESIDUE_CLASSES;
+            if (option.size() > 2) {
+                if (!parse_number(option.substr(2), value)) {
+                    return invalid(option, "the number of classes must be a non-negative integer");
+                }
+                config.classes = value;
+            }
+        } else if (option.find("eps") == 0) {
+            if (!parse_decimal(option.substr(3), config.min_gain)) {
+                return invalid(option, "the minimal gain must be a non-negative decimal number");
+            }
+        } else if (option.find("ms") == 0) {
+            if (!parse_number(option.substr(2), value)) {
+                return invalid(option, "the time budget must be a non-negative integer");
+            }
+            config.time_budget = value;
+        } else {
+            return invalid(option, "expected rc[c], eps<e> or ms<t>");
+        }
+    }
+    return true;
+}
+
 /**
  * @brief Creates a unique pointer for the given class name.
  *
@@ -131,9 +231,18 @@ std::unique_ptr<recompression<variable_t>> create_recompression(const std::strin
         return std::make_unique<recompression_fast<variable_t>>(dataset);
     } else if (name == "hash") {
         return std::make_unique<hash_recompression<variable_t>>(dataset);
-    } else {
-        return std::unique_ptr<recompression<variable_t>>(nullptr);
+    } else if (name == "append") {
+        return std::make_unique<append_recompression<variable_t>>(dataset);
+    }
+
+    parallel::local_search_config config;
+    if (parse_local_search_config(name, config)) {
+        std::cout << "Using " << config.passes << " passes for " << name << std::endl;
+        auto recomp = std::make_unique<parallel::parallel_ls_recompression<variable_t>>(dataset, config);
+        recomp->name = name;
+        return recomp;
     }
+    return std::unique_ptr<recompression<variable_t>>(nullptr);
 }
 
 namespace coder {
@@ -150,16 +259,19 @@ template<typename variable_t = var_t>
 void encode(const std::string& coder, const std::string& file_name, rlslp<variable_t>& rlslp) {
     if (coder == "plain") {
         PlainRLSLPCoder::Encoder enc{file_name};
-        enc.encode(rlslp);
+        enc.template encode<variable_t>(rlslp);
     } else if (coder == "fixed") {
         PlainFixedRLSLPCoder::Encoder enc{file_name};
-        enc.encode(rlslp);
+        enc.template encode<variable_t>(rlslp);
     } else if (coder == "sorted") {
         SortedRLSLPCoder::Encoder enc{file_name};
-        enc.encode(rlslp);
+        enc.template encode<variable_t>(rlslp);
     } else if (coder == "sorted_dr") {
         SortedRLSLPDRCoder::Encoder enc{file_name};
-        enc.encode(rlslp);
+        enc.template encode<variable_t>(rlslp);
+    } else if (coder == "huffman") {
+        HuffmanRLSLPCoder::Encoder enc{file_name};
+        enc.template encode<variable_t>(rlslp);
     }
 }
 
@@ -175,16 +287,19 @@ template<typename variable_t = var_t>
 rlslp<variable_t> decode(const std::string& coder, const std::string& file_name) {
     if (coder == "plain") {
         PlainRLSLPCoder::Decoder dec{file_name};
-        return dec.decode();
+        return dec.template decode<variable_t>();
     } else if (coder == "fixed") {
         PlainFixedRLSLPCoder::Decoder dec{file_name};
-        return dec.decode();
+        return dec.template decode<variable_t>();
     } else if (coder == "sorted") {
         SortedRLSLPCoder::Decoder dec{file_name};
-        return dec.decode();
+        return dec.template decode<variable_t>();
     } else if (coder == "sorted_dr") {
         SortedRLSLPDRCoder::Decoder dec{file_name};
-        return dec.decode();
+        return dec.template decode<variable_t>();
+    } else if (coder == "huffman") {
+        HuffmanRLSLPCoder::Decoder dec{file_name};
+        return dec.template decode<variable_t>();
     } else {
         return rlslp<variable_t>{};
     }
@@ -205,6 +320,8 @@ std::string get_coder_extension(const std::string& name) {
         return coder::SortedRLSLPCoder::k_extension;
     } else if (name == "sorted_dr") {
         return coder::SortedRLSLPDRCoder::k_extension;
+    } else if (name == "huffman") {
+        return coder::HuffmanRLSLPCoder::k_extension;
     } else {
         return "unkown";
     }
@@ -0,0 +1,730 @@
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "recompression.hpp"
+#include "defs.hpp"
+#include "rlslp.hpp"
+#include "io/bitistream.hpp"
+#include "io/bitostream.hpp"
+
+namespace recomp {
+
+/**
+ * @brief This class is a sequential implementation of the recompression that supports appending text to an already
+ * computed rlslp.
+ *
+ * The text is compressed in a streaming fashion. For every level the right boundary is kept, i.e. the last run of a
+ * block compression level and the last (unpaired) symbol of a pair compression level. Symbols left of the boundary
+ * are final and are passed to the next level. Appending a suffix therefore only recompresses the boundaries and the
+ * new data while all previously generated non-terminals are reused. The partition of the symbols of a pair
+ * compression level is fixed when a symbol occurs for the first time on this level.
+ *
+ * The rules are only stored in the rlslp. The levels refer to the rules by identifiers that do not change if a rule
+ * is moved within the rlslp. The rules closing the boundaries are removed again by the next append and their indices
+ * are reused by the new rules. Afterwards the remaining gaps are filled and the misplaced pairs and blocks are swapped
+ * such that the pairs are in front of the blocks again, so an append only moves a few rules instead of renaming the
+ * whole rlslp. The boundaries can be written next to the encoded rlslp (@code{write_state}) and read again
+ * (@code{read_state}) to continue a decoded rlslp with a coder that keeps the order of the rules, e.g. the plain or
+ * the fixed coder.
+ *
+ * @tparam variable_t The type of non-terminals
+ */
+template<typename variable_t = var_t>
+class append_recompression : public recompression<variable_t> {
+ public:
+    typedef typename recompression<variable_t>::text_t text_t;
+    typedef typename recompression<variable_t>::alphabet_t alphabet_t;
+    typedef typename recompression<variable_t>::bv_t bv_t;
+    typedef std::unordered_map<variable_t, bool> partition_t;
+    typedef std::unordered_map<std::pair<variable_t, variable_t>, variable_t, pair_hash> dictionary_t;
+
+    /**
+     * @brief The right boundary of a single level. Non-terminals are given by their identifiers.
+     */
+    struct boundary_t {
+        /**
+         * The symbol of the last run (block compression) or the pending symbol (pair compression).
+         */
+        variable_t symbol = 0;
+
+        /**
+         * The length of the last run (block compression) or 1 if a symbol is pending (pair compression).
+         */
+        variable_t count = 0;
+
+        /**
+         * The last symbol seen on this level. Only used for pair compression levels.
+         */
+        variable_t last = 0;
+
+        /**
+         * The partition of the symbols. Only used for pair compression levels.
+         */
+        partition_t partition;
+    };
+
+    inline append_recompression() {
+        this->name = "append";
+    }
+
+    inline append_recompression(std::string& dataset) : recompression<variable_t>(dataset) {
+        this->name = "append";
+    }
+
+    inline virtual void recomp(text_t& text,
+                               rlslp<variable_t>& rlslp,
+                               const size_t& alphabet_size,
+                               const size_t cores) override {
+        trace_scope trace("recompression", "recompression", "text", text.size());
+        clear();
+        this->cores = cores;
+        terminals = alphabet_size;
+        append(text, rlslp);
+    }
+
+    using recompression<variable_t>::recomp;
+
+    /**
+     * @brief Appends the given suffix to the text compressed so far and updates the rlslp accordingly.
+     *
+     * Only the right boundaries of the levels and the suffix are compressed. All non-terminals that have been
+     * generated by former calls are reused and the new rules are added to the rlslp. The rlslp must be the one of the
+     * former calls (or of @code{read_state}) and is reset if nothing has been compressed yet.
+     *
+     * @param suffix[in] The suffix to append
+     * @param rlslp[in,out] The rlslp deriving the whole text
+     */
+    inline void append(const text_t& suffix, rlslp<variable_t>& rlslp) {
+#ifdef BENCH
+        const auto startTime = recomp::timer::now();
+#endif
+        if (terminals == 0) {
+            terminals = rlslp.terminals;
+        }
+        if (text_size == 0 && rules == 0) {
+            rlslp.terminals = terminals;
+            rlslp.blocks = 0;
+            rlslp.resize(0);
+        }
+        const size_t first_pairs = pair_rules;
+        while (!closing.empty()) {
+            remove_rule(rlslp, closing.back());
+            closing.pop_back();
+        }
+
+        for (size_t i = 0; i < suffix.size(); ++i) {
+            push(rlslp, suffix[i]);
+        }
+        text_size += suffix.size();
+#ifdef BENCH
+        const auto endTimeAppend = recomp::timer::now();
+        const auto timeSpanAppend = endTimeAppend - startTime;
+        const auto startTimeRlslp = recomp::timer::now();
+#endif
+        variable_t root = 0;
+        if (text_size > 0) {
+            root = close(rlslp);
+        }
+        sort_rules(rlslp, first_pairs);
+        rlslp.is_empty = text_size == 0;
+        rlslp.root = text_size > 0 ? to_nt(root) : 0;
+#ifdef BENCH
+        const auto endTime = recomp::timer::now();
+        const auto timeSpan = endTime - startTime;
+        std::cout << "RESULT algo=" << this->name << "_recompression dataset=" << this->dataset << " time="
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count() << " append="
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanAppend).count() << " rlslp="
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTimeRlslp).count()
+                  << " production=" << rlslp.size() << " terminals=" << rlslp.terminals << " level="
+                  << boundaries.size() << " size=" << text_size << " suffix=" << suffix.size() << std::endl;
+#endif
+    }
+
+    /**
+     * @brief Resets the state such that the next call of append starts a new text.
+     */
+    inline void clear() {
+        boundaries.clear();
+        blocks.clear();
+        pairs.clear();
+        closing.clear();
+        index.clear();
+        ids.clear();
+        bv.clear();
+        parents.clear();
+        free_ids.clear();
+        free_pairs.clear();
+        free_blocks.clear();
+        filled.clear();
+        tail.clear();
+        rules = 0;
+        pair_rules = 0;
+        text_size = 0;
+        terminals = 0;
+        this->level = 0;
+    }
+
+    /**
+     * @brief Returns the right boundaries of all levels.
+     *
+     * @return The boundaries
+     */
+    inline const std::vector<boundary_t>& get_boundaries() const {
+        return boundaries;
+    }
+
+    /**
+     * @brief Writes the boundaries of all levels and the rules closing them to a file. Together with the rlslp they
+     * allow to append to the text later on.
+     *
+     * @param file_name The file to write to
+     */
+    inline void write_state(const std::string& file_name) const {
+        BitOStream ostream(file_name);
+        ostream.write_int<size_t>(terminals);
+        ostream.write_int<size_t>(text_size);
+        ostream.write_int<size_t>(rules);
+        ostream.write_int<size_t>(closing.size());
+        for (const auto& id : closing) {
+            ostream.write_int<variable_t>(to_nt(id));
+        }
+        ostream.write_int<size_t>(boundaries.size());
+        for (const auto& b : boundaries) {
+            ostream.write_int<variable_t>(b.count > 0 ? to_nt(b.symbol) : 0);
+            ostream.write_int<variable_t>(b.count);
+            ostream.write_int<variable_t>(b.partition.empty() ? 0 : to_nt(b.last));
+            ostream.write_int<size_t>(b.partition.size());
+            for (const auto& part : b.partition) {
+                ostream.write_int<variable_t>(to_nt(part.first));
+                ostream.write_bit(part.second);
+            }
+        }
+        ostream.close();
+    }
+
+    /**
+     * @brief Reads the boundaries written by @code{write_state} such that the next call of append continues the given
+     * rlslp, e.g. a decoded one. The dictionaries of the rules are rebuilt from the rlslp.
+     *
+     * @param file_name The file to read from
+     * @param rlslp The rlslp the state has been written with
+     * @return @code{false} if the state does not belong to the rlslp, @code{true} otherwise
+     */
+    inline bool read_state(const std::string& file_name, const rlslp<variable_t>& rlslp) {
+        clear();
+        BitIStream istream(file_name);
+        terminals = istream.read_int<size_t>();
+        text_size = istream.read_int<size_t>();
+        const auto size = istream.read_int<size_t>();
+        closing.resize(istream.read_int<size_t>());
+        for (auto& id : closing) {
+            id = istream.read_int<variable_t>();
+        }
+        boundaries.resize(istream.read_int<size_t>());
+        for (auto& b : boundaries) {
+            b.symbol = istream.read_int<variable_t>();
+            b.count = istream.read_int<variable_t>();
+            b.last = istream.read_int<variable_t>();
+            auto parts = istream.read_int<size_t>();
+            while (parts--) {
+                auto symbol = istream.read_int<variable_t>();
+                b.partition[symbol] = istream.read_bit();
+            }
+        }
+        istream.close();
+
+        const bool valid = (terminals == rlslp.terminals || (terminals == 0 && text_size == 0)) &&
+                           size == rlslp.size() && rlslp.empty() == (text_size == 0) &&
+                           std::all_of(closing.begin(), closing.end(), [&](variable_t id) {
+                               return id >= terminals && id - terminals < size;
+                           });
+        if (!valid) {
+            std::cerr << "The state " << file_name << " does not belong to the rlslp" << std::endl;
+            clear();
+            return false;
+        }
+
+        // the identifiers are the non-terminals of the rlslp
+        rules = size;
+        pair_rules = rlslp.blocks;
+        index.resize(rules);
+        ids.resize(rules);
+        bv.resize(rules);
+        parents.resize(rules);
+        for (size_t i = 0; i < rules; ++i) {
+            index[i] = i;
+            ids[i] = nt_at(i);
+            bv[i] = rlslp.is_block(ids[i]);
+        }
+        for (size_t i = 0; i < rules; ++i) {
+            add_key(rlslp, ids[i]);
+        }
+        this->level = boundaries.size();
+        return true;
+    }
+
+ private:
+    std::vector<boundary_t> boundaries;
+    dictionary_t blocks;
+    dictionary_t pairs;
+
+    /**
+     * The identifiers of the rules closing the boundaries in the order of their creation. They are removed by the next
+     * append.
+     */
+    std::vector<variable_t> closing;
+
+    /**
+     * The index of the rule of each identifier.
+     */
+    std::vector<size_t> index;
+
+    /**
+     * The identifier of the rule at each index.
+     */
+    std::vector<variable_t> ids;
+
+    /**
+     * Indicates the block rules for each identifier.
+     */
+    bv_t bv;
+
+    /**
+     * The identifiers of the rules with the rule as a child for each identifier.
+     */
+    std::vector<std::vector<variable_t>> parents;
+
+    /**
+     * The identifiers of removed rules.
+     */
+    std::vector<variable_t> free_ids;
+
+    /**
+     * The unused indices of removed pairs and blocks while appending.
+     */
+    std::vector<size_t> free_pairs;
+    std::vector<size_t> free_blocks;
+
+    /**
+     * The indices that got a new rule while appending.
+     */
+    std::vector<size_t> filled;
+
+    /**
+     * The rules behind the end of the rlslp while appending.
+     */
+    std::vector<non_terminal<variable_t>> tail;
+
+    /**
+     * The number of rules. While appending there may be unused indices and rules behind the end of the rlslp.
+     */
+    size_t rules = 0;
+    size_t pair_rules = 0;
+    size_t text_size = 0;
+    size_t terminals = 0;
+
+    /**
+     * @return The non-terminal of the rule at the given index
+     */
+    inline variable_t nt_at(size_t i) const {
+        return static_cast<variable_t>(terminals + i);
+    }
+
+    /**
+     * @return The current non-terminal of the given identifier
+     */
+    inline variable_t to_nt(variable_t id) const {
+        return id < terminals ? id : static_cast<variable_t>(terminals + index[id - terminals]);
+    }
+
+    /**
+     * @return The identifier of the given non-terminal
+     */
+    inline variable_t to_id(variable_t nt) const {
+        return nt < terminals ? nt : ids[nt - terminals];
+    }
+
+    inline non_terminal<variable_t>& rule(rlslp<variable_t>& rlslp, size_t i) {
+        return i < rlslp.size() ? rlslp[i] : tail[i - rlslp.size()];
+    }
+
+    inline const non_terminal<variable_t>& rule(const rlslp<variable_t>& rlslp, size_t i) const {
+        return i < rlslp.size() ? rlslp[i] : tail[i - rlslp.size()];
+    }
+
+    inline size_t len(const rlslp<variable_t>& rlslp, variable_t id) const {
+        return id < terminals ? 1 : rule(rlslp, index[id - terminals]).len;
+    }
+
+    /**
+     * @return The block or pair of the rule of the identifier with the identifiers of the children
+     */
+    inline std::pair<variable_t, variable_t> key(const rlslp<variable_t>& rlslp, variable_t id) const {
+        const auto& r = rule(rlslp, index[id - terminals]);
+        return std::make_pair(to_id(r.first()), bv[id - terminals] ? r.second() : to_id(r.second()));
+    }
+
+    /**
+     * @brief Adds the rule of the identifier to the dictionary and to the parents of its children.
+     */
+    inline void add_key(const rlslp<variable_t>& rlslp, variable_t id) {
+        const auto k = key(rlslp, id);
+        (bv[id - terminals] ? blocks : pairs)[k] = id;
+        if (k.first >= terminals) {
+            parents[k.first - terminals].push_back(id);
+        }
+        if (!bv[id - terminals] && k.second >= terminals) {
+            parents[k.second - terminals].push_back(id);
+        }
+    }
+
+    /**
+     * @brief Moves the rule at index from to the unused index to and renames the non-terminal in the rules with the
+     * rule as a child.
+     */
+    inline void move_rule(rlslp<variable_t>& rlslp, size_t from, size_t to) {
+        const variable_t id = ids[from];
+        const variable_t old_nt = nt_at(from);
+        const variable_t new_nt = nt_at(to);
+        rule(rlslp, to) = rule(rlslp, from);
+        ids[to] = id;
+        index[id - terminals] = to;
+        for (const auto& p : parents[id - terminals]) {
+            auto& parent = rule(rlslp, index[p - terminals]);
+            if (parent.first() == old_nt) {
+                parent.first() = new_nt;
+            }
+            if (!bv[p - terminals] && parent.second() == old_nt) {
+                parent.second() = new_nt;
+            }
+        }
+    }
+
+    /**
+     * @brief Adds a rule at an unused index of the same kind or behind the last rule.
+     *
+     * @return The identifier of the rule
+     */
+    inline variable_t add_rule(rlslp<variable_t>& rlslp, const std::pair<variable_t, variable_t>& k, bool block) {
+        variable_t id;
+        if (free_ids.empty()) {
+            id = static_cast<variable_t>(terminals + index.size());
+            index.emplace_back();
+            bv.push_back(block);
+            parents.emplace_back();
+        } else {
+            id = free_ids.back();
+            free_ids.pop_back();
+        }
+        auto& free = block ? free_blocks : free_pairs;
+        size_t i;
+        if (free.empty()) {
+            i = rlslp.size() + tail.size();
+            tail.emplace_back();
+            ids.emplace_back();
+        } else {
+            i = free.back();
+            free.pop_back();
+        }
+        index[id - terminals] = i;
+        ids[i] = id;
+        bv[id - terminals] = block;
+        const size_t l = block ? len(rlslp, k.first) * k.second : len(rlslp, k.first) + len(rlslp, k.second);
+        rule(rlslp, i) = non_terminal<variable_t>(to_nt(k.first), block ? k.second : to_nt(k.second), l);
+        add_key(rlslp, id);
+        filled.push_back(i);
+        rules++;
+        if (!block) {
+            pair_rules++;
+        }
+        return id;
+    }
+
+    /**
+     * @brief Removes the rule of the identifier which must not be a child of another rule. Its index is reused by the
+     * next rule of the same kind.
+     */
+    inline void remove_rule(const rlslp<variable_t>& rlslp, variable_t id) {
+        const auto k = key(rlslp, id);
+        const bool block = bv[id - terminals];
+        (block ? blocks : pairs).erase(k);
+        for (const auto& child : {k.first, k.second}) {
+            if (child >= terminals && (!block || child == k.first)) {
+                auto& child_parents = parents[child - terminals];
+                child_parents.erase(std::find(child_parents.begin(), child_parents.end(), id));
+            }
+        }
+        (block ? free_blocks : free_pairs).push_back(index[id - terminals]);
+        free_ids.push_back(id);
+        rules--;
+        if (!block) {
+            pair_rules--;
+        }
+    }
+
+    /**
+     * @brief Moves the rules behind the number of rules to the unused indices in front of it and swaps the pairs
+     * behind and the blocks in front of the number of pairs such that the pairs are in front of the blocks. Only the
+     * filled indices and the indices between the former and the current number of pairs can be misplaced. Afterwards
+     * the rlslp is resized to the number of rules.
+     *
+     * @param rlslp[in,out] The rlslp
+     * @param first_pairs The number of pairs before the append
+     */
+    inline void sort_rules(rlslp<variable_t>& rlslp, size_t first_pairs) {
+        const size_t end = rlslp.size() + tail.size();
+        std::vector<size_t> gaps;
+        std::vector<bool> unused(end - rules, false);
+        for (const auto& free : {&free_pairs, &free_blocks}) {
+            for (const auto& i : *free) {
+                if (i < rules) {
+                    gaps.push_back(i);
+                } else {
+                    unused[i - rules] = true;
+                }
+            }
+            free->clear();
+        }
+        // the gaps of the pairs are filled with pairs and the gaps of the blocks with blocks if possible
+        std::vector<size_t> behind[2];
+        for (size_t i = rules; i < end; ++i) {
+            if (!unused[i - rules]) {
+                behind[bv[ids[i] - terminals]].push_back(i);
+            }
+        }
+        std::vector<size_t> other_gaps;
+        for (const auto& i : gaps) {
+            auto& from = behind[i >= pair_rules];
+            if (from.empty()) {
+                other_gaps.push_back(i);
+            } else {
+                move_rule(rlslp, from.back(), i);
+                from.pop_back();
+                filled.push_back(i);
+            }
+        }
+        for (const auto& i : other_gaps) {
+            auto& from = behind[i < pair_rules];
+            move_rule(rlslp, from.back(), i);
+            from.pop_back();
+            filled.push_back(i);
+        }
+
+        std::vector<size_t> candidates = filled;
+        for (size_t i = std::min(first_pairs, pair_rules); i < std::max(first_pairs, pair_rules); ++i) {
+            candidates.push_back(i);
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        filled.clear();
+        std::vector<size_t> misplaced[2];
+        for (const auto& i : candidates) {
+            if (i < rules && bv[ids[i] - terminals] == (i < pair_rules)) {
+                misplaced[bv[ids[i] - terminals]].push_back(i);
+            }
+        }
+        if (!misplaced[0].empty()) {
+            // the index behind the last rule is the buffer of the swaps, the pairs are moved twice since they are
+            // usually new and have fewer parents than the blocks
+            if (rules == end) {
+                tail.emplace_back();
+                ids.emplace_back();
+            }
+            for (size_t k = 0; k < misplaced[0].size(); ++k) {
+                move_rule(rlslp, misplaced[0][k], rules);
+                move_rule(rlslp, misplaced[1][k], misplaced[0][k]);
+                move_rule(rlslp, rules, misplaced[1][k]);
+            }
+        }
+
+        const size_t size = rlslp.size();
+        if (rules != size) {
+            rlslp.resize(rules);
+            for (size_t i = size; i < rules; ++i) {
+                rlslp[i] = tail[i - size];
+            }
+        }
+        tail.clear();
+        ids.resize(rules);
+        rlslp.blocks = pair_rules;
+    }
+
+    /**
+     * @brief Returns the identifier of the given block or pair and generates a new rule if it does not exist.
+     *
+     * If temporary is true, new rules close the boundaries and are removed by the next append.
+     */
+    inline variable_t get_nt(rlslp<variable_t>& rlslp, const std::pair<variable_t, variable_t>& key, bool block,
+                             bool temporary = false) {
+        auto& dict = block ? blocks : pairs;
+        auto found = dict.find(key);
+        if (found != dict.end()) {
+            return (*found).second;
+        }
+        const variable_t id = add_rule(rlslp, key, block);
+        if (temporary) {
+            closing.push_back(id);
+        }
+        return id;
+    }
+
+    /**
+     * @brief Assigns the symbol to the opposite set of its left neighbour if it has no set yet.
+     *
+     * This is the greedy undirected maximum cut restricted to the neighbours known at the time the symbol occurs.
+     *
+     * @return @code{true} if the symbol is in the right set, @code{false} if it is in the left set
+     */
+    inline bool side(partition_t& partition, variable_t symbol, bool has_left, bool left_side) {
+        auto found = partition.find(symbol);
+        if (found != partition.end()) {
+            return (*found).second;
+        }
+        bool s = has_left && !left_side;
+        partition[symbol] = s;
+        return s;
+    }
+
+    /**
+     * @brief Pushes the symbol to the first level and passes all final symbols to the next levels.
+     *
+     * Each level emits at most one final symbol per pushed symbol.
+     *
+     * @param symbol The next symbol of the text
+     */
+    inline void push(rlslp<variable_t>& rlslp, variable_t symbol) {
+        size_t lvl = 0;
+        bool emit = true;
+        while (emit) {
+            emit = false;
+            if (lvl == boundaries.size()) {
+                boundaries.emplace_back();
+                this->level = boundaries.size();
+            }
+            auto& b = boundaries[lvl];
+            if (lvl % 2 == 0) {  // block compression
+                if (b.count > 0 && b.symbol == symbol) {
+                    b.count++;
+                } else {
+                    if (b.count > 0) {
+                        variable_t out = b.symbol;
+                        if (b.count > 1) {
+                            out = get_nt(rlslp, std::make_pair(b.symbol, b.count), true);
+                        }
+                        emit = true;
+                        b.symbol = symbol;
+                        b.count = 1;
+                        symbol = out;
+                    } else {
+                        b.symbol = symbol;
+                        b.count = 1;
+                    }
+                }
+            } else {  // pair compression
+                bool has_left = b.count > 0 || !b.partition.empty();
+                bool last_side = has_left && b.partition[b.last];
+                bool s = side(b.partition, symbol, has_left, last_side);
+                b.last = symbol;
+                if (b.count > 0) {
+                    if (s) {
+                        symbol = get_nt(rlslp, std::make_pair(b.symbol, symbol), false);
+                        b.count = 0;
+                    } else {
+                        std::swap(symbol, b.symbol);
+                    }
+                    emit = true;
+                } else if (s) {
+                    emit = true;
+                } else {
+                    b.symbol = symbol;
+                    b.count = 1;
+                }
+            }
+            lvl++;
+        }
+    }
+
+    /**
+     * @brief Compresses the boundaries of all levels without changing them and returns the identifier of the root. The
+     * new rules are temporary.
+     *
+     * The sequence of a level consists of its boundary followed by the symbols of the lower levels. The levels are
+     * continued until only one symbol is left.
+     *
+     * @param rlslp[in,out] The rlslp
+     * @return The identifier of the root
+     */
+    inline variable_t close(rlslp<variable_t>& rlslp) {
+        std::vector<variable_t> carry;
+        std::vector<variable_t> seq;
+        for (size_t lvl = 0; lvl < boundaries.size() || carry.size() > 1; ++lvl) {
+            if (lvl % 2 == 0) {
+                // the run of the boundary is not expanded since it may be arbitrarily long
+                variable_t symbol = 0;
+                variable_t count = 0;
+                if (lvl < boundaries.size()) {
+                    symbol = boundaries[lvl].symbol;
+                    count = boundaries[lvl].count;
+                }
+                seq.clear();
+                for (size_t i = 0; i <= carry.size(); ++i) {
+                    if (i < carry.size() && count > 0 && carry[i] == symbol) {
+                        count++;
+                        continue;
+                    }
+                    if (count > 1) {
+                        seq.push_back(get_nt(rlslp, std::make_pair(symbol, count), true, true));
+                    } else if (count == 1) {
+                        seq.push_back(symbol);
+                    }
+                    if (i < carry.size()) {
+                        symbol = carry[i];
+                        count = 1;
+                    }
+                }
+                std::swap(seq, carry);
+            } else {
+                seq.clear();
+                if (lvl < boundaries.size() && boundaries[lvl].count > 0) {
+                    seq.push_back(boundaries[lvl].symbol);
+                }
+                seq.insert(seq.end(), carry.begin(), carry.end());
+                carry.clear();
+                partition_t tmp;
+                std::vector<bool> sides(seq.size());
+                for (size_t i = 0; i < seq.size(); ++i) {
+                    if (lvl < boundaries.size()) {
+                        const auto& part = boundaries[lvl].partition;
+                        auto found = part.find(seq[i]);
+                        if (found != part.end()) {
+                            sides[i] = (*found).second;
+                            continue;
+                        }
+                    }
+                    sides[i] = side(tmp, seq[i], i > 0, i > 0 && sides[i - 1]);
+                }
+                size_t i = 0;
+                while (i < seq.size()) {
+                    if (i + 1 < seq.size() && !sides[i] && sides[i + 1]) {
+                        carry.push_back(get_nt(rlslp, std::make_pair(seq[i], seq[i + 1]), false, true));
+                        i += 2;
+                    } else {
+                        carry.push_back(seq[i]);
+                        i++;
+                    }
+                }
+            }
+        }
+        return carry[0];
+    }
+};
+
+}  // namespace recomp
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "memory_tracker.hpp"
+
+namespace recomp {
+
+/**
+ * @brief A job of a batch, i.e. one input, with the resources assigned to it.
+ */
+struct batch_job {
+    size_t id;      // the index of the input
+    size_t size;    // the size of the input in bytes
+    size_t cores;   // the number of cores assigned to the job
+    size_t memory;  // the estimated peak memory of the job in bytes
+};
+
+/**
+ * @brief Schedules the compression of many inputs concurrently.
+ *
+ * Every job gets one core per @code{bytes_per_core} bytes of input (at least one, at most all cores) and is estimated
+ * to use @code{memory_per_byte} bytes of memory per input byte. The jobs are started from the largest to the smallest
+ * input as soon as enough cores and memory are free. If the next job does not fit, smaller jobs that fit are started
+ * instead. A job that exceeds the memory limit on its own is started when no other job is running.
+ */
+class batch_scheduler {
+ public:
+    size_t cores = 1;
+
+    /**
+     * The bound of the estimated memory of all running jobs in bytes. 0 means unbounded.
+     */
+    size_t memory_limit = 0;
+
+    /**
+     * The number of input bytes per assigned core.
+     */
+    size_t bytes_per_core = 1 << 20;
+
+    /**
+     * The estimated peak memory per input byte, i.e. text, rlslp and the working memory of the recompression.
+     */
+    size_t memory_per_byte = 32;
+
+    inline batch_scheduler() = default;
+
+    inline batch_scheduler(size_t cores, size_t memory_limit = 0) : cores(std::max(cores, static_cast<size_t>(1))),
+                                                                    memory_limit(memory_limit) {}
+
+    /**
+     * @brief Computes the jobs for the inputs of the given sizes in the order they are started.
+     *
+     * @param sizes The sizes of the inputs in bytes
+     * @return The jobs sorted by decreasing size
+     */
+    inline std::vector<batch_job> plan(const std::vector<size_t>& sizes) const {
+        std::vector<batch_job> jobs(sizes.size());
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            jobs[i].id = i;
+            jobs[i].size = sizes[i];
+            jobs[i].cores = std::max(static_cast<size_t>(1),
+                                     std::min(cores, sizes[i] / std::max(bytes_per_core, static_cast<size_t>(1))));
+            jobs[i].memory = sizes[i] * memory_per_byte;
+        }
+        std::stable_sort(jobs.begin(), jobs.end(), [](const batch_job& a, const batch_job& b) {
+            return a.size > b.size;
+        });
+        return jobs;
+    }
+
+    /**
+     * @brief Runs @code{f(job)} for the inputs of the given sizes. Every job runs in its own thread and must not use
+     * more than @code{job.cores} cores. The first exception thrown by a job is rethrown after all jobs finished.
+     * The memory phases of the jobs are skipped (see @code{skip_memory_phases}) since the jobs run concurrently.
+     *
+     * @param sizes The sizes of the inputs in bytes
+     * @param f The function processing a job
+     */
+    template<typename function_t>
+    inline void run(const std::vector<size_t>& sizes, function_t f) const {
+        std::vector<batch_job> pending = plan(sizes);
+        std::vector<std::thread> threads;
+        std::vector<size_t> finished;
+        std::exception_ptr error;
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        size_t free_cores = cores;
+        size_t used_memory = 0;
+        size_t running = 0;
+
+        auto fits = [&](const batch_job& job) {
+            if (running == 0) {
+                return true;
+            }
+            return job.cores <= free_cores && (memory_limit == 0 || used_memory + job.memory <= memory_limit);
+        };
+
+        std::unique_lock<std::mutex> lock(mutex);
+        size_t next = 0;
+        while (next < pending.size() || running > 0) {
+            auto it = std::find_if(pending.begin() + next, pending.end(), fits);
+            if (it == pending.end()) {
+                changed.wait(lock);
+            } else {
+                std::rotate(pending.begin() + next, it, it + 1);
+                const batch_job job = pending[next++];
+                free_cores -= std::min(job.cores, free_cores);
+                used_memory += job.memory;
+                running++;
+
+                const size_t slot = threads.size();
+                threads.emplace_back([&, job, slot]() {
+                    std::exception_ptr job_error;
+                    try {
+                        skip_memory_phases skip;
+                        f(job);
+                    } catch (...) {
+                        job_error = std::current_exception();
+                    }
+                    std::lock_guard<std::mutex> guard(mutex);
+                    if (job_error && !error) {
+                        error = job_error;
+                    }
+                    free_cores = std::min(cores, free_cores + job.cores);
+                    used_memory -= job.memory;
+                    running--;
+                    finished.push_back(slot);
+                    changed.notify_one();
+                });
+            }
+
+            std::vector<size_t> joinable;
+            std::swap(joinable, finished);
+            lock.unlock();
+            for (const auto slot : joinable) {
+                threads[slot].join();
+            }
+            lock.lock();
+        }
+        lock.unlock();
+
+        for (auto& thread : threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+}  // namespace recomp
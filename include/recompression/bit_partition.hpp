@@ -0,0 +1,205 @@
+#pragma once
+
+#include <omp.h>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+
+#include "defs.hpp"
+
+namespace recomp {
+
+/**
+ * @brief A read-only bitset representation of a partition of the alphabet.
+ *
+ * The partition computed by the variants uses one byte per symbol since the symbols are assigned concurrently. For
+ * the scans over the text it is packed into 64 bit words such that it stays in cache for much larger alphabets.
+ * The membership of consecutive text positions is evaluated in blocks of 64 positions resulting in a bitmask. The
+ * blocks are computed with AVX-512 or AVX2 gathers if available (32 bit symbols only) and with a scalar loop
+ * otherwise. The instruction set is selected at compile time (-march=native).
+ */
+class bit_partition {
+ public:
+    typedef std::uint64_t word_t;
+
+    static const size_t BLOCK = 64;
+
+ private:
+    ui_vector<word_t> words;
+    size_t n = 0;
+
+#if defined(__AVX512F__)
+    template<typename variable_t>
+    inline word_t gather(const variable_t* text, size_t len, variable_t minimum, size_t& j) const {
+        word_t mask = 0;
+        if (sizeof(variable_t) == 4) {
+            const int* base = reinterpret_cast<const int*>(words.data());
+            const __m512i min_v = _mm512_set1_epi32(static_cast<int>(minimum));
+            const __m512i low = _mm512_set1_epi32(31);
+            const __m512i one = _mm512_set1_epi32(1);
+            for (; j + 16 <= len; j += 16) {
+                __m512i sym = _mm512_sub_epi32(_mm512_loadu_si512(reinterpret_cast<const void*>(text + j)), min_v);
+                __m512i w = _mm512_i32gather_epi32(_mm512_srli_epi32(sym, 5), base, 4);
+                __m512i bit = _mm512_srlv_epi32(w, _mm512_and_si512(sym, low));
+                mask |= static_cast<word_t>(_mm512_test_epi32_mask(bit, one)) << j;
+            }
+        }
+        return mask;
+    }
+#elif defined(__AVX2__)
+    template<typename variable_t>
+    inline word_t gather(const variable_t* text, size_t len, variable_t minimum, size_t& j) const {
+        word_t mask = 0;
+        if (sizeof(variable_t) == 4) {
+            const int* base = reinterpret_cast<const int*>(words.data());
+            const __m256i min_v = _mm256_set1_epi32(static_cast<int>(minimum));
+            const __m256i low = _mm256_set1_epi32(31);
+            for (; j + 8 <= len; j += 8) {
+                __m256i sym = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + j)), min_v);
+                __m256i w = _mm256_i32gather_epi32(base, _mm256_srli_epi32(sym, 5), 4);
+                __m256i bit = _mm256_slli_epi32(_mm256_srlv_epi32(w, _mm256_and_si256(sym, low)), 31);
+                mask |= static_cast<word_t>(_mm256_movemask_ps(_mm256_castsi256_ps(bit))) << j;
+            }
+        }
+        return mask;
+    }
+#else
+    template<typename variable_t>
+    inline word_t gather(const variable_t*, size_t, variable_t, size_t&) const {
+        return 0;
+    }
+#endif
+
+ public:
+    inline bit_partition() = default;
+
+    /**
+     * @brief Packs the given partition.
+     *
+     * @tparam partition_t The type of the partition
+     * @param partition The partition
+     * @param cores The number of cores to use
+     */
+    template<typename partition_t>
+    inline bit_partition(const partition_t& partition, size_t cores) {
+        build(partition, cores);
+    }
+
+    /**
+     * @brief Packs the given partition. Every thread computes whole words.
+     *
+     * @tparam partition_t The type of the partition
+     * @param partition The partition
+     * @param cores The number of cores to use
+     */
+    template<typename partition_t>
+    inline void build(const partition_t& partition, size_t cores) {
+        n = partition.size();
+        words.resize((n + BLOCK - 1) / BLOCK);
+
+#pragma omp parallel for schedule(static) num_threads(cores)
+        for (size_t w = 0; w < words.size(); ++w) {
+            word_t word = 0;
+            const size_t end = std::min(n, (w + 1) * BLOCK);
+            for (size_t i = w * BLOCK; i < end; ++i) {
+                word |= static_cast<word_t>(partition[i] ? 1 : 0) << (i % BLOCK);
+            }
+            words[w] = word;
+        }
+    }
+
+    inline size_t size() const {
+        return n;
+    }
+
+    inline bool operator[](size_t i) const {
+        return (words[i / BLOCK] >> (i % BLOCK)) & 1;
+    }
+
+    /**
+     * @brief Prefetches the word containing the given symbol.
+     *
+     * @param i The symbol
+     */
+    inline void prefetch(size_t i) const {
+        __builtin_prefetch(words.data() + i / BLOCK);
+    }
+
+    /**
+     * @brief Computes the bitmask of the sides of the symbols @code{text[0], ..., text[len - 1]}, i.e. bit j is set
+     * iff @code{text[j] - minimum} is in the partition set @code{true}.
+     *
+     * @param text Pointer to the first symbol
+     * @param len The number of symbols (at most 64)
+     * @param minimum The smallest symbol in the text
+     * @return The bitmask
+     */
+    template<typename variable_t>
+    inline word_t block_mask(const variable_t* text, size_t len, variable_t minimum) const {
+        size_t j = 0;
+        word_t mask = gather(text, len, minimum, j);
+        for (; j < len; ++j) {
+            mask |= static_cast<word_t>((*this)[text[j] - minimum]) << j;
+        }
+        return mask;
+    }
+
+    /**
+     * @brief Counts the pairs (text[i], text[i + 1]) for i in [begin, end) with text[i] in the set @code{false} and
+     * text[i + 1] in the set @code{true} (lr) and vice versa (rl). Requires @code{end < text.size()}.
+     *
+     * @param text The text
+     * @param begin The first position
+     * @param end The position after the last position
+     * @param minimum The smallest symbol in the text
+     * @param lr_count[in,out] The number of (false,true) pairs
+     * @param rl_count[in,out] The number of (true,false) pairs
+     */
+    template<typename text_t, typename variable_t>
+    inline void count_pairs(const text_t& text, size_t begin, size_t end, variable_t minimum,
+                            size_t& lr_count, size_t& rl_count) const {
+        for (size_t i = begin; i < end; i += BLOCK) {
+            const size_t len = std::min(static_cast<size_t>(BLOCK), end - i);
+            const word_t mask = block_mask(text.data() + i, len, minimum);
+            const word_t next = (mask >> 1) | (static_cast<word_t>((*this)[text[i + len] - minimum]) << (len - 1));
+            const word_t valid = (len == BLOCK) ? ~word_t(0) : (word_t(1) << len) - 1;
+            lr_count += __builtin_popcountll(~mask & next & valid);
+            rl_count += __builtin_popcountll(mask & ~next & valid);
+        }
+    }
+
+    /**
+     * @brief Calls @code{f(i)} in increasing order for all positions i in [begin, end) such that text[i] is in the
+     * set @code{part_l} and text[i + 1] is not. Requires @code{end < text.size()}.
+     *
+     * @param text The text
+     * @param begin The first position
+     * @param end The position after the last position
+     * @param minimum The smallest symbol in the text
+     * @param part_l The set of the left symbols
+     * @param f The function to call
+     */
+    template<typename text_t, typename variable_t, typename function_t>
+    inline void for_each_pair(const text_t& text, size_t begin, size_t end, variable_t minimum, bool part_l,
+                              function_t f) const {
+        const word_t flip = part_l ? 0 : ~word_t(0);
+        for (size_t i = begin; i < end; i += BLOCK) {
+            const size_t len = std::min(static_cast<size_t>(BLOCK), end - i);
+            const word_t valid = (len == BLOCK) ? ~word_t(0) : (word_t(1) << len) - 1;
+            const word_t mask = (block_mask(text.data() + i, len, minimum) ^ flip) & valid;
+            const word_t next = (mask >> 1) |
+                                (static_cast<word_t>((*this)[text[i + len] - minimum] == part_l) << (len - 1));
+            word_t starts = mask & ~next;
+            while (starts) {
+                f(i + __builtin_ctzll(starts));
+                starts &= starts - 1;
+            }
+        }
+    }
+};
+
+}  // namespace recomp
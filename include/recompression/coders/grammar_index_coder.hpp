@@ -0,0 +1,184 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#ifdef BENCH
+#include <iostream>
+#endif
+
+#include "recompression/defs.hpp"
+#include "recompression/grammar_index.hpp"
+#include "recompression/rlslp.hpp"
+#include "coder.hpp"
+#include "recompression/io/bitostream.hpp"
+#include "recompression/io/bitistream.hpp"
+#include "recompression/trace.hpp"
+
+namespace recomp {
+namespace coder {
+
+/**
+ * @brief This class implements a coder that encodes and decodes a grammar index.
+ *
+ * The rules of the rlslp are stored with a fixed length like in @code{PlainFixedRLSLPCoder} followed by the sorted
+ * rows and columns of the grid of the index. Loading the index only rebuilds the linear time data structures and
+ * avoids sorting the rows and columns again.
+ */
+class GrammarIndexCoder {
+ public:
+    static const std::string k_extension;
+
+    GrammarIndexCoder() = delete;
+
+    class Encoder : public coder::Encoder {
+     protected:
+        BitOStream ostream;
+
+     public:
+        inline Encoder(const std::string& file_name) : ostream(file_name + k_extension) {}
+
+        template<typename variable_t = var_t>
+        inline void encode(const index::grammar_index<variable_t>& index) {
+            trace_scope trace("enc_grammar_index", "coder");
+#ifdef BENCH
+            const auto startTime = recomp::timer::now();
+#endif
+            const auto& rlslp = index.get_rlslp();
+            ostream.write_bit(rlslp.is_empty);
+
+            if (!rlslp.is_empty) {
+                auto bits = util::bits_for(rlslp.size() + rlslp.terminals);
+                ostream.write_int<uint8_t>(bits, 6);
+                ostream.write_int<size_t>(rlslp.size(), bits);
+                ostream.write_int<size_t>(rlslp.terminals, bits);
+                ostream.write_int<variable_t>(rlslp.root, bits);
+                ostream.write_int<variable_t>(rlslp.blocks, bits);
+
+                for (size_t i = 0; i < rlslp.blocks; ++i) {
+                    ostream.write_int<variable_t>(rlslp[i].first(), bits);
+                    ostream.write_int<variable_t>(rlslp[i].second(), bits);
+                }
+
+                variable_t max_len = 0;
+                for (size_t i = rlslp.blocks; i < rlslp.size(); ++i) {
+                    if (max_len < rlslp[i].second()) {
+                        max_len = rlslp[i].second();
+                    }
+                }
+
+                auto len_bits = util::bits_for(max_len);
+                ostream.write_int<uint8_t>(len_bits, 6);
+                for (size_t i = rlslp.blocks; i < rlslp.size(); ++i) {
+                    ostream.write_int<variable_t>(rlslp[i].first(), bits);
+                    ostream.write_int<variable_t>(rlslp[i].second(), len_bits);
+                }
+
+                const auto& rows = index.get_rows();
+                const auto& columns = index.get_columns();
+                ostream.write_int<size_t>(rows.size(), bits);
+                for (const auto& nt : rows) {
+                    ostream.write_int<variable_t>(nt, bits);
+                }
+                for (const auto& nt : columns) {
+                    ostream.write_int<variable_t>(nt, bits);
+                }
+            }
+
+            ostream.close();
+#ifdef BENCH
+            const auto endTime = recomp::timer::now();
+            const auto timeSpan = endTime - startTime;
+            std::string dataset = ostream.get_file_name();
+
+            util::file_name_without_path(dataset);
+            util::file_name_without_extension(dataset);
+            util::replace_all(dataset, "_", "\\_");
+
+            std::cout << "RESULT algo=enc_grammar_index dataset=" << dataset
+                      << " time=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                      << " productions=" << rlslp.size() << " blocks=" << (rlslp.size() - rlslp.blocks)
+                      << " points=" << index.get_rows().size() << " empty=" << rlslp.is_empty << std::endl;
+#endif
+        }
+    };
+
+    class Decoder : public coder::Decoder {
+     protected:
+        BitIStream istream;
+
+     public:
+        inline Decoder(const std::string& file_name) : istream(file_name + k_extension) {}
+
+        template<typename variable_t = var_t>
+        inline std::unique_ptr<index::grammar_index<variable_t>> decode() {
+            trace_scope trace("dec_grammar_index", "coder");
+#ifdef BENCH
+            const auto startTime = recomp::timer::now();
+#endif
+            rlslp<variable_t> rlslp;
+            std::vector<variable_t> rows;
+            std::vector<variable_t> columns;
+            bool empty = istream.read_bit();
+
+            if (!empty) {
+                auto bits = istream.read_int<uint8_t>(6);
+                auto size = istream.read_int<size_t>(bits);
+                rlslp.resize(size);
+                rlslp.terminals = istream.read_int<size_t>(bits);
+                rlslp.root = istream.read_int<variable_t>(bits);
+                rlslp.blocks = istream.read_int<variable_t>(bits);
+
+                for (size_t i = 0; i < rlslp.blocks; ++i) {
+                    variable_t first = istream.read_int<variable_t>(bits);
+                    variable_t second = istream.read_int<variable_t>(bits);
+                    rlslp[i] = non_terminal<variable_t>(first, second);
+                }
+
+                auto len_bits = istream.read_int<uint8_t>(6);
+                for (size_t i = rlslp.blocks; i < rlslp.size(); ++i) {
+                    variable_t first = istream.read_int<variable_t>(bits);
+                    variable_t second = istream.read_int<variable_t>(len_bits);
+                    rlslp[i] = non_terminal<variable_t>(first, second);
+                }
+
+                rlslp.compute_lengths();
+
+                auto points = istream.read_int<size_t>(bits);
+                rows.resize(points);
+                columns.resize(points);
+                for (size_t i = 0; i < points; ++i) {
+                    rows[i] = istream.read_int<variable_t>(bits);
+                }
+                for (size_t i = 0; i < points; ++i) {
+                    columns[i] = istream.read_int<variable_t>(bits);
+                }
+            }
+            rlslp.is_empty = empty;
+            istream.close();
+
+            std::unique_ptr<index::grammar_index<variable_t>> index(
+                    new index::grammar_index<variable_t>(std::move(rlslp), std::move(rows), std::move(columns)));
+#ifdef BENCH
+            const auto endTime = recomp::timer::now();
+            const auto timeSpan = endTime - startTime;
+            std::string dataset = istream.get_file_name();
+
+            util::file_name_without_path(dataset);
+            util::file_name_without_extension(dataset);
+            util::replace_all(dataset, "_", "\\_");
+
+            std::cout << "RESULT algo=dec_grammar_index dataset=" << dataset
+                      << " time=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                      << " productions=" << index->get_rlslp().size() << " points=" << index->get_rows().size()
+                      << " empty=" << empty << std::endl;
+#endif
+            return index;
+        }
+    };
+};
+
+const std::string GrammarIndexCoder::k_extension = ".gidx";
+
+}  // namespace coder
+}  // namespace recomp
@@ -0,0 +1,400 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "recompression/io/bitistream.hpp"
+#include "recompression/io/bitostream.hpp"
+#include "recompression/util.hpp"
+
+namespace recomp {
+namespace coder {
+
+/**
+ * @brief A growable sequence of bits stored MSB first in 64 bit words, i.e. the first bit is the highest bit of the
+ * first word.
+ */
+class bit_buffer {
+ public:
+    std::vector<std::uint64_t> words;
+    size_t size = 0;
+
+    /**
+     * @brief Appends the lowest @code{bits} bits of the value MSB first.
+     *
+     * @param value The value
+     * @param bits The number of bits in [0, 64]
+     */
+    inline void write(std::uint64_t value, size_t bits) {
+        if (bits == 0) {
+            return;
+        }
+        if (bits < 64) {
+            value &= (std::uint64_t(1) << bits) - 1;
+        }
+        const size_t offset = size % 64;
+        if (offset == 0) {
+            words.push_back(0);
+        }
+        if (offset + bits <= 64) {
+            words.back() |= value << (64 - offset - bits);
+        } else {
+            const size_t rest = offset + bits - 64;
+            words.back() |= value >> rest;
+            words.push_back(value << (64 - rest));
+        }
+        size += bits;
+    }
+
+    /**
+     * @brief Returns the next @code{bits} bits starting at the given position without consuming them. Bits behind the
+     * end are 0.
+     *
+     * @param pos The position of the first bit
+     * @param bits The number of bits in [1, 64]
+     * @return The bits
+     */
+    inline std::uint64_t peek(size_t pos, size_t bits) const {
+        const size_t word = pos / 64;
+        const size_t offset = pos % 64;
+        std::uint64_t value = (word < words.size()) ? words[word] << offset : 0;
+        if (offset + bits > 64 && word + 1 < words.size()) {
+            value |= words[word + 1] >> (64 - offset);
+        }
+        return value >> (64 - bits);
+    }
+
+    /**
+     * @brief Writes the number of bits and the words to the stream.
+     *
+     * @param ostream The stream
+     */
+    inline void write(BitOStream& ostream) const {
+        ostream.write_int<std::uint64_t>(size);
+        for (const auto& word : words) {
+            ostream.write_int<std::uint64_t>(word);
+        }
+    }
+
+    /**
+     * @brief Reads the number of bits and the words from the stream.
+     *
+     * @param istream The stream
+     */
+    inline void read(BitIStream& istream) {
+        size = istream.read_int<std::uint64_t>();
+        words.resize((size + 63) / 64);
+        for (auto& word : words) {
+            word = istream.read_int<std::uint64_t>();
+        }
+    }
+};
+
+/**
+ * @brief A length limited canonical Huffman code for small alphabets.
+ *
+ * Only the code lengths are stored. The codes are assigned canonically, i.e. by increasing length and for equal
+ * lengths by increasing symbol. Decoding looks up the next @code{max_length} bits in a table that maps them to the
+ * symbol and its code length.
+ */
+class huffman_code {
+ public:
+    /**
+     * The maximal length of a code. The decoding table has 2^max_length entries.
+     */
+    static constexpr std::uint8_t MAX_LENGTH = 16;
+
+    std::vector<std::uint8_t> lengths;
+    std::vector<std::uint32_t> codes;
+    std::uint8_t max_length = 0;
+
+    /**
+     * The decoding table. Every entry consists of the symbol and the length of its code.
+     */
+    std::vector<std::pair<std::uint32_t, std::uint8_t>> table;
+
+    inline huffman_code() = default;
+
+    /**
+     * @brief Computes the code for the given frequencies of the symbols. The frequencies are halved until no code is
+     * longer than @code{MAX_LENGTH}. If only one symbol occurs, its code has length 1.
+     *
+     * @param freqs The frequencies of the symbols
+     */
+    inline explicit huffman_code(const std::vector<size_t>& freqs) {
+        lengths.resize(freqs.size(), 0);
+        std::vector<size_t> weights = freqs;
+        while (!compute_lengths(weights)) {
+            for (auto& weight : weights) {
+                if (weight > 0) {
+                    weight = (weight >> 1) + 1;
+                }
+            }
+        }
+        assign_codes();
+    }
+
+    /**
+     * @brief Returns the number of bits needed to encode the symbols with the given frequencies.
+     *
+     * @param freqs The frequencies of the symbols
+     * @return The number of bits
+     */
+    inline size_t cost(const std::vector<size_t>& freqs) const {
+        size_t bits = 0;
+        for (size_t i = 0; i < freqs.size(); ++i) {
+            bits += freqs[i] * lengths[i];
+        }
+        return bits;
+    }
+
+    /**
+     * @brief Appends the code of the symbol to the buffer.
+     *
+     * @param buffer The buffer
+     * @param symbol The symbol
+     */
+    inline void encode(bit_buffer& buffer, size_t symbol) const {
+        buffer.write(codes[symbol], lengths[symbol]);
+    }
+
+    /**
+     * @brief Decodes the symbol starting at the given position of the buffer and advances the position.
+     *
+     * @param buffer The buffer
+     * @param pos[in,out] The position of the next code
+     * @return The symbol
+     */
+    inline std::uint32_t decode(const bit_buffer& buffer, size_t& pos) const {
+        const auto& entry = table[buffer.peek(pos, max_length)];
+        pos += entry.second;
+        return entry.first;
+    }
+
+    /**
+     * @brief Writes the code lengths up to the last used symbol to the stream.
+     *
+     * @param ostream The stream
+     */
+    inline void write(BitOStream& ostream) const {
+        size_t used = lengths.size();
+        while (used > 0 && lengths[used - 1] == 0) {
+            used--;
+        }
+        ostream.write_int<std::uint32_t>(used, 32);
+        for (size_t i = 0; i < used; ++i) {
+            ostream.write_int<std::uint8_t>(lengths[i], 5);
+        }
+    }
+
+    /**
+     * @brief Reads the code lengths from the stream and builds the decoding table.
+     *
+     * @param istream The stream
+     */
+    inline void read(BitIStream& istream) {
+        lengths.resize(istream.read_int<std::uint32_t>(32));
+        for (auto& length : lengths) {
+            length = istream.read_int<std::uint8_t>(5);
+        }
+        assign_codes();
+        build_table();
+    }
+
+    /**
+     * @brief Builds the decoding table.
+     */
+    inline void build_table() {
+        table.assign(max_length > 0 ? size_t(1) << max_length : 0, std::make_pair(std::uint32_t(0), std::uint8_t(0)));
+        for (size_t i = 0; i < lengths.size(); ++i) {
+            if (lengths[i] > 0) {
+                const size_t shift = max_length - lengths[i];
+                const size_t begin = size_t(codes[i]) << shift;
+                const size_t end = size_t(codes[i] + 1) << shift;
+                std::fill(table.begin() + begin, table.begin() + end, std::make_pair(std::uint32_t(i), lengths[i]));
+            }
+        }
+    }
+
+ private:
+    /**
+     * @brief Computes the code lengths of the symbols with a Huffman tree.
+     *
+     * @param weights The weights of the symbols
+     * @return Whether no code is longer than @code{MAX_LENGTH}
+     */
+    inline bool compute_lengths(const std::vector<size_t>& weights) {
+        typedef std::pair<size_t, size_t> node_t;
+        std::priority_queue<node_t, std::vector<node_t>, std::greater<node_t>> queue;
+        std::vector<size_t> parents;
+        for (size_t i = 0; i < weights.size(); ++i) {
+            parents.push_back(i);
+            if (weights[i] > 0) {
+                queue.emplace(weights[i], i);
+            }
+        }
+        std::fill(lengths.begin(), lengths.end(), 0);
+        if (queue.size() == 1) {
+            lengths[queue.top().second] = 1;
+            return true;
+        }
+
+        while (queue.size() > 1) {
+            auto left = queue.top();
+            queue.pop();
+            auto right = queue.top();
+            queue.pop();
+            const size_t node = parents.size();
+            parents.push_back(node);
+            parents[left.second] = node;
+            parents[right.second] = node;
+            queue.emplace(left.first + right.first, node);
+        }
+
+        for (size_t i = 0; i < weights.size(); ++i) {
+            if (weights[i] > 0) {
+                size_t length = 0;
+                for (size_t node = i; parents[node] != node; node = parents[node]) {
+                    length++;
+                }
+                if (length > MAX_LENGTH) {
+                    return false;
+                }
+                lengths[i] = static_cast<std::uint8_t>(length);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Assigns the canonical codes to the symbols by increasing length and symbol.
+     */
+    inline void assign_codes() {
+        codes.assign(lengths.size(), 0);
+        max_length = 0;
+        std::vector<size_t> symbols;
+        for (size_t i = 0; i < lengths.size(); ++i) {
+            if (lengths[i] > 0) {
+                symbols.push_back(i);
+                max_length = std::max(max_length, lengths[i]);
+            }
+        }
+        std::stable_sort(symbols.begin(), symbols.end(), [&](size_t a, size_t b) {
+            return lengths[a] < lengths[b];
+        });
+
+        std::uint32_t code = 0;
+        std::uint8_t prev_length = 0;
+        for (const auto& symbol : symbols) {
+            code <<= (lengths[symbol] - prev_length);
+            codes[symbol] = code++;
+            prev_length = lengths[symbol];
+        }
+    }
+};
+
+/**
+ * @brief Maps integers to the symbols of a small alphabet and extra bits. Values below @code{DIRECT} are symbols
+ * themselves. Larger values are mapped to a symbol for their bit length and the bit below the highest set bit,
+ * followed by the remaining lower bits.
+ */
+class huffman_integer_code {
+ public:
+    static constexpr std::uint32_t DIRECT = 16;
+    static constexpr std::uint32_t ALPHABET = DIRECT + 2 * (64 - 4);
+
+    huffman_code code;
+
+    /**
+     * @brief Returns the symbol of the value.
+     *
+     * @param value The value
+     * @return The symbol
+     */
+    static inline std::uint32_t symbol(std::uint64_t value) {
+        if (value < DIRECT) {
+            return static_cast<std::uint32_t>(value);
+        }
+        const std::uint32_t bits = util::bits_for(value);
+        return DIRECT + 2 * (bits - 5) + static_cast<std::uint32_t>((value >> (bits - 2)) & 1);
+    }
+
+    /**
+     * @brief Returns the number of extra bits following the symbol.
+     *
+     * @param symbol The symbol
+     * @return The number of extra bits
+     */
+    static inline size_t extra_bits(std::uint32_t symbol) {
+        return symbol < DIRECT ? 0 : (symbol - DIRECT) / 2 + 3;
+    }
+
+    /**
+     * @brief Counts the symbols of the values.
+     *
+     * @param values The values
+     * @return The frequencies of the symbols
+     */
+    static inline std::vector<size_t> frequencies(const std::vector<std::uint64_t>& values) {
+        std::vector<size_t> freqs(static_cast<size_t>(ALPHABET), 0);
+        for (const auto& value : values) {
+            freqs[symbol(value)]++;
+        }
+        return freqs;
+    }
+
+    /**
+     * @brief Returns the number of bits needed to encode values with the given symbol frequencies.
+     *
+     * @param freqs The frequencies of the symbols
+     * @return The number of bits
+     */
+    inline size_t cost(const std::vector<size_t>& freqs) const {
+        size_t bits = code.cost(freqs);
+        for (size_t i = DIRECT; i < freqs.size(); ++i) {
+            bits += freqs[i] * extra_bits(static_cast<std::uint32_t>(i));
+        }
+        return bits;
+    }
+
+    inline huffman_integer_code() = default;
+
+    inline explicit huffman_integer_code(const std::vector<size_t>& freqs) : code(freqs) {}
+
+    /**
+     * @brief Appends the code of the value to the buffer.
+     *
+     * @param buffer The buffer
+     * @param value The value
+     */
+    inline void encode(bit_buffer& buffer, std::uint64_t value) const {
+        const auto sym = symbol(value);
+        code.encode(buffer, sym);
+        buffer.write(value, extra_bits(sym));
+    }
+
+    /**
+     * @brief Decodes the value starting at the given position of the buffer and advances the position.
+     *
+     * @param buffer The buffer
+     * @param pos[in,out] The position of the next code
+     * @return The value
+     */
+    inline std::uint64_t decode(const bit_buffer& buffer, size_t& pos) const {
+        const auto sym = code.decode(buffer, pos);
+        if (sym < DIRECT) {
+            return sym;
+        }
+        const size_t bits = extra_bits(sym);
+        const std::uint64_t value = (std::uint64_t(2 | ((sym - DIRECT) & 1)) << bits) | buffer.peek(pos, bits);
+        pos += bits;
+        return value;
+    }
+};
+
+}  // namespace coder
+}  // namespace recomp
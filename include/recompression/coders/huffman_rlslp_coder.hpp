@@ -0,0 +1,248 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#ifdef BENCH
+#include <iostream>
+#endif
+
+#include "recompression/io/bitistream.hpp"
+#include "recompression/defs.hpp"
+#include "coder.hpp"
+#include "huffman_code.hpp"
+#include "recompression/io/bitostream.hpp"
+#include "recompression/rlslp.hpp"
+#include "rlslp_rule_sorter.hpp"
+#include "recompression/util.hpp"
+#include "recompression/trace.hpp"
+
+namespace recomp {
+namespace coder {
+
+/**
+ * @brief This class implements a coder that encodes and decodes the rules of the rlslp with canonical Huffman codes.
+ *
+ * The rules are sorted like in the @code{SortedRLSLPCoder}. The rules are split into four streams: the gaps of the
+ * first symbols of the pairs, the second symbols of the pairs, the gaps of the first symbols of the blocks and the
+ * lengths of the blocks. The second symbols of the pairs are either coded as they are or as zigzag coded differences
+ * to the previous one, whatever is smaller. Every stream gets its own Huffman code over small values and the bit
+ * lengths of large values (see @code{huffman_integer_code}), so decoding is a table lookup per value.
+ */
+class HuffmanRLSLPCoder {
+ public:
+    static const std::string k_extension;
+
+    HuffmanRLSLPCoder() = delete;
+
+    /**
+     * @brief Maps the difference of two values to a non-negative integer, i.e. 0, -1, 1, -2, ... to 0, 1, 2, 3, ...
+     *
+     * @param value The value
+     * @param prev The previous value
+     * @return The zigzag code of the difference
+     */
+    static inline std::uint64_t zigzag(std::uint64_t value, std::uint64_t prev) {
+        return value >= prev ? (value - prev) << 1 : ((prev - value) << 1) - 1;
+    }
+
+    /**
+     * @brief Reverts @code{zigzag}.
+     *
+     * @param code The zigzag code of the difference
+     * @param prev The previous value
+     * @return The value
+     */
+    static inline std::uint64_t unzigzag(std::uint64_t code, std::uint64_t prev) {
+        return (code & 1) ? prev - ((code + 1) >> 1) : prev + (code >> 1);
+    }
+
+    class Encoder : public coder::Encoder {
+     protected:
+        BitOStream ostream;
+
+        inline void encode_stream(const std::vector<std::uint64_t>& values, const huffman_integer_code& code,
+                                  bit_buffer& buffer) {
+            for (const auto& value : values) {
+                code.encode(buffer, value);
+            }
+        }
+
+     public:
+        inline Encoder(const std::string& file_name) : ostream(file_name + k_extension) {}
+
+        template<typename variable_t = var_t>
+        inline void encode(rlslp<variable_t>& rlslp) {
+            trace_scope trace("enc_rlslp_huffman", "coder", "productions", rlslp.size());
+#ifdef BENCH
+            const auto startTime = recomp::timer::now();
+#endif
+            ostream.write_bit(rlslp.is_empty);
+
+            if (!rlslp.is_empty) {
+                auto bits = util::bits_for(rlslp.size() + rlslp.terminals);
+
+                sort_rlslp_rules(rlslp);
+
+                ostream.write_int<uint8_t>(bits, 6);
+                ostream.write_int<size_t>(rlslp.size(), bits);
+                ostream.write_int<size_t>(rlslp.terminals, bits);
+                ostream.write_int<variable_t>(rlslp.root, bits);
+                ostream.write_int<variable_t>(rlslp.blocks, bits);
+
+                std::vector<std::uint64_t> pair_first(rlslp.blocks);
+                std::vector<std::uint64_t> pair_second(rlslp.blocks);
+                std::vector<std::uint64_t> pair_second_diff(rlslp.blocks);
+                std::uint64_t prev_first = 0;
+                std::uint64_t prev_second = 0;
+                for (size_t i = 0; i < rlslp.blocks; ++i) {
+                    pair_first[i] = rlslp[i].first() - prev_first;
+                    pair_second[i] = rlslp[i].second();
+                    pair_second_diff[i] = zigzag(rlslp[i].second(), prev_second);
+                    prev_first = rlslp[i].first();
+                    prev_second = rlslp[i].second();
+                }
+
+                std::vector<std::uint64_t> block_first(rlslp.size() - rlslp.blocks);
+                std::vector<std::uint64_t> block_length(rlslp.size() - rlslp.blocks);
+                prev_first = 0;
+                for (size_t i = rlslp.blocks; i < rlslp.size(); ++i) {
+                    block_first[i - rlslp.blocks] = rlslp[i].first() - prev_first;
+                    block_length[i - rlslp.blocks] = rlslp[i].second();
+                    prev_first = rlslp[i].first();
+                }
+
+                auto second_freqs = huffman_integer_code::frequencies(pair_second);
+                auto diff_freqs = huffman_integer_code::frequencies(pair_second_diff);
+                huffman_integer_code first_code{huffman_integer_code::frequencies(pair_first)};
+                huffman_integer_code second_code{second_freqs};
+                huffman_integer_code diff_code{diff_freqs};
+                huffman_integer_code block_first_code{huffman_integer_code::frequencies(block_first)};
+                huffman_integer_code block_length_code{huffman_integer_code::frequencies(block_length)};
+
+                const bool diff = diff_code.cost(diff_freqs) < second_code.cost(second_freqs);
+                if (diff) {
+                    second_code = std::move(diff_code);
+                    std::swap(pair_second, pair_second_diff);
+                }
+                pair_second_diff.clear();
+                pair_second_diff.shrink_to_fit();
+
+                ostream.write_bit(diff);
+                first_code.code.write(ostream);
+                second_code.code.write(ostream);
+                block_first_code.code.write(ostream);
+                block_length_code.code.write(ostream);
+
+                bit_buffer buffer;
+                encode_stream(pair_first, first_code, buffer);
+                encode_stream(pair_second, second_code, buffer);
+                encode_stream(block_first, block_first_code, buffer);
+                encode_stream(block_length, block_length_code, buffer);
+                buffer.write(ostream);
+            }
+
+            ostream.close();
+#ifdef BENCH
+            const auto endTime = recomp::timer::now();
+            const auto timeSpan = endTime - startTime;
+            std::string dataset = ostream.get_file_name();
+
+            util::file_name_without_path(dataset);
+            util::file_name_without_extension(dataset);
+            util::replace_all(dataset, "_", "\\_");
+
+            std::cout << "RESULT algo=enc_rlslp_huffman dataset=" << dataset
+                      << " time=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                      << " productions=" << rlslp.size() << " blocks=" << (rlslp.size() - rlslp.blocks)
+                      << " empty=" << rlslp.is_empty << std::endl;
+#endif
+        }
+    };
+
+    class Decoder : public coder::Decoder {
+     protected:
+        BitIStream istream;
+
+     public:
+        inline Decoder(const std::string& file_name) : istream(file_name + k_extension) {}
+
+        template<typename variable_t = var_t>
+        inline rlslp<variable_t> decode() {
+            trace_scope trace("dec_rlslp_huffman", "coder");
+#ifdef BENCH
+            const auto startTime = recomp::timer::now();
+#endif
+            rlslp<variable_t> rlslp;
+            bool empty = istream.read_bit();
+
+            if (!empty) {
+                auto bits = istream.read_int<uint8_t>(6);
+                auto size = istream.read_int<size_t>(bits);
+                rlslp.resize(size);
+                rlslp.terminals = istream.read_int<size_t>(bits);
+                rlslp.root = istream.read_int<variable_t>(bits);
+                rlslp.blocks = istream.read_int<variable_t>(bits);
+
+                const bool diff = istream.read_bit();
+                huffman_integer_code first_code;
+                huffman_integer_code second_code;
+                huffman_integer_code block_first_code;
+                huffman_integer_code block_length_code;
+                first_code.code.read(istream);
+                second_code.code.read(istream);
+                block_first_code.code.read(istream);
+                block_length_code.code.read(istream);
+
+                bit_buffer buffer;
+                buffer.read(istream);
+                size_t pos = 0;
+
+                std::uint64_t prev = 0;
+                for (size_t i = 0; i < rlslp.blocks; ++i) {
+                    prev += first_code.decode(buffer, pos);
+                    rlslp[i].first() = static_cast<variable_t>(prev);
+                }
+                prev = 0;
+                for (size_t i = 0; i < rlslp.blocks; ++i) {
+                    const auto value = second_code.decode(buffer, pos);
+                    prev = diff ? unzigzag(value, prev) : value;
+                    rlslp[i].second() = static_cast<variable_t>(prev);
+                }
+                prev = 0;
+                for (size_t i = rlslp.blocks; i < rlslp.size(); ++i) {
+                    prev += block_first_code.decode(buffer, pos);
+                    rlslp[i].first() = static_cast<variable_t>(prev);
+                }
+                for (size_t i = rlslp.blocks; i < rlslp.size(); ++i) {
+                    rlslp[i].second() = static_cast<variable_t>(block_length_code.decode(buffer, pos));
+                }
+
+                rlslp.compute_lengths();
+            }
+
+            rlslp.is_empty = empty;
+            istream.close();
+#ifdef BENCH
+            const auto endTime = recomp::timer::now();
+            const auto timeSpan = endTime - startTime;
+            std::string dataset = istream.get_file_name();
+
+            util::file_name_without_path(dataset);
+            util::file_name_without_extension(dataset);
+            util::replace_all(dataset, "_", "\\_");
+
+            std::cout << "RESULT algo=dec_rlslp_huffman dataset=" << dataset
+                      << " time=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                      << " productions=" << rlslp.size() << " blocks=" << (rlslp.size() - rlslp.blocks)
+                      << " empty=" << rlslp.is_empty << std::endl;
+#endif
+            return rlslp;
+        }
+    };
+};
+
+const std::string HuffmanRLSLPCoder::k_extension = ".rlslp_huff";
+
+}  // namespace coder
+}  // namespace recomp
@@ -11,6 +11,7 @@
 #include "coder.hpp"
 #include "recompression/io/bitostream.hpp"
 #include "recompression/io/bitistream.hpp"
+#include "recompression/trace.hpp"
 
 namespace recomp {
 namespace coder {
@@ -33,6 +34,7 @@ class PlainFixedRLSLPCoder {
 
         template<typename variable_t = var_t>
         inline void encode(rlslp<variable_t>& rlslp) {
+            trace_scope trace("enc_plain_fixed", "coder", "productions", rlslp.size());
 #ifdef BENCH
             const auto startTime = recomp::timer::now();
 #endif
@@ -99,6 +101,7 @@ class PlainFixedRLSLPCoder {
 
         template<typename variable_t = var_t>
         inline rlslp<variable_t> decode() {
+            trace_scope trace("dec_plain_fixed", "coder");
 #ifdef BENCH
             const auto startTime = recomp::timer::now();
 #endif
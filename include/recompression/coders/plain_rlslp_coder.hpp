@@ -7,6 +7,7 @@
 #include "recompression/coders/coder.hpp"
 #include "recompression/io/bitostream.hpp"
 #include "recompression/io/bitistream.hpp"
+#include "recompression/trace.hpp"
 
 namespace recomp {
 namespace coder {
@@ -30,6 +31,7 @@ class PlainRLSLPCoder {
 
         template<typename variable_t = var_t>
         inline void encode(rlslp<variable_t>& rlslp) {
+            trace_scope trace("enc_plain", "coder", "productions", rlslp.size());
             ostream.write_bit(rlslp.is_empty);
 
             if (!rlslp.is_empty) {
@@ -57,6 +59,7 @@ class PlainRLSLPCoder {
 
         template<typename variable_t = var_t>
         inline rlslp<variable_t> decode() {
+            trace_scope trace("dec_plain", "coder");
             rlslp<variable_t> rlslp;
             bool empty = istream.read_bit();
 
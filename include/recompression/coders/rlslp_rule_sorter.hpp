@@ -1,28 +1,39 @@
 #pragma once
 
+#include <omp.h>
+
+#ifdef BENCH
+#include <chrono>
+#endif
+
 #include <iostream>
 #include <queue>
 #include <stack>
 #include <thread>
 
 #include "recompression/defs.hpp"
+#include "recompression/radix_sort.hpp"
 #include "recompression/rlslp.hpp"
+#include "recompression/trace.hpp"
+#include "recompression/util.hpp"
 
 namespace recomp {
 
 /**
  * @brief Computes a permutation and renames the variables that the first symbols of each pair is sorted.
  *
+ * Sequential version traversing the first symbols with queues and stacks. It computes the same permutation as
+ * @code{sort_rlslp_rules}.
+ *
  * @tparam variable_t The type of non-terminals
  * @param rlslp The rlslp to permute and rename
- * @param cores The number of cores to use
  */
 template<typename variable_t = recomp::var_t>
-inline void sort_rlslp_rules(rlslp<variable_t>& rlslp, size_t cores = std::thread::hardware_concurrency()) {
+inline void sequential_sort_rlslp_rules(rlslp<variable_t>& rlslp) {
+    trace_scope trace("sequential_sort_rlslp_rules", "coder", "productions", rlslp.size());
     ui_vector<variable_t> first(rlslp.size() + rlslp.terminals);
     ui_vector<variable_t> next(rlslp.size() + rlslp.terminals);
 
-#pragma omp parallel for num_threads(cores) schedule(static)
     for (size_t i = 0; i < first.size(); ++i) {
         first[i] = i;
         next[i] = i;
@@ -176,4 +187,295 @@ inline void sort_rlslp_rules(rlslp<variable_t>& rlslp, size_t cores = std::threa
     }
 }
 
+namespace rule_sorter {
+
+/**
+ * @brief Assigns dense ranks to the sorted values, i.e. consecutive values get the same rank iff they are equal.
+ *
+ * @param sorted The sorted values
+ * @param equal The function comparing two values
+ * @param ranks[out] The ranks indexed by the values
+ * @param cores The number of cores to use
+ */
+template<typename variable_t, typename equal_t>
+inline void dense_ranks(const ui_vector<variable_t>& sorted, equal_t equal, ui_vector<variable_t>& ranks,
+                        size_t cores) {
+    ui_vector<size_t> counts;
+#pragma omp parallel num_threads(cores)
+    {
+        auto thread_id = static_cast<size_t>(omp_get_thread_num());
+        auto n_threads = static_cast<size_t>(omp_get_num_threads());
+        const size_t from = sorted.size() * thread_id / n_threads;
+        const size_t to = sorted.size() * (thread_id + 1) / n_threads;
+
+#pragma omp single
+        {
+            counts.resize(n_threads + 1);
+            counts[0] = 0;
+        }
+        size_t distinct = 0;
+        for (size_t i = std::max(from, static_cast<size_t>(1)); i < to; ++i) {
+            if (!equal(sorted[i - 1], sorted[i])) {
+                distinct++;
+            }
+        }
+        counts[thread_id + 1] = distinct;
+
+#pragma omp barrier
+#pragma omp single
+        {
+            for (size_t t = 1; t <= n_threads; ++t) {
+                counts[t] += counts[t - 1];
+            }
+        }
+
+        size_t rank = counts[thread_id];
+        for (size_t i = from; i < to; ++i) {
+            if (i > 0 && !equal(sorted[i - 1], sorted[i])) {
+                rank++;
+            }
+            ranks[sorted[i]] = rank;
+        }
+    }
+}
+
+}  // namespace rule_sorter
+
+/**
+ * @brief Computes a permutation and renames the variables such that the first symbols of the pairs and the first
+ * symbols of the blocks are sorted. The pairs are kept in front of the blocks.
+ *
+ * The first symbols form a forest rooted at the terminals. Since the new name of a rule is only determined by its
+ * class (terminal, pair or block), the new name of its first symbol and its position among its siblings, two rules
+ * are ordered by the classes on their paths to the root and, for equal class paths, by a breadth first search. The
+ * children of every variable are computed with a parallel radix sort by the first symbols and the breadth first
+ * search is level synchronous. The class paths are packed into 64 bit words top-down (2 bits per class), so a single
+ * radix sort suffices for forests of height at most 32. Higher forests rank the paths by prefix doubling.
+ *
+ * @tparam variable_t The type of non-terminals
+ * @param rlslp The rlslp to permute and rename
+ * @param cores The number of cores to use
+ */
+template<typename variable_t = recomp::var_t>
+inline void sort_rlslp_rules(rlslp<variable_t>& rlslp, size_t cores = std::thread::hardware_concurrency()) {
+    trace_scope trace("sort_rlslp_rules", "coder", "productions", rlslp.size());
+    if (rlslp.size() == 0) {
+        return;
+    }
+#ifdef BENCH
+    const auto startTime = recomp::timer::now();
+#endif
+    const size_t terminals = rlslp.terminals;
+    const size_t n = rlslp.size() + terminals;
+    const size_t none = n;
+    const size_t bits = util::bits_for(n);
+    const size_t PACKED_LEVELS = 32;
+
+    auto parent = [&](size_t x) -> size_t {
+        return rlslp[x - terminals].first();
+    };
+    auto type = [&](size_t x) -> std::uint64_t {
+        return x < terminals ? 0 : (rlslp.is_block(x) ? 2 : 1);
+    };
+
+    // children of every variable sorted by their names, i.e. children[begin[x]..begin[x + 1]) are the children of x
+    ui_vector<variable_t> children(rlslp.size());
+    ui_vector<variable_t> begin(n + 1);
+#pragma omp parallel for schedule(static) num_threads(cores)
+    for (size_t i = 0; i < children.size(); ++i) {
+        children[i] = i + terminals;
+    }
+    parallel::radix_sort_by_key(children, parent, bits, cores);
+#ifdef BENCH
+    const auto endTimeChildren = recomp::timer::now();
+#endif
+
+    // breadth first search, level l is bfs[level_bounds[l]..level_bounds[l + 1])
+    ui_vector<variable_t> bfs(n);
+    ui_vector<size_t> counts;
+    std::vector<size_t> level_bounds = {0, terminals};
+#pragma omp parallel num_threads(cores)
+    {
+        auto thread_id = static_cast<size_t>(omp_get_thread_num());
+        auto n_threads = static_cast<size_t>(omp_get_num_threads());
+
+#pragma omp single
+        {
+            counts.resize(n_threads + 1);
+        }
+
+#pragma omp for schedule(static)
+        for (size_t i = 0; i < children.size(); ++i) {
+            const size_t prev = (i == 0) ? 0 : parent(children[i - 1]) + 1;
+            for (size_t x = prev; x <= parent(children[i]); ++x) {
+                begin[x] = i;
+            }
+        }
+#pragma omp for schedule(static)
+        for (size_t x = parent(children[children.size() - 1]) + 1; x <= n; ++x) {
+            begin[x] = children.size();
+        }
+#pragma omp for schedule(static)
+        for (size_t x = 0; x < terminals; ++x) {
+            bfs[x] = x;
+        }
+
+        while (level_bounds[level_bounds.size() - 2] < level_bounds.back() && level_bounds.back() < n) {
+            const size_t lb = level_bounds[level_bounds.size() - 2];
+            const size_t le = level_bounds.back();
+            const size_t from = lb + (le - lb) * thread_id / n_threads;
+            const size_t to = lb + (le - lb) * (thread_id + 1) / n_threads;
+            size_t count = 0;
+            for (size_t i = from; i < to; ++i) {
+                count += begin[bfs[i] + 1] - begin[bfs[i]];
+            }
+            counts[thread_id + 1] = count;
+
+#pragma omp barrier
+#pragma omp single
+            {
+                counts[0] = le;
+                for (size_t t = 1; t <= n_threads; ++t) {
+                    counts[t] += counts[t - 1];
+                }
+            }
+
+            size_t pos = counts[thread_id];
+            for (size_t i = from; i < to; ++i) {
+                for (size_t c = begin[bfs[i]]; c < begin[bfs[i] + 1]; ++c) {
+                    bfs[pos++] = children[c];
+                }
+            }
+
+#pragma omp barrier
+#pragma omp single
+            {
+                level_bounds.push_back(counts[n_threads]);
+            }
+        }
+    }
+    children.resize(0);
+    begin.resize(0);
+    const size_t levels = level_bounds.size() - 1;
+
+    // class paths of up to 32 variables with the class of the variable in the highest bits
+    const size_t packed = std::min(levels, PACKED_LEVELS);
+    ui_vector<std::uint64_t> path(n);
+    for (size_t l = 0; l < levels; ++l) {
+#pragma omp parallel for schedule(static) num_threads(cores)
+        for (size_t i = level_bounds[l]; i < level_bounds[l + 1]; ++i) {
+            const size_t x = bfs[i];
+            path[x] = (type(x) << 62) | (x < terminals ? 0 : path[parent(x)] >> 2);
+        }
+    }
+    auto path_key = [&](variable_t x) -> std::uint64_t {
+        return path[x] >> (64 - 2 * packed);
+    };
+
+    ui_vector<variable_t> order(rlslp.size());
+#pragma omp parallel for schedule(static) num_threads(cores)
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = bfs[i + terminals];
+    }
+    bfs.resize(0);
+#ifdef BENCH
+    const auto endTimeBfs = recomp::timer::now();
+#endif
+
+    if (levels <= PACKED_LEVELS) {
+        parallel::radix_sort_by_key(order, path_key, 2 * packed, cores);
+    } else {
+        // rank the class paths of length 32, 64, ... by doubling
+        ui_vector<variable_t> rank(n);
+        ui_vector<variable_t> next_rank(n);
+        ui_vector<variable_t> anc(n);
+        ui_vector<variable_t> next_anc(n);
+        ui_vector<variable_t> all(n);
+#pragma omp parallel for schedule(static) num_threads(cores)
+        for (size_t x = 0; x < n; ++x) {
+            all[x] = x;
+            anc[x] = (x < terminals) ? none : parent(x);
+        }
+        parallel::radix_sort_by_key(all, path_key, 2 * packed, cores);
+        rule_sorter::dense_ranks(all, [&](variable_t x, variable_t y) {
+            return path_key(x) == path_key(y);
+        }, rank, cores);
+        path.resize(0);
+
+        for (size_t h = 1; h < PACKED_LEVELS; h *= 2) {
+#pragma omp parallel for schedule(static) num_threads(cores)
+            for (size_t x = 0; x < n; ++x) {
+                next_anc[x] = (anc[x] == none) ? none : anc[anc[x]];
+            }
+            std::swap(anc, next_anc);
+        }
+
+        auto anc_rank = [&](variable_t x) -> size_t {
+            return anc[x] == none ? 0 : rank[anc[x]];
+        };
+        auto own_rank = [&](variable_t x) -> size_t {
+            return rank[x];
+        };
+        for (size_t h = PACKED_LEVELS; h < levels; h *= 2) {
+#pragma omp parallel for schedule(static) num_threads(cores)
+            for (size_t x = 0; x < n; ++x) {
+                all[x] = x;
+            }
+            parallel::radix_sort_by_key(all, anc_rank, bits, cores);
+            parallel::radix_sort_by_key(all, own_rank, bits, cores);
+            rule_sorter::dense_ranks(all, [&](variable_t x, variable_t y) {
+                return rank[x] == rank[y] && anc_rank(x) == anc_rank(y);
+            }, next_rank, cores);
+
+#pragma omp parallel for schedule(static) num_threads(cores)
+            for (size_t x = 0; x < n; ++x) {
+                next_anc[x] = (anc[x] == none) ? none : anc[anc[x]];
+            }
+            std::swap(rank, next_rank);
+            std::swap(anc, next_anc);
+        }
+        parallel::radix_sort_by_key(order, own_rank, bits, cores);
+    }
+    path.resize(0);
+#ifdef BENCH
+    const auto endTimeRanks = recomp::timer::now();
+#endif
+
+    ui_vector<variable_t> renamed(rlslp.size());
+#pragma omp parallel for schedule(static) num_threads(cores)
+    for (size_t i = 0; i < order.size(); ++i) {
+        renamed[order[i] - terminals] = i;
+    }
+    order.resize(0);
+
+    ui_vector<recomp::non_terminal<variable_t>> renamed_rules = std::move(rlslp.non_terminals);
+    rlslp.non_terminals.resize(renamed_rules.size());
+#pragma omp parallel for schedule(static) num_threads(cores)
+    for (size_t i = 0; i < renamed_rules.size(); ++i) {
+        auto rule = renamed_rules[i];
+        if (!rlslp.is_block(i + terminals) && !rlslp.is_terminal(rule.second())) {
+            rule.second() = renamed[rule.second() - terminals] + terminals;
+        }
+        if (!rlslp.is_terminal(rule.first())) {
+            rule.first() = renamed[rule.first() - terminals] + terminals;
+        }
+        rlslp[renamed[i]] = rule;
+    }
+
+    if (rlslp.root >= terminals && !rlslp.empty()) {
+        rlslp.root = renamed[rlslp.root - terminals] + terminals;
+    }
+#ifdef BENCH
+    const auto endTime = recomp::timer::now();
+    std::cout << "RESULT algo=sort_rlslp_rules productions=" << rlslp.size() << " levels=" << levels << " cores="
+              << cores << " children="
+              << std::chrono::duration_cast<std::chrono::milliseconds>(endTimeChildren - startTime).count()
+              << " bfs=" << std::chrono::duration_cast<std::chrono::milliseconds>(endTimeBfs - endTimeChildren).count()
+              << " ranks=" << std::chrono::duration_cast<std::chrono::milliseconds>(endTimeRanks - endTimeBfs).count()
+              << " rename=" << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - endTimeRanks).count()
+              << " time=" << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count()
+              << std::endl;
+#endif
+}
+
 }  // namespace recomp
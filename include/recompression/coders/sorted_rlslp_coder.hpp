@@ -9,6 +9,7 @@
 #include "coder.hpp"
 #include "recompression/io/bitostream.hpp"
 #include "recompression/rlslp.hpp"
+#include "recompression/trace.hpp"
 #include "rlslp_rule_sorter.hpp"
 
 namespace recomp {
@@ -33,6 +34,7 @@ class SortedRLSLPCoder {
 
         template<typename variable_t = var_t>
         inline void encode(rlslp<variable_t>& rlslp) {
+            trace_scope trace("enc_rlslp", "coder", "productions", rlslp.size());
 #ifdef BENCH
             const auto startTime = recomp::timer::now();
 #endif
@@ -107,6 +109,7 @@ class SortedRLSLPCoder {
 
         template<typename variable_t = var_t>
         inline rlslp<variable_t> decode() {
+            trace_scope trace("dec_rlslp", "coder");
 #ifdef BENCH
             const auto startTime = recomp::timer::now();
 #endif
@@ -14,6 +14,7 @@
 #include "recompression/rlslp.hpp"
 #include "rlslp_rule_sorter.hpp"
 #include "recompression/util.hpp"
+#include "recompression/trace.hpp"
 
 namespace recomp {
 namespace coder {
@@ -40,6 +41,7 @@ class SortedRLSLPDRCoder {
 
         template<typename variable_t = var_t>
         inline void encode(rlslp<variable_t>& rlslp) {
+            trace_scope trace("enc_rlslp_dr", "coder", "productions", rlslp.size());
 #ifdef BENCH
             const auto startTime = recomp::timer::now();
 #endif
@@ -156,6 +158,7 @@ class SortedRLSLPDRCoder {
 
         template<typename variable_t = var_t>
         inline rlslp<variable_t> decode() {
+            trace_scope trace("dec_rlslp_dr", "coder");
 #ifdef BENCH
             const auto startTime = recomp::timer::now();
 #endif
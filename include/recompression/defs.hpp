@@ -9,15 +9,32 @@
 
 #include <tlx/simple_vector.hpp>
 
+#ifdef RECOMPRESSION_TRACK_MEMORY
+#include "recompression/memory_tracker.hpp"
+#endif
+
 namespace recomp {
 
 using timer = std::chrono::steady_clock;
 
+#ifdef RECOMPRESSION_TRACK_MEMORY
+#ifndef RECOMPRESSION_UI_VECTOR_ALLOCATOR
+#define RECOMPRESSION_UI_VECTOR_ALLOCATOR std::allocator
+#endif
+
+/**
+ * Uninitialized vector whose memory is accounted by the memory tracker. The allocator can be replaced by defining
+ * RECOMPRESSION_UI_VECTOR_ALLOCATOR as the name of an allocator template.
+ */
+template<typename T>
+using ui_vector = allocator_vector<T, tracking_allocator<T, RECOMPRESSION_UI_VECTOR_ALLOCATOR<T>>>;
+#else
 /**
  * Uninitialized tlx vector
  */
 template<typename T>
 using ui_vector = tlx::SimpleVector<T, tlx::SimpleVectorMode::NoInitButDestroy>;
+#endif
 
 /**
  * Initialized tlx vector
@@ -7,7 +7,6 @@
 #include <algorithm>
 #include <chrono>
 #include <iostream>
-#include <random>
 #include <string>
 #include <thread>
 #include <tuple>
@@ -19,6 +18,7 @@
 #include "recompression/parallel_ls_recompression.hpp"
 #include "recompression/defs.hpp"
 #include "recompression/util.hpp"
+#include "recompression/random.hpp"
 #include "recompression/rlslp.hpp"
 
 namespace recomp {
@@ -64,6 +64,7 @@ class parallel_ls_gain_recompression : public parallel_ls_recompression<variable
      *                    are in Sigma_l, otherwise all symbols with value true are in Sigma_l)
      */
     inline virtual void compute_partition(const text_t& text, partition_t& partition, bool& part_l) override {
+        trace_scope trace("partition");
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
@@ -81,16 +82,7 @@ class parallel_ls_gain_recompression : public parallel_ls_recompression<variable
 #endif
         partition[0] = false;  // ensure, that minimum one symbol is in the left partition and one in the right
         partition[partition.size() - 1] = true;
-#pragma omp parallel num_threads(this->cores)
-        {
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<uint8_t> distribution(0, 1);
-#pragma omp for schedule(static)
-            for (size_t i = 1; i < partition.size() - 1; ++i) {
-                partition[i] = (distribution(gen) == 1);
-            }
-        }
+        counter_rng(this->seed, this->level).fill(partition, 1, partition.size() - 1, this->cores);
 #ifdef BENCH
         const auto endTimePar = recomp::timer::now();
         const auto timeSpanPar = endTimePar - startTimePar;
@@ -98,53 +90,19 @@ class parallel_ls_gain_recompression : public parallel_ls_recompression<variable
         const auto startTimeLocalSearch = recomp::timer::now();
 #endif
 
-        i_vector<ui_vector<std::int64_t>> flip;
         std::vector<size_t> bounds;
-#pragma omp parallel num_threads(this->cores)
-        {
-            auto n_threads = (size_t) omp_get_num_threads();
-#pragma omp single
-            {
-                flip.resize(n_threads);
-                for (size_t i = 0; i < n_threads; ++i) {
-                    flip[i].resize(partition.size());
-                }
-                bounds.reserve(n_threads + 1);
-                bounds.resize(n_threads + 1, adj_list.size() - 1);
-            }
-        }
-
+        ui_vector<std::int64_t> gain;
         for (size_t k = 0; k < 5; ++k) {
+            this->compute_gains(text, adj_list, partition, gain);
 #pragma omp parallel num_threads(this->cores)
             {
-                auto n_threads = (size_t) omp_get_num_threads();
-                auto thread_id = (size_t) omp_get_thread_num();
-
-                flip[thread_id].fill(0);
-
-#pragma omp for schedule(static)
-                for (size_t i = 0; i < adj_list_size; ++i) {
-                    auto char_i = text[adj_list[i]];
-                    auto char_i1 = text[adj_list[i] + 1];
-                    if (partition[char_i] != partition[char_i1]) {
-                        flip[thread_id][char_i]++;
-                        flip[thread_id][char_i1]++;
-                    } else {
-                        flip[thread_id][char_i]--;
-                        flip[thread_id][char_i1]--;
-                    }
-                }
-
                 size_t idx = partition.size();
                 std::int64_t min = 0;
 #pragma omp for schedule(static)
                 for (size_t i = 0; i < partition.size(); ++i) {
-                    for (size_t j = 1; j < n_threads; ++j) {
-                        flip[0][i] += flip[j][i];
-                    }
-                    if (flip[0][i] < min) {
+                    if (gain[i] < min) {
                         idx = i;
-                        min = flip[0][i];
+                        min = gain[i];
                     }
                 }
 
@@ -157,10 +115,7 @@ class parallel_ls_gain_recompression : public parallel_ls_recompression<variable
                 }
             }
         }
-        for (size_t i = 0; i < flip.size(); ++i) {
-            flip[i].resize(1);
-        }
-        flip.resize(1);
+        gain.resize(1);
 #ifdef BENCH
         const auto endTimeLocalSearch = recomp::timer::now();
         const auto timeSpanLocalSearch = endTimeLocalSearch - startTimeLocalSearch;
@@ -187,17 +142,17 @@ class parallel_ls_gain_recompression : public parallel_ls_recompression<variable
         const auto startTimeCount = recomp::timer::now();
 #endif
 
-        int lr_count = 0;
-        int rl_count = 0;
-        int prod_l = 0;
-        int prod_r = 0;
+        size_t lr_count = 0;
+        size_t rl_count = 0;
+        size_t prod_l = 0;
+        size_t prod_r = 0;
 #pragma omp parallel num_threads(this->cores) reduction(+:lr_count) reduction(+:rl_count) reduction(+:prod_r) reduction(+:prod_l)
         {
             auto thread_id = omp_get_thread_num();
 
 #pragma omp single
             {
-                std::fill(bounds.begin(), bounds.end(), adj_list.size());
+                bounds.assign(omp_get_num_threads() + 1, adj_list.size());
             }
 
 #pragma omp for schedule(static)
@@ -62,21 +62,28 @@ class recompression_order_gr : public recompression<variable_t> {
                                rlslp<variable_t>& rlslp,
                                const size_t& alphabet_size,
                                const size_t cores) override {
+        trace_scope trace("recompression", "recompression", "text", text.size());
 #ifdef BENCH_RECOMP
         const auto startTime = recomp::timer::now();
         size_t text_size = text.size();
 #endif
-        this->cores = cores;
         rlslp.terminals = alphabet_size;
         bv_t bv;
 
-        while (text.size() > 1) {
-            bcomp(text, rlslp, bv);
-            this->level++;
-
-            if (text.size() > 1) {
-                pcomp(text, rlslp, bv);
+        {
+            typename recompression<variable_t>::cores_guard guard(*this, cores);
+            while (text.size() > 1) {
+                this->begin_round(text.size(), cores);
+                bcomp(text, rlslp, bv);
+                this->end_round();
                 this->level++;
+
+                if (text.size() > 1) {
+                    this->begin_round(text.size(), cores);
+                    pcomp(text, rlslp, bv);
+                    this->end_round();
+                    this->level++;
+                }
             }
         }
 
@@ -110,6 +117,7 @@ class recompression_order_gr : public recompression<variable_t> {
      * @param bv[in,out] The bitvector to indicate which rules derive blocks
      */
     inline void bcomp(text_t& text, rlslp<variable_t>& rlslp, bv_t& bv) {
+        trace_scope trace("bcomp", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         std::cout << "RESULT algo=" << this->name << "_bcomp dataset=" << this->dataset << " text=" << text.size()
@@ -417,6 +425,7 @@ class recompression_order_gr : public recompression<variable_t> {
      * @param adj_list[out] The adjacency list
      */
     inline void compute_adj_list(const text_t& text, adj_list_t& adj_list, size_t& begin) {
+        trace_scope trace("adj_list");
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
@@ -463,11 +472,12 @@ class recompression_order_gr : public recompression<variable_t> {
                                   partition_t& partition,
                                   size_t& begin,
                                   bool& part_l) {
+        trace_scope trace("partition");
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
-        int l_count = 0;
-        int r_count = 0;
+        size_t l_count = 0;
+        size_t r_count = 0;
         size_t glob_i = 0;
         size_t i = 0;
         size_t j = begin;
@@ -520,8 +530,8 @@ class recompression_order_gr : public recompression<variable_t> {
 #ifdef BENCH
         const auto startTimeCount = recomp::timer::now();
 #endif
-        int lr_count = 0;
-        int rl_count = 0;
+        size_t lr_count = 0;
+        size_t rl_count = 0;
 #pragma omp parallel for num_threads(this->cores) schedule(static) reduction(+:lr_count) reduction(+:rl_count)
         for (size_t k = 0; k < text.size() - 1; ++k) {
             if (!partition[text[k]] && partition[text[k + 1]]) {
@@ -554,6 +564,7 @@ class recompression_order_gr : public recompression<variable_t> {
      * @param bv[in,out] The bitvector to indicate which rules derive blocks
      */
     inline void pcomp(text_t& text, rlslp<variable_t>& rlslp, bv_t& bv) {
+        trace_scope trace("pcomp", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         std::cout << "RESULT algo=" << this->name << "_pcomp dataset=" << this->dataset << " text=" << text.size()
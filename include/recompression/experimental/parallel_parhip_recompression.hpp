@@ -66,21 +66,28 @@ class parallel_parhip_recompression : public parallel_rnd_recompression<variable
                                rlslp<variable_t>& rlslp,
                                const size_t& alphabet_size,
                                const size_t cores) override {
+        trace_scope trace("recompression", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         size_t text_size = text.size();
 #endif
-        this->cores = cores;
         rlslp.terminals = alphabet_size;
         bv_t bv;
 
-        while (text.size() > 1) {
-            this->bcomp(text, rlslp, bv);
-            this->level++;
-
-            if (text.size() > 1) {
-                pcomp(text, rlslp, bv);
+        {
+            typename recompression<variable_t>::cores_guard guard(*this, cores);
+            while (text.size() > 1) {
+                this->begin_round(text.size(), cores);
+                this->bcomp(text, rlslp, bv);
+                this->end_round();
                 this->level++;
+
+                if (text.size() > 1) {
+                    this->begin_round(text.size(), cores);
+                    pcomp(text, rlslp, bv);
+                    this->end_round();
+                    this->level++;
+                }
             }
         }
 
@@ -120,6 +127,7 @@ class parallel_parhip_recompression : public parallel_rnd_recompression<variable
                         const ui_vector<size_t>& copy_bounds,
                         size_t count,
                         const ui_vector<variable_t>& mapping) {
+        trace_scope trace("compact");
 #ifdef BENCH
         const auto startTimeCompact = recomp::timer::now();
 #endif
@@ -289,6 +297,7 @@ class parallel_parhip_recompression : public parallel_rnd_recompression<variable
      *                    are in Sigma_l, otherwise all symbols with value true are in Sigma_l)
      */
     inline void compute_partition(const text_t& text, partition_t& partition, bool& part_l) {
+        trace_scope trace("partition");
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         const auto startTimeGraph = recomp::timer::now();
@@ -381,8 +390,8 @@ class parallel_parhip_recompression : public parallel_rnd_recompression<variable
                 partition[i] = false;
             }
 
-            int l_count = 0;
-            int r_count = 0;
+            size_t l_count = 0;
+            size_t r_count = 0;
 
             auto thread_id = omp_get_thread_num();
             size_t p_size = nodes[thread_id].size();
@@ -437,10 +446,10 @@ class parallel_parhip_recompression : public parallel_rnd_recompression<variable
         const auto startTimeCount = recomp::timer::now();
 #endif
 
-        int lr_count = 0;
-        int rl_count = 0;
-        int prod_l = 0;
-        int prod_r = 0;
+        size_t lr_count = 0;
+        size_t rl_count = 0;
+        size_t prod_l = 0;
+        size_t prod_r = 0;
 #pragma omp parallel num_threads(this->cores) reduction(+:lr_count) reduction(+:rl_count) reduction(+:prod_r) reduction(+:prod_l)
         {
             auto thread_id = omp_get_thread_num();
@@ -519,6 +528,7 @@ class parallel_parhip_recompression : public parallel_rnd_recompression<variable
      * @param bv[in,out] The bitvector to indicate which rules derive blocks
      */
     inline void pcomp(text_t& text, rlslp<variable_t>& rlslp, bv_t& bv) {
+        trace_scope trace("pcomp", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         std::cout << "RESULT algo=" << this->name << "_pcomp dataset=" << this->dataset << " text=" << text.size()
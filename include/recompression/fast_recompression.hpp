@@ -42,6 +42,7 @@ class recompression_fast : public recompression<variable_t> {
                                rlslp<variable_t>& rlslp,
                                const size_t& alphabet_size,
                                const size_t cores) override {
+        trace_scope trace("recompression", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         size_t text_size = text.size();
@@ -155,6 +156,7 @@ class recompression_fast : public recompression<variable_t> {
                       bv_t& bv,
                       size_t& alphabet_size,
                       std::vector<variable_t>& mapping) {
+        trace_scope trace("bcomp", "recompression", "text", text.size());
 #ifdef BENCH
         std::cout << "RESULT algo=" << this->name << "_bcomp dataset=" << this->dataset << " text=" << text.size()
                   << " level=" << this->level << " alphabet=" << alphabet_size;
@@ -260,6 +262,7 @@ class recompression_fast : public recompression<variable_t> {
      * @param adj_list[out] The adjacency list of the text
      */
     inline void compute_adj_list(const text_t& text, adj_list_t& adj_list) {
+        trace_scope trace("adj_list");
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
@@ -297,11 +300,12 @@ class recompression_fast : public recompression<variable_t> {
      * @param partition[out] The partitioning of the symbols
      */
     inline void compute_partition(const adj_list_t& adj_list, partition_t& partition) {
+        trace_scope trace("partition");
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
-        int l_count = 0;
-        int r_count = 0;
+        size_t l_count = 0;
+        size_t r_count = 0;
         for (size_t i = 0; i < adj_list.size(); ++i) {
             if (!adj_list[i].empty()) {
                 for (const auto& mult : adj_list[i]) {
@@ -339,8 +343,8 @@ class recompression_fast : public recompression<variable_t> {
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
-        int lr_count = 0;
-        int rl_count = 0;
+        size_t lr_count = 0;
+        size_t rl_count = 0;
         for (size_t i = 0; i < adj_list.size(); ++i) {
             for (const auto& sec : adj_list[i]) {
                 if (!partition[i] && partition[sec.first]) {
@@ -428,6 +432,7 @@ class recompression_fast : public recompression<variable_t> {
                       bv_t& bv,
                       size_t& alphabet_size,
                       std::vector<variable_t>& mapping) {
+        trace_scope trace("pcomp", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         std::cout << "RESULT algo=" << this->name << "_pcomp dataset=" << this->dataset << " text=" << text.size()
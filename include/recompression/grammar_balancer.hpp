@@ -0,0 +1,405 @@
+#pragma once
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#ifdef BENCH
+#include <chrono>
+#include <iostream>
+#endif
+
+#include "recompression/defs.hpp"
+#include "recompression/grammar_optimizer.hpp"
+#include "recompression/memory_tracker.hpp"
+#include "recompression/rlslp.hpp"
+#include "recompression/trace.hpp"
+
+namespace recomp {
+
+/**
+ * @brief The distribution of the heights of the rules reachable from the root of an rlslp.
+ */
+struct height_distribution {
+    size_t height = 0;              // the height of the root
+    size_t bound = 0;               // the height guaranteed by balance_rlslp for the length of the text
+    size_t unbalanced = 0;          // the pairs whose children differ by more than one in height
+    std::vector<size_t> rules;      // rules[h] is the number of rules of height h
+
+    friend inline std::ostream& operator<<(std::ostream& out, const height_distribution& dist) {
+        out << " height=" << dist.height << " height_bound=" << dist.bound << " unbalanced=" << dist.unbalanced
+            << " heights=";
+        bool first = true;
+        for (size_t h = 1; h < dist.rules.size(); ++h) {
+            if (dist.rules[h] > 0) {
+                out << (first ? "" : ",") << h << ":" << dist.rules[h];
+                first = false;
+            }
+        }
+        return out;
+    }
+};
+
+namespace balancer {
+
+/**
+ * @brief Returns the maximal height of an AVL tree with the given number of leaves, i.e. the largest h such that the
+ * Fibonacci number F(h + 2) is at most the number of leaves. This is less than 1.4405 log2(leaves + 2).
+ */
+inline size_t avl_height_bound(size_t leaves) {
+    size_t height = 0;
+    size_t fib = 1;       // F(h + 2)
+    size_t next = 2;      // F(h + 3)
+    while (next <= leaves) {
+        height++;
+        if (fib > leaves - next) {
+            break;
+        }
+        const size_t sum = fib + next;
+        fib = next;
+        next = sum;
+    }
+    return height;
+}
+
+/**
+ * @brief Returns ceil(log2(k)) for k > 0.
+ */
+inline size_t ceil_log2(size_t k) {
+    size_t log = 0;
+    while ((static_cast<size_t>(1) << log) < k) {
+        log++;
+    }
+    return log;
+}
+
+/**
+ * @brief Builds new rules by AVL concatenation (Rytter) on top of the rules of a grammar.
+ *
+ * Every symbol is the root of an AVL tree. A block A^k is regarded as the balanced tree of k copies of A, so its AVL
+ * height is the height of A plus ceil(log2(k)) and its children are A^ceil(k/2) and A^floor(k/2). The new rules are
+ * stored locally and are referenced by symbols with the LOCAL bit set, such that several threads can build rules on
+ * top of the same grammar at the same time.
+ *
+ * @tparam variable_t The type of non-terminals
+ */
+template<typename variable_t>
+class avl_builder {
+ public:
+    typedef std::uint64_t symbol_t;
+
+    static constexpr symbol_t LOCAL = static_cast<symbol_t>(1) << 63;
+
+    struct node {
+        symbol_t first;
+        symbol_t second;          // the number of repetitions of a block
+        std::uint8_t block;
+        std::uint8_t height;
+    };
+
+    std::vector<node> nodes;
+
+    avl_builder(const optimizer::grammar<variable_t>& gr, const std::vector<std::uint8_t>& heights)
+            : gr(gr), heights(heights) {}
+
+    inline size_t height(symbol_t s) const {
+        if (s & LOCAL) {
+            return nodes[s & ~LOCAL].height;
+        }
+        return s < gr.terminals ? 0 : heights[s - gr.terminals];
+    }
+
+    inline symbol_t make_pair(symbol_t first, symbol_t second) {
+        nodes.push_back(node{first, second, 0,
+                             static_cast<std::uint8_t>(std::max(height(first), height(second)) + 1)});
+        return (nodes.size() - 1) | LOCAL;
+    }
+
+    inline symbol_t make_block(symbol_t first, size_t k) {
+        if (k == 1) {
+            return first;
+        }
+        nodes.push_back(node{first, k, 1, static_cast<std::uint8_t>(height(first) + ceil_log2(k))});
+        return (nodes.size() - 1) | LOCAL;
+    }
+
+    /**
+     * @brief Returns the concatenation of the AVL trees a and b as AVL tree. Its height is the larger height of both
+     * trees or one more.
+     */
+    inline symbol_t concat(symbol_t a, symbol_t b) {
+        const size_t h_a = height(a);
+        const size_t h_b = height(b);
+        if (h_a > h_b + 1) {
+            return join_right(a, b);
+        } else if (h_b > h_a + 1) {
+            return join_left(a, b);
+        }
+        return make_pair(a, b);
+    }
+
+ private:
+    const optimizer::grammar<variable_t>& gr;
+    const std::vector<std::uint8_t>& heights;
+
+    inline void expose(symbol_t s, symbol_t& first, symbol_t& second) {
+        node rule;
+        if (s & LOCAL) {
+            rule = nodes[s & ~LOCAL];
+        } else {
+            const auto& production = gr.rules[s - gr.terminals];
+            rule = node{production.first(), production.second(), gr.blocks[s - gr.terminals], 0};
+        }
+        if (rule.block) {
+            const size_t k = rule.second;
+            first = make_block(rule.first, (k + 1) / 2);
+            second = make_block(rule.first, k / 2);
+        } else {
+            first = rule.first;
+            second = rule.second;
+        }
+    }
+
+    // height(a) > height(b) + 1, b is appended to the right spine of a
+    symbol_t join_right(symbol_t a, symbol_t b) {
+        symbol_t l, c;
+        expose(a, l, c);
+        if (height(c) <= height(b) + 1) {
+            if (std::max(height(c), height(b)) + 1 <= height(l) + 1) {
+                return make_pair(l, make_pair(c, b));
+            }
+            symbol_t c_1, c_2;
+            expose(c, c_1, c_2);
+            return make_pair(make_pair(l, c_1), make_pair(c_2, b));
+        }
+        const symbol_t t = join_right(c, b);
+        if (height(t) <= height(l) + 1) {
+            return make_pair(l, t);
+        }
+        symbol_t t_1, t_2;
+        expose(t, t_1, t_2);
+        return make_pair(make_pair(l, t_1), t_2);
+    }
+
+    // height(b) > height(a) + 1, a is prepended to the left spine of b
+    symbol_t join_left(symbol_t a, symbol_t b) {
+        symbol_t c, r;
+        expose(b, c, r);
+        if (height(c) <= height(a) + 1) {
+            if (std::max(height(a), height(c)) + 1 <= height(r) + 1) {
+                return make_pair(make_pair(a, c), r);
+            }
+            symbol_t c_1, c_2;
+            expose(c, c_1, c_2);
+            return make_pair(make_pair(a, c_1), make_pair(c_2, r));
+        }
+        const symbol_t t = join_left(a, c);
+        if (height(t) <= height(r) + 1) {
+            return make_pair(t, r);
+        }
+        symbol_t t_1, t_2;
+        expose(t, t_1, t_2);
+        return make_pair(t_1, make_pair(t_2, r));
+    }
+};
+
+/**
+ * @brief Rebuilds the rules of the rlslp as AVL grammar.
+ *
+ * The rules are processed by increasing height in parallel. A rule whose children are unchanged and whose children
+ * differ by at most one in AVL height is kept. Otherwise the rule is replaced by the AVL concatenation of its balanced
+ * children (or the block of its balanced child). The threads build the new rules of a level locally and append them
+ * to the grammar at the end of the level. The resulting grammar is pruned and its equivalent rules are merged.
+ *
+ * @tparam variable_t The type of non-terminals
+ * @param rlslp[in,out] The rlslp
+ * @param cores The number of cores to use
+ */
+template<typename variable_t>
+inline void balance(rlslp<variable_t>& rlslp, size_t cores) {
+    typedef typename avl_builder<variable_t>::symbol_t symbol_t;
+    const size_t terminals = rlslp.terminals;
+    optimizer::grammar<variable_t> gr;
+    optimizer::to_grammar(rlslp, gr, cores);
+
+    std::vector<size_t> levels_heights;
+    const size_t max_height = optimizer::compute_heights(gr, levels_heights);
+    std::vector<size_t> level_bounds;
+    std::vector<variable_t> levels;
+    optimizer::compute_levels(levels_heights, max_height, level_bounds, levels);
+    levels_heights = std::vector<size_t>();
+
+    // balanced[i] is the balanced variable of rule i, heights[i] the AVL height of rule i
+    std::vector<variable_t> balanced(gr.rules.size());
+    std::vector<std::uint8_t> heights(gr.rules.size(), 0);
+    auto balanced_name = [&](variable_t nt) -> variable_t {
+        return nt < terminals ? nt : balanced[nt - terminals];
+    };
+
+    std::vector<size_t> offsets(cores + 1, 0);
+    for (size_t h = 0; h < max_height; ++h) {
+#pragma omp parallel num_threads(cores)
+        {
+            const auto thread_id = static_cast<size_t>(omp_get_thread_num());
+            const auto n_threads = static_cast<size_t>(omp_get_num_threads());
+            avl_builder<variable_t> builder(gr, heights);
+            std::vector<std::pair<variable_t, symbol_t>> replaced;
+
+#pragma omp for schedule(dynamic, 1024)
+            for (size_t i = level_bounds[h]; i < level_bounds[h + 1]; ++i) {
+                const auto rule = levels[i];
+                const auto& production = gr.rules[rule];
+                const variable_t first = balanced_name(production.first());
+                if (gr.blocks[rule]) {
+                    if (first == production.first()) {
+                        balanced[rule] = rule + terminals;
+                        heights[rule] = static_cast<std::uint8_t>(builder.height(first) +
+                                                                  ceil_log2(production.second()));
+                    } else {
+                        replaced.emplace_back(rule, builder.make_block(first, production.second()));
+                    }
+                    continue;
+                }
+                const variable_t second = balanced_name(production.second());
+                const size_t h_first = builder.height(first);
+                const size_t h_second = builder.height(second);
+                if (first == production.first() && second == production.second() && h_first <= h_second + 1 &&
+                    h_second <= h_first + 1) {
+                    balanced[rule] = rule + terminals;
+                    heights[rule] = static_cast<std::uint8_t>(std::max(h_first, h_second) + 1);
+                } else {
+                    replaced.emplace_back(rule, builder.concat(first, second));
+                }
+            }
+            offsets[thread_id + 1] = builder.nodes.size();
+
+#pragma omp barrier
+#pragma omp single
+            {
+                offsets[0] = gr.rules.size();
+                for (size_t t = 0; t < n_threads; ++t) {
+                    offsets[t + 1] += offsets[t];
+                }
+                gr.rules.resize(offsets[n_threads]);
+                gr.blocks.resize(offsets[n_threads]);
+                heights.resize(offsets[n_threads]);
+            }
+
+            const size_t offset = offsets[thread_id];
+            auto global_name = [&](symbol_t s) -> variable_t {
+                return static_cast<variable_t>((s & avl_builder<variable_t>::LOCAL)
+                                               ? offset + (s & ~avl_builder<variable_t>::LOCAL) + terminals : s);
+            };
+            for (size_t j = 0; j < builder.nodes.size(); ++j) {
+                const auto& node = builder.nodes[j];
+                gr.rules[offset + j] = non_terminal<variable_t>(
+                        global_name(node.first),
+                        node.block ? static_cast<variable_t>(node.second) : global_name(node.second));
+                gr.blocks[offset + j] = node.block;
+                heights[offset + j] = node.height;
+            }
+            for (const auto& r : replaced) {
+                balanced[r.first] = global_name(r.second);
+                heights[r.first] = static_cast<std::uint8_t>(builder.height(r.second));
+            }
+        }
+    }
+
+    gr.root = balanced_name(rlslp.root);
+    recomp::rlslp<variable_t> balanced_rlslp;
+    optimizer::to_rlslp(gr, balanced_rlslp, cores);
+    rlslp = std::move(balanced_rlslp);
+}
+
+}  // namespace balancer
+
+/**
+ * @brief Computes the distribution of the heights of the rules reachable from the root.
+ *
+ * @tparam variable_t The type of non-terminals
+ * @param rlslp The rlslp
+ * @param cores The number of cores to use
+ * @return The height distribution
+ */
+template<typename variable_t = var_t>
+inline height_distribution compute_height_distribution(const rlslp<variable_t>& rlslp,
+                                                       size_t cores = std::thread::hardware_concurrency()) {
+    height_distribution dist;
+    if (rlslp.empty() || rlslp.is_terminal(rlslp.root) || rlslp.size() == 0) {
+        return dist;
+    }
+    optimizer::grammar<variable_t> gr;
+    optimizer::to_grammar(rlslp, gr, cores);
+    std::vector<size_t> heights;
+    dist.height = optimizer::compute_heights(gr, heights);
+    dist.bound = balancer::avl_height_bound(rlslp.len(rlslp.root));
+    dist.rules.assign(dist.height + 1, 0);
+    auto height = [&](variable_t nt) -> size_t {
+        return nt < rlslp.terminals ? 0 : heights[nt - rlslp.terminals];
+    };
+    for (size_t i = 0; i < heights.size(); ++i) {
+        if (heights[i] == 0) {
+            continue;
+        }
+        dist.rules[heights[i]]++;
+        if (!gr.blocks[i]) {
+            const size_t h_first = height(gr.rules[i].first());
+            const size_t h_second = height(gr.rules[i].second());
+            if (h_first > h_second + 1 || h_second > h_first + 1) {
+                dist.unbalanced++;
+            }
+        }
+    }
+    return dist;
+}
+
+/**
+ * @brief Rebalances the rlslp such that its height is at most the height of an AVL tree with n leaves, i.e. less than
+ * 1.4405 log2(n + 2) for a text of length n. The costs of @code{extract}, @code{lce_query} and the traversal of
+ * subtrees are proportional to the height.
+ *
+ * If the height already is within the bound, the rlslp is not changed. Otherwise all rules are rebuilt bottom up as AVL
+ * grammar (Rytter): a block A^k is treated as balanced tree of k copies of A and the rules whose children differ by
+ * more than one in height are replaced by the AVL concatenation of their children. Each replacement adds O(log n)
+ * rules. Afterwards unreachable rules are removed and equivalent rules are merged. The pairs of the resulting rlslp are
+ * followed by the blocks, both ordered by their heights.
+ *
+ * @tparam variable_t The type of non-terminals
+ * @param rlslp[in,out] The rlslp
+ * @param cores The number of cores to use
+ * @return Whether the rlslp has been rebalanced
+ */
+template<typename variable_t = var_t>
+inline bool balance_rlslp(rlslp<variable_t>& rlslp, size_t cores = std::thread::hardware_concurrency()) {
+    if (rlslp.empty() || rlslp.is_terminal(rlslp.root) || rlslp.size() == 0) {
+        return false;
+    }
+    const size_t bound = balancer::avl_height_bound(rlslp.len(rlslp.root));
+    const size_t height = rlslp.height();
+    if (height <= bound) {
+        return false;
+    }
+    memory_phase mem_balance("balance");
+    trace_scope trace("balance_rlslp", "rlslp", "productions", rlslp.size());
+#ifdef BENCH
+    const auto startTime = recomp::timer::now();
+    const size_t productions = rlslp.size();
+#endif
+    balancer::balance(rlslp, cores);
+#ifdef BENCH
+    const auto endTime = recomp::timer::now();
+    const auto timeSpan = endTime - startTime;
+    std::cout << "RESULT algo=balance_rlslp productions=" << productions << " balanced=" << rlslp.size()
+              << " height=" << height << " balanced_height=" << rlslp.height() << " height_bound=" << bound
+              << " cores=" << cores
+              << " time=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count() << mem_balance
+              << std::endl;
+#endif
+    return true;
+}
+
+}  // namespace recomp
@@ -0,0 +1,568 @@
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef BENCH
+#include <iostream>
+#endif
+
+#include <ips4o.hpp>
+
+#include "defs.hpp"
+#include "karp_rabin.hpp"
+#include "pattern_matching.hpp"
+#include "rlslp.hpp"
+#include "util.hpp"
+
+namespace recomp {
+namespace index {
+
+/**
+ * @brief A wavelet matrix over a sequence of integers supporting two-dimensional range counting and reporting.
+ *
+ * Every level stores one bit of the values (most significant bit first) in a bitvector with rank support. After each
+ * level the sequence is stably partitioned by the bit of this level. The positions of the last level are mapped back
+ * to the original positions to report points without select support.
+ */
+class wavelet_matrix {
+ public:
+    wavelet_matrix() = default;
+
+    /**
+     * @brief Builds the wavelet matrix of the given values.
+     *
+     * @param values The values
+     */
+    explicit wavelet_matrix(const std::vector<size_t>& values) {
+        build(values);
+    }
+
+    /**
+     * @brief Builds the wavelet matrix of the given values.
+     *
+     * @param values The values
+     */
+    void build(const std::vector<size_t>& values) {
+        n = values.size();
+        size_t max_val = 0;
+        for (const auto& value : values) {
+            max_val = std::max(max_val, value);
+        }
+        levels = util::bits_for(max_val);
+        const size_t words = n / 64 + 1;
+        bits.assign(levels, std::vector<std::uint64_t>(words, 0));
+        ranks.assign(levels, std::vector<size_t>(words, 0));
+        zeros.assign(levels, 0);
+
+        std::vector<size_t> cur = values;
+        std::vector<size_t> next(n);
+        leaf.resize(n);
+        std::vector<size_t> next_leaf(n);
+        for (size_t i = 0; i < n; ++i) {
+            leaf[i] = i;
+        }
+        for (size_t l = 0; l < levels; ++l) {
+            const size_t shift = levels - 1 - l;
+            for (size_t i = 0; i < n; ++i) {
+                if ((cur[i] >> shift) & 1) {
+                    bits[l][i / 64] |= static_cast<std::uint64_t>(1) << (i % 64);
+                }
+            }
+            for (size_t w = 1; w < words; ++w) {
+                ranks[l][w] = ranks[l][w - 1] + __builtin_popcountll(bits[l][w - 1]);
+            }
+            zeros[l] = n - rank1(l, n);
+
+            size_t z = 0;
+            size_t o = zeros[l];
+            for (size_t i = 0; i < n; ++i) {
+                const size_t pos = ((cur[i] >> shift) & 1) ? o++ : z++;
+                next[pos] = cur[i];
+                next_leaf[pos] = leaf[i];
+            }
+            std::swap(cur, next);
+            std::swap(leaf, next_leaf);
+        }
+    }
+
+    /**
+     * @return The number of values
+     */
+    inline size_t size() const {
+        return n;
+    }
+
+    /**
+     * @brief Counts the values in [a, b) at the positions [lo, hi).
+     *
+     * @param lo The first position
+     * @param hi The position behind the last one
+     * @param a The smallest value
+     * @param b The value behind the largest one
+     * @return The number of values in the range
+     */
+    size_t count(size_t lo, size_t hi, size_t a, size_t b) const {
+        if (lo >= hi || a >= b) {
+            return 0;
+        }
+        return count_less(lo, hi, b) - count_less(lo, hi, a);
+    }
+
+    /**
+     * @brief Reports the positions of the values in [a, b) at the positions [lo, hi).
+     *
+     * @param lo The first position
+     * @param hi The position behind the last one
+     * @param a The smallest value
+     * @param b The value behind the largest one
+     * @param positions[out] The positions of the values in the range (not sorted)
+     */
+    void report(size_t lo, size_t hi, size_t a, size_t b, std::vector<size_t>& positions) const {
+        if (lo < hi && a < b) {
+            report(0, lo, hi, 0, a, b, positions);
+        }
+    }
+
+ private:
+    size_t n = 0;
+    size_t levels = 0;
+
+    std::vector<std::vector<std::uint64_t>> bits;
+
+    /**
+     * The number of ones in front of each word.
+     */
+    std::vector<std::vector<size_t>> ranks;
+    std::vector<size_t> zeros;
+
+    /**
+     * The original position of every position of the last level.
+     */
+    std::vector<size_t> leaf;
+
+    inline size_t rank1(size_t l, size_t i) const {
+        const std::uint64_t mask = (static_cast<std::uint64_t>(1) << (i % 64)) - 1;
+        return ranks[l][i / 64] + __builtin_popcountll(bits[l][i / 64] & mask);
+    }
+
+    inline size_t rank0(size_t l, size_t i) const {
+        return i - rank1(l, i);
+    }
+
+    size_t count_less(size_t lo, size_t hi, size_t x) const {
+        if (levels < 64 && x >= (static_cast<size_t>(1) << levels)) {
+            return hi - lo;
+        }
+        size_t res = 0;
+        for (size_t l = 0; l < levels && lo < hi; ++l) {
+            const size_t r0_lo = rank0(l, lo);
+            const size_t r0_hi = rank0(l, hi);
+            if ((x >> (levels - 1 - l)) & 1) {
+                res += r0_hi - r0_lo;
+                lo = zeros[l] + lo - r0_lo;
+                hi = zeros[l] + hi - r0_hi;
+            } else {
+                lo = r0_lo;
+                hi = r0_hi;
+            }
+        }
+        return res;
+    }
+
+    void report(size_t l, size_t lo, size_t hi, size_t prefix, size_t a, size_t b,
+                std::vector<size_t>& positions) const {
+        if (lo >= hi) {
+            return;
+        }
+        const size_t width = levels - l;
+        const size_t lo_val = prefix << width;
+        const size_t hi_val = (prefix + 1) << width;
+        if (hi_val <= a || lo_val >= b) {
+            return;
+        }
+        if (l == levels) {
+            for (size_t i = lo; i < hi; ++i) {
+                positions.push_back(leaf[i]);
+            }
+            return;
+        }
+        const size_t r0_lo = rank0(l, lo);
+        const size_t r0_hi = rank0(l, hi);
+        report(l + 1, r0_lo, r0_hi, prefix << 1, a, b, positions);
+        report(l + 1, zeros[l] + lo - r0_lo, zeros[l] + hi - r0_hi, (prefix << 1) | 1, a, b, positions);
+    }
+};
+
+/**
+ * @brief A grammar-based self-index on top of a rlslp supporting count, locate and extract.
+ *
+ * Every reachable non-terminal X -> YZ (or X -> Y^d) defines a point of a grid. The rows of the grid are the
+ * non-terminals sorted by the reversed string of their left child Y, the columns are sorted by the string of the right
+ * part (Z or Y^(d-1)). An occurrence of a pattern P of length m >= 2 that is split at position k into P[0, k) and
+ * P[k, m) is primary in X if the left child ends with P[0, k) and the right part starts with P[k, m). For every split
+ * the rows and columns are found by binary search and the points in the resulting rectangle are reported by a wavelet
+ * matrix. The secondary occurrences are found by traversing the parents in the derivation tree (see
+ * @code{pattern_matching::pattern_matcher}).
+ *
+ * The rows and columns are sorted with Karp-Rabin fingerprints in parallel. The sorted rows and columns are stored
+ * with the rlslp (see @code{coder::GrammarIndexCoder}) so that a loaded index does not need to sort again.
+ *
+ * Finding the primary occurrences takes O(m^2 * log g * h) time, where g is the size of the rlslp and h is the
+ * height of the derivation tree.
+ *
+ * @tparam variable_t The type of non-terminals
+ */
+template<typename variable_t = var_t>
+class grammar_index {
+ public:
+    /**
+     * @brief Builds the index of the given rlslp. The rlslp is copied.
+     *
+     * @param rlslp The rlslp
+     * @param cores The number of cores to use
+     */
+    explicit grammar_index(const rlslp<variable_t>& rlslp, const size_t cores = 1)
+            : slp(copy(rlslp)), matcher(slp) {
+        trace_scope trace("grammar_index", "query", "productions", slp.size());
+#ifdef BENCH
+        const auto startTime = recomp::timer::now();
+#endif
+        sort_points(cores);
+        build_grid();
+#ifdef BENCH
+        const auto endTime = recomp::timer::now();
+        const auto timeSpan = endTime - startTime;
+        std::cout << "RESULT algo=grammar_index production=" << slp.size() << " points=" << rows.size()
+                  << " cores=" << cores << " time="
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count() << std::endl;
+#endif
+    }
+
+    /**
+     * @brief Restores an index from a rlslp and the already sorted rows and columns of the grid.
+     *
+     * @param rlslp The rlslp with computed lengths
+     * @param rows The reachable non-terminals sorted by the reversed strings of their left children
+     * @param columns The reachable non-terminals sorted by the strings of their right parts
+     */
+    grammar_index(rlslp<variable_t>&& rlslp, std::vector<variable_t>&& rows, std::vector<variable_t>&& columns)
+            : slp(std::move(rlslp)), matcher(slp), rows(std::move(rows)), columns(std::move(columns)) {
+        build_grid();
+    }
+
+    grammar_index(const grammar_index&) = delete;
+    grammar_index& operator=(const grammar_index&) = delete;
+
+    /**
+     * @brief Counts the occurrences of the pattern.
+     *
+     * @param pattern The pattern
+     * @return The number of (possibly overlapping) occurrences
+     */
+    size_t count(const std::string& pattern) const {
+        trace_scope trace("index_count", "query", "pattern", pattern.size());
+        if (pattern.size() < 2) {
+            return matcher.count(pattern);
+        }
+        std::vector<primary_t> primaries;
+        find_primary(pattern, primaries);
+        size_t count = 0;
+        for (const auto& primary : primaries) {
+            count += primary.repeats * matcher.occurrences(primary.nt);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Computes all starting positions of the pattern.
+     *
+     * @param pattern The pattern
+     * @return The increasingly sorted starting positions of all (possibly overlapping) occurrences
+     */
+    std::vector<size_t> locate(const std::string& pattern) const {
+        trace_scope trace("index_locate", "query", "pattern", pattern.size());
+        if (pattern.size() < 2) {
+            return matcher.find_occurrences(pattern);
+        }
+        std::vector<primary_t> primaries;
+        find_primary(pattern, primaries);
+        std::vector<size_t> positions;
+        for (const auto& primary : primaries) {
+            size_t period = 0;
+            if (slp.is_block(primary.nt)) {
+                period = slp.len(slp[primary.nt - slp.terminals].first());
+            }
+            matcher.locate(primary.nt, primary.offset, primary.repeats, period, positions);
+        }
+        std::sort(positions.begin(), positions.end());
+        return positions;
+    }
+
+    /**
+     * @brief Extracts the substring of length @code{len} beginning at position @code{i}.
+     *
+     * @param i The position to start
+     * @param len The length of the substring
+     * @return The substring
+     */
+    inline std::string extract(size_t i, size_t len) const {
+        return slp.extract(i, len);
+    }
+
+    /**
+     * @return The indexed rlslp
+     */
+    inline const rlslp<variable_t>& get_rlslp() const {
+        return slp;
+    }
+
+    /**
+     * @return The non-terminals sorted by the reversed strings of their left children
+     */
+    inline const std::vector<variable_t>& get_rows() const {
+        return rows;
+    }
+
+    /**
+     * @return The non-terminals sorted by the strings of their right parts
+     */
+    inline const std::vector<variable_t>& get_columns() const {
+        return columns;
+    }
+
+ private:
+    struct primary_t {
+        variable_t nt;
+        size_t offset;
+        size_t repeats;
+    };
+
+    rlslp<variable_t> slp;
+    pattern_matching::pattern_matcher<variable_t> matcher;
+
+    std::vector<variable_t> rows;
+    std::vector<variable_t> columns;
+
+    /**
+     * The column of the point of every row.
+     */
+    wavelet_matrix grid;
+
+    static rlslp<variable_t> copy(const rlslp<variable_t>& rlslp) {
+        recomp::rlslp<variable_t> res;
+        res.resize(rlslp.size());
+        for (size_t i = 0; i < rlslp.size(); ++i) {
+            res[i] = rlslp[i];
+        }
+        res.root = rlslp.root;
+        res.terminals = rlslp.terminals;
+        res.is_empty = rlslp.is_empty;
+        res.blocks = rlslp.blocks;
+        return res;
+    }
+
+    /**
+     * @return The length of the left child of the non-terminal
+     */
+    inline size_t split(variable_t nt) const {
+        return slp.len(slp[nt - slp.terminals].first());
+    }
+
+    /**
+     * @brief Sorts the points of the grid by the reversed left children and by the right parts.
+     *
+     * Two strings are compared by computing the length of their longest common suffix (prefix) using binary search
+     * on the fingerprints of their leftmost occurrences followed by comparing the next character.
+     *
+     * @param cores The number of cores to use
+     */
+    void sort_points(const size_t cores) {
+        rows = matcher.reachable();
+        columns = matcher.reachable();
+        if (rows.empty()) {
+            return;
+        }
+        karp_rabin<variable_t> kr{slp, cores};
+
+        auto sort_rows = [&](const variable_t a, const variable_t b) {
+            const size_t len_a = split(a);
+            const size_t len_b = split(b);
+            const size_t end_a = matcher.leftmost(a) + len_a;
+            const size_t end_b = matcher.leftmost(b) + len_b;
+            const size_t max = std::min(len_a, len_b);
+            size_t lo = 0;
+            size_t hi = max;
+            while (lo < hi) {
+                const size_t mid = (lo + hi + 1) / 2;
+                if (kr.equal(end_a - mid, end_b - mid, mid)) {
+                    lo = mid;
+                } else {
+                    hi = mid - 1;
+                }
+            }
+            if (lo == max) {
+                return len_a < len_b || (len_a == len_b && a < b);
+            }
+            return symbol_at(end_a - lo - 1) < symbol_at(end_b - lo - 1);
+        };
+        auto sort_columns = [&](const variable_t a, const variable_t b) {
+            const size_t start_a = matcher.leftmost(a) + split(a);
+            const size_t start_b = matcher.leftmost(b) + split(b);
+            const size_t len_a = slp.len(a) - split(a);
+            const size_t len_b = slp.len(b) - split(b);
+            const size_t max = std::min(len_a, len_b);
+            size_t lo = 0;
+            size_t hi = max;
+            while (lo < hi) {
+                const size_t mid = (lo + hi + 1) / 2;
+                if (kr.equal(start_a, start_b, mid)) {
+                    lo = mid;
+                } else {
+                    hi = mid - 1;
+                }
+            }
+            if (lo == max) {
+                return len_a < len_b || (len_a == len_b && a < b);
+            }
+            return symbol_at(start_a + lo) < symbol_at(start_b + lo);
+        };
+
+        ips4o::parallel::sort(rows.begin(), rows.end(), sort_rows, cores);
+        ips4o::parallel::sort(columns.begin(), columns.end(), sort_columns, cores);
+    }
+
+    /**
+     * @brief Builds the wavelet matrix over the columns of the rows.
+     */
+    void build_grid() {
+        std::vector<size_t> column_of(slp.size(), 0);
+        for (size_t c = 0; c < columns.size(); ++c) {
+            column_of[columns[c] - slp.terminals] = c;
+        }
+        std::vector<size_t> values(rows.size());
+        for (size_t r = 0; r < rows.size(); ++r) {
+            values[r] = column_of[rows[r] - slp.terminals];
+        }
+        grid.build(values);
+    }
+
+    /**
+     * @brief Returns the terminal at the given text position by traversing down from the root.
+     *
+     * @param pos The text position
+     * @return The terminal
+     */
+    variable_t symbol_at(size_t pos) const {
+        variable_t nt = slp.root;
+        while (!slp.is_terminal(nt)) {
+            const auto& rule = slp[nt - slp.terminals];
+            const size_t first_len = slp.len(rule.first());
+            if (slp.is_block(nt)) {
+                pos %= first_len;
+                nt = rule.first();
+            } else if (pos < first_len) {
+                nt = rule.first();
+            } else {
+                pos -= first_len;
+                nt = rule.second();
+            }
+        }
+        return nt;
+    }
+
+    /**
+     * @brief Compares the reversed left child of the non-terminal with the reversed pattern prefix of length k.
+     *
+     * @return A negative value if the reversed left child is smaller and does not start with the reversed prefix,
+     * zero if it starts with the reversed prefix, a positive value otherwise
+     */
+    int compare_row(variable_t nt, const std::string& pattern, size_t k) const {
+        const size_t len = split(nt);
+        const size_t t = std::min(k, len);
+        const std::string str = slp.extract(matcher.leftmost(nt) + len - t, t);
+        for (size_t q = 0; q < t; ++q) {
+            const auto a = static_cast<unsigned char>(str[t - 1 - q]);
+            const auto b = static_cast<unsigned char>(pattern[k - 1 - q]);
+            if (a != b) {
+                return a < b ? -1 : 1;
+            }
+        }
+        return t < k ? -1 : 0;
+    }
+
+    /**
+     * @brief Compares the right part of the non-terminal with the pattern suffix beginning at position k.
+     *
+     * @return A negative value if the right part is smaller and does not start with the suffix, zero if it starts
+     * with the suffix, a positive value otherwise
+     */
+    int compare_column(variable_t nt, const std::string& pattern, size_t k) const {
+        const size_t len = slp.len(nt) - split(nt);
+        const size_t m = pattern.size() - k;
+        const size_t t = std::min(m, len);
+        const std::string str = slp.extract(matcher.leftmost(nt) + split(nt), t);
+        for (size_t q = 0; q < t; ++q) {
+            const auto a = static_cast<unsigned char>(str[q]);
+            const auto b = static_cast<unsigned char>(pattern[k + q]);
+            if (a != b) {
+                return a < b ? -1 : 1;
+            }
+        }
+        return t < m ? -1 : 0;
+    }
+
+    /**
+     * @brief Computes the primary occurrences of the pattern for all splits using the grid.
+     *
+     * @param pattern The pattern of length at least two
+     * @param primaries[out] The primary occurrences
+     */
+    void find_primary(const std::string& pattern, std::vector<primary_t>& primaries) const {
+        const size_t m = pattern.size();
+        if (slp.empty() || rows.empty() || m > slp.len(slp.root)) {
+            return;
+        }
+        std::vector<size_t> points;
+        for (size_t k = 1; k < m; ++k) {
+            auto row_lo = std::partition_point(rows.begin(), rows.end(), [&](const variable_t nt) {
+                return compare_row(nt, pattern, k) < 0;
+            });
+            auto row_hi = std::partition_point(row_lo, rows.end(), [&](const variable_t nt) {
+                return compare_row(nt, pattern, k) == 0;
+            });
+            if (row_lo == row_hi) {
+                continue;
+            }
+            auto col_lo = std::partition_point(columns.begin(), columns.end(), [&](const variable_t nt) {
+                return compare_column(nt, pattern, k) < 0;
+            });
+            auto col_hi = std::partition_point(col_lo, columns.end(), [&](const variable_t nt) {
+                return compare_column(nt, pattern, k) == 0;
+            });
+            if (col_lo == col_hi) {
+                continue;
+            }
+
+            points.clear();
+            grid.report(row_lo - rows.begin(), row_hi - rows.begin(), col_lo - columns.begin(),
+                        col_hi - columns.begin(), points);
+            for (const auto& point : points) {
+                const variable_t nt = rows[point];
+                const size_t offset = split(nt) - k;
+                size_t repeats = 1;
+                if (slp.is_block(nt)) {
+                    repeats = (slp.len(nt) - m - offset) / split(nt) + 1;
+                }
+                primaries.push_back(primary_t{nt, offset, repeats});
+            }
+        }
+    }
+};
+
+}  // namespace index
+}  // namespace recomp
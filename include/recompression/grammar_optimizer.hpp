@@ -0,0 +1,618 @@
+#pragma once
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#ifdef BENCH
+#include <chrono>
+#include <iostream>
+#endif
+
+#include <ips4o.hpp>
+
+#include "recompression/defs.hpp"
+#include "recompression/memory_tracker.hpp"
+#include "recompression/rlslp.hpp"
+#include "recompression/trace.hpp"
+
+namespace recomp {
+
+/**
+ * @brief The configuration of the @code{optimize_rlslp} pass.
+ */
+struct optimizer_config {
+    /**
+     * Whether to inline the pairs that are used once by another pair and to rebuild the right-hand sides as balanced
+     * trees.
+     */
+    bool inline_rules = true;
+
+    /**
+     * The maximal number of rounds of the RePair pass over the right-hand sides (0 to disable it). Every round replaces
+     * all pairs of symbols that occur at least twice.
+     */
+    size_t repair_rounds = 0;
+};
+
+namespace optimizer {
+
+/**
+ * @brief A grammar whose rules are pairs or blocks in any order. Rule i defines the variable @code{terminals + i}.
+ */
+template<typename variable_t>
+struct grammar {
+    size_t terminals = CHAR_ALPHABET;
+    variable_t root = 0;
+    std::vector<non_terminal<variable_t>> rules;
+    std::vector<std::uint8_t> blocks;  // whether rule i is a block
+};
+
+/**
+ * @brief A rule with the canonical names of its children to find equivalent rules by sorting.
+ */
+template<typename variable_t>
+struct rule_key {
+    variable_t first;
+    variable_t second;
+    std::uint8_t block;
+    variable_t rule;
+
+    inline bool operator<(const rule_key& key) const {
+        return std::tie(block, first, second, rule) < std::tie(key.block, key.first, key.second, key.rule);
+    }
+
+    inline bool equivalent(const rule_key& key) const {
+        return block == key.block && first == key.first && second == key.second;
+    }
+};
+
+/**
+ * @brief Converts the rlslp to a grammar with the same names.
+ *
+ * @tparam variable_t The type of non-terminals
+ * @param rlslp The rlslp
+ * @param gr[out] The grammar
+ * @param cores The number of cores to use
+ */
+template<typename variable_t>
+inline void to_grammar(const rlslp<variable_t>& rlslp, grammar<variable_t>& gr, size_t cores) {
+    gr.terminals = rlslp.terminals;
+    gr.root = rlslp.root;
+    gr.rules.resize(rlslp.size());
+    gr.blocks.resize(rlslp.size());
+#pragma omp parallel for schedule(static) num_threads(cores)
+    for (size_t i = 0; i < rlslp.size(); ++i) {
+        gr.rules[i] = rlslp[i];
+        gr.blocks[i] = rlslp.is_block(i + rlslp.terminals);
+    }
+}
+
+/**
+ * @brief Computes the heights of the rules reachable from the root by a post order traversal. The height of a rule is
+ * the number of non-terminals on the longest path to a terminal, unreachable rules get height 0.
+ *
+ * @tparam variable_t The type of non-terminals
+ * @param gr The grammar
+ * @param heights[out] The heights of the rules
+ * @return The height of the root
+ */
+template<typename variable_t>
+inline size_t compute_heights(const grammar<variable_t>& gr, std::vector<size_t>& heights) {
+    const size_t terminals = gr.terminals;
+    heights.assign(gr.rules.size(), 0);
+    if (gr.root < terminals) {
+        return 0;
+    }
+    std::vector<variable_t> stack;
+    stack.push_back(gr.root);
+    while (!stack.empty()) {
+        const variable_t nt = stack.back();
+        if (heights[nt - terminals] > 0) {
+            stack.pop_back();
+            continue;
+        }
+        const auto& rule = gr.rules[nt - terminals];
+        size_t h = 1;
+        bool ready = true;
+        for (size_t c = 0; c < (gr.blocks[nt - terminals] ? 1 : 2); ++c) {
+            const variable_t child = rule.production[c];
+            if (child >= terminals) {
+                if (heights[child - terminals] == 0) {
+                    stack.push_back(child);
+                    ready = false;
+                } else {
+                    h = std::max(h, heights[child - terminals] + 1);
+                }
+            }
+        }
+        if (ready) {
+            heights[nt - terminals] = h;
+            stack.pop_back();
+        }
+    }
+    return heights[gr.root - terminals];
+}
+
+/**
+ * @brief Orders the reachable rules by their heights. The rules of height h are
+ * @code{levels[level_bounds[h - 1]..level_bounds[h])} in increasing order.
+ *
+ * @tparam variable_t The type of non-terminals
+ * @param heights The heights of the rules computed by @code{compute_heights}
+ * @param max_height The maximal height
+ * @param level_bounds[out] The bounds of the levels
+ * @param levels[out] The rules ordered by their heights
+ */
+template<typename variable_t>
+inline void compute_levels(const std::vector<size_t>& heights, size_t max_height, std::vector<size_t>& level_bounds,
+                           std::vector<variable_t>& levels) {
+    level_bounds.assign(max_height + 1, 0);
+    for (size_t i = 0; i < heights.size(); ++i) {
+        if (heights[i] > 0) {
+            level_bounds[heights[i]]++;
+        }
+    }
+    for (size_t h = 1; h <= max_height; ++h) {
+        level_bounds[h] += level_bounds[h - 1];
+    }
+    levels.resize(level_bounds[max_height]);
+    std::vector<size_t> pos(level_bounds.begin(), level_bounds.end() - 1);
+    for (size_t i = 0; i < heights.size(); ++i) {
+        if (heights[i] > 0) {
+            levels[pos[heights[i] - 1]++] = i;
+        }
+    }
+}
+
+/**
+ * @brief Builds the rlslp of the rules reachable from the root of the grammar. Equivalent rules, i.e. rules with the
+ * same type and equivalent children (and the same number of repetitions for blocks), are merged into one rule.
+ *
+ * The rules are processed by increasing height, so the children of a rule are merged before the rule itself. The
+ * rules of a height are grouped by sorting them by their canonical children. The pairs and the blocks of the rlslp
+ * are ordered by their heights and the lengths are computed from scratch.
+ *
+ * @tparam variable_t The type of non-terminals
+ * @param gr The grammar
+ * @param rlslp[out] The rlslp
+ * @param cores The number of cores to use
+ */
+template<typename variable_t>
+inline void to_rlslp(const grammar<variable_t>& gr, rlslp<variable_t>& rlslp, size_t cores) {
+    const size_t terminals = gr.terminals;
+    rlslp.terminals = terminals;
+    rlslp.root = gr.root;
+    rlslp.is_empty = false;
+    rlslp.blocks = 0;
+    if (gr.root < terminals) {
+        rlslp.resize(0);
+        return;
+    }
+
+    const size_t n = gr.rules.size();
+    std::vector<size_t> heights;
+    const size_t max_height = compute_heights(gr, heights);
+    std::vector<size_t> level_bounds;
+    std::vector<variable_t> levels;
+    compute_levels(heights, max_height, level_bounds, levels);
+
+    // canonical[i] is the smallest rule equivalent to rule i
+    std::vector<variable_t> canonical(n);
+    auto canonical_name = [&](variable_t nt) -> variable_t {
+        return nt < terminals ? nt : canonical[nt - terminals] + terminals;
+    };
+    std::vector<rule_key<variable_t>> keys;
+    for (size_t h = 0; h < max_height; ++h) {
+        const size_t begin = level_bounds[h];
+        const size_t end = level_bounds[h + 1];
+        keys.resize(end - begin);
+#pragma omp parallel for schedule(static) num_threads(cores)
+        for (size_t i = begin; i < end; ++i) {
+            const auto rule = levels[i];
+            const bool block = gr.blocks[rule];
+            keys[i - begin] = rule_key<variable_t>{canonical_name(gr.rules[rule].first()),
+                                                   block ? gr.rules[rule].second()
+                                                         : canonical_name(gr.rules[rule].second()),
+                                                   static_cast<std::uint8_t>(block), rule};
+        }
+        ips4o::parallel::sort(keys.begin(), keys.end(), std::less<rule_key<variable_t>>(), cores);
+        size_t representative = 0;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (i == 0 || !keys[i].equivalent(keys[i - 1])) {
+                representative = i;
+            }
+            canonical[keys[i].rule] = keys[representative].rule;
+        }
+    }
+
+    // the new names, the pairs of all levels in front of the blocks
+    std::vector<variable_t> names(n);
+    size_t pairs = 0;
+    size_t blocks = 0;
+    for (const auto rule : levels) {
+        if (canonical[rule] == rule && !gr.blocks[rule]) {
+            names[rule] = pairs++;
+        }
+    }
+    for (const auto rule : levels) {
+        if (canonical[rule] == rule && gr.blocks[rule]) {
+            names[rule] = pairs + blocks++;
+        }
+    }
+    auto rename = [&](variable_t nt) -> variable_t {
+        return nt < terminals ? nt : names[canonical[nt - terminals]] + terminals;
+    };
+
+    rlslp.resize(pairs + blocks);
+    rlslp.blocks = pairs;
+    rlslp.root = rename(gr.root);
+    for (size_t h = 0; h < max_height; ++h) {
+#pragma omp parallel for schedule(static) num_threads(cores)
+        for (size_t i = level_bounds[h]; i < level_bounds[h + 1]; ++i) {
+            const auto rule = levels[i];
+            if (canonical[rule] != rule) {
+                continue;
+            }
+            const auto& production = gr.rules[rule];
+            const auto first = rename(production.first());
+            if (gr.blocks[rule]) {
+                rlslp[names[rule]] = non_terminal<variable_t>(first, production.second(),
+                                                              rlslp.len(first) * production.second());
+            } else {
+                const auto second = rename(production.second());
+                rlslp[names[rule]] = non_terminal<variable_t>(first, second, rlslp.len(first) + rlslp.len(second));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Returns the right-hand sides of the pairs that are not inlined. A pair is inlined into its parent if it is
+ * not the root and is used exactly once by another pair. Blocks and the children of blocks are never inlined.
+ *
+ * The pairs of the rlslp must be ordered by their heights like the output of @code{to_rlslp}.
+ *
+ * @tparam variable_t The type of non-terminals
+ * @param rlslp The rlslp
+ * @param inline_rules Whether to inline the pairs used once
+ * @param kept[out] The pairs that are not inlined
+ * @param bounds[out] The right-hand side of kept[k] is symbols[bounds[k]..bounds[k + 1])
+ * @param symbols[out] The symbols of the right-hand sides
+ * @param cores The number of cores to use
+ */
+template<typename variable_t>
+inline void right_hand_sides(const rlslp<variable_t>& rlslp, bool inline_rules, std::vector<variable_t>& kept,
+                             std::vector<size_t>& bounds, std::vector<variable_t>& symbols, size_t cores) {
+    const size_t terminals = rlslp.terminals;
+    const size_t pairs = rlslp.blocks;
+
+    std::vector<std::uint8_t> inlined(pairs, 0);
+    if (inline_rules) {
+        std::vector<size_t> uses(rlslp.size(), 0);
+        std::vector<std::uint8_t> in_block(rlslp.size(), 0);
+#pragma omp parallel for schedule(static) num_threads(cores)
+        for (size_t i = 0; i < rlslp.size(); ++i) {
+            const bool block = i >= pairs;
+            for (size_t c = 0; c < (block ? 1 : 2); ++c) {
+                const variable_t child = rlslp[i].production[c];
+                if (child >= terminals) {
+#pragma omp atomic
+                    uses[child - terminals]++;
+                    if (block) {
+#pragma omp atomic write
+                        in_block[child - terminals] = 1;
+                    }
+                }
+            }
+        }
+#pragma omp parallel for schedule(static) num_threads(cores)
+        for (size_t i = 0; i < pairs; ++i) {
+            inlined[i] = uses[i] == 1 && !in_block[i] && i + terminals != rlslp.root;
+        }
+    }
+
+    // the number of symbols of the expanded pairs, the children of a pair precede it
+    std::vector<size_t> leaves(pairs);
+    auto count = [&](variable_t nt) -> size_t {
+        return (nt >= terminals && nt - terminals < pairs && inlined[nt - terminals]) ? leaves[nt - terminals] : 1;
+    };
+    kept.clear();
+    bounds.assign(1, 0);
+    for (size_t i = 0; i < pairs; ++i) {
+        leaves[i] = count(rlslp[i].first()) + count(rlslp[i].second());
+        if (!inlined[i]) {
+            kept.push_back(i);
+            bounds.push_back(bounds.back() + leaves[i]);
+        }
+    }
+
+    symbols.resize(bounds.back());
+#pragma omp parallel num_threads(cores)
+    {
+        std::vector<variable_t> stack;
+#pragma omp for schedule(dynamic, 1024)
+        for (size_t k = 0; k < kept.size(); ++k) {
+            size_t pos = bounds[k];
+            stack.push_back(rlslp[kept[k]].second());
+            stack.push_back(rlslp[kept[k]].first());
+            while (!stack.empty()) {
+                const variable_t nt = stack.back();
+                stack.pop_back();
+                if (nt >= terminals && nt - terminals < pairs && inlined[nt - terminals]) {
+                    stack.push_back(rlslp[nt - terminals].second());
+                    stack.push_back(rlslp[nt - terminals].first());
+                } else {
+                    symbols[pos++] = nt;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Replaces pairs of symbols occurring at least twice in the right-hand sides by new rules for at most the given
+ * number of rounds.
+ *
+ * In every round the occurrences of all pairs are counted (non-overlapping for runs of a symbol) and every
+ * right-hand side is scanned from left to right. An occurrence of a frequent pair is replaced unless the next pair is
+ * more frequent. A pair that already is the whole right-hand side of a kept rule is replaced by this rule. The
+ * right-hand sides are not shortened below two symbols.
+ *
+ * @tparam variable_t The type of non-terminals
+ * @param kept The kept pairs
+ * @param bounds[in,out] The bounds of the right-hand sides
+ * @param symbols[in,out] The symbols of the right-hand sides
+ * @param first_name The name of the first new rule
+ * @param new_rules[out] The new rules, rule j defines the variable @code{first_name + j}
+ * @param rounds The maximal number of rounds
+ * @param terminals The number of terminals
+ * @param cores The number of cores to use
+ */
+template<typename variable_t>
+inline void repair(const std::vector<variable_t>& kept, std::vector<size_t>& bounds, std::vector<variable_t>& symbols,
+                   variable_t first_name, std::vector<std::pair<variable_t, variable_t>>& new_rules, size_t rounds,
+                   size_t terminals, size_t cores) {
+    typedef std::pair<variable_t, variable_t> pair_t;
+    const size_t rhs = kept.size();
+    new_rules.clear();
+
+    for (size_t round = 0; round < rounds; ++round) {
+        // occurrences of the pairs, the pairs of rhs k are written to occ[occ_bounds[k]..occ_bounds[k + 1])
+        std::vector<size_t> occ_bounds(rhs + 1, 0);
+#pragma omp parallel for schedule(static) num_threads(cores)
+        for (size_t k = 0; k < rhs; ++k) {
+            occ_bounds[k + 1] = bounds[k + 1] - bounds[k] - 1;
+        }
+        for (size_t k = 0; k < rhs; ++k) {
+            occ_bounds[k + 1] += occ_bounds[k];
+        }
+        std::vector<pair_t> occ(occ_bounds[rhs]);
+        std::vector<size_t> occ_count(rhs);
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(cores)
+        for (size_t k = 0; k < rhs; ++k) {
+            size_t pos = occ_bounds[k];
+            bool counted_run = false;
+            for (size_t i = bounds[k]; i + 1 < bounds[k + 1]; ++i) {
+                const bool run = symbols[i] == symbols[i + 1];
+                if (run && counted_run) {
+                    counted_run = false;
+                    continue;
+                }
+                counted_run = run;
+                occ[pos++] = std::make_pair(symbols[i], symbols[i + 1]);
+            }
+            occ_count[k] = pos - occ_bounds[k];
+        }
+        size_t total = 0;
+        for (size_t k = 0; k < rhs; ++k) {
+            std::copy(occ.begin() + occ_bounds[k], occ.begin() + occ_bounds[k] + occ_count[k], occ.begin() + total);
+            total += occ_count[k];
+        }
+        occ.resize(total);
+        ips4o::parallel::sort(occ.begin(), occ.end(), std::less<pair_t>(), cores);
+
+        // the frequent pairs with their frequencies
+        std::vector<pair_t> frequent;
+        std::vector<size_t> frequencies;
+        for (size_t i = 0; i < occ.size();) {
+            size_t j = i + 1;
+            while (j < occ.size() && occ[j] == occ[i]) {
+                ++j;
+            }
+            if (j - i >= 2) {
+                frequent.push_back(occ[i]);
+                frequencies.push_back(j - i);
+            }
+            i = j;
+        }
+        if (frequent.empty()) {
+            break;
+        }
+
+        // the names of the frequent pairs, either an existing rule of two symbols or a new rule
+        std::vector<std::pair<pair_t, variable_t>> existing;
+        for (size_t k = 0; k < rhs; ++k) {
+            if (bounds[k + 1] - bounds[k] == 2) {
+                existing.emplace_back(std::make_pair(symbols[bounds[k]], symbols[bounds[k] + 1]),
+                                      kept[k] + terminals);
+            }
+        }
+        std::sort(existing.begin(), existing.end());
+        std::vector<variable_t> names(frequent.size());
+        for (size_t f = 0; f < frequent.size(); ++f) {
+            auto iter = std::lower_bound(existing.begin(), existing.end(),
+                                         std::make_pair(frequent[f], static_cast<variable_t>(0)));
+            if (iter != existing.end() && iter->first == frequent[f]) {
+                names[f] = iter->second;
+            } else {
+                names[f] = first_name + new_rules.size();
+                new_rules.push_back(frequent[f]);
+            }
+        }
+        auto find = [&](variable_t a, variable_t b) -> size_t {
+            auto iter = std::lower_bound(frequent.begin(), frequent.end(), std::make_pair(a, b));
+            return (iter != frequent.end() && *iter == std::make_pair(a, b)) ? iter - frequent.begin()
+                                                                             : frequent.size();
+        };
+
+        // replace the occurrences in place
+        std::vector<size_t> lengths(rhs);
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(cores)
+        for (size_t k = 0; k < rhs; ++k) {
+            const size_t begin = bounds[k];
+            const size_t end = bounds[k + 1];
+            size_t out = begin;
+            if (end - begin > 2) {
+                for (size_t i = begin; i < end;) {
+                    const size_t f = (i + 1 < end) ? find(symbols[i], symbols[i + 1]) : frequent.size();
+                    if (f < frequent.size()) {
+                        const size_t next = (i + 2 < end) ? find(symbols[i + 1], symbols[i + 2]) : frequent.size();
+                        if (next == frequent.size() || frequencies[next] <= frequencies[f]) {
+                            symbols[out++] = names[f];
+                            i += 2;
+                            continue;
+                        }
+                    }
+                    symbols[out++] = symbols[i++];
+                }
+            } else {
+                out = end;
+            }
+            lengths[k] = out - begin;
+        }
+
+        // compact the right-hand sides
+        size_t pos = 0;
+        for (size_t k = 0; k < rhs; ++k) {
+            std::copy(symbols.begin() + bounds[k], symbols.begin() + bounds[k] + lengths[k], symbols.begin() + pos);
+            bounds[k] = pos;
+            pos += lengths[k];
+        }
+        bounds[rhs] = pos;
+        symbols.resize(pos);
+    }
+}
+
+/**
+ * @brief Writes the balanced binary tree of the symbols [begin, end) to the rules beginning at @code{next} and
+ * returns the name of its root.
+ */
+template<typename variable_t>
+inline variable_t binarize(const std::vector<variable_t>& symbols, size_t begin, size_t end, grammar<variable_t>& gr,
+                           size_t& next) {
+    if (end - begin == 1) {
+        return symbols[begin];
+    }
+    const size_t mid = begin + (end - begin) / 2;
+    const variable_t first = binarize(symbols, begin, mid, gr, next);
+    const variable_t second = binarize(symbols, mid, end, gr, next);
+    const size_t rule = next++;
+    gr.rules[rule] = non_terminal<variable_t>(first, second);
+    return rule + gr.terminals;
+}
+
+}  // namespace optimizer
+
+/**
+ * @brief Reduces the number of rules of the rlslp while preserving the derived text, the lengths and the blocks.
+ *
+ * First, unreachable rules are removed and equivalent rules are merged. If enabled, the pairs used only once by
+ * another pair are inlined into their parents and the right-hand sides of the remaining pairs are rebuilt as balanced
+ * trees. The optional RePair pass replaces pairs of symbols that occur multiple times in the right-hand sides by new
+ * rules before. Afterwards equivalent rules are merged again. The restructured grammar is only used if it is not
+ * larger. All steps work in parallel on the rules of the same height or on the right-hand sides.
+ *
+ * The pairs of the resulting rlslp are followed by the blocks. Both are ordered by their heights.
+ *
+ * @tparam variable_t The type of non-terminals
+ * @param rlslp[in,out] The rlslp
+ * @param config The configuration
+ * @param cores The number of cores to use
+ */
+template<typename variable_t = var_t>
+inline void optimize_rlslp(rlslp<variable_t>& rlslp, const optimizer_config& config = optimizer_config(),
+                           size_t cores = std::thread::hardware_concurrency()) {
+    if (rlslp.empty() || rlslp.is_terminal(rlslp.root) || rlslp.size() == 0) {
+        return;
+    }
+    memory_phase mem_optimize("optimize");
+    trace_scope trace("optimize_rlslp", "rlslp", "productions", rlslp.size());
+#ifdef BENCH
+    const auto startTime = recomp::timer::now();
+    const size_t productions = rlslp.size();
+#endif
+    optimizer::grammar<variable_t> gr;
+    optimizer::to_grammar(rlslp, gr, cores);
+    recomp::rlslp<variable_t> merged;
+    optimizer::to_rlslp(gr, merged, cores);
+#ifdef BENCH
+    const size_t merged_productions = merged.size();
+#endif
+
+    if (config.inline_rules || config.repair_rounds > 0) {
+        std::vector<variable_t> kept;
+        std::vector<size_t> bounds;
+        std::vector<variable_t> symbols;
+        optimizer::right_hand_sides(merged, config.inline_rules, kept, bounds, symbols, cores);
+
+        const size_t terminals = merged.terminals;
+        std::vector<std::pair<variable_t, variable_t>> new_rules;
+        if (config.repair_rounds > 0) {
+            optimizer::repair(kept, bounds, symbols, static_cast<variable_t>(terminals + merged.size()), new_rules,
+                              config.repair_rounds, terminals, cores);
+        }
+
+        // the kept pairs are rebuilt in place, the other rules keep their names
+        std::vector<size_t> rule_bounds(kept.size() + 1, merged.size() + new_rules.size());
+        for (size_t k = 0; k < kept.size(); ++k) {
+            rule_bounds[k + 1] = rule_bounds[k] + (bounds[k + 1] - bounds[k] - 2);
+        }
+        gr.terminals = terminals;
+        gr.root = merged.root;
+        gr.rules.resize(rule_bounds[kept.size()]);
+        gr.blocks.assign(gr.rules.size(), 0);
+#pragma omp parallel for schedule(static) num_threads(cores)
+        for (size_t i = 0; i < merged.size(); ++i) {
+            gr.rules[i] = merged[i];
+            gr.blocks[i] = merged.is_block(i + terminals);
+        }
+#pragma omp parallel for schedule(static) num_threads(cores)
+        for (size_t j = 0; j < new_rules.size(); ++j) {
+            gr.rules[merged.size() + j] = non_terminal<variable_t>(new_rules[j].first, new_rules[j].second);
+        }
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(cores)
+        for (size_t k = 0; k < kept.size(); ++k) {
+            const size_t begin = bounds[k];
+            const size_t end = bounds[k + 1];
+            const size_t mid = begin + (end - begin) / 2;
+            size_t next = rule_bounds[k];
+            const variable_t first = optimizer::binarize(symbols, begin, mid, gr, next);
+            const variable_t second = optimizer::binarize(symbols, mid, end, gr, next);
+            gr.rules[kept[k]] = non_terminal<variable_t>(first, second);
+        }
+
+        recomp::rlslp<variable_t> restructured;
+        optimizer::to_rlslp(gr, restructured, cores);
+        if (restructured.size() <= merged.size()) {
+            merged = std::move(restructured);
+        }
+    }
+    rlslp = std::move(merged);
+#ifdef BENCH
+    const auto endTime = recomp::timer::now();
+    const auto timeSpan = endTime - startTime;
+    std::cout << "RESULT algo=optimize_rlslp productions=" << productions << " merged=" << merged_productions
+              << " optimized=" << rlslp.size() << " repair_rounds=" << config.repair_rounds << " cores=" << cores
+              << " time=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count() << mem_optimize
+              << std::endl;
+#endif
+}
+
+}  // namespace recomp
@@ -46,6 +46,7 @@ class hash_recompression : public recompression<variable_t> {
                                rlslp<variable_t>& rlslp,
                                const size_t& alphabet_size,
                                const size_t cores) override {
+        trace_scope trace("recompression", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         size_t text_size = text.size();
@@ -91,6 +92,7 @@ class hash_recompression : public recompression<variable_t> {
      * @param bv[in,out] The bitvector to indicate which rules derive blocks
      */
     inline void bcomp(text_t& text, rlslp<variable_t>& rlslp, bv_t& bv) {
+        trace_scope trace("bcomp", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         std::cout << "RESULT algo=" << this->name << "_bcomp dataset=" << this->dataset << " text=" << text.size()
@@ -187,6 +189,7 @@ class hash_recompression : public recompression<variable_t> {
     inline void compute_adj_list(const text_t& text,
                                  adj_list_t& adj,
                                  partition_t& part) {
+        trace_scope trace("adj_list");
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
@@ -256,13 +259,14 @@ class hash_recompression : public recompression<variable_t> {
     inline void compute_partition(const text_t& text,
                                   partition_t& partition,
                                   bool& part_l) {
+        trace_scope trace("partition");
         adj_list_t adj;
         compute_adj_list(text, adj, partition);
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
-        int l_count = 0;
-        int r_count = 0;
+        size_t l_count = 0;
+        size_t r_count = 0;
         size_t glob_i = 0;
         size_t l = 0;
         size_t r = 0;
@@ -320,8 +324,8 @@ class hash_recompression : public recompression<variable_t> {
 #endif
         // Count pairs in the current text based on the pairs build by the partition
         // from left set to right set and vice versa
-        int lr_count = 0;
-        int rl_count = 0;
+        size_t lr_count = 0;
+        size_t rl_count = 0;
         for (size_t k = 0; k < text.size() - 1; ++k) {
             if (!partition[text[k]] && partition[text[k + 1]]) {
                 lr_count++;
@@ -350,6 +354,7 @@ class hash_recompression : public recompression<variable_t> {
      * @param bv[in,out] The bitvector to indicate which rules derive blocks
      */
     inline void pcomp(text_t& text, rlslp<variable_t>& rlslp, bv_t& bv) {
+        trace_scope trace("pcomp", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         std::cout << "RESULT algo=" << this->name << "_pcomp dataset=" << this->dataset << " text=" << text.size()
@@ -0,0 +1,355 @@
+
+#pragma once
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <stack>
+#include <utility>
+#include <vector>
+
+#ifdef BENCH
+#include <iostream>
+#endif
+
+#include "defs.hpp"
+#include "rlslp.hpp"
+
+namespace recomp {
+
+/**
+ * @brief Karp-Rabin fingerprints of the non-terminals of a rlslp.
+ *
+ * The fingerprint of a string s is the polynomial sum_{k} s[k] * b^(|s| - 1 - k) mod p with the Mersenne prime
+ * p = 2^61 - 1 and a base b. For every non-terminal X the fingerprint of the derived string and b^|X| are stored.
+ * They are computed bottom-up level by level where all non-terminals of the same height are processed in parallel.
+ * The fingerprint of a block Y^d is computed with fast exponentiation of the geometric sum of b^|Y|.
+ *
+ * Two substrings with different fingerprints are always different. Equal fingerprints imply equal substrings with
+ * high probability only if the base is chosen uniformly at random. The default base is a fixed constant, so the
+ * fingerprints are reproducible but an adversarial text can produce collisions. Pass a random base (e.g. drawn from
+ * @code{counter_rng}) to get the probabilistic guarantee.
+ *
+ * The lengths of the non-terminals must be computed before (see @code{rlslp::compute_lengths}).
+ *
+ * @tparam variable_t The type of non-terminals
+ */
+template<typename variable_t = var_t>
+class karp_rabin {
+ public:
+    typedef std::uint64_t fp_t;
+
+    static constexpr fp_t k_prime = (static_cast<fp_t>(1) << 61) - 1;
+    // a fixed base in [2^32, p), not random
+    static constexpr fp_t k_default_base = 0x1b873593a6f1c4d7ULL % ((static_cast<fp_t>(1) << 61) - 1);
+
+    /**
+     * @brief Computes the fingerprints of all non-terminals of the rlslp.
+     *
+     * @param rlslp The rlslp
+     * @param cores The number of cores to use
+     * @param base The base of the polynomial (must be greater than the number of terminals and less than the prime)
+     */
+    explicit karp_rabin(const rlslp<variable_t>& rlslp, const size_t cores = 1, const fp_t base = k_default_base)
+            : slp(rlslp), base(base % k_prime) {
+        trace_scope trace("karp_rabin", "query", "productions", rlslp.size());
+        compute_fingerprints(cores);
+    }
+
+    /**
+     * @brief Returns the fingerprint of the string derived by the given symbol.
+     *
+     * @param nt The symbol
+     * @return The fingerprint
+     */
+    inline fp_t fingerprint(const variable_t nt) const {
+        if (slp.is_terminal(nt)) {
+            return static_cast<fp_t>(nt);
+        }
+        return fps[nt - slp.terminals];
+    }
+
+    /**
+     * @brief Returns the fingerprint of the substring of length @code{len} beginning at position @code{i}.
+     *
+     * If @code{i} + @code{len} is greater than the text size the fingerprint of the suffix beginning at position
+     * @code{i} will be returned.
+     *
+     * @param i The start position
+     * @param len The length of the substring
+     * @return The fingerprint of the substring
+     */
+    fp_t fingerprint(size_t i, size_t len) const {
+        if (slp.empty() || len == 0) {
+            return 0;
+        }
+        const size_t n = slp.len(slp.root);
+        if (i >= n) {
+            return 0;
+        }
+        if (i + len > n) {
+            len = n - i;
+        }
+        fp_t prefix_i = prefix_fingerprint(i);
+        fp_t prefix_j = prefix_fingerprint(i + len);
+        return sub(prefix_j, mul(prefix_i, pow(base, len)));
+    }
+
+    /**
+     * @brief Checks whether the substrings of length @code{len} beginning at @code{i} and @code{j} are equal.
+     *
+     * @param i The start position of the first substring
+     * @param j The start position of the second substring
+     * @param len The length of the substrings
+     * @return @code{true} if the fingerprints of the substrings are equal, @code{false} otherwise
+     */
+    inline bool equal(size_t i, size_t j, size_t len) const {
+        const size_t n = slp.len(slp.root);
+        if (i + len > n || j + len > n) {
+            return false;
+        }
+        return i == j || fingerprint(i, len) == fingerprint(j, len);
+    }
+
+    /**
+     * @return The underlying rlslp
+     */
+    inline const rlslp<variable_t>& get_rlslp() const {
+        return slp;
+    }
+
+    /**
+     * @brief Computes a * b mod p.
+     */
+    static inline fp_t mul(const fp_t a, const fp_t b) {
+        __extension__ typedef unsigned __int128 uint128_t;
+        uint128_t prod = static_cast<uint128_t>(a) * b;
+        fp_t res = static_cast<fp_t>(prod & k_prime) + static_cast<fp_t>(prod >> 61);
+        return res >= k_prime ? res - k_prime : res;
+    }
+
+    /**
+     * @brief Computes a + b mod p.
+     */
+    static inline fp_t add(const fp_t a, const fp_t b) {
+        fp_t res = a + b;
+        return res >= k_prime ? res - k_prime : res;
+    }
+
+    /**
+     * @brief Computes a - b mod p.
+     */
+    static inline fp_t sub(const fp_t a, const fp_t b) {
+        return a >= b ? a - b : a + k_prime - b;
+    }
+
+    /**
+     * @brief Computes b^e mod p by fast exponentiation.
+     */
+    static inline fp_t pow(fp_t b, size_t e) {
+        fp_t res = 1;
+        while (e > 0) {
+            if (e & 1) {
+                res = mul(res, b);
+            }
+            b = mul(b, b);
+            e >>= 1;
+        }
+        return res;
+    }
+
+    /**
+     * @brief Computes b^e and the geometric sum 1 + b + ... + b^(e - 1) mod p by fast exponentiation.
+     *
+     * @param b The base
+     * @param e The exponent
+     * @param power[out] b^e
+     * @param sum[out] The geometric sum
+     */
+    static inline void geometric(const fp_t b, size_t e, fp_t& power, fp_t& sum) {
+        power = 1;
+        sum = 0;
+        if (e == 0) {
+            return;
+        }
+        size_t bit = static_cast<size_t>(1) << (63 - __builtin_clzll(e));
+        for (; bit > 0; bit >>= 1) {
+            // (power, sum) for k -> 2k
+            sum = add(sum, mul(power, sum));
+            power = mul(power, power);
+            if (e & bit) {
+                // k -> k + 1
+                sum = add(sum, power);
+                power = mul(power, b);
+            }
+        }
+    }
+
+ private:
+    const rlslp<variable_t>& slp;
+    fp_t base;
+
+    /**
+     * The fingerprints of the non-terminals.
+     */
+    ui_vector<fp_t> fps;
+
+    /**
+     * b^|X| for all non-terminals X.
+     */
+    ui_vector<fp_t> pows;
+
+    inline fp_t power(const variable_t nt) const {
+        if (slp.is_terminal(nt)) {
+            return base;
+        }
+        return pows[nt - slp.terminals];
+    }
+
+    /**
+     * @brief Computes the fingerprints of all non-terminals reachable from the root.
+     *
+     * The heights of the non-terminals are computed with an iterative depth first search. Afterwards the
+     * non-terminals are bucketed by their heights and each bucket is processed in parallel.
+     *
+     * @param cores The number of cores to use
+     */
+    void compute_fingerprints(const size_t cores) {
+#ifdef BENCH
+        const auto startTime = recomp::timer::now();
+#endif
+        fps.resize(slp.size());
+        pows.resize(slp.size());
+        if (slp.empty() || slp.is_terminal(slp.root)) {
+            return;
+        }
+        const size_t terminals = slp.terminals;
+        ui_vector<size_t> height(slp.size());
+        std::vector<bool> visited(slp.size(), false);
+        std::vector<size_t> order;
+        order.reserve(slp.size());
+        std::stack<std::pair<variable_t, bool>> stack;
+        stack.emplace(slp.root, false);
+        while (!stack.empty()) {
+            auto top = stack.top();
+            stack.pop();
+            const size_t nt = top.first - terminals;
+            const auto& rule = slp[nt];
+            if (top.second) {
+                size_t h = 0;
+                if (!slp.is_terminal(rule.first())) {
+                    h = height[rule.first() - terminals] + 1;
+                }
+                if (!slp.is_block(top.first) && !slp.is_terminal(rule.second())) {
+                    h = std::max(h, height[rule.second() - terminals] + 1);
+                }
+                height[nt] = h;
+                order.push_back(nt);
+                continue;
+            }
+            if (visited[nt]) {
+                continue;
+            }
+            visited[nt] = true;
+            stack.emplace(top.first, true);
+            if (!slp.is_terminal(rule.first()) && !visited[rule.first() - terminals]) {
+                stack.emplace(rule.first(), false);
+            }
+            if (!slp.is_block(top.first) && !slp.is_terminal(rule.second()) &&
+                !visited[rule.second() - terminals]) {
+                stack.emplace(rule.second(), false);
+            }
+        }
+
+        // Bucket the non-terminals by their heights (counting sort)
+        size_t max_height = height[slp.root - terminals];
+        std::vector<size_t> bucket_start(max_height + 2, 0);
+        for (const auto& nt : order) {
+            bucket_start[height[nt] + 1]++;
+        }
+        for (size_t h = 1; h < bucket_start.size(); ++h) {
+            bucket_start[h] += bucket_start[h - 1];
+        }
+        std::vector<size_t> buckets(order.size());
+        std::vector<size_t> fill(bucket_start.begin(), bucket_start.end() - 1);
+        for (const auto& nt : order) {
+            buckets[fill[height[nt]]++] = nt;
+        }
+#ifdef BENCH
+        const auto endTimeHeight = recomp::timer::now();
+        const auto timeSpanHeight = endTimeHeight - startTime;
+        const auto startTimeFp = recomp::timer::now();
+#endif
+
+        for (size_t h = 0; h <= max_height; ++h) {
+#pragma omp parallel for schedule(static) num_threads(cores)
+            for (size_t k = bucket_start[h]; k < bucket_start[h + 1]; ++k) {
+                const size_t nt = buckets[k];
+                const auto& rule = slp[nt];
+                if (slp.is_block(nt + terminals)) {
+                    fp_t geo_sum;
+                    geometric(power(rule.first()), rule.second(), pows[nt], geo_sum);
+                    fps[nt] = mul(fingerprint(rule.first()), geo_sum);
+                } else {
+                    pows[nt] = mul(power(rule.first()), power(rule.second()));
+                    fps[nt] = add(mul(fingerprint(rule.first()), power(rule.second())), fingerprint(rule.second()));
+                }
+            }
+        }
+#ifdef BENCH
+        const auto endTime = recomp::timer::now();
+        const auto timeSpanFp = endTime - startTimeFp;
+        const auto timeSpan = endTime - startTime;
+        std::cout << "RESULT algo=karp_rabin production=" << slp.size() << " height=" << max_height << " cores="
+                  << cores << " heights=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanHeight).count()
+                  << " fingerprints=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanFp).count()
+                  << " time=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count() << std::endl;
+#endif
+    }
+
+    /**
+     * @brief Computes the fingerprint of the prefix of length @code{pos} by traversing down from the root.
+     *
+     * @param pos The length of the prefix
+     * @return The fingerprint of the prefix
+     */
+    fp_t prefix_fingerprint(size_t pos) const {
+        fp_t fp = 0;
+        variable_t nt = slp.root;
+        while (pos > 0) {
+            if (pos == slp.len(nt)) {
+                return add(mul(fp, power(nt)), fingerprint(nt));
+            }
+            // pos < len(nt), so nt is a non-terminal
+            const auto& rule = slp[nt - slp.terminals];
+            const size_t first_len = slp.len(rule.first());
+            if (slp.is_block(nt)) {
+                const size_t q = pos / first_len;
+                if (q > 0) {
+                    fp_t b_power;
+                    fp_t geo_sum;
+                    geometric(power(rule.first()), q, b_power, geo_sum);
+                    fp = add(mul(fp, b_power), mul(fingerprint(rule.first()), geo_sum));
+                    pos -= q * first_len;
+                }
+                nt = rule.first();
+            } else if (pos >= first_len) {
+                fp = add(mul(fp, power(rule.first())), fingerprint(rule.first()));
+                pos -= first_len;
+                nt = rule.second();
+            } else {
+                nt = rule.first();
+            }
+        }
+        return fp;
+    }
+};
+
+template<typename variable_t>
+constexpr typename karp_rabin<variable_t>::fp_t karp_rabin<variable_t>::k_prime;
+
+template<typename variable_t>
+constexpr typename karp_rabin<variable_t>::fp_t karp_rabin<variable_t>::k_default_base;
+
+}  // namespace recomp
@@ -3,10 +3,12 @@
 
 #include <omp.h>
 
+#include <algorithm>
 #include <stack>
 #include <unordered_map>
 #include <vector>
 
+#include "karp_rabin.hpp"
 #include "rlslp.hpp"
 
 namespace recomp {
@@ -537,6 +539,7 @@ size_t lce_query_recursive(const rlslp <variable_t>& rlslp,
  */
 template<typename variable_t = var_t>
 size_t lce_query(const rlslp <variable_t>& rlslp, size_t i, size_t j) {
+    trace_scope trace("lce_query", "query");
     if (rlslp.empty()) {
 //        DLOG(INFO) << "Empty rlslp";
         return 0;
@@ -562,6 +565,234 @@ size_t lce_query(const rlslp <variable_t>& rlslp, size_t i, size_t j) {
 }
 
 
+/**
+ * @brief Computes the length of the longest common prefix of two given suffices (longest common extension, LCE) using
+ * Karp-Rabin fingerprints.
+ *
+ * The LCE is found with an exponential search followed by a binary search comparing the fingerprints of the substrings
+ * of the two suffices. The result is correct with high probability.
+ *
+ * @tparam variable_t The type of variables
+ * @param kr The fingerprints of the rlslp
+ * @param i The start position of the first suffix
+ * @param j The start position of the second suffix
+ * @return The length of the longest common prefix of the two given suffices
+ */
+template<typename variable_t = var_t>
+size_t lce_query_fingerprint(const karp_rabin<variable_t>& kr, size_t i, size_t j) {
+    trace_scope trace("lce_query_fingerprint", "query");
+    const auto& rlslp = kr.get_rlslp();
+    if (rlslp.empty()) {
+        return 0;
+    }
+    const size_t n = rlslp.len(rlslp.root);
+    if (n <= i || n <= j) {
+        return 0;
+    }
+    if (i == j) {
+        return n - i;
+    }
+
+    const size_t max_len = n - std::max(i, j);
+    // Exponential search: find the first power of two that does not match
+    size_t len = 1;
+    while (len <= max_len && kr.equal(i, j, len)) {
+        len <<= 1;
+    }
+    // Binary search: lce is in [len / 2, min(len, max_len + 1))
+    size_t low = len >> 1;
+    size_t high = std::min(len, max_len + 1);
+    while (low + 1 < high) {
+        size_t mid = low + (high - low) / 2;
+        if (kr.equal(i, j, mid)) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+
+/**
+ * @brief Iterative computation of longest common extension (LCE) queries without recursion and hash tables.
+ *
+ * Each suffix is represented by the path from the root to the leaf deriving its first character. A path is stored in
+ * an array whose size is bounded by the height of the rlslp and which is allocated once on construction. Every entry
+ * of a path stores the non-terminal and the text position where it starts. The two paths are advanced in lockstep:
+ * if the highest non-terminals starting at the current positions are equal they are skipped, otherwise the longer one
+ * is replaced by its first child. Two aligned runs of the same block are skipped at once.
+ *
+ * The engine is not thread-safe since the paths are reused for all queries.
+ *
+ * @tparam variable_t The type of variables
+ */
+template<typename variable_t = var_t>
+class lce_engine {
+ public:
+    /**
+     * @brief Allocates the paths for the given rlslp. This computes the height of the rlslp, so the engine should be
+     * reused for all queries on the same rlslp.
+     *
+     * @param rlslp The rlslp
+     */
+    explicit lce_engine(const rlslp<variable_t>& rlslp) : slp(rlslp), path_i(rlslp.height() + 1),
+                                                           path_j(path_i.size()) {}
+
+    /**
+     * @brief Computes the length of the longest common prefix of the two given suffices.
+     *
+     * @param i The start position of the first suffix
+     * @param j The start position of the second suffix
+     * @return The length of the longest common prefix of the two given suffices
+     */
+    size_t query(size_t i, size_t j) {
+        if (slp.empty()) {
+            return 0;
+        }
+        const size_t n = slp.len(slp.root);
+        if (n <= i || n <= j) {
+            return 0;
+        }
+        if (i == j) {
+            return n - i;
+        }
+
+        cursor_t c_i{path_i, 0, 0, i};
+        cursor_t c_j{path_j, 0, 0, j};
+        init(c_i);
+        init(c_j);
+
+        size_t lce = 0;
+        while (true) {
+            const variable_t nt_i = c_i.path[c_i.cand].nt;
+            const variable_t nt_j = c_j.path[c_j.cand].nt;
+            if (nt_i == nt_j) {
+                size_t len = slp.len(nt_i);
+                if (c_i.cand > 0 && c_j.cand > 0) {
+                    // Two aligned runs of the same block
+                    const auto& parent_i = c_i.path[c_i.cand - 1];
+                    const auto& parent_j = c_j.path[c_j.cand - 1];
+                    if (slp.is_block(parent_i.nt) && slp.is_block(parent_j.nt)) {
+                        len = std::min(parent_i.start + slp.len(parent_i.nt) - c_i.pos,
+                                       parent_j.start + slp.len(parent_j.nt) - c_j.pos);
+                    }
+                }
+                lce += len;
+                if (!advance(c_i, len) || !advance(c_j, len)) {
+                    return lce;
+                }
+            } else if (slp.is_terminal(nt_i) && slp.is_terminal(nt_j)) {
+                return lce;
+            } else if (slp.len(nt_i) >= slp.len(nt_j) && !slp.is_terminal(nt_i)) {
+                c_i.cand++;
+            } else {
+                c_j.cand++;
+            }
+        }
+    }
+
+ private:
+    /**
+     * @brief A non-terminal on the path and the text position where it starts.
+     */
+    struct frame_t {
+        variable_t nt;
+        size_t start;
+    };
+
+    /**
+     * @brief A path from the root to a leaf, the depth of the leaf, the highest entry that starts at the current
+     * position and the current position.
+     */
+    struct cursor_t {
+        std::vector<frame_t>& path;
+        size_t depth;
+        size_t cand;
+        size_t pos;
+    };
+
+    const rlslp<variable_t>& slp;
+    std::vector<frame_t> path_i;
+    std::vector<frame_t> path_j;
+
+    inline void init(cursor_t& c) {
+        c.path[0] = frame_t{slp.root, 0};
+        c.depth = 0;
+        c.cand = 0;
+        descend(c, c.pos != 0);
+    }
+
+    /**
+     * @brief Extends the path down to the leaf of the current position and sets the candidate to the highest entry
+     * starting at the current position.
+     *
+     * @param c The cursor
+     * @param find_cand Whether the candidate has to be found below the current depth
+     */
+    inline void descend(cursor_t& c, bool find_cand) {
+        while (!slp.is_terminal(c.path[c.depth].nt)) {
+            const auto& parent = c.path[c.depth];
+            const auto& rule = slp[parent.nt - slp.terminals];
+            const size_t off = c.pos - parent.start;
+            const size_t first_len = slp.len(rule.first());
+            frame_t child;
+            if (slp.is_block(parent.nt)) {
+                child = frame_t{rule.first(), parent.start + (off / first_len) * first_len};
+            } else if (off < first_len) {
+                child = frame_t{rule.first(), parent.start};
+            } else {
+                child = frame_t{rule.second(), parent.start + first_len};
+            }
+            c.path[++c.depth] = child;
+            if (find_cand && child.start == c.pos) {
+                c.cand = c.depth;
+                find_cand = false;
+            }
+        }
+    }
+
+    /**
+     * @brief Moves the cursor by len positions. The current candidate must be covered by the skipped positions.
+     *
+     * @param c The cursor
+     * @param len The number of positions to skip
+     * @return @code{false} if the end of the text is reached, @code{true} otherwise
+     */
+    inline bool advance(cursor_t& c, size_t len) {
+        c.pos += len;
+        size_t d = c.cand;
+        while (c.pos >= c.path[d].start + slp.len(c.path[d].nt)) {
+            if (d == 0) {
+                return false;
+            }
+            d--;
+        }
+        c.depth = d;
+        descend(c, true);
+        return true;
+    }
+};
+
+/**
+ * @brief Computes the length of the longest common prefix of two given suffices (longest common extension, LCE)
+ * iteratively.
+ *
+ * The engine allocates the paths once for all queries on its rlslp, so the queries do not allocate memory.
+ *
+ * @tparam variable_t The type of variables
+ * @param engine The engine of the rlslp
+ * @param i The start position of the first suffix
+ * @param j The start position of the second suffix
+ * @return The length of the longest common prefix of the two given suffices
+ */
+template<typename variable_t = var_t>
+size_t lce_query_iterative(lce_engine<variable_t>& engine, size_t i, size_t j) {
+    trace_scope trace("lce_query_iterative", "query");
+    return engine.query(i, j);
+}
+
+
 /**
  * @brief Naive computation of a longest common extension query for two suffices.
  *
@@ -0,0 +1,454 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace recomp {
+
+/**
+ * @brief The memory statistics of a phase over all its executions.
+ */
+struct memory_phase_stats {
+    size_t calls = 0;    // the number of executions of the phase
+    size_t current = 0;  // the allocated bytes at the end of the last execution
+    size_t peak = 0;     // the maximal allocated bytes during an execution
+};
+
+/**
+ * @brief Accounts the currently allocated bytes, the peak and the peak of every phase.
+ *
+ * The bytes are reported either by an allocator (see @code{tracking_allocator}, which is used by @code{ui_vector} if
+ * @code{RECOMPRESSION_TRACK_MEMORY} is defined) or by an external counter via @code{set_current}, e.g. the callback of
+ * malloc_count. Only one of both should be used at the same time. Phases are marked with @code{memory_phase} and may be
+ * nested. The peak of a phase contains the memory of the enclosing phases that is still allocated.
+ *
+ * The bytes and the phases are global, so phases of concurrent computations (e.g. the jobs of the
+ * @code{batch_scheduler}) would interleave and contain the memory of each other. Threads running such computations
+ * skip their phases with @code{skip_memory_phases}; only the total bytes and the total peak are accounted for them.
+ */
+class memory_tracker {
+ public:
+    memory_tracker() = delete;
+
+    /**
+     * @brief Reports allocated bytes.
+     *
+     * @param bytes The number of bytes
+     */
+    static inline void allocate(size_t bytes) {
+        update_peak(state().current.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+    }
+
+    /**
+     * @brief Reports deallocated bytes.
+     *
+     * @param bytes The number of bytes
+     */
+    static inline void deallocate(size_t bytes) {
+        state().current.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sets the currently allocated bytes. Does not allocate memory, so it can be called from an allocation hook.
+     *
+     * @param bytes The number of bytes
+     */
+    static inline void set_current(size_t bytes) {
+        state().current.store(bytes, std::memory_order_relaxed);
+        update_peak(bytes);
+    }
+
+    /**
+     * @return The currently allocated bytes
+     */
+    static inline size_t current() {
+        return state().current.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return The peak of the allocated bytes since the last reset
+     */
+    static inline size_t peak() {
+        return state().peak.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Resets the peak to the currently allocated bytes and clears the statistics of the phases.
+     */
+    static inline void reset() {
+        auto& s = state();
+        const size_t bytes = s.current.load(std::memory_order_relaxed);
+        s.peak.store(bytes, std::memory_order_relaxed);
+        s.phase_peak.store(bytes, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> guard(s.mutex);
+        s.phases.clear();
+    }
+
+    /**
+     * @return The statistics of all phases executed since the last reset
+     */
+    static inline std::map<std::string, memory_phase_stats> phases() {
+        auto& s = state();
+        std::lock_guard<std::mutex> guard(s.mutex);
+        return s.phases;
+    }
+
+    /**
+     * @brief Prints one result line per phase executed since the last reset.
+     *
+     * @param out The stream to print to
+     * @param algo The name of the algorithm
+     * @param dataset The name of the dataset
+     */
+    static inline void print(std::ostream& out, const std::string& algo, const std::string& dataset) {
+        for (const auto& phase : phases()) {
+            out << "RESULT algo=" << algo << "_memory dataset=" << dataset << " phase=" << phase.first << " calls="
+                << phase.second.calls << " current=" << phase.second.current << " peak=" << phase.second.peak
+                << std::endl;
+        }
+        out << "RESULT algo=" << algo << "_memory dataset=" << dataset << " phase=total current=" << current()
+            << " peak=" << peak() << std::endl;
+    }
+
+ private:
+    friend class memory_phase;
+
+    struct state_t {
+        std::atomic<size_t> current{0};
+        std::atomic<size_t> peak{0};
+        std::atomic<size_t> phase_peak{0};
+        std::mutex mutex;
+        std::map<std::string, memory_phase_stats> phases;
+    };
+
+    static inline state_t& state() {
+        static state_t s;
+        return s;
+    }
+
+    static inline void atomic_max(std::atomic<size_t>& value, size_t bytes) {
+        size_t old = value.load(std::memory_order_relaxed);
+        while (old < bytes && !value.compare_exchange_weak(old, bytes, std::memory_order_relaxed)) {}
+    }
+
+    static inline void update_peak(size_t bytes) {
+        atomic_max(state().peak, bytes);
+        atomic_max(state().phase_peak, bytes);
+    }
+
+    /**
+     * @return Whether the phases started by the calling thread are skipped
+     */
+    static inline bool& phases_skipped() {
+        static thread_local bool skipped = false;
+        return skipped;
+    }
+
+    friend class skip_memory_phases;
+};
+
+/**
+ * @brief Skips the phases started by the calling thread until the end of the scope, e.g. in the jobs of the
+ * @code{batch_scheduler}.
+ */
+class skip_memory_phases {
+ public:
+    inline skip_memory_phases() : skipped(memory_tracker::phases_skipped()) {
+        memory_tracker::phases_skipped() = true;
+    }
+
+    skip_memory_phases(const skip_memory_phases&) = delete;
+
+    skip_memory_phases& operator=(const skip_memory_phases&) = delete;
+
+    inline ~skip_memory_phases() {
+        memory_tracker::phases_skipped() = skipped;
+    }
+
+ private:
+    const bool skipped;
+};
+
+/**
+ * @brief Marks a phase for the @code{memory_tracker} from its construction to its end or destruction. Phases must be
+ * started and ended by the same thread outside of parallel regions and must not run concurrently to other phases.
+ * Phases started while @code{skip_memory_phases} is active are not accounted and report the total peak.
+ *
+ * Printing a phase adds the fields @code{<name>_mem} and @code{<name>_mem_peak} with the currently allocated bytes and
+ * the peak since the start of the phase to a result line.
+ */
+class memory_phase {
+ public:
+    /**
+     * @brief Starts the phase.
+     *
+     * @param name The name of the phase
+     */
+    inline explicit memory_phase(const char* name) : name(name), skipped(memory_tracker::phases_skipped()) {
+        if (skipped) {
+            return;
+        }
+        auto& s = memory_tracker::state();
+        outer_peak = s.phase_peak.exchange(s.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    memory_phase(const memory_phase&) = delete;
+
+    memory_phase& operator=(const memory_phase&) = delete;
+
+    inline ~memory_phase() {
+        end();
+    }
+
+    /**
+     * @return The currently allocated bytes
+     */
+    inline size_t current() const {
+        return memory_tracker::current();
+    }
+
+    /**
+     * @return The peak of the allocated bytes since the start of the phase
+     */
+    inline size_t peak() const {
+        if (skipped) {
+            return memory_tracker::peak();
+        }
+        return ended ? end_peak : memory_tracker::state().phase_peak.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Ends the phase and adds it to the statistics of the tracker.
+     */
+    inline void end() {
+        if (ended || skipped) {
+            return;
+        }
+        ended = true;
+        auto& s = memory_tracker::state();
+        end_peak = s.phase_peak.load(std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> guard(s.mutex);
+            auto& stats = s.phases[name];
+            stats.calls++;
+            stats.current = s.current.load(std::memory_order_relaxed);
+            stats.peak = std::max(stats.peak, end_peak);
+        }
+        memory_tracker::atomic_max(s.phase_peak, outer_peak);
+    }
+
+    friend inline std::ostream& operator<<(std::ostream& out, const memory_phase& phase) {
+        return out << " " << phase.name << "_mem=" << phase.current() << " " << phase.name << "_mem_peak="
+                   << phase.peak();
+    }
+
+ private:
+    const char* name;
+    const bool skipped;
+    size_t outer_peak = 0;
+    size_t end_peak = 0;
+    bool ended = false;
+};
+
+/**
+ * @brief An allocator reporting the allocated bytes to the @code{memory_tracker}. The memory is allocated by the base
+ * allocator, so any custom allocator can be tracked.
+ *
+ * @tparam T The type of the elements
+ * @tparam base_allocator_t The allocator to allocate the memory with
+ */
+template<typename T, typename base_allocator_t = std::allocator<T>>
+class tracking_allocator : public base_allocator_t {
+    typedef std::allocator_traits<base_allocator_t> traits_t;
+
+ public:
+    typedef T value_type;
+
+    template<typename U>
+    struct rebind {
+        typedef tracking_allocator<U, typename traits_t::template rebind_alloc<U>> other;
+    };
+
+    inline tracking_allocator() = default;
+
+    template<typename U, typename base_u_t>
+    inline tracking_allocator(const tracking_allocator<U, base_u_t>& other) : base_allocator_t(other) {}
+
+    inline T* allocate(size_t n) {
+        T* ptr = traits_t::allocate(*this, n);
+        memory_tracker::allocate(n * sizeof(T));
+        return ptr;
+    }
+
+    inline void deallocate(T* ptr, size_t n) {
+        memory_tracker::deallocate(n * sizeof(T));
+        traits_t::deallocate(*this, ptr, n);
+    }
+};
+
+template<typename T, typename A, typename U, typename B>
+inline bool operator==(const tracking_allocator<T, A>& a, const tracking_allocator<U, B>& b) {
+    return static_cast<const A&>(a) == static_cast<const B&>(b);
+}
+
+template<typename T, typename A, typename U, typename B>
+inline bool operator!=(const tracking_allocator<T, A>& a, const tracking_allocator<U, B>& b) {
+    return !(a == b);
+}
+
+/**
+ * @brief A vector of uninitialized elements with the interface of @code{tlx::SimpleVector} whose memory is allocated
+ * by the given allocator. The elements must be trivially destructible.
+ *
+ * @tparam T The type of the elements
+ * @tparam allocator_t The allocator
+ */
+template<typename T, typename allocator_t = std::allocator<T>>
+class allocator_vector : private allocator_t {
+    static_assert(std::is_trivially_destructible<T>::value, "The elements must be trivially destructible");
+
+    typedef std::allocator_traits<allocator_t> traits_t;
+
+ public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef T& reference;
+    typedef const T& const_reference;
+
+    inline allocator_vector() = default;
+
+    inline explicit allocator_vector(size_type size) : size_(size) {
+        if (size_ > 0) {
+            array_ = traits_t::allocate(*this, size_);
+        }
+    }
+
+    allocator_vector(const allocator_vector&) = delete;
+
+    allocator_vector& operator=(const allocator_vector&) = delete;
+
+    inline allocator_vector(allocator_vector&& other) noexcept : allocator_t(std::move(other)), size_(other.size_),
+                                                                array_(other.array_) {
+        other.size_ = 0;
+        other.array_ = nullptr;
+    }
+
+    inline allocator_vector& operator=(allocator_vector&& other) noexcept {
+        if (&other != this) {
+            release();
+            size_ = other.size_;
+            array_ = other.array_;
+            other.size_ = 0;
+            other.array_ = nullptr;
+        }
+        return *this;
+    }
+
+    inline ~allocator_vector() {
+        release();
+    }
+
+    inline void swap(allocator_vector& other) noexcept {
+        std::swap(size_, other.size_);
+        std::swap(array_, other.array_);
+    }
+
+    inline size_type size() const noexcept {
+        return size_;
+    }
+
+    inline bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    inline iterator data() noexcept {
+        return array_;
+    }
+
+    inline const_iterator data() const noexcept {
+        return array_;
+    }
+
+    inline iterator begin() noexcept {
+        return array_;
+    }
+
+    inline const_iterator begin() const noexcept {
+        return array_;
+    }
+
+    inline const_iterator cbegin() const noexcept {
+        return array_;
+    }
+
+    inline iterator end() noexcept {
+        return array_ + size_;
+    }
+
+    inline const_iterator end() const noexcept {
+        return array_ + size_;
+    }
+
+    inline const_iterator cend() const noexcept {
+        return array_ + size_;
+    }
+
+    inline reference operator[](size_type i) noexcept {
+        return array_[i];
+    }
+
+    inline const_reference operator[](size_type i) const noexcept {
+        return array_[i];
+    }
+
+    inline reference at(size_type i) noexcept {
+        return array_[i];
+    }
+
+    /**
+     * @brief Reallocates the vector and keeps the first @code{min(size(), new_size)} elements.
+     *
+     * @param new_size The new size
+     */
+    inline void resize(size_type new_size) {
+        T* array = (new_size > 0) ? traits_t::allocate(*this, new_size) : nullptr;
+        if (array_) {
+            std::move(array_, array_ + std::min(size_, new_size), array);
+        }
+        release();
+        array_ = array;
+        size_ = new_size;
+    }
+
+    inline void fill(const value_type& value = value_type()) noexcept {
+        std::fill(array_, array_ + size_, value);
+    }
+
+ private:
+    size_type size_ = 0;
+    T* array_ = nullptr;
+
+    inline void release() {
+        if (array_) {
+            traits_t::deallocate(*this, array_, size_);
+            array_ = nullptr;
+        }
+    }
+};
+
+template<typename T, typename A>
+inline bool operator==(const allocator_vector<T, A>& vec1, const allocator_vector<T, A>& vec2) {
+    return vec1.size() == vec2.size() && std::equal(vec1.begin(), vec1.end(), vec2.begin());
+}
+
+}  // namespace recomp
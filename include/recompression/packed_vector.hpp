@@ -0,0 +1,189 @@
+#pragma once
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include "defs.hpp"
+#include "util.hpp"
+
+namespace recomp {
+
+/**
+ * @brief A vector storing integers with a fixed number of bits per element.
+ *
+ * The elements are stored consecutively in 64 bit words. An element may span two words. The width can be chosen
+ * between 1 and 64 bits. Since 64 elements always fill exactly @code{width} words the vector is packed and unpacked
+ * in parallel with chunks of 64 elements such that no two threads write to the same word.
+ *
+ * @tparam value_t The type of the elements
+ */
+template<typename value_t = var_t>
+class packed_vector {
+ public:
+    typedef std::uint64_t word_t;
+
+ private:
+    static const uint8_t WORD_BITS = 64;
+
+    ui_vector<word_t> words;
+    size_t n = 0;
+    uint8_t bits = 1;
+    word_t mask = 1;
+
+    static inline size_t words_for(size_t size, uint8_t width) {
+        return (size * width + WORD_BITS - 1) / WORD_BITS;
+    }
+
+    /**
+     * @brief Computes the range of elements of the given thread. The ranges start at multiples of 64.
+     */
+    inline std::pair<size_t, size_t> chunk(size_t thread_id, size_t n_threads) const {
+        size_t blocks = (n + WORD_BITS - 1) / WORD_BITS;
+        size_t begin = std::min(n, thread_id * blocks / n_threads * WORD_BITS);
+        size_t end = std::min(n, (thread_id + 1) * blocks / n_threads * WORD_BITS);
+        return std::make_pair(begin, end);
+    }
+
+ public:
+    inline packed_vector() = default;
+
+    /**
+     * @brief Constructs a vector of the given size and width. The elements are initialized with 0.
+     *
+     * @param size The number of elements
+     * @param width The number of bits per element
+     */
+    inline packed_vector(size_t size, uint8_t width) {
+        resize(size, width);
+    }
+
+    inline packed_vector(packed_vector&& vector) = default;
+
+    inline packed_vector& operator=(packed_vector&& vector) = default;
+
+    packed_vector(const packed_vector&) = delete;
+
+    packed_vector& operator=(const packed_vector&) = delete;
+
+    /**
+     * @brief Computes the minimal width to store all values between 0 and @code{max_value}.
+     *
+     * @param max_value The greatest value to store
+     * @return The number of bits per element
+     */
+    static inline uint8_t width_for(size_t max_value) {
+        return util::bits_for(max_value);
+    }
+
+    inline size_t size() const {
+        return n;
+    }
+
+    inline bool empty() const {
+        return n == 0;
+    }
+
+    inline uint8_t width() const {
+        return bits;
+    }
+
+    /**
+     * @brief Returns the number of bytes used for the elements.
+     *
+     * @return The memory of the packed elements in bytes
+     */
+    inline size_t bytes() const {
+        return words.size() * sizeof(word_t);
+    }
+
+    /**
+     * @brief Resizes the vector to the given size and width. All elements are set to 0.
+     *
+     * @param size The number of elements
+     * @param width The number of bits per element
+     */
+    inline void resize(size_t size, uint8_t width) {
+        n = size;
+        bits = width;
+        mask = (width == WORD_BITS) ? ~word_t(0) : (word_t(1) << width) - 1;
+        words.resize(words_for(size, width));
+        words.fill(0);
+    }
+
+    inline value_t get(size_t i) const {
+        const size_t pos = i * bits;
+        const size_t word = pos / WORD_BITS;
+        const size_t offset = pos % WORD_BITS;
+        word_t value = words[word] >> offset;
+        if (offset + bits > WORD_BITS) {
+            value |= words[word + 1] << (WORD_BITS - offset);
+        }
+        return static_cast<value_t>(value & mask);
+    }
+
+    inline void set(size_t i, value_t value) {
+        const size_t pos = i * bits;
+        const size_t word = pos / WORD_BITS;
+        const size_t offset = pos % WORD_BITS;
+        const word_t val = static_cast<word_t>(value) & mask;
+        words[word] = (words[word] & ~(mask << offset)) | (val << offset);
+        if (offset + bits > WORD_BITS) {
+            const size_t shift = WORD_BITS - offset;
+            words[word + 1] = (words[word + 1] & ~(mask >> shift)) | (val >> shift);
+        }
+    }
+
+    inline value_t operator[](size_t i) const {
+        return get(i);
+    }
+
+    /**
+     * @brief Packs the given text with the given width. The values of the text must be less than 2^width.
+     *
+     * @param text The text to pack
+     * @param width The number of bits per element
+     * @param cores The number of cores to use
+     */
+    inline void pack(const ui_vector<value_t>& text, uint8_t width, size_t cores = 1) {
+        resize(text.size(), width);
+
+#pragma omp parallel num_threads(cores)
+        {
+            auto range = chunk(omp_get_thread_num(), omp_get_num_threads());
+            for (size_t i = range.first; i < range.second; ++i) {
+                set(i, text[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Unpacks all elements into the given text. The text is resized to the size of this vector.
+     *
+     * @param text[out] The unpacked text
+     * @param cores The number of cores to use
+     */
+    inline void unpack(ui_vector<value_t>& text, size_t cores = 1) const {
+        text.resize(n);
+
+#pragma omp parallel num_threads(cores)
+        {
+            auto range = chunk(omp_get_thread_num(), omp_get_num_threads());
+            for (size_t i = range.first; i < range.second; ++i) {
+                text[i] = get(i);
+            }
+        }
+    }
+
+    /**
+     * @brief Frees the memory of the elements.
+     */
+    inline void clear() {
+        n = 0;
+        words.resize(0);
+    }
+};
+
+}  // namespace recomp
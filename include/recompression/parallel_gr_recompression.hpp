@@ -6,6 +6,7 @@
 #include "parallel_rnd_recompression.hpp"
 #include "defs.hpp"
 #include "util.hpp"
+#include "random.hpp"
 #include "rlslp.hpp"
 
 namespace recomp {
@@ -40,6 +41,13 @@ class parallel_gr_recompression : public parallel_rnd_recompression<variable_t>
 
 
  protected:
+    /**
+     * @brief The single region only computes the partitions of parallel and parallel_rnd.
+     */
+    inline virtual bool supports_single_region() const override {
+        return false;
+    }
+
     /**
      * @brief Computes a partitioning (Sigma_l, Sigma_r) of the symbols in the text.
      *
@@ -53,6 +61,8 @@ class parallel_gr_recompression : public parallel_rnd_recompression<variable_t>
                                           partition_t& partition,
                                           bool& part_l,
                                           variable_t minimum) override {
+        memory_phase mem_partition("partition");
+        trace_scope trace("partition");
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
@@ -70,16 +80,7 @@ class parallel_gr_recompression : public parallel_rnd_recompression<variable_t>
 #endif
         partition[0] = 0;  // ensure, that minimum one symbol is in the left partition and one in the right
         partition[partition.size() - 1] = 1;
-#pragma omp parallel num_threads(this->cores)
-        {
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<uint8_t> distribution(0, 1);
-#pragma omp for schedule(static)
-            for (size_t i = 1; i < partition.size() - 1; ++i) {
-                partition[i] = (distribution(gen) == 1);
-            }
-        }
+        counter_rng(this->seed, this->level).fill(partition, 1, partition.size() - 1, this->cores);
 #ifdef BENCH
         const auto endTimePar = recomp::timer::now();
         const auto timeSpanPar = endTimePar - startTimePar;
@@ -126,8 +127,8 @@ class parallel_gr_recompression : public parallel_rnd_recompression<variable_t>
                 }
             }
 
-            int l_count = 0;
-            int r_count = 0;
+            size_t l_count = 0;
+            size_t r_count = 0;
             for (; i < bounds[thread_id + 1]; ++i) {
                 auto text_i = text[adj_list[i]] - minimum;
                 auto text_i1 = text[adj_list[i] + 1] - minimum;
@@ -164,10 +165,10 @@ class parallel_gr_recompression : public parallel_rnd_recompression<variable_t>
         const auto startTimeCount = recomp::timer::now();
 #endif
 
-        int lr_count = 0;
-        int rl_count = 0;
-        int prod_l = 0;
-        int prod_r = 0;
+        size_t lr_count = 0;
+        size_t rl_count = 0;
+        size_t prod_l = 0;
+        size_t prod_r = 0;
 #pragma omp parallel num_threads(this->cores) reduction(+:lr_count) reduction(+:rl_count) reduction(+:prod_r) reduction(+:prod_l)
         {
             auto thread_id = omp_get_thread_num();
@@ -220,7 +221,8 @@ class parallel_gr_recompression : public parallel_rnd_recompression<variable_t>
                   << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanCount).count();
         const auto endTime = recomp::timer::now();
         const auto timeSpan = endTime - startTime;
-        std::cout << " partition=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count();
+        std::cout << " partition=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                  << mem_partition;
 #endif
     }
 };
@@ -0,0 +1,375 @@
+#pragma once
+
+#include <omp.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "defs.hpp"
+
+namespace recomp {
+
+/**
+ * The schedules of the parallel loops.
+ *
+ * STATIC splits the iterations into one contiguous range per thread (like @code{schedule(static)}).
+ * WORK_STEALING starts with the same ranges, but threads take adaptively sized chunks from their range and idle
+ * threads steal the second half of the remaining iterations of other threads.
+ */
+enum loop_schedule_t {
+    STATIC = 0,
+    WORK_STEALING = 1
+};
+
+inline std::string to_string(loop_schedule_t schedule) {
+    return schedule == WORK_STEALING ? "work_stealing" : "static";
+}
+
+namespace loop {
+
+/**
+ * @brief The remaining iterations of a thread. The range is protected by a spin lock and padded to a cache line. The
+ * epoch counts the loops the range was initialized for, so that ranges of different loops are never mixed.
+ */
+struct steal_range {
+    std::atomic<bool> locked;
+    size_t begin;
+    size_t end;
+    size_t epoch;
+    char padding[64 - 4 * sizeof(size_t)];
+
+    inline void lock() {
+        while (locked.exchange(true, std::memory_order_acquire)) {
+        }
+    }
+
+    inline void unlock() {
+        locked.store(false, std::memory_order_release);
+    }
+
+    /**
+     * @brief Takes the next chunk of the range. The chunk size decreases with the remaining iterations.
+     *
+     * @return @code{false} if the range is empty, @code{true} otherwise
+     */
+    inline bool take(size_t& lo, size_t& hi, size_t grain) {
+        lock();
+        const size_t remaining = end - begin;
+        if (remaining == 0) {
+            unlock();
+            return false;
+        }
+        const size_t chunk = std::min(remaining, std::max(grain, remaining / 8));
+        lo = begin;
+        hi = begin + chunk;
+        begin = hi;
+        unlock();
+        return true;
+    }
+
+    /**
+     * @brief Moves the second half of the remaining iterations of this range to the given (empty) range.
+     *
+     * @return @code{false} if there are too few iterations to steal or the range belongs to another loop,
+     * @code{true} otherwise
+     */
+    inline bool steal(steal_range& thief, size_t grain, size_t epoch) {
+        lock();
+        const size_t remaining = end - begin;
+        if (this->epoch != epoch || remaining <= grain) {
+            unlock();
+            return false;
+        }
+        const size_t mid = begin + remaining / 2;
+        const size_t stolen_end = end;
+        end = mid;
+        unlock();
+
+        thief.lock();
+        thief.begin = mid;
+        thief.end = stolen_end;
+        thief.unlock();
+        return true;
+    }
+};
+
+}  // namespace loop
+
+/**
+ * @brief Distributes the parts [0, parts) of a loop among the threads of the enclosing parallel region, so that the
+ * loops of a phase can use the work-stealing schedule without starting another parallel region. Every thread of the
+ * region calls @code{for_each} with the same number of parts; there is no barrier at its end.
+ *
+ * STATIC gives every thread a contiguous range of parts. WORK_STEALING starts with the same ranges and idle threads
+ * steal the second half of the remaining parts of other threads.
+ */
+class part_scheduler {
+ public:
+    /**
+     * The number of parts per thread with the work-stealing schedule.
+     */
+    static constexpr size_t PARTS_PER_THREAD = 8;
+
+    /**
+     * @param cores The maximal number of threads of the regions using the scheduler
+     * @param schedule The schedule
+     */
+    inline part_scheduler(size_t cores, loop_schedule_t schedule)
+            : schedule(schedule), ranges(new loop::steal_range[std::max(cores, static_cast<size_t>(1))]) {
+        for (size_t i = 0; i < std::max(cores, static_cast<size_t>(1)); ++i) {
+            ranges[i].locked.store(false);
+            ranges[i].begin = 0;
+            ranges[i].end = 0;
+            ranges[i].epoch = 0;
+        }
+    }
+
+    /**
+     * @brief Computes the number of parts to split a loop into.
+     *
+     * @param n_threads The number of threads of the region
+     * @return The number of parts
+     */
+    inline size_t parts(size_t n_threads) const {
+        return (schedule == WORK_STEALING && n_threads > 1) ? n_threads * PARTS_PER_THREAD : n_threads;
+    }
+
+    /**
+     * @brief Executes @code{f(part)} for every part in [0, parts) exactly once. Must be called by every thread of the
+     * enclosing parallel region.
+     *
+     * @param parts The number of parts
+     * @param f The function processing a part
+     */
+    template<typename function_t>
+    inline void for_each(size_t parts, function_t f) {
+        auto thread_id = static_cast<size_t>(omp_get_thread_num());
+        auto n_threads = static_cast<size_t>(omp_get_num_threads());
+        const size_t from = parts * thread_id / n_threads;
+        const size_t to = parts * (thread_id + 1) / n_threads;
+        if (schedule == STATIC || n_threads <= 1) {
+            for (size_t part = from; part < to; ++part) {
+                f(part);
+            }
+            return;
+        }
+
+        // the ranges are reinitialized by their owners, so only ranges of the same loop (epoch) are stolen from
+        loop::steal_range& own = ranges[thread_id];
+        own.lock();
+        own.begin = from;
+        own.end = to;
+        const size_t epoch = ++own.epoch;
+        own.unlock();
+
+        size_t lo;
+        size_t hi;
+        while (true) {
+            if (own.take(lo, hi, 1)) {
+                for (size_t part = lo; part < hi; ++part) {
+                    f(part);
+                }
+                continue;
+            }
+            bool stolen = false;
+            for (size_t k = 1; k < n_threads && !stolen; ++k) {
+                stolen = ranges[(thread_id + k) % n_threads].steal(own, 1, epoch);
+            }
+            if (!stolen) {
+                break;
+            }
+        }
+    }
+
+ private:
+    loop_schedule_t schedule;
+    std::unique_ptr<loop::steal_range[]> ranges;
+};
+
+/**
+ * @brief Measures the synchronization cost of the parallel regions of a phase: the time until the last thread of a
+ * region started (fork), the number of explicit barriers of the region and the average time a thread waits in them
+ * and the time from the last thread leaving the region until the region is joined (join).
+ *
+ * The master calls @code{begin} before and @code{end} after a region, every thread of the region calls @code{enter}
+ * first and @code{leave} last and uses @code{barrier} instead of @code{#pragma omp barrier}. Regions must not be
+ * nested. A region spanning several phases reports the barriers of each phase with @code{collect}. An inactive timer
+ * only executes the barriers.
+ */
+class sync_timer {
+ public:
+    /**
+     * @brief Clears the measured times.
+     *
+     * @param active Whether to measure the following regions
+     */
+    inline void reset(bool active) {
+        this->active = active;
+        regions = 0;
+        barriers = 0;
+        fork_ns = 0;
+        barrier_ns = 0;
+        join_ns = 0;
+    }
+
+    inline void begin() {
+        if (active) {
+            start = now();
+            last_enter.store(start, std::memory_order_relaxed);
+            last_leave.store(start, std::memory_order_relaxed);
+            wait.store(0, std::memory_order_relaxed);
+            passed.store(0, std::memory_order_relaxed);
+            threads.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    inline void enter() {
+        if (active) {
+            update_max(last_enter, now());
+            threads.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    inline void barrier() {
+        if (!active) {
+#pragma omp barrier
+            return;
+        }
+        const auto before = now();
+#pragma omp barrier
+        wait.fetch_add(now() - before, std::memory_order_relaxed);
+        passed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline void leave() {
+        if (active) {
+            update_max(last_leave, now());
+        }
+    }
+
+    inline void end() {
+        if (active) {
+            const auto joined = now();
+            regions++;
+            fork_ns += last_enter.load(std::memory_order_relaxed) - start;
+            join_ns += joined - last_leave.load(std::memory_order_relaxed);
+            collect();
+        }
+    }
+
+    /**
+     * @brief Adds the barriers of the current region since the last call to the measured barriers. Called by a single
+     * thread of the region after all threads added the waits of their last barrier, i.e. after another barrier.
+     */
+    inline void collect() {
+        if (active) {
+            const auto n_threads = std::max(threads.load(std::memory_order_relaxed), static_cast<std::uint64_t>(1));
+            barriers += passed.exchange(0, std::memory_order_relaxed) / n_threads;
+            barrier_ns += wait.exchange(0, std::memory_order_relaxed) / n_threads;
+        }
+    }
+
+    size_t regions = 0;            // the number of measured regions
+    size_t barriers = 0;           // the number of explicit barriers of the measured regions
+    std::uint64_t fork_ns = 0;     // the summed time until the last thread of a region started
+    std::uint64_t barrier_ns = 0;  // the summed average time of a thread in the barriers of a region
+    std::uint64_t join_ns = 0;     // the summed time from the last thread leaving a region until its join
+
+ private:
+    bool active = false;
+    std::uint64_t start = 0;
+    std::atomic<std::uint64_t> last_enter{0};
+    std::atomic<std::uint64_t> last_leave{0};
+    std::atomic<std::uint64_t> wait{0};
+    std::atomic<std::uint64_t> passed{0};
+    std::atomic<std::uint64_t> threads{0};
+
+    static inline std::uint64_t now() {
+        return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(timer::now().time_since_epoch()).count());
+    }
+
+    static inline void update_max(std::atomic<std::uint64_t>& value, std::uint64_t time) {
+        auto current = value.load(std::memory_order_relaxed);
+        while (current < time && !value.compare_exchange_weak(current, time, std::memory_order_relaxed)) {
+        }
+    }
+};
+
+namespace loop {
+
+/**
+ * @brief Computes the number of elements of the sorted range a among the first k elements of the merge of the sorted
+ * ranges a and b, where equal elements of a precede the ones of b.
+ */
+template<typename value_t, typename compare_t>
+inline size_t co_rank(const value_t* a, size_t a_len, const value_t* b, size_t b_len, size_t k, compare_t& comp) {
+    size_t lo = k > b_len ? k - b_len : 0;
+    size_t hi = std::min(k, a_len);
+    while (lo < hi) {
+        const size_t i = lo + (hi - lo) / 2;
+        if (comp(b[k - i - 1], a[i])) {
+            hi = i;
+        } else {
+            lo = i + 1;
+        }
+    }
+    return lo;
+}
+
+}  // namespace loop
+
+/**
+ * @brief Sorts the given elements with the threads of the enclosing parallel region, so that a phase can sort without
+ * starting another parallel region (like @code{ips4o::parallel::sort} does). Every thread sorts a contiguous part,
+ * then the sorted parts are merged pairwise in log2(threads) rounds. Each merge is split evenly among the threads of
+ * its parts.
+ *
+ * Must be called by every thread of the region with the same arguments. Ends with a barrier.
+ *
+ * @param data[in,out] The elements
+ * @param buffer[out] A buffer for at least n elements
+ * @param n The number of elements
+ * @param comp The comparator
+ * @param sync The timer of the barriers
+ */
+template<typename value_t, typename compare_t>
+inline void region_sort(value_t* data, value_t* buffer, size_t n, compare_t comp, sync_timer& sync) {
+    auto thread_id = static_cast<size_t>(omp_get_thread_num());
+    auto n_threads = static_cast<size_t>(omp_get_num_threads());
+    auto bound = [&](size_t part) {
+        return n * part / n_threads;
+    };
+    std::sort(data + bound(thread_id), data + bound(thread_id + 1), comp);
+    sync.barrier();
+
+    value_t* from = data;
+    value_t* to = buffer;
+    for (size_t width = 1; width < n_threads; width *= 2) {
+        const size_t first = thread_id / (2 * width) * (2 * width);
+        const size_t mid = std::min(first + width, n_threads);
+        const size_t last = std::min(first + 2 * width, n_threads);
+        const value_t* a = from + bound(first);
+        const value_t* b = from + bound(mid);
+        const size_t a_len = bound(mid) - bound(first);
+        const size_t b_len = bound(last) - bound(mid);
+        const size_t k_begin = (a_len + b_len) * (thread_id - first) / (last - first);
+        const size_t k_end = (a_len + b_len) * (thread_id - first + 1) / (last - first);
+        const size_t i_begin = loop::co_rank(a, a_len, b, b_len, k_begin, comp);
+        const size_t i_end = loop::co_rank(a, a_len, b, b_len, k_end, comp);
+        std::merge(a + i_begin, a + i_end, b + (k_begin - i_begin), b + (k_end - i_end), to + bound(first) + k_begin,
+                   comp);
+        sync.barrier();
+        std::swap(from, to);
+    }
+    if (from != data) {
+        std::copy(from + bound(thread_id), from + bound(thread_id + 1), data + bound(thread_id));
+        sync.barrier();
+    }
+}
+
+}  // namespace recomp
@@ -16,6 +16,7 @@
 #include "defs.hpp"
 #include "util.hpp"
 #include "rlslp.hpp"
+#include "bit_partition.hpp"
 
 namespace recomp {
 
@@ -51,6 +52,72 @@ class parallel_lp_recompression : public parallel_recompression<variable_t> {
 
 
  protected:
+    /**
+     * @brief The single region only computes the partitions of parallel and parallel_rnd.
+     */
+    inline virtual bool supports_single_region() const override {
+        return false;
+    }
+
+    /**
+     * The distance of the adjacency list entries whose text positions are prefetched in the directed cut.
+     */
+    const size_t PREFETCH_DISTANCE = 16;
+
+    /**
+     * @brief Compares the pairs at the given text positions by their larger and then by their smaller symbol. Of two
+     * pairs with the same symbols the one with the larger symbol first is the smaller one, so the pairs of both
+     * directions are adjacent but not mixed.
+     *
+     * @param text[in] The text
+     * @param i The position of the first pair
+     * @param j The position of the second pair
+     * @return Whether the first pair is less than the second one
+     */
+    static inline bool oriented_adj_less(const text_t& text, size_t i, size_t j) {
+        auto char_i = text[i];
+        auto char_i1 = text[i + 1];
+        auto char_j = text[j];
+        auto char_j1 = text[j + 1];
+        if (char_i > char_i1) {
+            if (char_j > char_j1) {
+                bool less = char_i < char_j;
+                if (char_i == char_j) {
+                    less = char_i1 < char_j1;
+                }
+                return less;
+            } else {
+                // char_j1 > char_j -> (char_i, char_i1, 0) (char_j1, char_j, 1)
+                bool less = char_i < char_j1;
+                if (char_i == char_j1) {
+                    if (char_i1 == char_j) {
+                        return true;
+                    }
+                    less = char_i1 < char_j;
+                }
+                return less;
+            }
+        } else {
+            if (char_j > char_j1) {
+                // char_i1 > char_i -> (char_i1, char_i, 1) (char_j, char_j1, 0)
+                bool less = char_i1 < char_j;
+                if (char_i1 == char_j) {
+                    if (char_i == char_j1) {
+                        return false;
+                    }
+                    less = char_i < char_j1;
+                }
+                return less;
+            } else {
+                bool less = char_i1 < char_j1;
+                if (char_i1 == char_j1) {
+                    less = char_i < char_j;
+                }
+                return less;
+            }
+        }
+    }
+
     /**
      * @brief Computes and sorts the adjacency list of the text in ascending order.
      *
@@ -60,14 +127,23 @@ class parallel_lp_recompression : public parallel_recompression<variable_t> {
      * @param adj_list[out] The adjacency list (represented as text positions)
      */
     inline virtual void compute_adj_list(const text_t& text, adj_list_t& adj_list) override {
+        memory_phase mem_adj_list("adj_list");
+        trace_scope trace("adj_list");
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
 
-#pragma omp parallel for schedule(static) num_threads(this->cores)
-        for (size_t i = 0; i < adj_list.size(); ++i) {
-            adj_list[i] = i;
+        this->sync.begin();
+#pragma omp parallel num_threads(this->cores)
+        {
+            this->sync.enter();
+#pragma omp for schedule(static) nowait
+            for (size_t i = 0; i < adj_list.size(); ++i) {
+                adj_list[i] = i;
+            }
+            this->sync.leave();
         }
+        this->sync.end();
 
 #ifdef BENCH
         const auto endTime = recomp::timer::now();
@@ -76,54 +152,15 @@ class parallel_lp_recompression : public parallel_recompression<variable_t> {
         const auto startTimeMult = recomp::timer::now();
 #endif
         auto sort_adj = [&](size_t i, size_t j) {
-            auto char_i = text[i];
-            auto char_i1 = text[i + 1];
-            auto char_j = text[j];
-            auto char_j1 = text[j + 1];
-            if (char_i > char_i1) {
-                if (char_j > char_j1) {
-                    bool less = char_i < char_j;
-                    if (char_i == char_j) {
-                        less = char_i1 < char_j1;
-                    }
-                    return less;
-                } else {
-                    // char_j1 > char_j -> (char_i, char_i1, 0) (char_j1, char_j, 1)
-                    bool less = char_i < char_j1;
-                    if (char_i == char_j1) {
-                        if (char_i1 == char_j) {
-                            return true;
-                        }
-                        less = char_i1 < char_j;
-                    }
-                    return less;
-                }
-            } else {
-                if (char_j > char_j1) {
-                    // char_i1 > char_i -> (char_i1, char_i, 1) (char_j, char_j1, 0)
-                    bool less = char_i1 < char_j;
-                    if (char_i1 == char_j) {
-                        if (char_i == char_j1) {
-                            return false;
-                        }
-                        less = char_i < char_j1;
-                    }
-                    return less;
-                } else {
-                    bool less = char_i1 < char_j1;
-                    if (char_i1 == char_j1) {
-                        less = char_i < char_j;
-                    }
-                    return less;
-                }
-            }
+            return oriented_adj_less(text, i, j);
         };
         ips4o::parallel::sort(adj_list.begin(), adj_list.end(), sort_adj, this->cores);
 #ifdef BENCH
         const auto endTimeMult = recomp::timer::now();
         const auto timeSpanMult = endTimeMult - startTimeMult;
         std::cout << " sort_adj_list="
-                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanMult).count());
+                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanMult).count())
+                  << mem_adj_list;
 #endif
     }
 
@@ -144,16 +181,20 @@ class parallel_lp_recompression : public parallel_recompression<variable_t> {
                                      adj_list_t& adj_list,
                                      bool& part_l,
                                      variable_t minimum) override {
+        trace_scope trace("directed_cut");
 #ifdef BENCH
         const auto startTimeCount = recomp::timer::now();
 #endif
-        int lr_count = 0;
-        int rl_count = 0;
-        int prod_l = 0;
-        int prod_r = 0;
+        size_t lr_count = 0;
+        size_t rl_count = 0;
+        size_t prod_l = 0;
+        size_t prod_r = 0;
+        bit_partition bits(partition, this->cores);
         ui_vector<size_t> bounds;
+        this->sync.begin();
 #pragma omp parallel num_threads(this->cores) reduction(+:lr_count) reduction(+:rl_count) reduction(+:prod_r) reduction(+:prod_l)
         {
+            this->sync.enter();
             auto thread_id = omp_get_thread_num();
             auto n_threads = static_cast<size_t>(omp_get_num_threads());
 
@@ -176,10 +217,10 @@ class parallel_lp_recompression : public parallel_recompression<variable_t> {
             if (i == 0) {
                 last_i = text[adj_list[i]] - minimum;
                 last_i1 = text[adj_list[i] + 1] - minimum;
-                if (!partition[last_i] && partition[last_i1]) {
+                if (!bits[last_i] && bits[last_i1]) {
                     lr_count++;
                     prod_l++;
-                } else if (partition[last_i] && !partition[last_i1]) {
+                } else if (bits[last_i] && !bits[last_i1]) {
                     rl_count++;
                     prod_r++;
                 }
@@ -190,14 +231,17 @@ class parallel_lp_recompression : public parallel_recompression<variable_t> {
             }
 
             for (; i < bounds[thread_id + 1]; ++i) {
+                if (i + PREFETCH_DISTANCE < bounds[thread_id + 1]) {
+                    __builtin_prefetch(text.data() + adj_list[i + PREFETCH_DISTANCE]);
+                }
                 variable_t char_i = text[adj_list[i]] - minimum;
                 variable_t char_i1 = text[adj_list[i] + 1] - minimum;
-                if (!partition[char_i] && partition[char_i1]) {
+                if (!bits[char_i] && bits[char_i1]) {
                     lr_count++;
                     if (char_i != last_i || char_i1 != last_i1) {
                         prod_l++;
                     }
-                } else if (partition[char_i] && !partition[char_i1]) {
+                } else if (bits[char_i] && !bits[char_i1]) {
                     rl_count++;
                     if (char_i != last_i || char_i1 != last_i1) {
                         prod_r++;
@@ -206,7 +250,9 @@ class parallel_lp_recompression : public parallel_recompression<variable_t> {
                 last_i = char_i;
                 last_i1 = char_i1;
             }
+            this->sync.leave();
         }
+        this->sync.end();
 
         part_l = rl_count > lr_count;
         // If number of pairs are the same, choose that one that generates fewer productions
@@ -7,7 +7,6 @@
 #include <algorithm>
 #include <chrono>
 #include <iostream>
-#include <random>
 #include <string>
 #include <thread>
 #include <tuple>
@@ -19,17 +18,57 @@
 #include "parallel_rnd_recompression.hpp"
 #include "defs.hpp"
 #include "util.hpp"
+#include "random.hpp"
 #include "rlslp.hpp"
 
 namespace recomp {
 
 namespace parallel {
 
+/**
+ * @brief The configuration of the local search of @code{parallel_ls_recompression}.
+ */
+struct local_search_config {
+    /**
+     * The update modes. In the Jacobi mode all symbols are flipped simultaneously based on the gains of the previous
+     * partition. In the residue class mode the symbols are split by their residue modulo the number of classes, the
+     * classes are updated one after another and the gains are recomputed after each class. The classes are not a
+     * coloring of the adjacency graph, so adjacent symbols of the same class still flip together.
+     */
+    enum mode_t {
+        JACOBI,
+        RESIDUE_CLASSES
+    };
+
+    /**
+     * The maximum number of passes.
+     */
+    size_t passes = 1;
+
+    mode_t mode = JACOBI;
+
+    /**
+     * The number of classes in the residue class mode.
+     */
+    size_t classes = 2;
+
+    /**
+     * The search stops if the cut grows by at most min_gain * (number of pairs) pairs in a pass.
+     */
+    double min_gain = 0.0;
+
+    /**
+     * The time budget of the local search per level in milliseconds (0 means unlimited).
+     */
+    size_t time_budget = 0;
+};
+
 /**
  * @brief This class is a parallel implementation of the recompression computing the undirected maximum cut using local
  * search based on a random partition.
  *
- * Counts also the number of new generated production rules like parallel_lp_recompression.
+ * Counts also the number of new generated production rules like parallel_lp_recompression. The number of passes of
+ * the local search, the update mode and the stopping criteria are configured by a @code{local_search_config}.
  *
  * @tparam variable_t The type of non-terminals
  */
@@ -51,25 +90,37 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
         this->name = "parallel_ls";
     }
 
+    inline parallel_ls_recompression(std::string& dataset, const local_search_config& config)
+            : parallel_rnd_recompression<variable_t>(dataset), ls_config(config) {
+        this->name = "parallel_ls";
+    }
+
     inline virtual void recomp(text_t& text,
                                rlslp<variable_t>& rlslp,
                                const size_t& alphabet_size,
                                const size_t cores) override {
+        trace_scope trace("recompression", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         size_t text_size = text.size();
 #endif
-        this->cores = cores;
         rlslp.terminals = alphabet_size;
         bv_t bv;
 
-        while (text.size() > 1) {
-            this->bcomp(text, rlslp, bv);
-            this->level++;
-
-            if (text.size() > 1) {
-                pcomp(text, rlslp, bv);
+        {
+            typename recompression<variable_t>::cores_guard guard(*this, cores);
+            while (text.size() > 1) {
+                this->begin_round(text.size(), cores);
+                this->bcomp(text, rlslp, bv);
+                this->end_round();
                 this->level++;
+
+                if (text.size() > 1) {
+                    this->begin_round(text.size(), cores);
+                    pcomp(text, rlslp, bv);
+                    this->end_round();
+                    this->level++;
+                }
             }
         }
 
@@ -95,12 +146,14 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
  protected:
     const variable_t DELETED = std::numeric_limits<variable_t>::max();
 
+    local_search_config ls_config;
+
     /**
      * @brief Compacts the text by copying the symbols.
      *
      * @param text[in,out] The text
-     * @param compact_bounds[in] The bounds for the cores to copy from
-     * @param copy_bounds[in] The bounds for the cores to copy to
+     * @param compact_bounds[in] The bounds of the parts of the text to copy from
+     * @param copy_bounds[in] The bounds of the parts of the text to copy to
      * @param count[in] The number of found blocks/pairs
      * @param mapping[in] The mapping of the effective alphabet to the replaced symbols
      */
@@ -109,6 +162,8 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
                         const ui_vector<size_t>& copy_bounds,
                         size_t count,
                         const ui_vector<variable_t>& mapping) {
+        memory_phase mem_compact("compact");
+        trace_scope trace("compact");
 #ifdef BENCH
         const auto startTimeCompact = recomp::timer::now();
 #endif
@@ -126,20 +181,26 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
             const auto startTimeCopy = recomp::timer::now();
 #endif
 
+            part_scheduler scheduler(this->cores, this->loop_schedule);
+            this->sync.begin();
 #pragma omp parallel num_threads(this->cores)
             {
-                auto thread_id = omp_get_thread_num();
-                size_t copy_i = copy_bounds[thread_id];
-                for (size_t i = compact_bounds[thread_id]; i < compact_bounds[thread_id + 1]; ++i) {
-                    if (text[i] != DELETED) {
-                        if (text[i] >= mapping.size()) {
-                            new_text[copy_i++] = text[i];
-                        } else {
-                            new_text[copy_i++] = mapping[text[i]];
+                this->sync.enter();
+                scheduler.for_each(compact_bounds.size() - 1, [&](size_t part) {
+                    size_t copy_i = copy_bounds[part];
+                    for (size_t i = compact_bounds[part]; i < compact_bounds[part + 1]; ++i) {
+                        if (text[i] != DELETED) {
+                            if (text[i] >= mapping.size()) {
+                                new_text[copy_i++] = text[i];
+                            } else {
+                                new_text[copy_i++] = mapping[text[i]];
+                            }
                         }
                     }
-                }
+                });
+                this->sync.leave();
             }
+            this->sync.end();
 #ifdef BENCH
             const auto endTimeCopy = recomp::timer::now();
             const auto timeSpanCopy = endTimeCopy - startTimeCopy;
@@ -162,7 +223,8 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
         const auto endTimeCompact = recomp::timer::now();
         const auto timeSpanCompact = endTimeCompact - startTimeCompact;
         std::cout << " compact_text="
-                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanCompact).count());
+                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanCompact).count())
+                  << mem_compact;
 #endif
     }
 
@@ -180,10 +242,17 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
         const auto startTime = recomp::timer::now();
 #endif
         variable_t minimum = std::numeric_limits<variable_t>::max();
-#pragma omp parallel for schedule(static) num_threads(this->cores) reduction(min:minimum)
-        for (size_t i = 0; i < text.size(); ++i) {
-            minimum = std::min(minimum, text[i]);
+        this->sync.begin();
+#pragma omp parallel num_threads(this->cores) reduction(min:minimum)
+        {
+            this->sync.enter();
+#pragma omp for schedule(static) nowait
+            for (size_t i = 0; i < text.size(); ++i) {
+                minimum = std::min(minimum, text[i]);
+            }
+            this->sync.leave();
         }
+        this->sync.end();
 #ifdef BENCH
         const auto endTimeInAl = recomp::timer::now();
         const auto timeSpanInAl = endTimeInAl - startTime;
@@ -195,8 +264,10 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
         ui_vector<variable_t> hist(max_letters);
         ui_vector<size_t> bounds;
         ui_vector<size_t> hist_bounds;
+        this->sync.begin();
 #pragma omp parallel num_threads(this->cores)
         {
+            this->sync.enter();
             auto n_threads = (size_t)omp_get_num_threads();
             auto thread_id = omp_get_thread_num();
 
@@ -220,7 +291,7 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
                 hist[i] = 0;
             }
 
-#pragma omp barrier
+            this->sync.barrier();
 #pragma omp for schedule(static)
             for (size_t i = 0; i < text.size(); ++i) {
                 hist[text[i] - minimum] = 1;
@@ -232,7 +303,7 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
                 }
             }
 
-#pragma omp barrier
+            this->sync.barrier();
 #pragma omp single
             {
                 for (size_t i = 1; i < bounds.size(); ++i) {
@@ -249,12 +320,14 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
                 }
             }
 
-#pragma omp barrier
+            this->sync.barrier();
 #pragma omp for schedule(static)
             for (size_t i = 0; i < text.size(); ++i) {
                 text[i] = hist[text[i] - minimum];
             }
+            this->sync.leave();
         }
+        this->sync.end();
         hist.resize(1);
         bounds.resize(1);
         hist_bounds.resize(1);
@@ -268,6 +341,286 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
 #endif
     }
 
+    /**
+     * The minimal number of pairs that are processed at once by @code{compute_gains}.
+     */
+    const size_t MIN_GAIN_BATCH = 1 << 16;
+
+    /**
+     * @brief Returns the first symbol of the shard of the given thread.
+     *
+     * The symbols are split into one contiguous range per thread. The symbol c belongs to the shard
+     * floor(c * n_threads / alphabet_size).
+     *
+     * @param shard The shard
+     * @param n_threads The number of threads
+     * @param alphabet_size The size of the alphabet
+     * @return The first symbol of the shard
+     */
+    inline size_t shard_start(size_t shard, size_t n_threads, size_t alphabet_size) const {
+        return (shard * alphabet_size + n_threads - 1) / n_threads;
+    }
+
+    /**
+     * @brief Computes for every symbol the number of incident pairs in the cut minus the number of incident pairs not
+     * in the cut. Flipping a symbol with a negative value increases the cut.
+     *
+     * Every thread owns the counters of one contiguous range of symbols (shard) and is the only one writing to them.
+     * The pairs are processed in batches. Every thread radix-partitions the symbols of its part of the batch by shard
+     * into a shared buffer (the symbols of cut and uncut pairs separately), afterwards every thread aggregates the
+     * symbols of its own shard. The memory is linear in the size of the alphabet and does not depend on the number
+     * of threads.
+     *
+     * @param text[in] The text
+     * @param adj_list[in] The adjacency list
+     * @param partition[in] The partition
+     * @param gain[out] The counters of all symbols
+     */
+    inline void compute_gains(const text_t& text,
+                              const adj_list_t& adj_list,
+                              const partition_t& partition,
+                              ui_vector<std::int64_t>& gain) {
+        const size_t alphabet_size = partition.size();
+        const size_t pairs = adj_list.size();
+        const size_t batch = std::max(std::min(pairs, alphabet_size), std::min(pairs, MIN_GAIN_BATCH));
+        gain.resize(alphabet_size);
+        ui_vector<variable_t> buffer(2 * batch);
+        ui_vector<size_t> offsets;
+        ui_vector<size_t> regions;
+
+        this->sync.begin();
+#pragma omp parallel num_threads(this->cores)
+        {
+            this->sync.enter();
+            auto n_threads = (size_t)omp_get_num_threads();
+            auto thread_id = (size_t)omp_get_thread_num();
+            const size_t buckets = 2 * n_threads;  // bucket k * n_threads + s holds cut (k = 0) or uncut (k = 1)
+#pragma omp single
+            {
+                offsets.resize(n_threads * buckets);
+                regions.resize(buckets + 1);
+            }
+            auto shard_of = [&](variable_t c) {
+                return static_cast<size_t>(c) * n_threads / alphabet_size;
+            };
+
+            const size_t shard_begin = shard_start(thread_id, n_threads, alphabet_size);
+            const size_t shard_end = shard_start(thread_id + 1, n_threads, alphabet_size);
+            for (size_t i = shard_begin; i < shard_end; ++i) {
+                gain[i] = 0;
+            }
+
+            size_t* count = &offsets[thread_id * buckets];
+            for (size_t b = 0; b < pairs; b += batch) {
+                const size_t len = std::min(pairs, b + batch) - b;
+                const size_t begin = b + len * thread_id / n_threads;
+                const size_t end = b + len * (thread_id + 1) / n_threads;
+
+                for (size_t k = 0; k < buckets; ++k) {
+                    count[k] = 0;
+                }
+                for (size_t i = begin; i < end; ++i) {
+                    auto char_i = text[adj_list[i]];
+                    auto char_i1 = text[adj_list[i] + 1];
+                    const size_t kind = (partition[char_i] != partition[char_i1]) ? 0 : n_threads;
+                    count[kind + shard_of(char_i)]++;
+                    count[kind + shard_of(char_i1)]++;
+                }
+                this->sync.barrier();
+#pragma omp single
+                {
+                    // Order the buffer by shard, then cut/uncut, then thread
+                    size_t sum = 0;
+                    for (size_t s = 0; s < n_threads; ++s) {
+                        for (size_t k = 0; k < 2; ++k) {
+                            regions[2 * s + k] = sum;
+                            for (size_t t = 0; t < n_threads; ++t) {
+                                const size_t idx = t * buckets + k * n_threads + s;
+                                const size_t c = offsets[idx];
+                                offsets[idx] = sum;
+                                sum += c;
+                            }
+                        }
+                    }
+                    regions[buckets] = sum;
+                }
+
+                for (size_t i = begin; i < end; ++i) {
+                    auto char_i = text[adj_list[i]];
+                    auto char_i1 = text[adj_list[i] + 1];
+                    const size_t kind = (partition[char_i] != partition[char_i1]) ? 0 : n_threads;
+                    buffer[count[kind + shard_of(char_i)]++] = char_i;
+                    buffer[count[kind + shard_of(char_i1)]++] = char_i1;
+                }
+                this->sync.barrier();
+
+                for (size_t i = regions[2 * thread_id]; i < regions[2 * thread_id + 1]; ++i) {
+                    gain[buffer[i]]++;
+                }
+                for (size_t i = regions[2 * thread_id + 1]; i < regions[2 * thread_id + 2]; ++i) {
+                    gain[buffer[i]]--;
+                }
+                this->sync.barrier();
+            }
+            this->sync.leave();
+        }
+        this->sync.end();
+    }
+
+    /**
+     * @brief Improves the undirected cut of the partition by flipping all symbols that have more incident pairs
+     * that are not in the cut than incident pairs in the cut.
+     *
+     * @param text[in] The text
+     * @param adj_list[in] The adjacency list
+     * @param partition[in,out] The partition
+     * @param gain[out] The counters of all symbols (see @code{compute_gains})
+     */
+    inline void local_search(const text_t& text,
+                             const adj_list_t& adj_list,
+                             partition_t& partition,
+                             ui_vector<std::int64_t>& gain) {
+        compute_gains(text, adj_list, partition, gain);
+        flip_class(partition, gain, 0, 1);
+    }
+
+    /**
+     * @brief Computes the number of pairs in the cut from the counters of all symbols.
+     *
+     * Every pair in the cut adds one to both of its symbols, every other pair subtracts one. So the sum of all
+     * counters is 4 * cut - 2 * pairs.
+     *
+     * @param gain[in] The counters of all symbols (see @code{compute_gains})
+     * @param pairs The number of pairs
+     * @return The number of pairs in the cut
+     */
+    inline size_t cut_size(const ui_vector<std::int64_t>& gain, const size_t pairs) {
+        std::int64_t sum = 0;
+        this->sync.begin();
+#pragma omp parallel num_threads(this->cores) reduction(+:sum)
+        {
+            this->sync.enter();
+#pragma omp for schedule(static) nowait
+            for (size_t i = 0; i < gain.size(); ++i) {
+                sum += gain[i];
+            }
+            this->sync.leave();
+        }
+        this->sync.end();
+        return static_cast<size_t>((sum + 2 * static_cast<std::int64_t>(pairs)) / 4);
+    }
+
+    /**
+     * @brief Flips all symbols with a negative counter whose residue modulo the number of classes is the given one.
+     *
+     * @param partition[in,out] The partition
+     * @param gain[in] The counters of all symbols (see @code{compute_gains})
+     * @param residue The residue of the symbols to flip
+     * @param classes The number of classes (1 to flip all symbols)
+     */
+    inline void flip_class(partition_t& partition,
+                           const ui_vector<std::int64_t>& gain,
+                           size_t residue,
+                           size_t classes) {
+        this->sync.begin();
+#pragma omp parallel num_threads(this->cores)
+        {
+            this->sync.enter();
+#pragma omp for schedule(static) nowait
+            for (size_t i = 0; i < partition.size(); ++i) {
+                if (gain[i] < 0 && i % classes == residue) {
+                    if (partition[i] == 0) {
+                        partition[i] = 1;
+                    } else {
+                        partition[i] = 0;
+                    }
+                }
+            }
+            this->sync.leave();
+        }
+        this->sync.end();
+    }
+
+    /**
+     * @brief Improves the undirected cut of the partition by local search as configured by @code{ls_config}.
+     *
+     * Every pass flips the symbols with negative counters (see @code{compute_gains}), either all at once (Jacobi) or
+     * residue class by residue class. The search stops after the maximum number of passes, if a pass increases
+     * the cut by at most the threshold or if the time budget is exhausted. With more than one pass the cut is checked
+     * after every pass including the last one and a pass decreasing the cut is reverted. A single pass is not checked
+     * like in the original local search.
+     *
+     * @param text[in] The text
+     * @param adj_list[in] The adjacency list
+     * @param partition[in,out] The partition
+     */
+    inline void improve_partition(const text_t& text, const adj_list_t& adj_list, partition_t& partition) {
+        const auto startTime = recomp::timer::now();
+        const size_t pairs = adj_list.size();
+        const size_t classes = (ls_config.mode == local_search_config::RESIDUE_CLASSES)
+                               ? std::max(ls_config.classes, static_cast<size_t>(1)) : 1;
+        ui_vector<std::int64_t> gain;
+        partition_t previous;
+        compute_gains(text, adj_list, partition, gain);
+        size_t cut = 0;
+        if (ls_config.passes > 1) {
+            cut = cut_size(gain, pairs);
+            previous.resize(partition.size());
+        }
+
+        size_t pass = 0;
+        while (pass < ls_config.passes) {
+            if (ls_config.passes > 1) {
+                this->sync.begin();
+#pragma omp parallel num_threads(this->cores)
+                {
+                    this->sync.enter();
+#pragma omp for schedule(static) nowait
+                    for (size_t i = 0; i < partition.size(); ++i) {
+                        previous[i] = partition[i];
+                    }
+                    this->sync.leave();
+                }
+                this->sync.end();
+            }
+            for (size_t residue = 0; residue < classes; ++residue) {
+                if (residue > 0) {
+                    compute_gains(text, adj_list, partition, gain);
+                }
+                flip_class(partition, gain, residue, classes);
+            }
+            pass++;
+
+            if (ls_config.passes == 1) {
+                break;
+            }
+            compute_gains(text, adj_list, partition, gain);
+            const size_t new_cut = cut_size(gain, pairs);
+            if (new_cut < cut) {
+                std::swap(partition, previous);
+                break;
+            }
+            if (pass == ls_config.passes) {
+                break;
+            }
+            const size_t pass_gain = new_cut - cut;
+            cut = new_cut;
+            if (pass_gain == 0 || static_cast<double>(pass_gain) <= ls_config.min_gain * pairs) {
+                break;
+            }
+            if (ls_config.time_budget > 0) {
+                const auto elapsed = recomp::timer::now() - startTime;
+                if (static_cast<size_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()) >=
+                    ls_config.time_budget) {
+                    break;
+                }
+            }
+        }
+#ifdef BENCH
+        std::cout << " ls_passes=" << pass;
+#endif
+    }
+
     /**
      * @brief Computes a partitioning (Sigma_l, Sigma_r) of the symbols in the text.
      *
@@ -277,6 +630,8 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
      *                    are in Sigma_l, otherwise all symbols with value true are in Sigma_l)
      */
     inline virtual void compute_partition(const text_t& text, partition_t& partition, bool& part_l) {
+        memory_phase mem_partition("partition");
+        trace_scope trace("partition");
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
@@ -294,16 +649,7 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
 #endif
         partition[0] = 0;  // ensure, that minimum one symbol is in the left partition and one in the right
         partition[partition.size() - 1] = 1;
-#pragma omp parallel num_threads(this->cores)
-        {
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<uint8_t> distribution(0, 1);
-#pragma omp for schedule(static)
-            for (size_t i = 1; i < partition.size() - 1; ++i) {
-                partition[i] = (distribution(gen) == 1);
-            }
-        }
+        counter_rng(this->seed, this->level).fill(partition, 1, partition.size() - 1, this->cores);
 #ifdef BENCH
         const auto endTimePar = recomp::timer::now();
         const auto timeSpanPar = endTimePar - startTimePar;
@@ -311,55 +657,7 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
         const auto startTimeLocalSearch = recomp::timer::now();
 #endif
 
-        i_vector<ui_vector<std::int64_t>> flip;
-        ui_vector<size_t> bounds;
-#pragma omp parallel num_threads(this->cores)
-        {
-            auto n_threads = (size_t)omp_get_num_threads();
-            auto thread_id = (size_t)omp_get_thread_num();
-#pragma omp single
-            {
-                flip.resize(n_threads);
-                for (size_t i = 0; i < n_threads; ++i) {
-                    flip[i].resize(partition.size());
-                }
-                bounds.resize(n_threads + 1);
-                bounds[n_threads] = adj_list.size() - 1;
-            }
-            bounds[thread_id] = adj_list.size() - 1;
-            flip[thread_id].fill(0);
-
-#pragma omp for schedule(static)
-            for (size_t i = 0; i < adj_list_size; ++i) {
-                auto char_i = text[adj_list[i]];
-                auto char_i1 = text[adj_list[i] + 1];
-                if (partition[char_i] != partition[char_i1]) {
-                    flip[thread_id][char_i]++;
-                    flip[thread_id][char_i1]++;
-                } else {
-                    flip[thread_id][char_i]--;
-                    flip[thread_id][char_i1]--;
-                }
-            }
-
-#pragma omp for schedule(static)
-            for (size_t i = 0; i < partition.size(); ++i) {
-                for (size_t j = 1; j < n_threads; ++j) {
-                    flip[0][i] += flip[j][i];
-                }
-                if (flip[0][i] < 0) {
-                    if (partition[i] == 0) {
-                        partition[i] = 1;
-                    } else {
-                        partition[i] = 0;
-                    }
-                }
-            }
-        }
-        for (size_t i = 0; i < flip.size(); ++i) {
-            flip[i].resize(1);
-        }
-        flip.resize(1);
+        improve_partition(text, adj_list, partition);
 #ifdef BENCH
         const auto endTimeLocalSearch = recomp::timer::now();
         const auto timeSpanLocalSearch = endTimeLocalSearch - startTimeLocalSearch;
@@ -368,12 +666,19 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
 #endif
 
         bool different = false;
-#pragma omp parallel for schedule(static) num_threads(this->cores) reduction(|:different)
-        for (size_t i = 0; i < partition.size() - 1; ++i) {
-            if (partition[i] != partition[i + 1]) {
-                different = true;
+        this->sync.begin();
+#pragma omp parallel num_threads(this->cores) reduction(|:different)
+        {
+            this->sync.enter();
+#pragma omp for schedule(static) nowait
+            for (size_t i = 0; i < partition.size() - 1; ++i) {
+                if (partition[i] != partition[i + 1]) {
+                    different = true;
+                }
             }
+            this->sync.leave();
         }
+        this->sync.end();
         if (!different) {
             partition[0] = 0;  // ensure, that minimum one symbol is in the left partition and one in the right
             partition[partition.size() - 1] = 1;
@@ -386,15 +691,24 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
         const auto startTimeCount = recomp::timer::now();
 #endif
 
-        int lr_count = 0;
-        int rl_count = 0;
-        int prod_l = 0;
-        int prod_r = 0;
-        bounds[bounds.size() - 1] = adj_list.size();
+        size_t lr_count = 0;
+        size_t rl_count = 0;
+        size_t prod_l = 0;
+        size_t prod_r = 0;
+        ui_vector<size_t> bounds;
+        this->sync.begin();
 #pragma omp parallel num_threads(this->cores) reduction(+:lr_count) reduction(+:rl_count) reduction(+:prod_r) reduction(+:prod_l)
         {
+            this->sync.enter();
+            auto n_threads = (size_t)omp_get_num_threads();
             auto thread_id = omp_get_thread_num();
 
+#pragma omp single
+            {
+                bounds.resize(n_threads + 1);
+                bounds[n_threads] = adj_list.size();
+            }
+
             bounds[thread_id] = adj_list.size();
 
 #pragma omp for schedule(static)
@@ -439,7 +753,9 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
                 last_i = char_i;
                 last_i1 = char_i1;
             }
+            this->sync.leave();
         }
+        this->sync.end();
         part_l = rl_count > lr_count;
         if (rl_count == lr_count) {
             part_l = prod_r < prod_l;
@@ -451,7 +767,8 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
                   << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanCount).count();
         const auto endTime = recomp::timer::now();
         const auto timeSpan = endTime - startTime;
-        std::cout << " partition=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count();
+        std::cout << " partition=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                  << mem_partition;
 #endif
     }
 
@@ -463,6 +780,8 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
      * @param bv[in,out] The bitvector to indicate which rules derive blocks
      */
     inline void pcomp(text_t& text, rlslp<variable_t>& rlslp, bv_t& bv) {
+        memory_phase mem_pcomp("pcomp");
+        trace_scope trace("pcomp", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         std::cout << "RESULT algo=" << this->name << "_pcomp dataset=" << this->dataset << " text=" << text.size()
@@ -483,74 +802,12 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
 #endif
         ui_vector<pair_position_t> positions;
 
-        ui_vector<size_t> bounds;
-        ui_vector<size_t> pair_counts;
         ui_vector<size_t> compact_bounds;
-        ui_vector<size_t> pair_overlaps;
-#pragma omp parallel num_threads(this->cores) reduction(+:pair_count)
-        {
-            auto thread_id = omp_get_thread_num();
-            auto n_threads = static_cast<size_t>(omp_get_num_threads());
-            size_t end_text = text.size() - 1;
-
-#pragma omp single
-            {
-                bounds.resize(n_threads + 1);
-                bounds[0] = 0;
-                compact_bounds.resize(n_threads + 1);
-                compact_bounds[n_threads] = end_text;
-                pair_counts.resize(n_threads + 1);
-                pair_counts[n_threads] = 0;
-                pair_overlaps.resize(n_threads + 1);
-                pair_overlaps[n_threads] = 0;
-            }
-            compact_bounds[thread_id] = end_text;
-            pair_counts[thread_id] = 0;
-            pair_overlaps[thread_id] = 0;
-            std::deque<pair_position_t> t_positions;
-
-#pragma omp for schedule(static)
-            for (size_t i = 0; i < text.size() - 1; ++i) {
-                compact_bounds[thread_id] = i;
-                i = text.size();
-            }
-
-            for (size_t i = compact_bounds[thread_id]; i < compact_bounds[thread_id + 1]; ++i) {
-                if (part_l == partition[text[i]] && part_l != partition[text[i + 1]]) {
-                    t_positions.emplace_back(i);
-                    pair_count++;
-                }
-            }
-
-            bounds[thread_id + 1] = t_positions.size();
-
-#pragma omp barrier
-#pragma omp single
-            {
-                compact_bounds[n_threads] = text.size();
-                for (size_t j = 1; j < n_threads + 1; ++j) {
-                    bounds[j] += bounds[j - 1];
-                }
-                positions.resize(positions.size() + bounds[n_threads]);
-
-                pair_counts[n_threads] = compact_bounds[n_threads] + pair_overlaps[n_threads] - bounds[n_threads];
-            }
-            std::copy(t_positions.begin(), t_positions.end(), positions.begin() + bounds[thread_id]);
-
-            if (compact_bounds[thread_id] == text.size() - 1) {
-                compact_bounds[thread_id] = text.size();
-            }
-
-            size_t cb = compact_bounds[thread_id];
-            if (cb > 0) {
-                if (cb < text.size()) {
-                    pair_overlaps[thread_id] = (partition[text[cb - 1]] == part_l && partition[text[cb]] != part_l) ? 1 : 0;
-                }
-                pair_counts[thread_id] = cb + pair_overlaps[thread_id] - bounds[thread_id];
-            }
-        }
+        ui_vector<size_t> pair_counts;
+        pair_count = this->find_pairs(text, [&](size_t i) {
+            return part_l == partition[text[i]] && part_l != partition[text[i + 1]];
+        }, positions, compact_bounds, pair_counts);
         partition.resize(1);
-        pair_overlaps.resize(1);
 #ifdef BENCH
         const auto endTimePairs = recomp::timer::now();
         const auto timeSpanPairs = endTimePairs - startTimePairs;
@@ -558,6 +815,8 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
                   << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanPairs).count());
         const auto startTimeSort = recomp::timer::now();
 #endif
+        memory_phase mem_sort("sort");
+        trace_scope trace_sort("sort");
         auto sort_cond = [&](const pair_position_t& i, const pair_position_t& j) {
             auto char_i = text[i];
             auto char_i1 = text[i + 1];
@@ -570,138 +829,31 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
             }
         };
         ips4o::parallel::sort(positions.begin(), positions.end(), sort_cond, this->cores);
+        mem_sort.end();
+        trace_sort.end();
 #ifdef BENCH
         const auto endTimeSort = recomp::timer::now();
         const auto timeSpanSort = endTimeSort - startTimeSort;
         std::cout << " sort="
-                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanSort).count());
+                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanSort).count())
+                  << mem_sort;
+        const auto rules_before = rlslp.size();
         const auto startTimeRules = recomp::timer::now();
 #endif
-        auto nt_count = rlslp.non_terminals.size();
-        auto next_nt = rlslp.terminals + nt_count;
-
-        ui_vector<size_t> assign_bounds;
-        ui_vector<size_t> distinct_pairs;
-        typename recomp::rlslp<variable_t>::production_t productions;
-#pragma omp parallel num_threads(this->cores)
-        {
-            auto thread_id = omp_get_thread_num();
-            auto n_threads = static_cast<size_t>(omp_get_num_threads());
-
-#pragma omp single
-            {
-                assign_bounds.resize(n_threads + 1);
-                assign_bounds[n_threads] = positions.size();
-                distinct_pairs.resize(n_threads + 1);
-                distinct_pairs[0] = 0;
-            }
-            assign_bounds[thread_id] = positions.size();
-            distinct_pairs[thread_id + 1] = 0;
-
-#pragma omp for schedule(static)
-            for (size_t i = 0; i < positions.size(); ++i) {
-                assign_bounds[thread_id] = i;
-                i = positions.size();
-            }
-
-            size_t i = assign_bounds[thread_id];
-            if (i == 0) {
-                distinct_pairs[thread_id + 1]++;
-                i++;
-            }
-
-            for (; i < assign_bounds[thread_id + 1]; ++i) {
-                if (text[positions[i]] != text[positions[i - 1]] ||
-                    text[positions[i] + 1] != text[positions[i - 1] + 1]) {
-                    distinct_pairs[thread_id + 1]++;
-                }
-            }
-
-#pragma omp barrier
-#pragma omp single
-            {
-                for (size_t j = 1; j < distinct_pairs.size(); ++j) {
-                    distinct_pairs[j] += distinct_pairs[j - 1];
-                }
-
-                auto pc = distinct_pairs[n_threads];
-                auto rlslp_size = nt_count + pc;
-                productions.resize(rlslp_size);
-                bv.resize(rlslp_size, false);
-            }
-#pragma omp for schedule(static)
-            for (size_t k = 0; k < rlslp.size(); ++k) {
-                productions[k] = rlslp[k];
-            }
-
-            i = assign_bounds[thread_id];
-            auto last_var = next_nt + distinct_pairs[thread_id] - 1;
-            variable_t last_char1 = 0;
-            variable_t last_char2 = 0;
-            if (i > 0 && i < assign_bounds[thread_id + 1]) {
-                last_char1 = mapping[text[positions[i - 1]]];
-                last_char2 = mapping[text[positions[i - 1] + 1]];
-            }
-
-#pragma omp barrier
-            size_t j = 0;
-            if (thread_id == 0) {
-                last_char1 = mapping[text[positions[i]]];
-                last_char2 = mapping[text[positions[i] + 1]];
-                size_t len = 0;
-                if (last_char1 >= rlslp.terminals) {
-                    len = rlslp[last_char1 - rlslp.terminals].len;
-                } else {
-                    len = 1;
-                }
-                if (last_char2 >= rlslp.terminals) {
-                    len += rlslp[last_char2 - rlslp.terminals].len;
-                } else {
-                    len += 1;
-                }
-                productions[nt_count + distinct_pairs[thread_id] + j] = non_terminal<variable_t>(last_char1, last_char2, len);
-                j++;
-                last_var++;
-                text[positions[i]] = last_var;
-                text[positions[i] + 1] = DELETED;
-                i++;
-            }
-
-            for (; i < assign_bounds[thread_id + 1]; ++i) {
-                auto char_i1 = mapping[text[positions[i]]];
-                auto char_i2 = mapping[text[positions[i] + 1]];
-                if (char_i1 == last_char1 && char_i2 == last_char2) {
-                    text[positions[i]] = last_var;
-                } else {
-                    size_t len = 0;
-                    if (char_i1 >= rlslp.terminals) {
-                        len = rlslp[char_i1 - rlslp.terminals].len;
-                    } else {
-                        len = 1;
-                    }
-                    if (char_i2 >= rlslp.terminals) {
-                        len += rlslp[char_i2 - rlslp.terminals].len;
-                    } else {
-                        len += 1;
-                    }
-                    productions[nt_count + distinct_pairs[thread_id] + j] = non_terminal<variable_t>(char_i1, char_i2, len);
-                    j++;
-                    last_var++;
-                    text[positions[i]] = last_var;
-                    last_char1 = char_i1;
-                    last_char2 = char_i2;
-                }
-                text[positions[i] + 1] = DELETED;
-            }
-        }
-        std::swap(rlslp.non_terminals, productions);
-        productions.resize(1);
+        memory_phase mem_rules("rules");
+        trace_scope trace_rules("rules");
+        this->create_pair_rules(text, rlslp, bv, positions, [&](variable_t c) {
+            return mapping[c];
+        });
         positions.resize(1);
+        mem_rules.end();
+        trace_rules.end();
 #ifdef BENCH
         const auto endTimeRules = recomp::timer::now();
         const auto timeSpanRules = endTimeRules - startTimeRules;
         std::cout << " rules=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanRules).count()
-                  << " productions=" << distinct_pairs[distinct_pairs.size() - 1] << " elements=" << pair_count;
+                  << " productions=" << rlslp.size() - rules_before << " elements=" << pair_count
+                  << mem_rules;
 #endif
 
         this->compact(text, compact_bounds, pair_counts, pair_count, mapping);
@@ -711,7 +863,7 @@ class parallel_ls_recompression : public parallel_rnd_recompression<variable_t>
         const auto timeSpan = endTime - startTime;
         std::cout << " time="
                   << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
-                  << " compressed_text=" << text.size() << std::endl;
+                  << " compressed_text=" << text.size() << mem_pcomp << std::endl;
 #endif
     }
 };
@@ -21,6 +21,10 @@
 #include "util.hpp"
 #include "rlslp.hpp"
 #include "radix_sort.hpp"
+#include "bit_partition.hpp"
+#include "memory_tracker.hpp"
+#include "run_detection.hpp"
+#include "parallel_loop.hpp"
 
 #include "graph.hpp"
 
@@ -59,21 +63,32 @@ class parallel_recompression : public recompression<variable_t> {
                                rlslp<variable_t>& rlslp,
                                const size_t& alphabet_size,
                                const size_t cores) override {
+        trace_scope trace("recompression", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         size_t text_size = text.size();
 #endif
-        this->cores = cores;
         rlslp.terminals = alphabet_size;
         bv_t bv;
 
-        while (text.size() > 1) {
-            bcomp(text, rlslp, bv);
-            this->level++;
-
-            if (text.size() > 1) {
-                pcomp(text, rlslp, bv);
-                this->level++;
+        {
+            typename recompression<variable_t>::cores_guard guard(*this, cores);
+            if (this->single_region && this->supports_single_region()) {
+                recomp_in_region(text, rlslp, bv, cores);
+            } else {
+                while (text.size() > 1) {
+                    this->begin_round(text.size(), cores);
+                    bcomp(text, rlslp, bv);
+                    this->end_round();
+                    this->level++;
+
+                    if (text.size() > 1) {
+                        this->begin_round(text.size(), cores);
+                        pcomp(text, rlslp, bv);
+                        this->end_round();
+                        this->level++;
+                    }
+                }
             }
         }
 
@@ -101,14 +116,16 @@ class parallel_recompression : public recompression<variable_t> {
      * @brief Compacts the text
      *
      * @param text[in,out] The text
-     * @param compact_bounds[in] The bounds for the cores to copy from
-     * @param copy_bounds[in] The bounds for the cores to copy to
+     * @param compact_bounds[in] The bounds of the parts of the text to copy from
+     * @param copy_bounds[in] The bounds of the parts of the text to copy to
      * @param count[in] The number of found blocks/pairs
      */
     inline void compact(text_t& text,
                         const ui_vector<size_t>& compact_bounds,
                         const ui_vector<size_t>& copy_bounds,
                         size_t count) {
+        memory_phase mem_compact("compact");
+        trace_scope trace("compact");
 #ifdef BENCH
         const auto startTimeCompact = recomp::timer::now();
 #endif
@@ -126,16 +143,22 @@ class parallel_recompression : public recompression<variable_t> {
             const auto startTimeCopy = recomp::timer::now();
 #endif
 
+            part_scheduler scheduler(this->cores, this->loop_schedule);
+            this->sync.begin();
 #pragma omp parallel num_threads(this->cores)
             {
-                auto thread_id = omp_get_thread_num();
-                size_t copy_i = copy_bounds[thread_id];
-                for (size_t i = compact_bounds[thread_id]; i < compact_bounds[thread_id + 1]; ++i) {
-                    if (text[i] != DELETED) {
-                        new_text[copy_i++] = text[i];
+                this->sync.enter();
+                scheduler.for_each(compact_bounds.size() - 1, [&](size_t part) {
+                    size_t copy_i = copy_bounds[part];
+                    for (size_t i = compact_bounds[part]; i < compact_bounds[part + 1]; ++i) {
+                        if (text[i] != DELETED) {
+                            new_text[copy_i++] = text[i];
+                        }
                     }
-                }
+                });
+                this->sync.leave();
             }
+            this->sync.end();
 #ifdef BENCH
             const auto endTimeCopy = recomp::timer::now();
             const auto timeSpanCopy = endTimeCopy - startTimeCopy;
@@ -158,10 +181,262 @@ class parallel_recompression : public recompression<variable_t> {
         const auto endTimeCompact = recomp::timer::now();
         const auto timeSpanCompact = endTimeCompact - startTimeCompact;
         std::cout << " compact_text="
-                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanCompact).count());
+                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanCompact).count())
+                  << mem_compact;
 #endif
     }
 
+    /**
+     * @brief Finds the positions of the pairs in the text. The text is split into parts of equal length which are
+     * distributed by the schedule of the loops.
+     *
+     * @param text[in] The text
+     * @param for_each_pair[in] Calls @code{f(i)} for every position i in [begin, end) a pair starts at
+     *                          (@code{for_each_pair(begin, end, f)})
+     * @param is_pair[in] Whether a pair starts at the given position
+     * @param positions[out] The positions of the pairs
+     * @param compact_bounds[out] The bounds of the parts of the text to copy from
+     * @param pair_counts[out] The bounds of the parts of the text to copy to
+     * @return The number of pairs
+     */
+    template<typename for_each_pair_t, typename is_pair_t>
+    inline size_t find_pairs(const text_t& text,
+                             for_each_pair_t for_each_pair,
+                             is_pair_t is_pair,
+                             ui_vector<pair_position_t>& positions,
+                             ui_vector<size_t>& compact_bounds,
+                             ui_vector<size_t>& pair_counts) {
+        size_t pair_count = 0;
+        part_scheduler scheduler(this->cores, this->loop_schedule);
+        size_t parts = 0;
+        ui_vector<size_t> bounds;
+        ui_vector<size_t> pair_overlaps;
+        std::vector<std::deque<pair_position_t>> part_positions;
+        this->sync.begin();
+#pragma omp parallel num_threads(this->cores) reduction(+:pair_count)
+        {
+            this->sync.enter();
+            auto n_threads = static_cast<size_t>(omp_get_num_threads());
+            size_t end_text = text.size() - 1;
+
+#pragma omp single
+            {
+                parts = scheduler.parts(n_threads);
+                bounds.resize(parts + 1);
+                bounds[0] = 0;
+                compact_bounds.resize(parts + 1);
+                pair_counts.resize(parts + 1);
+                pair_overlaps.resize(parts + 1);
+                for (size_t part = 0; part <= parts; ++part) {
+                    compact_bounds[part] = end_text * part / parts;
+                    pair_counts[part] = 0;
+                    pair_overlaps[part] = 0;
+                }
+                part_positions.resize(parts);
+            }
+
+            scheduler.for_each(parts, [&](size_t part) {
+                std::deque<pair_position_t>& t_positions = part_positions[part];
+                for_each_pair(compact_bounds[part], compact_bounds[part + 1], [&](size_t i) {
+                    t_positions.emplace_back(i);
+                    pair_count++;
+                });
+                bounds[part + 1] = t_positions.size();
+            });
+
+            this->sync.barrier();
+#pragma omp single
+            {
+                compact_bounds[parts] = text.size();
+                for (size_t j = 1; j < parts + 1; ++j) {
+                    bounds[j] += bounds[j - 1];
+                }
+                positions.resize(positions.size() + bounds[parts]);
+
+                pair_counts[parts] = compact_bounds[parts] + pair_overlaps[parts] - bounds[parts];
+            }
+
+            scheduler.for_each(parts, [&](size_t part) {
+                std::deque<pair_position_t>& t_positions = part_positions[part];
+                std::copy(t_positions.begin(), t_positions.end(), positions.begin() + bounds[part]);
+                std::deque<pair_position_t>().swap(t_positions);
+
+                size_t cb = compact_bounds[part];
+                if (cb > 0) {
+                    pair_overlaps[part] = is_pair(cb - 1) ? 1 : 0;
+                    pair_counts[part] = cb + pair_overlaps[part] - bounds[part];
+                }
+            });
+            this->sync.leave();
+        }
+        this->sync.end();
+        return pair_count;
+    }
+
+    /**
+     * @brief Finds the positions of the pairs in the text by testing every position.
+     *
+     * @param text[in] The text
+     * @param is_pair[in] Whether a pair starts at the given position
+     * @param positions[out] The positions of the pairs
+     * @param compact_bounds[out] The bounds of the parts of the text to copy from
+     * @param pair_counts[out] The bounds of the parts of the text to copy to
+     * @return The number of pairs
+     */
+    template<typename is_pair_t>
+    inline size_t find_pairs(const text_t& text,
+                             is_pair_t is_pair,
+                             ui_vector<pair_position_t>& positions,
+                             ui_vector<size_t>& compact_bounds,
+                             ui_vector<size_t>& pair_counts) {
+        return find_pairs(text, [&](size_t begin, size_t end, auto f) {
+            for (size_t i = begin; i < end; ++i) {
+                if (is_pair(i)) {
+                    f(i);
+                }
+            }
+        }, is_pair, positions, compact_bounds, pair_counts);
+    }
+
+    /**
+     * @brief Creates the rules for the sorted positions of the pairs, replaces the first symbol of every pair with its
+     * non-terminal and deletes the second symbol. The positions are split into parts which are distributed by the
+     * schedule of the loops.
+     *
+     * @param text[in,out] The text
+     * @param rlslp[in,out] The rlslp
+     * @param bv[in,out] The bitvector to indicate which rules derive blocks
+     * @param positions[in] The sorted positions of the pairs
+     * @param symbol[in] Maps a symbol of the text to the symbol of the rule
+     */
+    template<typename symbol_t>
+    inline void create_pair_rules(text_t& text,
+                                    rlslp<variable_t>& rlslp,
+                                    bv_t& bv,
+                                    const ui_vector<pair_position_t>& positions,
+                                    symbol_t symbol) {
+        auto nt_count = rlslp.non_terminals.size();
+        auto next_nt = rlslp.terminals + nt_count;
+
+        part_scheduler scheduler(this->cores, this->loop_schedule);
+        size_t parts = 0;
+        ui_vector<size_t> assign_bounds;
+        ui_vector<size_t> distinct_pairs;
+        ui_vector<variable_t> last_chars;
+        typename recomp::rlslp<variable_t>::production_t productions;
+        this->sync.begin();
+#pragma omp parallel num_threads(this->cores)
+        {
+            this->sync.enter();
+            auto n_threads = static_cast<size_t>(omp_get_num_threads());
+
+#pragma omp single
+            {
+                parts = scheduler.parts(n_threads);
+                assign_bounds.resize(parts + 1);
+                distinct_pairs.resize(parts + 1);
+                distinct_pairs[0] = 0;
+                last_chars.resize(2 * parts);
+                for (size_t part = 0; part <= parts; ++part) {
+                    assign_bounds[part] = positions.size() * part / parts;
+                }
+            }
+
+            // the symbols of the pair in front of each part are read before any part renames its pairs
+            scheduler.for_each(parts, [&](size_t part) {
+                size_t i = assign_bounds[part];
+                distinct_pairs[part + 1] = 0;
+                last_chars[2 * part] = 0;
+                last_chars[2 * part + 1] = 0;
+                if (i == 0 && i < assign_bounds[part + 1]) {
+                    distinct_pairs[part + 1]++;
+                    i++;
+                } else if (i > 0 && i < assign_bounds[part + 1]) {
+                    last_chars[2 * part] = symbol(text[positions[i - 1]]);
+                    last_chars[2 * part + 1] = symbol(text[positions[i - 1] + 1]);
+                }
+
+                for (; i < assign_bounds[part + 1]; ++i) {
+                    if (text[positions[i]] != text[positions[i - 1]] ||
+                        text[positions[i] + 1] != text[positions[i - 1] + 1]) {
+                        distinct_pairs[part + 1]++;
+                    }
+                }
+            });
+
+            this->sync.barrier();
+#pragma omp single
+            {
+                for (size_t j = 1; j < distinct_pairs.size(); ++j) {
+                    distinct_pairs[j] += distinct_pairs[j - 1];
+                }
+
+                auto pc = distinct_pairs[parts];
+                auto rlslp_size = nt_count + pc;
+                productions.resize(rlslp_size);
+                bv.resize(rlslp_size, false);
+            }
+#pragma omp for schedule(static)
+            for (size_t k = 0; k < rlslp.size(); ++k) {
+                productions[k] = rlslp[k];
+            }
+
+            auto rule_len = [&](variable_t char_1, variable_t char_2) {
+                size_t len = 0;
+                if (char_1 >= rlslp.terminals) {
+                    len = rlslp[char_1 - rlslp.terminals].len;
+                } else {
+                    len = 1;
+                }
+                if (char_2 >= rlslp.terminals) {
+                    len += rlslp[char_2 - rlslp.terminals].len;
+                } else {
+                    len += 1;
+                }
+                return len;
+            };
+
+            scheduler.for_each(parts, [&](size_t part) {
+                size_t i = assign_bounds[part];
+                auto last_var = next_nt + distinct_pairs[part] - 1;
+                variable_t last_char1 = last_chars[2 * part];
+                variable_t last_char2 = last_chars[2 * part + 1];
+                size_t j = 0;
+                if (i == 0 && i < assign_bounds[part + 1]) {
+                    last_char1 = symbol(text[positions[i]]);
+                    last_char2 = symbol(text[positions[i] + 1]);
+                    productions[nt_count + distinct_pairs[part] + j] = non_terminal<variable_t>(
+                            last_char1, last_char2, rule_len(last_char1, last_char2));
+                    j++;
+                    last_var++;
+                    text[positions[i]] = last_var;
+                    text[positions[i] + 1] = DELETED;
+                    i++;
+                }
+
+                for (; i < assign_bounds[part + 1]; ++i) {
+                    auto char_i1 = symbol(text[positions[i]]);
+                    auto char_i2 = symbol(text[positions[i] + 1]);
+                    if (char_i1 == last_char1 && char_i2 == last_char2) {
+                        text[positions[i]] = last_var;
+                    } else {
+                        productions[nt_count + distinct_pairs[part] + j] = non_terminal<variable_t>(
+                                char_i1, char_i2, rule_len(char_i1, char_i2));
+                        j++;
+                        last_var++;
+                        text[positions[i]] = last_var;
+                        last_char1 = char_i1;
+                        last_char2 = char_i2;
+                    }
+                    text[positions[i] + 1] = DELETED;
+                }
+            });
+            this->sync.leave();
+        }
+        this->sync.end();
+        std::swap(rlslp.non_terminals, productions);
+    }
+
     /**
      * @brief Replaces all block in the text with new non-terminals.
      *
@@ -170,6 +445,8 @@ class parallel_recompression : public recompression<variable_t> {
      * @param bv[in,out] The bitvector to indicate which rules derive blocks
      */
     inline void bcomp(text_t& text, rlslp<variable_t>& rlslp, bv_t& bv) {
+        memory_phase mem_bcomp("bcomp");
+        trace_scope trace("bcomp", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         std::cout << "RESULT algo=" << this->name << "_bcomp dataset=" << this->dataset << " text=" << text.size()
@@ -179,94 +456,106 @@ class parallel_recompression : public recompression<variable_t> {
         size_t block_count = 0;
         ui_vector<position_t> positions;
 
+        // the text is split into parts of equal length, so the tails of long blocks are deleted by all threads
+        part_scheduler scheduler(this->cores, this->loop_schedule);
+        size_t parts = 0;
         ui_vector<size_t> bounds;
         ui_vector<size_t> block_counts;
         ui_vector<size_t> compact_bounds;
         ui_vector<size_t> block_overlaps;
+        std::vector<std::deque<position_t>> part_positions;
+        this->sync.begin();
 #pragma omp parallel num_threads(this->cores) reduction(+:block_count)
         {
-            auto thread_id = omp_get_thread_num();
+            this->sync.enter();
             auto n_threads = static_cast<size_t>(omp_get_num_threads());
-            variable_t block_len = 1;
 
 #pragma omp single
             {
-                bounds.resize(n_threads + 1);
+                parts = scheduler.parts(n_threads);
+                bounds.resize(parts + 1);
                 bounds[0] = 0;
-                compact_bounds.resize(n_threads + 1);
-                compact_bounds[n_threads] = text.size();
-                block_counts.resize(n_threads + 1);
-                block_counts[n_threads] = 0;
-                block_overlaps.resize(n_threads + 1);
-                block_overlaps[n_threads] = 0;
-            }
-            compact_bounds[thread_id] = text.size();
-            block_counts[thread_id] = 0;
-            block_overlaps[thread_id] = 0;
-            std::deque<position_t> t_positions;
-            bool add = false;
-
-#pragma omp for schedule(static)
-            for (size_t i = 0; i < text.size(); ++i) {
-                compact_bounds[thread_id] = i;
-                if (i == 0) {
-                    add = thread_id == 0;
-                } else {
-                    add = text[i - 1] != text[i];
+                compact_bounds.resize(parts + 1);
+                block_counts.resize(parts + 1);
+                block_overlaps.resize(parts + 1);
+                for (size_t part = 0; part <= parts; ++part) {
+                    compact_bounds[part] = text.size() * part / parts;
+                    block_counts[part] = 0;
+                    block_overlaps[part] = 0;
                 }
-                i = text.size();
+                part_positions.resize(parts);
             }
 
-            size_t i = compact_bounds[thread_id];
-            if (i > 0 && i < compact_bounds[thread_id + 1]) {
-                while (i < text.size() - 1 && text[i] == text[i + 1]) {
-                    block_len++;
+            scheduler.for_each(parts, [&](size_t part) {
+                std::deque<position_t>& t_positions = part_positions[part];
+                variable_t block_len = 1;
+                size_t i = compact_bounds[part];
+                if (i > 0 && i < compact_bounds[part + 1]) {
+                    const bool add = text[i - 1] != text[i];
+                    const size_t end = simd::next_unequal(text.data(), i, text.size() - 1);
+                    block_len += end - i;
+                    i = end;
+                    if (!add) {
+                        block_overlaps[part] = block_len;
+                        block_len = 1;
+                    }
+                    if (block_len > 1) {
+                        t_positions.emplace_back(block_len, i - block_len + 1);
+                        block_count++;
+                        block_counts[part + 1] += block_len - 1;
+                        block_len = 1;
+                    }
                     i++;
                 }
-                if (!add) {
-                    block_overlaps[thread_id] = block_len;
-                    block_len = 1;
-                }
-                if (block_len > 1) {
-                    t_positions.emplace_back(block_len, i - block_len + 1);
-                    block_count++;
-                    block_counts[thread_id + 1] += block_len - 1;
-                    block_len = 1;
-                }
-                i++;
-            }
 
-            for (; i < compact_bounds[thread_id + 1]; ++i) {
-                while (i < text.size() - 1 && text[i] == text[i + 1]) {
-                    block_len++;
-                    i++;
-                }
-                if (block_len > 1) {
-                    t_positions.emplace_back(block_len, i - block_len + 1);
+                // jump from block to block using the bitmasks of equal neighbors
+                const size_t scan_end = std::min(compact_bounds[part + 1], text.size() - 1);
+                for (i = simd::next_equal(text.data(), i, scan_end); i < scan_end;
+                     i = simd::next_equal(text.data(), i + 1, scan_end)) {
+                    const size_t end = simd::next_unequal(text.data(), i, text.size() - 1);
+                    block_len = static_cast<variable_t>(end - i + 1);
+                    t_positions.emplace_back(block_len, i);
                     block_count++;
-                    block_counts[thread_id + 1] += block_len - 1;
+                    block_counts[part + 1] += block_len - 1;
                     block_len = 1;
+                    i = end;
                 }
-            }
 
-            bounds[thread_id + 1] = t_positions.size();
+                bounds[part + 1] = t_positions.size();
+            });
 
-#pragma omp barrier
+            this->sync.barrier();
 #pragma omp single
             {
-                for (size_t j = 1; j < n_threads + 1; ++j) {
+                for (size_t j = 1; j < parts + 1; ++j) {
                     bounds[j] += bounds[j - 1];
                     block_counts[j] += block_counts[j - 1];
                 }
-                positions.resize(positions.size() + bounds[n_threads]);
+                positions.resize(positions.size() + bounds[parts]);
             }
-            std::copy(t_positions.begin(), t_positions.end(), positions.begin() + bounds[thread_id]);
 
-            block_counts[thread_id] = compact_bounds[thread_id] + block_overlaps[thread_id] - block_counts[thread_id];
+            // every part deletes the tails of the blocks inside its range (the first symbols are renamed later)
+            scheduler.for_each(parts, [&](size_t part) {
+                std::deque<position_t>& t_positions = part_positions[part];
+                std::copy(t_positions.begin(), t_positions.end(), positions.begin() + bounds[part]);
+                const size_t part_end = compact_bounds[part + 1];
+                for (size_t i = compact_bounds[part];
+                     i < std::min(compact_bounds[part] + block_overlaps[part], part_end); ++i) {
+                    text[i] = DELETED;
+                }
+                for (const auto& pos : t_positions) {
+                    for (size_t i = pos.second + 1; i < std::min(pos.second + pos.first, part_end); ++i) {
+                        text[i] = DELETED;
+                    }
+                }
+                std::deque<position_t>().swap(t_positions);
+
+                block_counts[part] = compact_bounds[part] + block_overlaps[part] - block_counts[part];
+            });
+            this->sync.leave();
         }
-        block_counts[block_counts.size() - 1] =
-                compact_bounds[block_counts.size() - 1] + block_overlaps[block_counts.size() - 1] -
-                block_counts[block_counts.size() - 1];
+        this->sync.end();
+        block_counts[parts] = compact_bounds[parts] + block_overlaps[parts] - block_counts[parts];
         block_overlaps.resize(1);
 #ifdef BENCH
         const auto endTimeBlocks = recomp::timer::now();
@@ -279,6 +568,8 @@ class parallel_recompression : public recompression<variable_t> {
 #ifdef BENCH
             const auto startTimeSort = recomp::timer::now();
 #endif
+            memory_phase mem_sort("sort");
+            trace_scope trace_sort("sort");
             auto sort_cond = [&](const position_t& i, const position_t& j) {
                 auto char_i = text[i.second];
                 auto char_j = text[j.second];
@@ -289,61 +580,71 @@ class parallel_recompression : public recompression<variable_t> {
                 }
             };
             ips4o::parallel::sort(positions.begin(), positions.end(), sort_cond, this->cores);
+            mem_sort.end();
+            trace_sort.end();
 #ifdef BENCH
             const auto endTimeSort = recomp::timer::now();
             const auto timeSpanSort = endTimeSort - startTimeSort;
             std::cout << " sort="
-                      << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanSort).count());
+                      << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanSort).count())
+                      << mem_sort;
             const auto startTimeRules = recomp::timer::now();
 #endif
+            memory_phase mem_rules("rules");
+            trace_scope trace_rules("rules");
             auto nt_count = rlslp.non_terminals.size();
             auto next_nt = rlslp.terminals + nt_count;
 
             ui_vector<size_t> assign_bounds;
             ui_vector<size_t> distinct_blocks;
+            ui_vector<variable_t> last_chars;
             typename recomp::rlslp<variable_t>::production_t productions;
+            this->sync.begin();
 #pragma omp parallel num_threads(this->cores)
             {
-                auto thread_id = omp_get_thread_num();
+                this->sync.enter();
                 auto n_threads = static_cast<size_t>(omp_get_num_threads());
 
 #pragma omp single
                 {
-                    assign_bounds.resize(n_threads + 1);
-                    assign_bounds[n_threads] = positions.size();
-                    distinct_blocks.resize(n_threads + 1);
+                    parts = scheduler.parts(n_threads);
+                    assign_bounds.resize(parts + 1);
+                    distinct_blocks.resize(parts + 1);
                     distinct_blocks[0] = 0;
-                }
-                assign_bounds[thread_id] = positions.size();
-                distinct_blocks[thread_id + 1] = 0;
-
-#pragma omp for schedule(static)
-                for (size_t i = 0; i < positions.size(); ++i) {
-                    assign_bounds[thread_id] = i;
-                    i = positions.size();
+                    last_chars.resize(parts);
+                    for (size_t part = 0; part <= parts; ++part) {
+                        assign_bounds[part] = positions.size() * part / parts;
+                    }
                 }
 
-                size_t i = assign_bounds[thread_id];
-                if (i == 0) {
-                    distinct_blocks[thread_id + 1]++;
-                    i++;
-                }
+                // the symbol of the block in front of each part is read before any part renames its blocks
+                scheduler.for_each(parts, [&](size_t part) {
+                    size_t i = assign_bounds[part];
+                    distinct_blocks[part + 1] = 0;
+                    last_chars[part] = 0;
+                    if (i == 0 && i < assign_bounds[part + 1]) {
+                        distinct_blocks[part + 1]++;
+                        i++;
+                    } else if (i > 0 && i < assign_bounds[part + 1]) {
+                        last_chars[part] = text[positions[i - 1].second];
+                    }
 
-                for (; i < assign_bounds[thread_id + 1]; ++i) {
-                    if (positions[i].first != positions[i - 1].first ||
-                        text[positions[i].second] != text[positions[i - 1].second]) {
-                        distinct_blocks[thread_id + 1]++;
+                    for (; i < assign_bounds[part + 1]; ++i) {
+                        if (positions[i].first != positions[i - 1].first ||
+                            text[positions[i].second] != text[positions[i - 1].second]) {
+                            distinct_blocks[part + 1]++;
+                        }
                     }
-                }
+                });
 
-#pragma omp barrier
+                this->sync.barrier();
 #pragma omp single
                 {
                     for (size_t j = 1; j < distinct_blocks.size(); ++j) {
                         distinct_blocks[j] += distinct_blocks[j - 1];
                     }
 
-                    auto bc = distinct_blocks[n_threads];
+                    auto bc = distinct_blocks[parts];
                     auto rlslp_size = nt_count + bc;
                     productions.resize(rlslp_size);
                     rlslp.blocks += bc;
@@ -355,64 +656,60 @@ class parallel_recompression : public recompression<variable_t> {
                     productions[k] = rlslp[k];
                 }
 
-                i = assign_bounds[thread_id];
-                auto last_var = next_nt + distinct_blocks[thread_id] - 1;
-                variable_t last_char = 0;
-                if (i > 0 && i < assign_bounds[thread_id + 1]) {
-                    last_char = text[positions[i - 1].second];
-                }
-
-#pragma omp barrier
-                size_t j = 0;
-                if (thread_id == 0) {
-                    last_char = text[positions[i].second];
-                    auto b_len = positions[i].first;
-                    auto len = b_len;
-                    if (last_char >= rlslp.terminals) {
-                        len *= rlslp[last_char - rlslp.terminals].len;
-                    }
-                    productions[nt_count + distinct_blocks[thread_id] + j] = non_terminal<variable_t>(last_char, b_len,
-                                                                                                      len);
-                    j++;
-                    last_var++;
-                    text[positions[i].second] = last_var;
-                    for (size_t k = 1; k < b_len; ++k) {
-                        text[positions[i].second + k] = DELETED;
-                    }
-                    i++;
-                }
-
-                for (; i < assign_bounds[thread_id + 1]; ++i) {
-                    auto char_i = text[positions[i].second];
-                    auto b_len = positions[i].first;
-                    if (char_i == last_char && b_len == positions[i - 1].first) {
-                        text[positions[i].second] = last_var;
-                    } else {
+                scheduler.for_each(parts, [&](size_t part) {
+                    size_t i = assign_bounds[part];
+                    auto last_var = next_nt + distinct_blocks[part] - 1;
+                    variable_t last_char = last_chars[part];
+                    size_t j = 0;
+                    if (i == 0 && i < assign_bounds[part + 1]) {
+                        last_char = text[positions[i].second];
+                        auto b_len = positions[i].first;
                         auto len = b_len;
-                        if (char_i >= rlslp.terminals) {
-                            len *= rlslp[char_i - rlslp.terminals].len;
+                        if (last_char >= rlslp.terminals) {
+                            len *= rlslp[last_char - rlslp.terminals].len;
                         }
-                        productions[nt_count + distinct_blocks[thread_id] + j] = non_terminal<variable_t>(char_i, b_len,
-                                                                                                          len);
+                        productions[nt_count + distinct_blocks[part] + j] = non_terminal<variable_t>(last_char, b_len,
+                                                                                                     len);
                         j++;
                         last_var++;
                         text[positions[i].second] = last_var;
-                        last_char = char_i;
+                        i++;
                     }
-                    for (size_t k = 1; k < b_len; ++k) {
-                        text[positions[i].second + k] = DELETED;
+
+                    for (; i < assign_bounds[part + 1]; ++i) {
+                        auto char_i = text[positions[i].second];
+                        auto b_len = positions[i].first;
+                        if (char_i == last_char && b_len == positions[i - 1].first) {
+                            text[positions[i].second] = last_var;
+                        } else {
+                            auto len = b_len;
+                            if (char_i >= rlslp.terminals) {
+                                len *= rlslp[char_i - rlslp.terminals].len;
+                            }
+                            productions[nt_count + distinct_blocks[part] + j] = non_terminal<variable_t>(char_i, b_len,
+                                                                                                         len);
+                            j++;
+                            last_var++;
+                            text[positions[i].second] = last_var;
+                            last_char = char_i;
+                        }
                     }
-                }
+                });
+                this->sync.leave();
             }
+            this->sync.end();
             std::swap(rlslp.non_terminals, productions);
             productions.resize(1);
             positions.resize(1);
+            mem_rules.end();
+            trace_rules.end();
 #ifdef BENCH
             const auto endTimeRules = recomp::timer::now();
             const auto timeSpanRules = endTimeRules - startTimeRules;
             std::cout << " rules="
                       << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanRules).count())
-                      << " productions=" << distinct_blocks[distinct_blocks.size() - 1] << " elements=" << block_count;
+                      << " productions=" << distinct_blocks[distinct_blocks.size() - 1] << " elements=" << block_count
+                      << mem_rules;
 #endif
 
             compact(text, compact_bounds, block_counts, block_count);
@@ -427,10 +724,54 @@ class parallel_recompression : public recompression<variable_t> {
         const auto timeSpan = endTime - startTime;
         std::cout << " time="
                   << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
-                  << " compressed_text=" << text.size() << std::endl;
+                  << " compressed_text=" << text.size() << mem_bcomp << std::endl;
 #endif
     }
 
+    /**
+     * @brief Compares the pairs at the given text positions by their larger and then by their smaller symbol.
+     *
+     * @param text[in] The text
+     * @param i The position of the first pair
+     * @param j The position of the second pair
+     * @return Whether the first pair is less than the second one
+     */
+    static inline bool adj_less(const text_t& text, size_t i, size_t j) {
+        auto char_i = text[i];
+        auto char_i1 = text[i + 1];
+        auto char_j = text[j];
+        auto char_j1 = text[j + 1];
+        if (char_i > char_i1) {
+            if (char_j > char_j1) {
+                bool less = char_i < char_j;
+                if (char_i == char_j) {
+                    less = char_i1 < char_j1;
+                }
+                return less;
+            } else {
+                bool less = char_i < char_j1;
+                if (char_i == char_j1) {
+                    less = char_i1 < char_j;
+                }
+                return less;
+            }
+        } else {
+            if (char_j > char_j1) {
+                bool less = char_i1 < char_j;
+                if (char_i1 == char_j) {
+                    less = char_i < char_j1;
+                }
+                return less;
+            } else {
+                bool less = char_i1 < char_j1;
+                if (char_i1 == char_j1) {
+                    less = char_i < char_j;
+                }
+                return less;
+            }
+        }
+    }
+
     /**
      * @brief Computes and sorts the adjacency list of the text in ascending order.
      *
@@ -440,14 +781,23 @@ class parallel_recompression : public recompression<variable_t> {
      * @param adj_list[out] The adjacency list (represented as text positions)
      */
     virtual void compute_adj_list(const text_t& text, adj_list_t& adj_list) {
+        memory_phase mem_adj_list("adj_list");
+        trace_scope trace("adj_list");
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
 
-#pragma omp parallel for schedule(static) num_threads(this->cores)
-        for (size_t i = 0; i < adj_list.size(); ++i) {
-            adj_list[i] = i;
+        this->sync.begin();
+#pragma omp parallel num_threads(this->cores)
+        {
+            this->sync.enter();
+#pragma omp for schedule(static) nowait
+            for (size_t i = 0; i < adj_list.size(); ++i) {
+                adj_list[i] = i;
+            }
+            this->sync.leave();
         }
+        this->sync.end();
 
 #ifdef BENCH
         const auto endTime = recomp::timer::now();
@@ -456,46 +806,15 @@ class parallel_recompression : public recompression<variable_t> {
         const auto startTimeMult = recomp::timer::now();
 #endif
         auto sort_adj = [&](size_t i, size_t j) {
-            auto char_i = text[i];
-            auto char_i1 = text[i + 1];
-            auto char_j = text[j];
-            auto char_j1 = text[j + 1];
-            if (char_i > char_i1) {
-                if (char_j > char_j1) {
-                    bool less = char_i < char_j;
-                    if (char_i == char_j) {
-                        less = char_i1 < char_j1;
-                    }
-                    return less;
-                } else {
-                    bool less = char_i < char_j1;
-                    if (char_i == char_j1) {
-                        less = char_i1 < char_j;
-                    }
-                    return less;
-                }
-            } else {
-                if (char_j > char_j1) {
-                    bool less = char_i1 < char_j;
-                    if (char_i1 == char_j) {
-                        less = char_i < char_j1;
-                    }
-                    return less;
-                } else {
-                    bool less = char_i1 < char_j1;
-                    if (char_i1 == char_j1) {
-                        less = char_i < char_j;
-                    }
-                    return less;
-                }
-            }
+            return adj_less(text, i, j);
         };
         ips4o::parallel::sort(adj_list.begin(), adj_list.end(), sort_adj, this->cores);
 #ifdef BENCH
         const auto endTimeMult = recomp::timer::now();
         const auto timeSpanMult = endTimeMult - startTimeMult;
         std::cout << " sort_adj_list="
-                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanMult).count());
+                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanMult).count())
+                  << mem_adj_list;
 #endif
     }
 
@@ -514,21 +833,27 @@ class parallel_recompression : public recompression<variable_t> {
                               adj_list_t& adj_list,
                               bool& part_l,
                               variable_t minimum) {
+        trace_scope trace("directed_cut");
 #ifdef BENCH
         const auto startTimeCount = recomp::timer::now();
 #endif
         adj_list.resize(1);
 
-        int lr_count = 0;
-        int rl_count = 0;
-#pragma omp parallel for num_threads(this->cores) schedule(static) reduction(+:lr_count) reduction(+:rl_count)
-        for (size_t i = 0; i < text.size() - 1; ++i) {
-            if (!partition[text[i] - minimum] && partition[text[i + 1] - minimum]) {
-                lr_count++;
-            } else if (partition[text[i] - minimum] && !partition[text[i + 1] - minimum]) {
-                rl_count++;
-            }
+        size_t lr_count = 0;
+        size_t rl_count = 0;
+        bit_partition bits(partition, this->cores);
+        this->sync.begin();
+#pragma omp parallel num_threads(this->cores) reduction(+:lr_count) reduction(+:rl_count)
+        {
+            this->sync.enter();
+            auto thread_id = static_cast<size_t>(omp_get_thread_num());
+            auto n_threads = static_cast<size_t>(omp_get_num_threads());
+            const size_t pairs = text.size() - 1;
+            bits.count_pairs(text, thread_id * pairs / n_threads, (thread_id + 1) * pairs / n_threads, minimum,
+                             lr_count, rl_count);
+            this->sync.leave();
         }
+        this->sync.end();
         part_l = rl_count > lr_count;
 #ifdef BENCH
         const auto endTimeCount = recomp::timer::now();
@@ -548,6 +873,8 @@ class parallel_recompression : public recompression<variable_t> {
      * @param minimum[in] The smallest symbol in the text
      */
     inline void compute_partition(const text_t& text, partition_t& partition, bool& part_l, variable_t minimum) {
+        memory_phase mem_partition("partition");
+        trace_scope trace("partition");
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
@@ -561,18 +888,25 @@ class parallel_recompression : public recompression<variable_t> {
 #ifdef BENCH
         const auto startTimeInitPar = recomp::timer::now();
 #endif
-#pragma omp parallel for schedule(static) num_threads(this->cores)
-        for (size_t i = 0; i < partition.size(); ++i) {
-            partition[i] = false;
+        this->sync.begin();
+#pragma omp parallel num_threads(this->cores)
+        {
+            this->sync.enter();
+#pragma omp for schedule(static) nowait
+            for (size_t i = 0; i < partition.size(); ++i) {
+                partition[i] = false;
+            }
+            this->sync.leave();
         }
+        this->sync.end();
 #ifdef BENCH
         const auto endTimeInitPar = recomp::timer::now();
         const auto timeSpanInitPar = endTimeInitPar - startTimeInitPar;
         std::cout << " init_partition=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanInitPar).count();
         const auto startTimePar = recomp::timer::now();
 #endif
-        int l_count = 0;
-        int r_count = 0;
+        size_t l_count = 0;
+        size_t r_count = 0;
         variable_t val = 0;
         if (text[adj_list[0]] > text[adj_list[0] + 1]) {
             val = text[adj_list[0]];
@@ -618,7 +952,8 @@ class parallel_recompression : public recompression<variable_t> {
 #ifdef BENCH
         const auto endTime = recomp::timer::now();
         const auto timeSpan = endTime - startTime;
-        std::cout << " partition=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count();
+        std::cout << " partition=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                  << mem_partition;
 #endif
     }
 
@@ -631,16 +966,25 @@ class parallel_recompression : public recompression<variable_t> {
      * @param bv[in,out] The bitvector to indicate which rules derive blocks
      */
     inline void pcomp(text_t& text, rlslp<variable_t>& rlslp, bv_t& bv) {
+        memory_phase mem_pcomp("pcomp");
+        trace_scope trace("pcomp", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         std::cout << "RESULT algo=" << this->name << "_pcomp dataset=" << this->dataset << " text=" << text.size()
                   << " level=" << this->level << " cores=" << this->cores;
 #endif
         variable_t minimum = std::numeric_limits<variable_t>::max();
-#pragma omp parallel for schedule(static) num_threads(this->cores) reduction(min:minimum)
-        for (size_t i = 0; i < text.size(); ++i) {
-            minimum = std::min(minimum, text[i]);
+        this->sync.begin();
+#pragma omp parallel num_threads(this->cores) reduction(min:minimum)
+        {
+            this->sync.enter();
+#pragma omp for schedule(static) nowait
+            for (size_t i = 0; i < text.size(); ++i) {
+                minimum = std::min(minimum, text[i]);
+            }
+            this->sync.leave();
         }
+        this->sync.end();
 #ifdef BENCH
         const auto endTimeInAl = recomp::timer::now();
         const auto timeSpanInAl = endTimeInAl - startTime;
@@ -658,242 +1002,772 @@ class parallel_recompression : public recompression<variable_t> {
         const auto startTimePairs = recomp::timer::now();
         std::cout << " alphabet=" << partition.size();
 #endif
+        bit_partition bits(partition, this->cores);
+        partition.resize(1);
         ui_vector<pair_position_t> positions;
 
-        ui_vector<size_t> bounds;
-        ui_vector<size_t> pair_counts;
         ui_vector<size_t> compact_bounds;
-        ui_vector<size_t> pair_overlaps;
-#pragma omp parallel num_threads(this->cores) reduction(+:pair_count)
-        {
-            auto thread_id = omp_get_thread_num();
-            auto n_threads = static_cast<size_t>(omp_get_num_threads());
-            size_t end_text = text.size() - 1;
-
-#pragma omp single
-            {
-                bounds.resize(n_threads + 1);
-                bounds[0] = 0;
-                compact_bounds.resize(n_threads + 1);
-                compact_bounds[n_threads] = end_text;
-                pair_counts.resize(n_threads + 1);
-                pair_counts[n_threads] = 0;
-                pair_overlaps.resize(n_threads + 1);
-                pair_overlaps[n_threads] = 0;
-            }
-            compact_bounds[thread_id] = end_text;
-            pair_counts[thread_id] = 0;
-            pair_overlaps[thread_id] = 0;
-            std::deque<pair_position_t> t_positions;
-
-#pragma omp for schedule(static)
-            for (size_t i = 0; i < text.size() - 1; ++i) {
-                compact_bounds[thread_id] = i;
-                i = text.size();
+        ui_vector<size_t> pair_counts;
+        pair_count = find_pairs(text, [&](size_t begin, size_t end, auto f) {
+            bits.for_each_pair(text, begin, end, minimum, part_l, f);
+        }, [&](size_t i) {
+            return bits[text[i] - minimum] == part_l && bits[text[i + 1] - minimum] != part_l;
+        }, positions, compact_bounds, pair_counts);
+#ifdef BENCH
+        const auto endTimePairs = recomp::timer::now();
+        const auto timeSpanPairs = endTimePairs - startTimePairs;
+        std::cout << " find_pairs="
+                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanPairs).count());
+        const auto startTimeSort = recomp::timer::now();
+#endif
+        memory_phase mem_sort("sort");
+        trace_scope trace_sort("sort");
+        auto sort_cond = [&](const pair_position_t& i, const pair_position_t& j) {
+            auto char_i = text[i];
+            auto char_i1 = text[i + 1];
+            auto char_j = text[j];
+            auto char_j1 = text[j + 1];
+            if (char_i == char_j) {
+                return char_i1 < char_j1;
+            } else {
+                return char_i < char_j;
             }
-
-            for (size_t i = compact_bounds[thread_id]; i < compact_bounds[thread_id + 1]; ++i) {
-                if (part_l == partition[text[i] - minimum] && part_l != partition[text[i + 1] - minimum]) {
-                    t_positions.emplace_back(i);
-                    pair_count++;
+        };
+        ips4o::parallel::sort(positions.begin(), positions.end(), sort_cond, this->cores);
+        mem_sort.end();
+        trace_sort.end();
+#ifdef BENCH
+        const auto endTimeSort = recomp::timer::now();
+        const auto timeSpanSort = endTimeSort - startTimeSort;
+        std::cout << " sort="
+                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanSort).count())
+                  << mem_sort;
+        const auto rules_before = rlslp.size();
+        const auto startTimeRules = recomp::timer::now();
+#endif
+        memory_phase mem_rules("rules");
+        trace_scope trace_rules("rules");
+        create_pair_rules(text, rlslp, bv, positions, [](variable_t c) {
+            return c;
+        });
+        positions.resize(1);
+        mem_rules.end();
+        trace_rules.end();
+#ifdef BENCH
+        const auto endTimeRules = recomp::timer::now();
+        const auto timeSpanRules = endTimeRules - startTimeRules;
+        std::cout << " rules="
+                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanRules).count())
+                  << " productions=" << rlslp.size() - rules_before << " elements=" << pair_count
+                  << mem_rules;
+#endif
+
+        compact(text, compact_bounds, pair_counts, pair_count);
+
+#ifdef BENCH
+        const auto endTime = recomp::timer::now();
+        const auto timeSpan = endTime - startTime;
+        std::cout << " time="
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                  << " compressed_text=" << text.size() << mem_pcomp << std::endl;
+#endif
+    }
+
+    /**
+     * @brief Returns whether the recompression supports the single region (see @code{single_region}). Variants
+     * computing another partition than parallel or parallel_rnd always start a parallel region per phase.
+     */
+    virtual bool supports_single_region() const {
+        return true;
+    }
+
+    /**
+     * @brief The data of the single region (see @code{single_region}) shared by its threads. The local variables of
+     * a phase are private to the threads, so the phases keep their shared results here.
+     */
+    struct region_state {
+        /**
+         * The slots of the values of the threads to reduce.
+         */
+        enum slot_t {
+            MINIMUM = 0,
+            LR = 1,
+            RL = 2,
+            PROD_L = 3,
+            PROD_R = 4,
+            CUT = 5,
+            SLOTS = 6
+        };
+
+        inline region_state(size_t cores, loop_schedule_t schedule)
+                : cores(cores), scheduler(cores, schedule), values(SLOTS * cores) {}
+
+        /**
+         * @brief Returns the value of the calling thread in the given slot.
+         */
+        inline size_t& value(slot_t slot) {
+            return values[slot * cores + static_cast<size_t>(omp_get_thread_num())];
+        }
+
+        /**
+         * @brief Sums the values of all threads in the given slot. Must be called after a barrier following the
+         * assignments of the values.
+         */
+        inline size_t sum(slot_t slot) const {
+            size_t sum = 0;
+            for (size_t i = 0; i < static_cast<size_t>(omp_get_num_threads()); ++i) {
+                sum += values[slot * cores + i];
+            }
+            return sum;
+        }
+
+        /**
+         * @brief Computes the minimum of the values of all threads in the given slot. Must be called after a barrier
+         * following the assignments of the values.
+         */
+        inline size_t min(slot_t slot) const {
+            size_t min = values[slot * cores];
+            for (size_t i = 1; i < static_cast<size_t>(omp_get_num_threads()); ++i) {
+                min = std::min(min, values[slot * cores + i]);
+            }
+            return min;
+        }
+
+        size_t cores;
+        part_scheduler scheduler;
+        size_t parts = 0;
+        ui_vector<size_t> values;
+        ui_vector<size_t> bounds;          // the bounds of the positions of the parts
+        ui_vector<size_t> compact_bounds;  // the bounds of the parts of the text to copy from
+        ui_vector<size_t> copy_bounds;     // the bounds of the parts of the text to copy to
+        ui_vector<size_t> overlaps;        // the deleted symbols at the beginning of the parts
+        ui_vector<size_t> assign_bounds;   // the bounds of the parts of the sorted positions
+        ui_vector<size_t> distinct;        // the number of distinct blocks or pairs in front of the parts
+        ui_vector<variable_t> last_chars;  // the symbols of the block or pair in front of the parts
+        std::vector<std::deque<position_t>> part_blocks;
+        std::vector<std::deque<pair_position_t>> part_pairs;
+        ui_vector<position_t> blocks;
+        ui_vector<position_t> block_buffer;
+        ui_vector<pair_position_t> pairs;
+        adj_list_t adj_list;
+        ui_vector<size_t> buffer;          // the buffer to sort the pairs or the adjacency list
+        partition_t partition;
+        partition_t candidate;             // the partition of the current iteration of parallel_rnd
+        typename recomp::rlslp<variable_t>::production_t productions;
+        text_t new_text;
+    };
+
+    /**
+     * @brief Runs all rounds of the recompression in one parallel region (see @code{single_region}). All threads of
+     * the region execute every phase, the phases are separated by barriers.
+     *
+     * @param text[in,out] The text
+     * @param rlslp[in,out] The rlslp
+     * @param bv[in,out] The bitvector to indicate which rules derive blocks
+     * @param cores The number of cores to use
+     */
+    inline void recomp_in_region(text_t& text, rlslp<variable_t>& rlslp, bv_t& bv, size_t cores) {
+        trace_scope trace("single_region");
+        this->cores = cores;
+        this->round_text_size = text.size();
+#ifdef BENCH
+        this->sync.reset(true);
+#else
+        this->sync.reset(false);
+#endif
+        region_state state(cores, this->loop_schedule);
+        this->sync.begin();
+#pragma omp parallel num_threads(cores)
+        {
+            this->sync.enter();
+            while (text.size() > 1) {
+                bcomp_in_region(text, rlslp, bv, state);
+                end_round_in_region(text);
+
+                if (text.size() > 1) {
+                    pcomp_in_region(text, rlslp, bv, state);
+                    end_round_in_region(text);
                 }
             }
-            bounds[thread_id + 1] = t_positions.size();
+            this->sync.leave();
+        }
+        this->sync.end();
+#ifdef BENCH
+        std::cout << "RESULT algo=" << this->name << "_region dataset=" << this->dataset << " cores=" << cores
+                  << " fork_ns=" << this->sync.fork_ns << " join_ns=" << this->sync.join_ns << std::endl;
+#endif
+    }
 
+    /**
+     * @brief Ends a round of the single region. One thread reports the barriers of the round with BENCH and starts the
+     * next level. The next phase does not read the level before its first barrier, so there is no barrier at the end.
+     *
+     * @param text[in] The text after the round
+     */
+    inline void end_round_in_region(const text_t& text) {
+#ifdef BENCH
+        // the threads add the waits of the last barrier after leaving it
 #pragma omp barrier
-#pragma omp single
+#endif
+#pragma omp single nowait
+        {
+#ifdef BENCH
+            this->sync.collect();
+            this->end_round();
+            this->sync.reset(true);
+#endif
+            this->round_text_size = text.size();
+            this->level++;
+        }
+    }
+
+    /**
+     * @brief Compacts the text inside the single region like @code{compact}. Ends with a barrier.
+     *
+     * @param text[in,out] The text
+     * @param state[in,out] The state of the region (the bounds of the parts to copy from and to)
+     * @param count[in] The number of found blocks/pairs
+     */
+    inline void compact_in_region(text_t& text, region_state& state, size_t count) {
+        const size_t new_text_size = state.copy_bounds[state.copy_bounds.size() - 1];
+        if (new_text_size > 1 && count > 0) {
+#pragma omp single nowait
             {
-                compact_bounds[n_threads] = text.size();
-                for (size_t j = 1; j < n_threads + 1; ++j) {
-                    bounds[j] += bounds[j - 1];
+                state.new_text = text_t(new_text_size);
+            }
+            this->sync.barrier();
+            state.scheduler.for_each(state.compact_bounds.size() - 1, [&](size_t part) {
+                size_t copy_i = state.copy_bounds[part];
+                for (size_t i = state.compact_bounds[part]; i < state.compact_bounds[part + 1]; ++i) {
+                    if (text[i] != DELETED) {
+                        state.new_text[copy_i++] = text[i];
+                    }
                 }
-                positions.resize(positions.size() + bounds[n_threads]);
+            });
+            this->sync.barrier();
+#pragma omp single nowait
+            {
+                std::swap(text, state.new_text);
+                state.new_text = text_t();
+            }
+        } else if (new_text_size == 1) {
+#pragma omp single nowait
+            {
+                text.resize(new_text_size);
+            }
+        }
+        this->sync.barrier();
+    }
+
+    /**
+     * @brief Replaces all blocks in the text with new non-terminals like @code{bcomp}, but inside the single region.
+     * Must be called by every thread of the region. Ends with a barrier.
+     *
+     * @param text The text
+     * @param rlslp The rlslp
+     * @param bv[in,out] The bitvector to indicate which rules derive blocks
+     * @param state The state of the region
+     */
+    inline void bcomp_in_region(text_t& text, rlslp<variable_t>& rlslp, bv_t& bv, region_state& state) {
+        auto n_threads = static_cast<size_t>(omp_get_num_threads());
+#pragma omp single nowait
+        {
+            state.parts = state.scheduler.parts(n_threads);
+            state.bounds.resize(state.parts + 1);
+            state.bounds[0] = 0;
+            state.compact_bounds.resize(state.parts + 1);
+            state.copy_bounds.resize(state.parts + 1);
+            state.overlaps.resize(state.parts + 1);
+            for (size_t part = 0; part <= state.parts; ++part) {
+                state.compact_bounds[part] = text.size() * part / state.parts;
+                state.copy_bounds[part] = 0;
+                state.overlaps[part] = 0;
+            }
+            state.part_blocks.resize(state.parts);
+        }
+        this->sync.barrier();
+        const size_t parts = state.parts;
 
-                pair_counts[n_threads] = compact_bounds[n_threads] + pair_overlaps[n_threads] - bounds[n_threads];
+        state.scheduler.for_each(parts, [&](size_t part) {
+            std::deque<position_t>& t_positions = state.part_blocks[part];
+            variable_t block_len = 1;
+            size_t i = state.compact_bounds[part];
+            if (i > 0 && i < state.compact_bounds[part + 1]) {
+                const bool add = text[i - 1] != text[i];
+                const size_t end = simd::next_unequal(text.data(), i, text.size() - 1);
+                block_len += end - i;
+                i = end;
+                if (!add) {
+                    state.overlaps[part] = block_len;
+                    block_len = 1;
+                }
+                if (block_len > 1) {
+                    t_positions.emplace_back(block_len, i - block_len + 1);
+                    state.copy_bounds[part + 1] += block_len - 1;
+                    block_len = 1;
+                }
+                i++;
             }
-            std::copy(t_positions.begin(), t_positions.end(), positions.begin() + bounds[thread_id]);
 
-            if (compact_bounds[thread_id] == text.size() - 1) {
-                compact_bounds[thread_id] = text.size();
+            const size_t scan_end = std::min(state.compact_bounds[part + 1], text.size() - 1);
+            for (i = simd::next_equal(text.data(), i, scan_end); i < scan_end;
+                 i = simd::next_equal(text.data(), i + 1, scan_end)) {
+                const size_t end = simd::next_unequal(text.data(), i, text.size() - 1);
+                block_len = static_cast<variable_t>(end - i + 1);
+                t_positions.emplace_back(block_len, i);
+                state.copy_bounds[part + 1] += block_len - 1;
+                block_len = 1;
+                i = end;
             }
 
-            size_t cb = compact_bounds[thread_id];
-            if (cb > 0) {
-                if (cb < text.size()) {
-                    pair_overlaps[thread_id] = (partition[text[cb - 1] - minimum] == part_l &&
-                                                partition[text[cb] - minimum] != part_l) ? 1
-                                                                                         : 0;
+            state.bounds[part + 1] = t_positions.size();
+        });
+
+        this->sync.barrier();
+#pragma omp single nowait
+        {
+            for (size_t j = 1; j < parts + 1; ++j) {
+                state.bounds[j] += state.bounds[j - 1];
+                state.copy_bounds[j] += state.copy_bounds[j - 1];
+            }
+            state.copy_bounds[parts] = state.compact_bounds[parts] + state.overlaps[parts] - state.copy_bounds[parts];
+            state.blocks = ui_vector<position_t>(state.bounds[parts]);
+            state.block_buffer = ui_vector<position_t>(state.bounds[parts]);
+        }
+        this->sync.barrier();
+
+        state.scheduler.for_each(parts, [&](size_t part) {
+            std::deque<position_t>& t_positions = state.part_blocks[part];
+            std::copy(t_positions.begin(), t_positions.end(), state.blocks.begin() + state.bounds[part]);
+            const size_t part_end = state.compact_bounds[part + 1];
+            for (size_t i = state.compact_bounds[part];
+                 i < std::min(state.compact_bounds[part] + state.overlaps[part], part_end); ++i) {
+                text[i] = DELETED;
+            }
+            for (const auto& pos : t_positions) {
+                for (size_t i = pos.second + 1; i < std::min(pos.second + pos.first, part_end); ++i) {
+                    text[i] = DELETED;
                 }
-                pair_counts[thread_id] = cb + pair_overlaps[thread_id] - bounds[thread_id];
             }
+            std::deque<position_t>().swap(t_positions);
+
+            state.copy_bounds[part] = state.compact_bounds[part] + state.overlaps[part] - state.copy_bounds[part];
+        });
+        this->sync.barrier();
+
+        const size_t block_count = state.blocks.size();
+        if (block_count == 0) {
+            return;
         }
-        partition.resize(1);
-        pair_overlaps.resize(1);
-#ifdef BENCH
-        const auto endTimePairs = recomp::timer::now();
-        const auto timeSpanPairs = endTimePairs - startTimePairs;
-        std::cout << " find_pairs="
-                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanPairs).count());
-        const auto startTimeSort = recomp::timer::now();
-#endif
-        auto sort_cond = [&](const pair_position_t& i, const pair_position_t& j) {
-            auto char_i = text[i];
-            auto char_i1 = text[i + 1];
-            auto char_j = text[j];
-            auto char_j1 = text[j + 1];
+        region_sort(state.blocks.data(), state.block_buffer.data(), block_count,
+                    [&](const position_t& i, const position_t& j) {
+            auto char_i = text[i.second];
+            auto char_j = text[j.second];
             if (char_i == char_j) {
-                return char_i1 < char_j1;
+                return i.first < j.first;
             } else {
                 return char_i < char_j;
             }
-        };
-        ips4o::parallel::sort(positions.begin(), positions.end(), sort_cond, this->cores);
-#ifdef BENCH
-        const auto endTimeSort = recomp::timer::now();
-        const auto timeSpanSort = endTimeSort - startTimeSort;
-        std::cout << " sort="
-                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanSort).count());
-        const auto startTimeRules = recomp::timer::now();
-#endif
-        auto nt_count = rlslp.non_terminals.size();
-        auto next_nt = rlslp.terminals + nt_count;
+        }, this->sync);
 
-        ui_vector<size_t> assign_bounds;
-        ui_vector<size_t> distinct_pairs;
-        typename recomp::rlslp<variable_t>::production_t productions;
-#pragma omp parallel num_threads(this->cores)
+        const auto nt_count = rlslp.non_terminals.size();
+        const auto next_nt = rlslp.terminals + nt_count;
+#pragma omp single nowait
         {
-            auto thread_id = omp_get_thread_num();
-            auto n_threads = static_cast<size_t>(omp_get_num_threads());
-
-#pragma omp single
-            {
-                assign_bounds.resize(n_threads + 1);
-                assign_bounds[n_threads] = positions.size();
-                distinct_pairs.resize(n_threads + 1);
-                distinct_pairs[0] = 0;
+            state.block_buffer = ui_vector<position_t>();
+            state.assign_bounds.resize(parts + 1);
+            state.distinct.resize(parts + 1);
+            state.distinct[0] = 0;
+            state.last_chars.resize(parts);
+            for (size_t part = 0; part <= parts; ++part) {
+                state.assign_bounds[part] = block_count * part / parts;
+            }
+        }
+        this->sync.barrier();
+
+        const auto& positions = state.blocks;
+        state.scheduler.for_each(parts, [&](size_t part) {
+            size_t i = state.assign_bounds[part];
+            state.distinct[part + 1] = 0;
+            state.last_chars[part] = 0;
+            if (i == 0 && i < state.assign_bounds[part + 1]) {
+                state.distinct[part + 1]++;
+                i++;
+            } else if (i > 0 && i < state.assign_bounds[part + 1]) {
+                state.last_chars[part] = text[positions[i - 1].second];
             }
-            assign_bounds[thread_id] = positions.size();
-            distinct_pairs[thread_id + 1] = 0;
 
-#pragma omp for schedule(static)
-            for (size_t i = 0; i < positions.size(); ++i) {
-                assign_bounds[thread_id] = i;
-                i = positions.size();
+            for (; i < state.assign_bounds[part + 1]; ++i) {
+                if (positions[i].first != positions[i - 1].first ||
+                    text[positions[i].second] != text[positions[i - 1].second]) {
+                    state.distinct[part + 1]++;
+                }
             }
+        });
 
-            size_t i = assign_bounds[thread_id];
-            if (i == 0) {
-                distinct_pairs[thread_id + 1]++;
-                i++;
+        this->sync.barrier();
+#pragma omp single nowait
+        {
+            for (size_t j = 1; j < state.distinct.size(); ++j) {
+                state.distinct[j] += state.distinct[j - 1];
             }
+            state.productions.resize(nt_count + state.distinct[parts]);
+            rlslp.blocks += state.distinct[parts];
+            bv.resize(nt_count + state.distinct[parts], true);
+        }
+        this->sync.barrier();
 
-            for (; i < assign_bounds[thread_id + 1]; ++i) {
-                if (text[positions[i]] != text[positions[i - 1]] ||
-                    text[positions[i] + 1] != text[positions[i - 1] + 1]) {
-                    distinct_pairs[thread_id + 1]++;
+#pragma omp for schedule(static) nowait
+        for (size_t k = 0; k < nt_count; ++k) {
+            state.productions[k] = rlslp[k];
+        }
+
+        state.scheduler.for_each(parts, [&](size_t part) {
+            size_t i = state.assign_bounds[part];
+            auto last_var = next_nt + state.distinct[part] - 1;
+            variable_t last_char = state.last_chars[part];
+            size_t j = 0;
+            for (; i < state.assign_bounds[part + 1]; ++i) {
+                auto char_i = text[positions[i].second];
+                auto b_len = positions[i].first;
+                if (i == 0 || char_i != last_char || b_len != positions[i - 1].first) {
+                    auto len = b_len;
+                    if (char_i >= rlslp.terminals) {
+                        len *= rlslp[char_i - rlslp.terminals].len;
+                    }
+                    state.productions[nt_count + state.distinct[part] + j] = non_terminal<variable_t>(char_i, b_len,
+                                                                                                      len);
+                    j++;
+                    last_var++;
+                    last_char = char_i;
                 }
+                text[positions[i].second] = last_var;
             }
+        });
+        this->sync.barrier();
+#pragma omp single nowait
+        {
+            std::swap(rlslp.non_terminals, state.productions);
+            state.productions = typename recomp::rlslp<variable_t>::production_t();
+            state.blocks = ui_vector<position_t>();
+        }
 
-#pragma omp barrier
-#pragma omp single
-            {
-                for (size_t j = 1; j < distinct_pairs.size(); ++j) {
-                    distinct_pairs[j] += distinct_pairs[j - 1];
+        compact_in_region(text, state, block_count);
+    }
+
+    /**
+     * @brief Computes and sorts the adjacency list of the text like @code{compute_adj_list}, but inside the single
+     * region. Ends with a barrier.
+     *
+     * @param text[in] The text
+     * @param adj_less[in] The order of the pairs
+     * @param state[in,out] The state of the region (the adjacency list)
+     */
+    template<typename adj_less_t>
+    inline void compute_adj_list_in_region(const text_t& text, adj_less_t adj_less, region_state& state) {
+#pragma omp single nowait
+        {
+            state.adj_list = adj_list_t(text.size() - 1);
+            state.buffer = ui_vector<size_t>(text.size() - 1);
+        }
+        this->sync.barrier();
+#pragma omp for schedule(static) nowait
+        for (size_t i = 0; i < state.adj_list.size(); ++i) {
+            state.adj_list[i] = i;
+        }
+        this->sync.barrier();
+        region_sort(state.adj_list.data(), state.buffer.data(), state.adj_list.size(), adj_less, this->sync);
+#pragma omp single nowait
+        {
+            state.buffer = ui_vector<size_t>();
+        }
+    }
+
+    /**
+     * @brief Computes the partition like @code{compute_partition}, but inside the single region. Every thread gets
+     * the same value of @code{part_l}. Ends with a barrier.
+     *
+     * @param text[in] The text
+     * @param minimum[in] The smallest symbol in the text
+     * @param part_l[out] Indicates which partition set is the first one (@code{false} if symbol with value false
+     *                    are in Sigma_l, otherwise all symbols with value true are in Sigma_l)
+     * @param state[in,out] The state of the region (the partition)
+     */
+    virtual void compute_partition_in_region(const text_t& text, variable_t minimum, bool& part_l,
+                                             region_state& state) {
+        compute_adj_list_in_region(text, [&](size_t i, size_t j) {
+            return adj_less(text, i, j);
+        }, state);
+        partition_t& partition = state.partition;
+#pragma omp for schedule(static) nowait
+        for (size_t i = 0; i < partition.size(); ++i) {
+            partition[i] = false;
+        }
+        this->sync.barrier();
+
+        // the undirected cut is sequential, the other threads wait in the barrier
+#pragma omp single nowait
+        {
+            const adj_list_t& adj_list = state.adj_list;
+            size_t l_count = 0;
+            size_t r_count = 0;
+            variable_t val = 0;
+            if (text[adj_list[0]] > text[adj_list[0] + 1]) {
+                val = text[adj_list[0]];
+                partition[text[adj_list[0] + 1] - minimum] = false;
+            } else {
+                val = text[adj_list[0] + 1];
+                partition[text[adj_list[0]] - minimum] = false;
+            }
+
+            l_count++;
+            for (size_t i = 1; i < adj_list.size(); ++i) {
+                auto text_i = text[adj_list[i]];
+                auto text_i1 = text[adj_list[i] + 1];
+                if (text_i1 > text_i) {
+                    std::swap(text_i, text_i1);
                 }
 
-                auto pc = distinct_pairs[n_threads];
-                auto rlslp_size = nt_count + pc;
-                productions.resize(rlslp_size);
-                bv.resize(rlslp_size, false);
+                if (val < text_i) {
+                    partition[val - minimum] = l_count > r_count;
+                    l_count = 0;
+                    r_count = 0;
+                    val = text_i;
+                }
+                if (partition[text_i1 - minimum]) {
+                    r_count++;
+                } else {
+                    l_count++;
+                }
             }
-#pragma omp for schedule(static)
-            for (size_t k = 0; k < rlslp.size(); ++k) {
-                productions[k] = rlslp[k];
+            partition[val - minimum] = l_count > r_count;
+            state.adj_list = adj_list_t();
+        }
+        this->sync.barrier();
+
+        size_t lr_count = 0;
+        size_t rl_count = 0;
+#pragma omp for schedule(static) nowait
+        for (size_t i = 0; i < text.size() - 1; ++i) {
+            const bool left = partition[text[i] - minimum];
+            const bool right = partition[text[i + 1] - minimum];
+            if (!left && right) {
+                lr_count++;
+            } else if (left && !right) {
+                rl_count++;
             }
+        }
+        state.value(region_state::LR) = lr_count;
+        state.value(region_state::RL) = rl_count;
+        this->sync.barrier();
+        part_l = state.sum(region_state::RL) > state.sum(region_state::LR);
+    }
 
-            i = assign_bounds[thread_id];
-            auto last_var = next_nt + distinct_pairs[thread_id] - 1;
-            variable_t last_char1 = 0;
-            variable_t last_char2 = 0;
-            if (i > 0 && i < assign_bounds[thread_id + 1]) {
-                last_char1 = text[positions[i - 1]];
-                last_char2 = text[positions[i - 1] + 1];
+    /**
+     * @brief Finds the positions of the pairs in the text like @code{find_pairs}, but inside the single region. Ends
+     * with a barrier.
+     *
+     * @param text[in] The text
+     * @param is_pair[in] Whether a pair starts at the given position
+     * @param state[in,out] The state of the region (the positions of the pairs and the bounds of the parts)
+     */
+    template<typename is_pair_t>
+    inline void find_pairs_in_region(const text_t& text, is_pair_t is_pair, region_state& state) {
+        auto n_threads = static_cast<size_t>(omp_get_num_threads());
+        const size_t end_text = text.size() - 1;
+#pragma omp single nowait
+        {
+            state.parts = state.scheduler.parts(n_threads);
+            state.bounds.resize(state.parts + 1);
+            state.bounds[0] = 0;
+            state.compact_bounds.resize(state.parts + 1);
+            state.copy_bounds.resize(state.parts + 1);
+            state.overlaps.resize(state.parts + 1);
+            for (size_t part = 0; part <= state.parts; ++part) {
+                state.compact_bounds[part] = end_text * part / state.parts;
+                state.copy_bounds[part] = 0;
+                state.overlaps[part] = 0;
             }
+            state.part_pairs.resize(state.parts);
+        }
+        this->sync.barrier();
+        const size_t parts = state.parts;
 
-#pragma omp barrier
-            size_t j = 0;
-            if (thread_id == 0) {
-                last_char1 = text[positions[i]];
-                last_char2 = text[positions[i] + 1];
-                size_t len = 0;
-                if (last_char1 >= rlslp.terminals) {
-                    len = rlslp[last_char1 - rlslp.terminals].len;
-                } else {
-                    len = 1;
-                }
-                if (last_char2 >= rlslp.terminals) {
-                    len += rlslp[last_char2 - rlslp.terminals].len;
-                } else {
-                    len += 1;
+        state.scheduler.for_each(parts, [&](size_t part) {
+            std::deque<pair_position_t>& t_positions = state.part_pairs[part];
+            for (size_t i = state.compact_bounds[part]; i < state.compact_bounds[part + 1]; ++i) {
+                if (is_pair(i)) {
+                    t_positions.emplace_back(i);
                 }
-                productions[nt_count + distinct_pairs[thread_id] + j] = non_terminal<variable_t>(last_char1, last_char2,
-                                                                                                 len);
-                j++;
-                last_var++;
-                text[positions[i]] = last_var;
-                text[positions[i] + 1] = DELETED;
+            }
+            state.bounds[part + 1] = t_positions.size();
+        });
+
+        this->sync.barrier();
+#pragma omp single nowait
+        {
+            state.compact_bounds[parts] = text.size();
+            for (size_t j = 1; j < parts + 1; ++j) {
+                state.bounds[j] += state.bounds[j - 1];
+            }
+            state.pairs = ui_vector<pair_position_t>(state.bounds[parts]);
+            state.buffer = ui_vector<size_t>(state.bounds[parts]);
+            state.copy_bounds[parts] = state.compact_bounds[parts] + state.overlaps[parts] - state.bounds[parts];
+        }
+        this->sync.barrier();
+
+        state.scheduler.for_each(parts, [&](size_t part) {
+            std::deque<pair_position_t>& t_positions = state.part_pairs[part];
+            std::copy(t_positions.begin(), t_positions.end(), state.pairs.begin() + state.bounds[part]);
+            std::deque<pair_position_t>().swap(t_positions);
+
+            size_t cb = state.compact_bounds[part];
+            if (cb > 0) {
+                state.overlaps[part] = is_pair(cb - 1) ? 1 : 0;
+                state.copy_bounds[part] = cb + state.overlaps[part] - state.bounds[part];
+            }
+        });
+        this->sync.barrier();
+    }
+
+    /**
+     * @brief Replaces all pairs in the text based on a partition of the symbols with new non-terminals like
+     * @code{pcomp}, but inside the single region. Must be called by every thread of the region. Ends with a barrier.
+     *
+     * @param text The text
+     * @param rlslp The rlslp
+     * @param bv[in,out] The bitvector to indicate which rules derive blocks
+     * @param state The state of the region
+     */
+    inline void pcomp_in_region(text_t& text, rlslp<variable_t>& rlslp, bv_t& bv, region_state& state) {
+        variable_t minimum = std::numeric_limits<variable_t>::max();
+#pragma omp for schedule(static) nowait
+        for (size_t i = 0; i < text.size(); ++i) {
+            minimum = std::min(minimum, text[i]);
+        }
+        state.value(region_state::MINIMUM) = minimum;
+        this->sync.barrier();
+        minimum = static_cast<variable_t>(state.min(region_state::MINIMUM));
+
+        // the partition is first used after the first barrier of the partitioning
+#pragma omp single nowait
+        {
+            state.partition = partition_t(rlslp.size() + rlslp.terminals - minimum);
+        }
+        bool part_l = false;
+        compute_partition_in_region(text, minimum, part_l, state);
+
+        const partition_t& partition = state.partition;
+        find_pairs_in_region(text, [&](size_t i) {
+            return part_l == partition[text[i] - minimum] && part_l != partition[text[i + 1] - minimum];
+        }, state);
+#pragma omp single nowait
+        {
+            state.partition = partition_t();
+        }
+
+        const size_t pair_count = state.pairs.size();
+        region_sort(state.pairs.data(), state.buffer.data(), pair_count,
+                    [&](const pair_position_t& i, const pair_position_t& j) {
+            auto char_i = text[i];
+            auto char_i1 = text[i + 1];
+            auto char_j = text[j];
+            auto char_j1 = text[j + 1];
+            if (char_i == char_j) {
+                return char_i1 < char_j1;
+            } else {
+                return char_i < char_j;
+            }
+        }, this->sync);
+
+        const auto nt_count = rlslp.non_terminals.size();
+        const auto next_nt = rlslp.terminals + nt_count;
+        const size_t parts = state.parts;
+#pragma omp single nowait
+        {
+            state.buffer = ui_vector<size_t>();
+            state.assign_bounds.resize(parts + 1);
+            state.distinct.resize(parts + 1);
+            state.distinct[0] = 0;
+            state.last_chars.resize(2 * parts);
+            for (size_t part = 0; part <= parts; ++part) {
+                state.assign_bounds[part] = pair_count * part / parts;
+            }
+        }
+        this->sync.barrier();
+
+        const auto& positions = state.pairs;
+        state.scheduler.for_each(parts, [&](size_t part) {
+            size_t i = state.assign_bounds[part];
+            state.distinct[part + 1] = 0;
+            state.last_chars[2 * part] = 0;
+            state.last_chars[2 * part + 1] = 0;
+            if (i == 0 && i < state.assign_bounds[part + 1]) {
+                state.distinct[part + 1]++;
                 i++;
+            } else if (i > 0 && i < state.assign_bounds[part + 1]) {
+                state.last_chars[2 * part] = text[positions[i - 1]];
+                state.last_chars[2 * part + 1] = text[positions[i - 1] + 1];
             }
 
-            for (; i < assign_bounds[thread_id + 1]; ++i) {
+            for (; i < state.assign_bounds[part + 1]; ++i) {
+                if (text[positions[i]] != text[positions[i - 1]] ||
+                    text[positions[i] + 1] != text[positions[i - 1] + 1]) {
+                    state.distinct[part + 1]++;
+                }
+            }
+        });
+
+        this->sync.barrier();
+#pragma omp single nowait
+        {
+            for (size_t j = 1; j < state.distinct.size(); ++j) {
+                state.distinct[j] += state.distinct[j - 1];
+            }
+            state.productions.resize(nt_count + state.distinct[parts]);
+            bv.resize(nt_count + state.distinct[parts], false);
+        }
+        this->sync.barrier();
+
+#pragma omp for schedule(static) nowait
+        for (size_t k = 0; k < nt_count; ++k) {
+            state.productions[k] = rlslp[k];
+        }
+
+        auto rule_len = [&](variable_t char_1, variable_t char_2) {
+            size_t len = char_1 >= rlslp.terminals ? rlslp[char_1 - rlslp.terminals].len : 1;
+            return len + (char_2 >= rlslp.terminals ? rlslp[char_2 - rlslp.terminals].len : 1);
+        };
+        state.scheduler.for_each(parts, [&](size_t part) {
+            size_t i = state.assign_bounds[part];
+            auto last_var = next_nt + state.distinct[part] - 1;
+            variable_t last_char1 = state.last_chars[2 * part];
+            variable_t last_char2 = state.last_chars[2 * part + 1];
+            size_t j = 0;
+            for (; i < state.assign_bounds[part + 1]; ++i) {
                 auto char_i1 = text[positions[i]];
                 auto char_i2 = text[positions[i] + 1];
-                if (char_i1 == last_char1 && char_i2 == last_char2) {
-                    text[positions[i]] = last_var;
-                } else {
-                    size_t len = 0;
-                    if (char_i1 >= rlslp.terminals) {
-                        len = rlslp[char_i1 - rlslp.terminals].len;
-                    } else {
-                        len = 1;
-                    }
-                    if (char_i2 >= rlslp.terminals) {
-                        len += rlslp[char_i2 - rlslp.terminals].len;
-                    } else {
-                        len += 1;
-                    }
-                    productions[nt_count + distinct_pairs[thread_id] + j] = non_terminal<variable_t>(char_i1, char_i2,
-                                                                                                     len);
+                if (i == 0 || char_i1 != last_char1 || char_i2 != last_char2) {
+                    state.productions[nt_count + state.distinct[part] + j] = non_terminal<variable_t>(
+                            char_i1, char_i2, rule_len(char_i1, char_i2));
                     j++;
                     last_var++;
-                    text[positions[i]] = last_var;
                     last_char1 = char_i1;
                     last_char2 = char_i2;
                 }
+                text[positions[i]] = last_var;
                 text[positions[i] + 1] = DELETED;
             }
+        });
+        this->sync.barrier();
+#pragma omp single nowait
+        {
+            std::swap(rlslp.non_terminals, state.productions);
+            state.productions = typename recomp::rlslp<variable_t>::production_t();
+            state.pairs = ui_vector<pair_position_t>();
         }
-        std::swap(rlslp.non_terminals, productions);
-        productions.resize(1);
-        positions.resize(1);
-#ifdef BENCH
-        const auto endTimeRules = recomp::timer::now();
-        const auto timeSpanRules = endTimeRules - startTimeRules;
-        std::cout << " rules="
-                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanRules).count())
-                  << " productions=" << distinct_pairs[distinct_pairs.size() - 1] << " elements=" << pair_count;
-#endif
-
-        compact(text, compact_bounds, pair_counts, pair_count);
 
-#ifdef BENCH
-        const auto endTime = recomp::timer::now();
-        const auto timeSpan = endTime - startTime;
-        std::cout << " time="
-                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
-                  << " compressed_text=" << text.size() << std::endl;
-#endif
+        compact_in_region(text, state, pair_count);
     }
 
     inline void compute_graph_stats(const text_t& text, adj_list_t& adj_list) {
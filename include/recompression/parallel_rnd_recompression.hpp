@@ -19,6 +19,7 @@
 #include "parallel_lp_recompression.hpp"
 #include "defs.hpp"
 #include "util.hpp"
+#include "random.hpp"
 #include "rlslp.hpp"
 
 namespace recomp {
@@ -44,6 +45,7 @@ class parallel_rnd_recompression : public parallel_lp_recompression<variable_t>
     typedef typename recompression<variable_t>::bv_t bv_t;
     typedef typename parallel_recompression<variable_t>::adj_t adj_t;
     typedef typename parallel_recompression<variable_t>::adj_list_t adj_list_t;
+    typedef typename parallel_recompression<variable_t>::region_state region_state;
     typedef ui_vector<bool> partition_t;
     typedef size_t pair_position_t;
 
@@ -87,21 +89,32 @@ class parallel_rnd_recompression : public parallel_lp_recompression<variable_t>
                                rlslp<variable_t>& rlslp,
                                const size_t& alphabet_size,
                                const size_t cores) override {
+        trace_scope trace("recompression", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         size_t text_size = text.size();
 #endif
-        this->cores = cores;
         rlslp.terminals = alphabet_size;
         bv_t bv;
 
-        while (text.size() > 1) {
-            this->bcomp(text, rlslp, bv);
-            this->level++;
-
-            if (text.size() > 1) {
-                pcomp(text, rlslp, bv);
-                this->level++;
+        {
+            typename recompression<variable_t>::cores_guard guard(*this, cores);
+            if (this->single_region && this->supports_single_region()) {
+                this->recomp_in_region(text, rlslp, bv, cores);
+            } else {
+                while (text.size() > 1) {
+                    this->begin_round(text.size(), cores);
+                    this->bcomp(text, rlslp, bv);
+                    this->end_round();
+                    this->level++;
+
+                    if (text.size() > 1) {
+                        this->begin_round(text.size(), cores);
+                        pcomp(text, rlslp, bv);
+                        this->end_round();
+                        this->level++;
+                    }
+                }
             }
         }
 
@@ -137,6 +150,8 @@ class parallel_rnd_recompression : public parallel_lp_recompression<variable_t>
      * @param minimum[in] The smallest symbol in the text
      */
     virtual void compute_partition(const text_t& text, partition_t& partition, bool& part_l, variable_t minimum) {
+        memory_phase mem_partition("partition");
+        trace_scope trace("partition");
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
@@ -154,16 +169,7 @@ class parallel_rnd_recompression : public parallel_lp_recompression<variable_t>
 #endif
             partition[0] = false;  // ensure, that minimum one symbol is in the left partition and one in the right
             partition[partition.size() - 1] = true;
-#pragma omp parallel num_threads(this->cores)
-            {
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                std::uniform_int_distribution<uint8_t> distribution(0, 1);
-#pragma omp for schedule(static)
-                for (size_t i = 1; i < partition.size() - 1; ++i) {
-                    partition[i] = (distribution(gen) == 1);
-                }
-            }
+            counter_rng(this->seed, this->level).fill(partition, 1, partition.size() - 1, this->cores);
 
 #ifdef BENCH
             const auto endTimePar = recomp::timer::now();
@@ -172,8 +178,8 @@ class parallel_rnd_recompression : public parallel_lp_recompression<variable_t>
 #endif
         } else {
 
-            int tmp_cut = 0;
-            int cut = 0;
+            size_t tmp_cut = 0;
+            size_t cut = 0;
             for (size_t j = 0; j < this->iters; ++j) {
 #ifdef BENCH
                 const auto startTimePar = recomp::timer::now();
@@ -182,17 +188,13 @@ class parallel_rnd_recompression : public parallel_lp_recompression<variable_t>
                 partition_t tmp_part(partition.size());
                 tmp_part[0] = false;  // ensure, that minimum one symbol is in the left partition and one in the right
                 tmp_part[tmp_part.size() - 1] = true;
-#pragma omp parallel num_threads(this->cores)
-                {
-                    std::random_device rd;
-                    std::mt19937 gen(rd());
-                    std::uniform_int_distribution<uint8_t> distribution(0, 1);
-#pragma omp for schedule(static)
-                    for (size_t i = 1; i < tmp_part.size() - 1; ++i) {
-                        tmp_part[i] = (distribution(gen) == 1);
-                    }
+                counter_rng(this->seed, this->level, j).fill(tmp_part, 1, tmp_part.size() - 1, this->cores);
 
-#pragma omp for schedule(static) reduction(+:tmp_cut)
+                this->sync.begin();
+#pragma omp parallel num_threads(this->cores) reduction(+:tmp_cut)
+                {
+                    this->sync.enter();
+#pragma omp for schedule(static) nowait
                     for (size_t i = 0; i < adj_list.size(); ++i) {
                         variable_t char_i = text[adj_list[i]] - minimum;
                         variable_t char_i1 = text[adj_list[i] + 1] - minimum;
@@ -200,7 +202,9 @@ class parallel_rnd_recompression : public parallel_lp_recompression<variable_t>
                             tmp_cut++;
                         }
                     }
+                    this->sync.leave();
                 }
+                this->sync.end();
                 if (cut < tmp_cut) {
                     cut = tmp_cut;
                     partition.swap(tmp_part);
@@ -217,13 +221,15 @@ class parallel_rnd_recompression : public parallel_lp_recompression<variable_t>
 #ifdef BENCH
             const auto startTimeCount = recomp::timer::now();
 #endif
-        int lr_count = 0;
-        int rl_count = 0;
-        int prod_l = 0;
-        int prod_r = 0;
+        size_t lr_count = 0;
+        size_t rl_count = 0;
+        size_t prod_l = 0;
+        size_t prod_r = 0;
         ui_vector<size_t> bounds;
+        this->sync.begin();
 #pragma omp parallel num_threads(this->cores) reduction(+:lr_count) reduction(+:rl_count) reduction(+:prod_r) reduction(+:prod_l)
         {
+            this->sync.enter();
             auto thread_id = omp_get_thread_num();
             auto n_threads = static_cast<size_t>(omp_get_num_threads());
 
@@ -276,7 +282,9 @@ class parallel_rnd_recompression : public parallel_lp_recompression<variable_t>
                 last_i = char_i;
                 last_i1 = char_i1;
             }
+            this->sync.leave();
         }
+        this->sync.end();
         part_l = rl_count > lr_count;
         if (rl_count == lr_count) {
             part_l = prod_r < prod_l;
@@ -288,11 +296,141 @@ class parallel_rnd_recompression : public parallel_lp_recompression<variable_t>
                   << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanCount).count();
         const auto endTime = recomp::timer::now();
         const auto timeSpan = endTime - startTime;
-        std::cout << " partition=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count();
+        std::cout << " partition=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
+                  << mem_partition;
 #endif
     }
 
 
+    inline virtual bool supports_single_region() const override {
+        return true;
+    }
+
+    /**
+     * @brief Computes the random partition like @code{compute_partition}, but inside the single region. Every thread
+     * gets the same value of @code{part_l}. Ends with a barrier.
+     *
+     * @param text[in] The text
+     * @param minimum[in] The smallest symbol in the text
+     * @param part_l[out] Indicates which partition set is the first one (@code{false} if symbol with value false
+     *                    are in Sigma_l, otherwise all symbols with value true are in Sigma_l)
+     * @param state[in,out] The state of the region (the partition)
+     */
+    virtual void compute_partition_in_region(const text_t& text, variable_t minimum, bool& part_l,
+                                             region_state& state) override {
+        this->compute_adj_list_in_region(text, [&](size_t i, size_t j) {
+            return this->oriented_adj_less(text, i, j);
+        }, state);
+        partition_t& partition = state.partition;
+        const adj_list_t& adj_list = state.adj_list;
+        if (this->iters == 1) {
+#pragma omp single nowait
+            {
+                partition[0] = false;  // ensure, that minimum one symbol is in the left partition and one in the right
+                partition[partition.size() - 1] = true;
+            }
+            counter_rng(this->seed, this->level).fill_in_region(partition, 1, partition.size() - 1);
+        } else {
+            size_t cut = 0;
+            for (size_t j = 0; j < this->iters; ++j) {
+#pragma omp single nowait
+                {
+                    state.candidate = partition_t(partition.size());
+                    state.candidate[0] = false;
+                    state.candidate[partition.size() - 1] = true;
+                }
+                this->sync.barrier();
+                counter_rng(this->seed, this->level, j).fill_in_region(state.candidate, 1, partition.size() - 1);
+                this->sync.barrier();
+
+                size_t tmp_cut = 0;
+#pragma omp for schedule(static) nowait
+                for (size_t i = 0; i < adj_list.size(); ++i) {
+                    variable_t char_i = text[adj_list[i]] - minimum;
+                    variable_t char_i1 = text[adj_list[i] + 1] - minimum;
+                    if (state.candidate[char_i] != state.candidate[char_i1]) {
+                        tmp_cut++;
+                    }
+                }
+                state.value(region_state::CUT) = tmp_cut;
+                this->sync.barrier();
+                tmp_cut = state.sum(region_state::CUT);
+                if (cut < tmp_cut) {  // the same decision in every thread
+                    cut = tmp_cut;
+#pragma omp single nowait
+                    {
+                        std::swap(partition, state.candidate);
+                    }
+                    this->sync.barrier();
+                }
+            }
+#pragma omp single nowait
+            {
+                state.candidate = partition_t();
+            }
+        }
+        this->sync.barrier();
+
+        auto thread_id = static_cast<size_t>(omp_get_thread_num());
+        auto n_threads = static_cast<size_t>(omp_get_num_threads());
+        size_t lr_count = 0;
+        size_t rl_count = 0;
+        size_t prod_l = 0;
+        size_t prod_r = 0;
+        variable_t last_i = 0;  // avoid more random access than necessary
+        variable_t last_i1 = 0;
+        size_t i = adj_list.size() * thread_id / n_threads;
+        const size_t end = adj_list.size() * (thread_id + 1) / n_threads;
+        if (i == 0 && i < end) {
+            last_i = text[adj_list[i]] - minimum;
+            last_i1 = text[adj_list[i] + 1] - minimum;
+            if (!partition[last_i] && partition[last_i1]) {
+                lr_count++;
+                prod_l++;
+            } else if (partition[last_i] && !partition[last_i1]) {
+                rl_count++;
+                prod_r++;
+            }
+            i++;
+        } else if (i > 0 && i < end) {
+            last_i = text[adj_list[i - 1]] - minimum;
+            last_i1 = text[adj_list[i - 1] + 1] - minimum;
+        }
+
+        for (; i < end; ++i) {
+            variable_t char_i = text[adj_list[i]] - minimum;
+            variable_t char_i1 = text[adj_list[i] + 1] - minimum;
+            if (!partition[char_i] && partition[char_i1]) {
+                lr_count++;
+                if (char_i != last_i || char_i1 != last_i1) {
+                    prod_l++;
+                }
+            } else if (partition[char_i] && !partition[char_i1]) {
+                rl_count++;
+                if (char_i != last_i || char_i1 != last_i1) {
+                    prod_r++;
+                }
+            }
+            last_i = char_i;
+            last_i1 = char_i1;
+        }
+        state.value(region_state::LR) = lr_count;
+        state.value(region_state::RL) = rl_count;
+        state.value(region_state::PROD_L) = prod_l;
+        state.value(region_state::PROD_R) = prod_r;
+        this->sync.barrier();
+        lr_count = state.sum(region_state::LR);
+        rl_count = state.sum(region_state::RL);
+        part_l = rl_count > lr_count;
+        if (rl_count == lr_count) {
+            part_l = state.sum(region_state::PROD_R) < state.sum(region_state::PROD_L);
+        }
+#pragma omp single nowait
+        {
+            state.adj_list = adj_list_t();
+        }
+    }
+
     /**
      * @brief Replaces all pairs in the text based on a partition of the symbols with new non-terminals.
      *
@@ -301,16 +439,25 @@ class parallel_rnd_recompression : public parallel_lp_recompression<variable_t>
      * @param bv[in,out] The bitvector to indicate which rules derive blocks
      */
     inline void pcomp(text_t& text, rlslp<variable_t>& rlslp, bv_t& bv) {
+        memory_phase mem_pcomp("pcomp");
+        trace_scope trace("pcomp", "recompression", "text", text.size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
         std::cout << "RESULT algo=" << this->name << "_pcomp dataset=" << this->dataset << " text=" << text.size()
                   << " level=" << this->level << " cores=" << this->cores;
 #endif
         variable_t minimum = std::numeric_limits<variable_t>::max();
-#pragma omp parallel for schedule(static) num_threads(this->cores) reduction(min:minimum)
-        for (size_t i = 0; i < text.size(); ++i) {
-            minimum = std::min(minimum, text[i]);
+        this->sync.begin();
+#pragma omp parallel num_threads(this->cores) reduction(min:minimum)
+        {
+            this->sync.enter();
+#pragma omp for schedule(static) nowait
+            for (size_t i = 0; i < text.size(); ++i) {
+                minimum = std::min(minimum, text[i]);
+            }
+            this->sync.leave();
         }
+        this->sync.end();
 #ifdef BENCH
         const auto endTimeInAl = recomp::timer::now();
         const auto timeSpanInAl = endTimeInAl - startTime;
@@ -330,74 +477,12 @@ class parallel_rnd_recompression : public parallel_lp_recompression<variable_t>
 #endif
         ui_vector<pair_position_t> positions;
 
-        ui_vector<size_t> bounds;
-        ui_vector<size_t> pair_counts;
         ui_vector<size_t> compact_bounds;
-        ui_vector<size_t> pair_overlaps;
-#pragma omp parallel num_threads(this->cores) reduction(+:pair_count)
-        {
-            auto thread_id = omp_get_thread_num();
-            auto n_threads = static_cast<size_t>(omp_get_num_threads());
-            size_t end_text = text.size() - 1;
-
-#pragma omp single
-            {
-                bounds.resize(n_threads + 1);
-                bounds[0] = 0;
-                compact_bounds.resize(n_threads + 1);
-                compact_bounds[n_threads] = end_text;
-                pair_counts.resize(n_threads + 1);
-                pair_counts[n_threads] = 0;
-                pair_overlaps.resize(n_threads + 1);
-                pair_overlaps[n_threads] = 0;
-            }
-            compact_bounds[thread_id] = end_text;
-            pair_counts[thread_id] = 0;
-            pair_overlaps[thread_id] = 0;
-            std::deque<pair_position_t> t_positions;
-
-#pragma omp for schedule(static)
-            for (size_t i = 0; i < text.size() - 1; ++i) {
-                compact_bounds[thread_id] = i;
-                i = text.size();
-            }
-
-            for (size_t i = compact_bounds[thread_id]; i < compact_bounds[thread_id + 1]; ++i) {
-                if (part_l == partition[text[i] - minimum] && part_l != partition[text[i + 1] - minimum]) {
-                    t_positions.emplace_back(i);
-                    pair_count++;
-                }
-            }
-
-            bounds[thread_id + 1] = t_positions.size();
-
-#pragma omp barrier
-#pragma omp single
-            {
-                compact_bounds[n_threads] = text.size();
-                for (size_t j = 1; j < n_threads + 1; ++j) {
-                    bounds[j] += bounds[j - 1];
-                }
-                positions.resize(positions.size() + bounds[n_threads]);
-
-                pair_counts[n_threads] = compact_bounds[n_threads] + pair_overlaps[n_threads] - bounds[n_threads];
-            }
-            std::copy(t_positions.begin(), t_positions.end(), positions.begin() + bounds[thread_id]);
-
-            if (compact_bounds[thread_id] == text.size() - 1) {
-                compact_bounds[thread_id] = text.size();
-            }
-
-            size_t cb = compact_bounds[thread_id];
-            if (cb > 0) {
-                if (cb < text.size()) {
-                    pair_overlaps[thread_id] = (partition[text[cb - 1] - minimum] == part_l && partition[text[cb] - minimum] != part_l) ? 1 : 0;
-                }
-                pair_counts[thread_id] = cb + pair_overlaps[thread_id] - bounds[thread_id];
-            }
-        }
+        ui_vector<size_t> pair_counts;
+        pair_count = this->find_pairs(text, [&](size_t i) {
+            return part_l == partition[text[i] - minimum] && part_l != partition[text[i + 1] - minimum];
+        }, positions, compact_bounds, pair_counts);
         partition.resize(1);
-        pair_overlaps.resize(1);
 #ifdef BENCH
         const auto endTimePairs = recomp::timer::now();
         const auto timeSpanPairs = endTimePairs - startTimePairs;
@@ -405,6 +490,8 @@ class parallel_rnd_recompression : public parallel_lp_recompression<variable_t>
                   << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanPairs).count());
         const auto startTimeSort = recomp::timer::now();
 #endif
+        memory_phase mem_sort("sort");
+        trace_scope trace_sort("sort");
         auto sort_cond = [&](const pair_position_t& i, const pair_position_t& j) {
             auto char_i = text[i];
             auto char_i1 = text[i + 1];
@@ -417,138 +504,31 @@ class parallel_rnd_recompression : public parallel_lp_recompression<variable_t>
             }
         };
         ips4o::parallel::sort(positions.begin(), positions.end(), sort_cond, this->cores);
+        mem_sort.end();
+        trace_sort.end();
 #ifdef BENCH
         const auto endTimeSort = recomp::timer::now();
         const auto timeSpanSort = endTimeSort - startTimeSort;
         std::cout << " sort="
-                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanSort).count());
+                  << std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanSort).count())
+                  << mem_sort;
+        const auto rules_before = rlslp.size();
         const auto startTimeRules = recomp::timer::now();
 #endif
-        auto nt_count = rlslp.non_terminals.size();
-        auto next_nt = rlslp.terminals + nt_count;
-
-        ui_vector<size_t> assign_bounds;
-        ui_vector<size_t> distinct_pairs;
-        typename recomp::rlslp<variable_t>::production_t productions;
-#pragma omp parallel num_threads(this->cores)
-        {
-            auto thread_id = omp_get_thread_num();
-            auto n_threads = static_cast<size_t>(omp_get_num_threads());
-
-#pragma omp single
-            {
-                assign_bounds.resize(n_threads + 1);
-                assign_bounds[n_threads] = positions.size();
-                distinct_pairs.resize(n_threads + 1);
-                distinct_pairs[0] = 0;
-            }
-            assign_bounds[thread_id] = positions.size();
-            distinct_pairs[thread_id + 1] = 0;
-
-#pragma omp for schedule(static)
-            for (size_t i = 0; i < positions.size(); ++i) {
-                assign_bounds[thread_id] = i;
-                i = positions.size();
-            }
-
-            size_t i = assign_bounds[thread_id];
-            if (i == 0) {
-                distinct_pairs[thread_id + 1]++;
-                i++;
-            }
-
-            for (; i < assign_bounds[thread_id + 1]; ++i) {
-                if (text[positions[i]] != text[positions[i - 1]] ||
-                    text[positions[i] + 1] != text[positions[i - 1] + 1]) {
-                    distinct_pairs[thread_id + 1]++;
-                }
-            }
-
-#pragma omp barrier
-#pragma omp single
-            {
-                for (size_t j = 1; j < distinct_pairs.size(); ++j) {
-                    distinct_pairs[j] += distinct_pairs[j - 1];
-                }
-
-                auto pc = distinct_pairs[n_threads];
-                auto rlslp_size = nt_count + pc;
-                productions.resize(rlslp_size);
-                bv.resize(rlslp_size, false);
-            }
-#pragma omp for schedule(static)
-            for (size_t k = 0; k < rlslp.size(); ++k) {
-                productions[k] = rlslp[k];
-            }
-
-            i = assign_bounds[thread_id];
-            auto last_var = next_nt + distinct_pairs[thread_id] - 1;
-            variable_t last_char1 = 0;
-            variable_t last_char2 = 0;
-            if (i > 0 && i < assign_bounds[thread_id + 1]) {
-                last_char1 = text[positions[i - 1]];
-                last_char2 = text[positions[i - 1] + 1];
-            }
-
-#pragma omp barrier
-            size_t j = 0;
-            if (thread_id == 0) {
-                last_char1 = text[positions[i]];
-                last_char2 = text[positions[i] + 1];
-                size_t len = 0;
-                if (last_char1 >= rlslp.terminals) {
-                    len = rlslp[last_char1 - rlslp.terminals].len;
-                } else {
-                    len = 1;
-                }
-                if (last_char2 >= rlslp.terminals) {
-                    len += rlslp[last_char2 - rlslp.terminals].len;
-                } else {
-                    len += 1;
-                }
-                productions[nt_count + distinct_pairs[thread_id] + j] = non_terminal<variable_t>(last_char1, last_char2, len);
-                j++;
-                last_var++;
-                text[positions[i]] = last_var;
-                text[positions[i] + 1] = DELETED;
-                i++;
-            }
-
-            for (; i < assign_bounds[thread_id + 1]; ++i) {
-                auto char_i1 = text[positions[i]];
-                auto char_i2 = text[positions[i] + 1];
-                if (char_i1 == last_char1 && char_i2 == last_char2) {
-                    text[positions[i]] = last_var;
-                } else {
-                    size_t len = 0;
-                    if (char_i1 >= rlslp.terminals) {
-                        len = rlslp[char_i1 - rlslp.terminals].len;
-                    } else {
-                        len = 1;
-                    }
-                    if (char_i2 >= rlslp.terminals) {
-                        len += rlslp[char_i2 - rlslp.terminals].len;
-                    } else {
-                        len += 1;
-                    }
-                    productions[nt_count + distinct_pairs[thread_id] + j] = non_terminal<variable_t>(char_i1, char_i2, len);
-                    j++;
-                    last_var++;
-                    text[positions[i]] = last_var;
-                    last_char1 = char_i1;
-                    last_char2 = char_i2;
-                }
-                text[positions[i] + 1] = DELETED;
-            }
-        }
-        std::swap(rlslp.non_terminals, productions);
-        productions.resize(1);
+        memory_phase mem_rules("rules");
+        trace_scope trace_rules("rules");
+        this->create_pair_rules(text, rlslp, bv, positions, [](variable_t c) {
+            return c;
+        });
         positions.resize(1);
+        mem_rules.end();
+        trace_rules.end();
 #ifdef BENCH
         const auto endTimeRules = recomp::timer::now();
         const auto timeSpanRules = endTimeRules - startTimeRules;
         std::cout << " rules=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanRules).count()
-                  << " productions=" << distinct_pairs[distinct_pairs.size() - 1] << " elements=" << pair_count;
+                  << " productions=" << rlslp.size() - rules_before << " elements=" << pair_count
+                  << mem_rules;
 #endif
 
         this->compact(text, compact_bounds, pair_counts, pair_count);
@@ -558,7 +538,7 @@ class parallel_rnd_recompression : public parallel_lp_recompression<variable_t>
         const auto timeSpan = endTime - startTime;
         std::cout << " time="
                   << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count()
-                  << " compressed_text=" << text.size() << std::endl;
+                  << " compressed_text=" << text.size() << mem_pcomp << std::endl;
 #endif
     }
 };
@@ -0,0 +1,403 @@
+
+#pragma once
+
+#include <algorithm>
+#include <stack>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "defs.hpp"
+#include "lce_query.hpp"
+#include "rlslp.hpp"
+
+namespace recomp {
+namespace pattern_matching {
+
+/**
+ * @brief Finds and counts the occurrences of patterns directly on a rlslp without deriving the text.
+ *
+ * Every occurrence of a pattern of length at least two has a unique lowest non-terminal in the derivation tree whose
+ * subtree covers the occurrence. Such an occurrence crosses the boundary between the two children of a pair or the
+ * boundary between two consecutive repetitions of a block (primary occurrence). All other occurrences of the pattern
+ * are copies of primary occurrences induced by the other occurrences of the non-terminal in the derivation tree
+ * (secondary occurrences).
+ *
+ * The candidates of primary occurrences are filtered by the last terminal of the left child and the first terminal of
+ * the right child. The remaining candidates are verified at the leftmost occurrence of the non-terminal in the text.
+ * The first verified candidate is compared to the pattern using @code{extract}, all further candidates are verified
+ * against this occurrence using @code{lce_query}.
+ *
+ * The construction takes linear time in the size of the rlslp. Counting takes O(g * m) time plus the time to verify
+ * the candidates, where g is the size of the rlslp and m is the length of the pattern.
+ *
+ * @tparam variable_t The type of non-terminals
+ */
+template<typename variable_t = var_t>
+class pattern_matcher {
+ public:
+    /**
+     * @brief Precomputes the number of occurrences, the leftmost position and the first and last terminal of each
+     * non-terminal.
+     *
+     * @param rlslp The rlslp to search in
+     */
+    explicit pattern_matcher(const rlslp<variable_t>& rlslp) : slp(rlslp) {
+        if (slp.empty()) {
+            return;
+        }
+        const size_t terminals = slp.terminals;
+        occ.resize(terminals + slp.size(), 0);
+        parents.resize(terminals + slp.size());
+        first_t.resize(slp.size());
+        last_t.resize(slp.size());
+        first_pos.resize(slp.size(), 0);
+
+        compute_order();
+
+        // Bottom-up: first and last terminals
+        for (const auto& nt : order) {
+            const auto& rule = slp[nt - terminals];
+            first_t[nt - terminals] = first_terminal(rule.first());
+            if (slp.is_block(nt)) {
+                last_t[nt - terminals] = last_terminal(rule.first());
+            } else {
+                last_t[nt - terminals] = last_terminal(rule.second());
+            }
+        }
+
+        // Top-down: number of occurrences in the derivation tree, leftmost position and parents
+        occ[slp.root] = 1;
+        std::vector<bool> has_pos(slp.size(), false);
+        if (!slp.is_terminal(slp.root)) {
+            has_pos[slp.root - terminals] = true;
+        }
+        for (auto iter = order.rbegin(); iter != order.rend(); ++iter) {
+            const auto nt = *iter;
+            const auto& rule = slp[nt - terminals];
+            const size_t pos = first_pos[nt - terminals];
+            auto set_pos = [&](variable_t child, size_t child_pos) {
+                if (!slp.is_terminal(child) && (!has_pos[child - terminals] || child_pos < first_pos[child - terminals])) {
+                    has_pos[child - terminals] = true;
+                    first_pos[child - terminals] = child_pos;
+                }
+            };
+            if (slp.is_block(nt)) {
+                occ[rule.first()] += occ[nt] * rule.second();
+                set_pos(rule.first(), pos);
+                parents[rule.first()].push_back(nt);
+            } else {
+                occ[rule.first()] += occ[nt];
+                occ[rule.second()] += occ[nt];
+                set_pos(rule.first(), pos);
+                set_pos(rule.second(), pos + slp.len(rule.first()));
+                parents[rule.first()].push_back(nt);
+                if (rule.first() != rule.second()) {
+                    parents[rule.second()].push_back(nt);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Counts the occurrences of the pattern in the text derived by the rlslp.
+     *
+     * @param pattern The pattern
+     * @return The number of (possibly overlapping) occurrences
+     */
+    size_t count(const std::string& pattern) const {
+        std::vector<primary_t> primaries;
+        if (!find_primary(pattern, primaries)) {
+            if (!slp.empty() && pattern.size() == 1 && static_cast<unsigned char>(pattern[0]) < slp.terminals) {
+                return occ[static_cast<unsigned char>(pattern[0])];
+            }
+            return 0;
+        }
+        size_t count = 0;
+        for (const auto& primary : primaries) {
+            count += primary.repeats * occ[primary.nt];
+        }
+        return count;
+    }
+
+    /**
+     * @brief Computes all starting positions of the pattern in the text derived by the rlslp.
+     *
+     * @param pattern The pattern
+     * @return The increasingly sorted starting positions of all (possibly overlapping) occurrences
+     */
+    std::vector<size_t> find_occurrences(const std::string& pattern) const {
+        std::vector<size_t> positions;
+        std::vector<primary_t> primaries;
+        if (!find_primary(pattern, primaries)) {
+            if (!slp.empty() && pattern.size() == 1 && static_cast<unsigned char>(pattern[0]) < slp.terminals) {
+                locate(static_cast<unsigned char>(pattern[0]), 0, 1, 0, positions);
+            }
+        } else {
+            for (const auto& primary : primaries) {
+                size_t period = 0;
+                if (slp.is_block(primary.nt)) {
+                    period = slp.len(slp[primary.nt - slp.terminals].first());
+                }
+                locate(primary.nt, primary.offset, primary.repeats, period, positions);
+            }
+        }
+        std::sort(positions.begin(), positions.end());
+        return positions;
+    }
+
+    /**
+     * @brief Returns the number of occurrences of the given symbol in the derivation tree.
+     *
+     * @param nt The symbol
+     * @return The number of occurrences
+     */
+    inline size_t occurrences(variable_t nt) const {
+        return occ[nt];
+    }
+
+    /**
+     * @brief Returns the leftmost text position of the given non-terminal.
+     *
+     * @param nt The non-terminal (must be reachable from the root)
+     * @return The leftmost text position
+     */
+    inline size_t leftmost(variable_t nt) const {
+        return first_pos[nt - slp.terminals];
+    }
+
+    /**
+     * @return The reachable non-terminals in topological order (children before parents)
+     */
+    inline const std::vector<variable_t>& reachable() const {
+        return order;
+    }
+
+    /**
+     * @brief Computes all text positions of the occurrences inside the given symbol by traversing all paths to the
+     * root.
+     *
+     * @param nt The symbol
+     * @param offset The offset of the occurrence inside the symbol
+     * @param repeats The number of repetitions of the occurrence
+     * @param period The distance of the repetitions
+     * @param positions[out] The text positions
+     */
+    void locate(variable_t nt, size_t offset, size_t repeats, size_t period, std::vector<size_t>& positions) const {
+        std::stack<std::pair<variable_t, size_t>> stack;
+        for (size_t r = 0; r < repeats; ++r) {
+            stack.emplace(nt, offset + r * period);
+        }
+        while (!stack.empty()) {
+            auto top = stack.top();
+            stack.pop();
+            const auto child = top.first;
+            if (child == slp.root) {
+                positions.push_back(top.second);
+                continue;
+            }
+            for (const auto& parent : parents[child]) {
+                const auto& rule = slp[parent - slp.terminals];
+                if (slp.is_block(parent)) {
+                    const size_t len = slp.len(child);
+                    for (size_t r = 0; r < rule.second(); ++r) {
+                        stack.emplace(parent, top.second + r * len);
+                    }
+                } else {
+                    if (rule.first() == child) {
+                        stack.emplace(parent, top.second);
+                    }
+                    if (rule.second() == child) {
+                        stack.emplace(parent, top.second + slp.len(rule.first()));
+                    }
+                }
+            }
+        }
+    }
+
+ private:
+    /**
+     * @brief A verified primary occurrence at @code{offset} inside the non-terminal @code{nt}. For blocks the
+     * occurrence is repeated @code{repeats} times with the length of the repeated symbol as period.
+     */
+    struct primary_t {
+        variable_t nt;
+        size_t offset;
+        size_t repeats;
+    };
+
+    const rlslp<variable_t>& slp;
+
+    /**
+     * The number of occurrences of every symbol in the derivation tree.
+     */
+    std::vector<size_t> occ;
+
+    /**
+     * The parents of every symbol in the derivation tree.
+     */
+    std::vector<std::vector<variable_t>> parents;
+
+    /**
+     * The reachable non-terminals in topological order (children before parents).
+     */
+    std::vector<variable_t> order;
+
+    std::vector<variable_t> first_t;
+    std::vector<variable_t> last_t;
+    std::vector<size_t> first_pos;
+
+    inline variable_t first_terminal(variable_t nt) const {
+        return slp.is_terminal(nt) ? nt : first_t[nt - slp.terminals];
+    }
+
+    inline variable_t last_terminal(variable_t nt) const {
+        return slp.is_terminal(nt) ? nt : last_t[nt - slp.terminals];
+    }
+
+    /**
+     * @brief Computes the reachable non-terminals in topological order using an iterative depth first search.
+     */
+    void compute_order() {
+        if (slp.is_terminal(slp.root)) {
+            return;
+        }
+        std::vector<bool> visited(slp.size(), false);
+        std::stack<std::pair<variable_t, bool>> stack;
+        stack.emplace(slp.root, false);
+        while (!stack.empty()) {
+            auto top = stack.top();
+            stack.pop();
+            const auto nt = top.first;
+            if (top.second) {
+                order.push_back(nt);
+                continue;
+            }
+            if (visited[nt - slp.terminals]) {
+                continue;
+            }
+            visited[nt - slp.terminals] = true;
+            stack.emplace(nt, true);
+            const auto& rule = slp[nt - slp.terminals];
+            if (!slp.is_terminal(rule.first()) && !visited[rule.first() - slp.terminals]) {
+                stack.emplace(rule.first(), false);
+            }
+            if (!slp.is_block(nt) && !slp.is_terminal(rule.second()) && !visited[rule.second() - slp.terminals]) {
+                stack.emplace(rule.second(), false);
+            }
+        }
+    }
+
+    /**
+     * @brief Computes the verified primary occurrences of the pattern.
+     *
+     * @param pattern The pattern
+     * @param primaries[out] The primary occurrences
+     * @return @code{false} if the pattern has no primary occurrences since it is empty, consists of a single
+     * character or the rlslp is empty, @code{true} otherwise
+     */
+    bool find_primary(const std::string& pattern, std::vector<primary_t>& primaries) const {
+        const size_t m = pattern.size();
+        if (slp.empty() || m < 2 || m > slp.len(slp.root)) {
+            return false;
+        }
+        const size_t terminals = slp.terminals;
+        bool found_ref = false;
+        size_t ref = 0;
+        for (const auto& nt : order) {
+            const auto& rule = slp[nt - terminals];
+            const size_t nt_len = slp.len(nt);
+            if (nt_len < m) {
+                continue;
+            }
+            const bool block = slp.is_block(nt);
+            const auto left = rule.first();
+            const auto right = block ? rule.first() : rule.second();
+            const size_t left_len = slp.len(left);
+            const auto left_last = static_cast<char>(last_terminal(left));
+            const auto right_first = static_cast<char>(first_terminal(right));
+
+            // offset of the occurrence inside nt, it must start in the left child and end in the right one
+            size_t offset = (left_len >= m) ? left_len - m + 1 : 0;
+            for (; offset < left_len && offset + m <= nt_len; ++offset) {
+                const size_t split = left_len - offset;
+                if (pattern[split - 1] != left_last || pattern[split] != right_first) {
+                    continue;
+                }
+                const size_t pos = first_pos[nt - terminals] + offset;
+                bool match;
+                if (!found_ref) {
+                    match = slp.extract(pos, m) == pattern;
+                    if (match) {
+                        found_ref = true;
+                        ref = pos;
+                    }
+                } else {
+                    match = lce_query::lce_query(slp, ref, pos) >= m;
+                }
+                if (match) {
+                    size_t repeats = 1;
+                    if (block) {
+                        repeats = (nt_len - m - offset) / left_len + 1;
+                    }
+                    primaries.push_back(primary_t{nt, offset, repeats});
+                }
+            }
+        }
+        return true;
+    }
+
+};
+
+/**
+ * @brief Counts the occurrences of the pattern in the text derived by the rlslp.
+ *
+ * @tparam variable_t The type of non-terminals
+ * @param rlslp The rlslp
+ * @param pattern The pattern
+ * @return The number of (possibly overlapping) occurrences
+ */
+template<typename variable_t = var_t>
+size_t count(const rlslp<variable_t>& rlslp, const std::string& pattern) {
+    trace_scope trace("count", "query", "pattern", pattern.size());
+    pattern_matcher<variable_t> matcher{rlslp};
+    return matcher.count(pattern);
+}
+
+/**
+ * @brief Computes all starting positions of the pattern in the text derived by the rlslp.
+ *
+ * @tparam variable_t The type of non-terminals
+ * @param rlslp The rlslp
+ * @param pattern The pattern
+ * @return The increasingly sorted starting positions of all (possibly overlapping) occurrences
+ */
+template<typename variable_t = var_t>
+std::vector<size_t> find_occurrences(const rlslp<variable_t>& rlslp, const std::string& pattern) {
+    trace_scope trace("find_occurrences", "query", "pattern", pattern.size());
+    pattern_matcher<variable_t> matcher{rlslp};
+    return matcher.find_occurrences(pattern);
+}
+
+/**
+ * @brief Naive computation of the starting positions of all occurrences of the pattern in the text.
+ *
+ * @param text The text
+ * @param pattern The pattern
+ * @return The increasingly sorted starting positions of all (possibly overlapping) occurrences
+ */
+inline std::vector<size_t> find_occurrences_naive(const std::string& text, const std::string& pattern) {
+    std::vector<size_t> positions;
+    if (pattern.empty()) {
+        return positions;
+    }
+    size_t pos = text.find(pattern);
+    while (pos != std::string::npos) {
+        positions.push_back(pos);
+        pos = text.find(pattern, pos + 1);
+    }
+    return positions;
+}
+
+}  // namespace pattern_matching
+}  // namespace recomp
@@ -978,6 +978,77 @@ void partitioned_radix_sort(std::vector<std::tuple<variable_t, variable_t, bool>
     }
 }
 
+/**
+ * @brief Sorts the values stably by the lowest @code{key_bits} bits of their keys with a parallel LSD radix sort.
+ *
+ * Every pass distributes the values by D bits of their keys. The threads count the digits of a static range of
+ * values, compute their offsets of every bucket from the prefix sums of all counts and scatter their range.
+ *
+ * @tparam value_t The type of the values
+ * @tparam key_fn_t The type of the function computing the key of a value
+ * @tparam D The number of bits per pass
+ * @param values The values to sort
+ * @param key The function computing the key of a value
+ * @param key_bits The number of bits of the keys to sort by
+ * @param cores The number of cores to use
+ */
+template<typename value_t, typename key_fn_t, std::uint8_t D = 8>
+void radix_sort_by_key(ui_vector<value_t>& values, key_fn_t key, size_t key_bits,
+                       const size_t cores = std::thread::hardware_concurrency()) {
+    const size_t n_buckets = size_t(1) << D;
+    const size_t passes = (key_bits + D - 1) / D;
+    if (values.size() <= 1 || passes == 0) {
+        return;
+    }
+
+    ui_vector<value_t> tmp(values.size());
+    ui_vector<size_t> offsets;
+#pragma omp parallel num_threads(cores)
+    {
+        auto thread_id = static_cast<size_t>(omp_get_thread_num());
+        auto n_threads = static_cast<size_t>(omp_get_num_threads());
+        const size_t begin = values.size() * thread_id / n_threads;
+        const size_t end = values.size() * (thread_id + 1) / n_threads;
+
+#pragma omp single
+        {
+            offsets.resize(n_buckets * n_threads);
+        }
+
+        for (size_t pass = 0; pass < passes; ++pass) {
+            const size_t shift = pass * D;
+            size_t* own = offsets.data() + n_buckets * thread_id;
+            std::fill(own, own + n_buckets, 0);
+            for (size_t i = begin; i < end; ++i) {
+                own[(static_cast<std::uint64_t>(key(values[i])) >> shift) & (n_buckets - 1)]++;
+            }
+
+#pragma omp barrier
+#pragma omp single
+            {
+                size_t sum = 0;
+                for (size_t b = 0; b < n_buckets; ++b) {
+                    for (size_t t = 0; t < n_threads; ++t) {
+                        const size_t count = offsets[n_buckets * t + b];
+                        offsets[n_buckets * t + b] = sum;
+                        sum += count;
+                    }
+                }
+            }
+
+            for (size_t i = begin; i < end; ++i) {
+                tmp[own[(static_cast<std::uint64_t>(key(values[i])) >> shift) & (n_buckets - 1)]++] = values[i];
+            }
+
+#pragma omp barrier
+#pragma omp single
+            {
+                std::swap(values, tmp);
+            }
+        }
+    }
+}
+
 template<typename adj_list_t>
 void bucket_sort(adj_list_t& adj_list, const size_t cores = std::thread::hardware_concurrency()) {
     std::vector<size_t> bounds;
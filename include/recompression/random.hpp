@@ -0,0 +1,126 @@
+#pragma once
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace recomp {
+
+/**
+ * @brief A counter-based pseudo random number generator.
+ *
+ * The random number of a counter is the splitmix64 hash of the counter combined with a key derived from a seed, the
+ * round of the recompression and an optional stream (e.g. the iteration of a repeated partitioning). Since the random
+ * numbers only depend on (seed, round, stream, counter) there is no state to initialize per thread and the generated
+ * numbers are the same for any number of threads.
+ */
+class counter_rng {
+ public:
+    typedef std::uint64_t word_t;
+
+    /**
+     * The seed used if no seed is specified by the user.
+     */
+    static const word_t DEFAULT_SEED = 0x5DEECE66DULL;
+
+ private:
+    static const word_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+    word_t key;
+
+ public:
+    /**
+     * @brief Mixes the bits of the given value (finalizer of splitmix64).
+     *
+     * @param x The value
+     * @return The mixed value
+     */
+    static inline word_t mix(word_t x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    /**
+     * @brief Constructs a generator for the given seed, round and stream.
+     *
+     * @param seed The seed
+     * @param round The round (level) of the recompression
+     * @param stream The stream
+     */
+    inline counter_rng(word_t seed, word_t round, word_t stream = 0)
+            : key(mix(mix(mix(seed) + round * GOLDEN_GAMMA) + stream)) {}
+
+    /**
+     * @brief Returns 64 random bits for the given counter.
+     *
+     * @param counter The counter
+     * @return The random bits
+     */
+    inline word_t operator()(word_t counter) const {
+        return mix(key + (counter + 1) * GOLDEN_GAMMA);
+    }
+
+    /**
+     * @brief Returns the random bit with the given index, i.e. bit @code{i % 64} of the random word @code{i / 64}.
+     *
+     * @param i The index of the bit
+     * @return The random bit
+     */
+    inline bool bit(word_t i) const {
+        return ((*this)(i >> 6) >> (i & 63)) & 1;
+    }
+
+    /**
+     * @brief Sets @code{bits[i]} to @code{bit(i)} for all i in [begin, end).
+     *
+     * One random word is computed for 64 consecutive indices. The words are distributed statically to the threads.
+     *
+     * @tparam vector_t The type of the vector (the elements must be assignable from bool)
+     * @param bits[out] The vector
+     * @param begin The first index to set
+     * @param end The index after the last index to set
+     * @param cores The number of cores to use
+     */
+    template<typename vector_t>
+    inline void fill(vector_t& bits, size_t begin, size_t end, size_t cores) const {
+        if (begin >= end) {
+            return;
+        }
+#pragma omp parallel num_threads(cores)
+        {
+            fill_in_region(bits, begin, end);
+        }
+    }
+
+    /**
+     * @brief Like @code{fill}, but distributes the words among the threads of the enclosing parallel region. Must be
+     * called by every thread of the region; there is no barrier at its end.
+     *
+     * @tparam vector_t The type of the vector (the elements must be assignable from bool)
+     * @param bits[out] The vector
+     * @param begin The first index to set
+     * @param end The index after the last index to set
+     */
+    template<typename vector_t>
+    inline void fill_in_region(vector_t& bits, size_t begin, size_t end) const {
+        if (begin >= end) {
+            return;
+        }
+        const size_t first_word = begin >> 6;
+        const size_t last_word = ((end - 1) >> 6) + 1;
+
+#pragma omp for schedule(static) nowait
+        for (size_t w = first_word; w < last_word; ++w) {
+            const word_t random = (*this)(w);
+            const size_t start = std::max(begin, w << 6);
+            const size_t stop = std::min(end, (w + 1) << 6);
+            for (size_t i = start; i < stop; ++i) {
+                bits[i] = (random >> (i & 63)) & 1;
+            }
+        }
+    }
+};
+
+}  // namespace recomp
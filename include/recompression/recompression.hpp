@@ -1,11 +1,18 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "defs.hpp"
+#include "memory_tracker.hpp"
+#include "trace.hpp"
+#include "packed_vector.hpp"
+#include "parallel_loop.hpp"
+#include "random.hpp"
 #include "rlslp.hpp"
 
 namespace recomp {
@@ -27,6 +34,32 @@ class recompression {
     size_t level = 0;
     size_t cores = 1;
 
+    /**
+     * The seed of the random partitions. The partitions only depend on the seed, the level and the text, not on the
+     * number of cores.
+     */
+    std::uint64_t seed = counter_rng::DEFAULT_SEED;
+
+    /**
+     * The schedule of the loops of the parallel variants over the parts of the text (finding blocks and pairs,
+     * deleting and compacting) and over the parts of the sorted positions (creating the rules).
+     */
+    loop_schedule_t loop_schedule = STATIC;
+
+    /**
+     * The minimal number of symbols per thread in a round of the parallel variants. Rounds on shorter texts use fewer
+     * threads and the last rounds run on a single thread which saves the start-up and the barriers of the parallel
+     * regions of these rounds. 0 always uses all cores.
+     */
+    size_t min_round_work = 0;
+
+    /**
+     * Whether the parallel and parallel_rnd variants run all rounds in one parallel region. The phases of a round are
+     * separated by barriers instead of starting a parallel region per phase, which saves the fork and join of the
+     * regions on the short texts of the last rounds. All rounds use all cores (@code{min_round_work} is ignored).
+     */
+    bool single_region = false;
+
     inline recompression() = default;
 
     /**
@@ -35,6 +68,8 @@ class recompression {
      */
     inline recompression(std::string& dataset) : dataset(dataset) {}
 
+    virtual ~recompression() = default;
+
     /**
      * @brief Builds the straight-line program generating the given text using the recompression technique.
      *
@@ -73,7 +108,114 @@ class recompression {
         this->recomp(text, rlslp, recomp::CHAR_ALPHABET, cores);
     }
 
+    /**
+     * @brief Builds the straight-line program generating the given bit-packed text using the recompression technique.
+     *
+     * The packed text is the at-rest representation of the input and the result. It is unpacked in parallel and the
+     * packed words are freed before the recompression starts, so the peak memory of the recompression itself is the
+     * one of the unpacked text. Afterwards the remaining text is packed with the minimal width for the non-terminals
+     * of the rlslp, i.e. @code{rlslp.size() + rlslp.terminals}, and only contains the root of the rlslp.
+     *
+     * @param text[in,out] The packed text
+     * @param rlslp[out] The rlslp
+     * @param alphabet_size The first non-terminal to generate
+     * @param cores The number of cores to use
+     */
+    void recomp(packed_vector<variable_t>& text,
+                rlslp<variable_t>& rlslp,
+                const size_t& alphabet_size,
+                const size_t cores) {
+        text_t unpacked;
+        text.unpack(unpacked, cores);
+        text.clear();
+
+        this->recomp(unpacked, rlslp, alphabet_size, cores);
+        if (unpacked.size() == 1) {
+            unpacked[0] = rlslp.root;
+        }
+
+        text.pack(unpacked, packed_vector<variable_t>::width_for(rlslp.size() + rlslp.terminals), cores);
+    }
+
+    /**
+     * @brief Computes the number of threads of a round on a text of the given size.
+     *
+     * @param text_size The size of the text at the beginning of the round
+     * @param cores The maximal number of cores
+     * @return The number of threads
+     */
+    inline size_t round_cores(size_t text_size, size_t cores) const {
+        if (min_round_work == 0) {
+            return cores;
+        }
+        return std::max(static_cast<size_t>(1), std::min(cores, text_size / min_round_work));
+    }
+
+    /**
+     * @brief Sets the number of cores of the recompression and restores it at the end of the scope, so rounds that run
+     * with fewer cores (see @code{min_round_work}) do not leave their number of cores behind, also if a round throws.
+     */
+    class cores_guard {
+     public:
+        inline cores_guard(recompression& recomp, size_t cores) : recomp(recomp), cores(cores) {
+            recomp.cores = cores;
+        }
+
+        inline ~cores_guard() {
+            recomp.cores = cores;
+        }
+
+        cores_guard(const cores_guard&) = delete;
+        cores_guard& operator=(const cores_guard&) = delete;
+
+     private:
+        recompression& recomp;
+        const size_t cores;
+    };
+
  protected:
+    /**
+     * @brief Sets the number of cores used by the next round (bcomp or pcomp) of the recompression.
+     *
+     * With BENCH the synchronization cost of the parallel regions of the round is measured by @code{sync}.
+     *
+     * @param text_size The size of the text at the beginning of the round
+     * @param cores The maximal number of cores
+     */
+    inline void begin_round(size_t text_size, size_t cores) {
+        this->cores = round_cores(text_size, cores);
+        round_text_size = text_size;
+#ifdef BENCH
+        sync.reset(true);
+#else
+        sync.reset(false);
+#endif
+    }
+
+    /**
+     * @brief Ends the round started by @code{begin_round}. With BENCH the number of measured parallel regions and
+     * barriers of the round and their fork, barrier and join times are reported.
+     */
+    inline void end_round() {
+#ifdef BENCH
+        std::cout << "RESULT algo=" << this->name << "_round dataset=" << this->dataset << " level=" << this->level
+                  << " text=" << round_text_size << " cores=" << this->cores << " regions=" << sync.regions
+                  << " barriers=" << sync.barriers << " fork_ns=" << sync.fork_ns << " barrier_ns=" << sync.barrier_ns
+                  << " join_ns=" << sync.join_ns
+                  << std::endl;
+#endif
+    }
+
+    /**
+     * The synchronization cost of the parallel regions of the current round.
+     */
+    sync_timer sync;
+
+    /**
+     * The size of the text at the beginning of the current round.
+     */
+    size_t round_text_size = 0;
+
     /**
      * @brief Moves all block rules to the end and renames the non-terminals according to their new position.
      *
@@ -81,6 +223,8 @@ class recompression {
      * @param bv The bitvector indicating the block rules
      */
     void rename_rlslp(rlslp<variable_t>& rlslp, const bv_t& bv) {
+        memory_phase mem_rename("rename_rlslp");
+        trace_scope trace("rename_rlslp");
 #ifdef BENCH
         const auto startTimeRlslp = recomp::timer::now();
 #endif
@@ -129,7 +273,8 @@ class recompression {
         const auto timeSpanRlslp = endTimeRlslp - startTimeRlslp;
         std::cout << "RESULT algo=" << this->name << "_rlslp dataset=" << this->dataset << " blocks="
                   << (rlslp.size() - rlslp.blocks) << " cores=" << this->cores << " time="
-                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanRlslp).count() << std::endl;
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpanRlslp).count() << mem_rename
+                  << std::endl;
 #endif
     }
 };
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace recomp {
+
+/**
+ * @brief Results of the regression harness and their comparison with a baseline.
+ *
+ * The results are stored as JSON of the form
+ * @code{{"results": [{"algo": "parallel", "dataset": "fibonacci_n1024", "cores": 4, "time_ms": 12,
+ * "memory_bytes": 4096, "rlslp_size": 42, "correct": true}, ...]}}. A result of the current run regresses if its time,
+ * memory or grammar size exceeds the result with the same algorithm, dataset and cores in the baseline by more than
+ * the relative threshold of the metric.
+ */
+namespace regression {
+
+/**
+ * @brief The result of one algorithm on one dataset.
+ */
+struct result {
+    std::string algo;
+    std::string dataset;
+    size_t cores = 0;
+    std::uint64_t time_ms = 0;    // the median time of the repetitions
+    size_t memory_bytes = 0;      // the peak memory (0 if not measured)
+    size_t rlslp_size = 0;        // the number of rules of the rlslp
+    bool correct = true;          // whether the rlslp derives the text
+};
+
+/**
+ * @brief The relative thresholds for a regression. Times are only compared if they differ by at least
+ * @code{min_time_ms} to ignore the noise of short runs.
+ */
+struct thresholds {
+    double time = 0.1;
+    double memory = 0.05;
+    double size = 0.0;
+    std::uint64_t min_time_ms = 10;
+};
+
+/**
+ * @brief A regressed metric of a result.
+ */
+struct finding {
+    std::string algo;
+    std::string dataset;
+    size_t cores;
+    std::string metric;    // time_ms, memory_bytes, rlslp_size, correct or missing
+    double baseline;
+    double current;
+};
+
+namespace detail {
+
+inline void write_string(std::ostream& out, const std::string& str) {
+    out << '"';
+    for (const auto c : str) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+inline void skip_whitespace(std::istream& in) {
+    while (in && std::isspace(in.peek())) {
+        in.get();
+    }
+}
+
+inline bool expect(std::istream& in, char c) {
+    skip_whitespace(in);
+    if (in.peek() != c) {
+        return false;
+    }
+    in.get();
+    return true;
+}
+
+inline bool read_string(std::istream& in, std::string& str) {
+    if (!expect(in, '"')) {
+        return false;
+    }
+    str.clear();
+    char c;
+    while (in.get(c)) {
+        if (c == '"') {
+            return true;
+        }
+        if (c == '\\' && !in.get(c)) {
+            return false;
+        }
+        str += c;
+    }
+    return false;
+}
+
+/**
+ * @brief Reads a string, a number or a boolean as string.
+ */
+inline bool read_value(std::istream& in, std::string& value) {
+    skip_whitespace(in);
+    if (in.peek() == '"') {
+        return read_string(in, value);
+    }
+    value.clear();
+    while (in && (std::isalnum(in.peek()) || in.peek() == '.' || in.peek() == '-' || in.peek() == '+')) {
+        value += static_cast<char>(in.get());
+    }
+    return !value.empty();
+}
+
+inline bool read_result(std::istream& in, result& res) {
+    if (!expect(in, '{')) {
+        return false;
+    }
+    if (expect(in, '}')) {
+        return true;
+    }
+    do {
+        std::string key;
+        std::string value;
+        if (!read_string(in, key) || !expect(in, ':') || !read_value(in, value)) {
+            return false;
+        }
+        if (key == "algo") {
+            res.algo = value;
+        } else if (key == "dataset") {
+            res.dataset = value;
+        } else if (key == "cores") {
+            res.cores = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "time_ms") {
+            res.time_ms = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "memory_bytes") {
+            res.memory_bytes = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "rlslp_size") {
+            res.rlslp_size = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "correct") {
+            res.correct = value == "true";
+        }
+    } while (expect(in, ','));
+    return expect(in, '}');
+}
+
+}  // namespace detail
+
+/**
+ * @brief Writes the results as JSON.
+ *
+ * @param out The stream to write to
+ * @param results The results
+ */
+inline void write_json(std::ostream& out, const std::vector<result>& results) {
+    out << "{\"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& res = results[i];
+        out << ((i == 0) ? "\n" : ",\n") << "  {\"algo\": ";
+        detail::write_string(out, res.algo);
+        out << ", \"dataset\": ";
+        detail::write_string(out, res.dataset);
+        out << ", \"cores\": " << res.cores << ", \"time_ms\": " << res.time_ms << ", \"memory_bytes\": "
+            << res.memory_bytes << ", \"rlslp_size\": " << res.rlslp_size << ", \"correct\": "
+            << (res.correct ? "true" : "false") << "}";
+    }
+    out << "\n]}" << std::endl;
+}
+
+/**
+ * @brief Reads results written by @code{write_json}. Unknown keys are ignored.
+ *
+ * @param in The stream to read from
+ * @param results[out] The results
+ * @return Whether the input is valid
+ */
+inline bool read_json(std::istream& in, std::vector<result>& results) {
+    results.clear();
+    std::string key;
+    if (!detail::expect(in, '{') || !detail::read_string(in, key) || key != "results" || !detail::expect(in, ':') ||
+        !detail::expect(in, '[')) {
+        return false;
+    }
+    if (detail::expect(in, ']')) {
+        return detail::expect(in, '}');
+    }
+    do {
+        result res;
+        if (!detail::read_result(in, res)) {
+            return false;
+        }
+        results.push_back(res);
+    } while (detail::expect(in, ','));
+    return detail::expect(in, ']') && detail::expect(in, '}');
+}
+
+/**
+ * @brief Compares the current results with the baseline. Results without a counterpart in the baseline are not
+ * compared, memory is only compared if it has been measured in both runs. A result that does not derive its text is
+ * always reported, as is every result of the baseline that is missing in the current run (e.g. a variant that has been
+ * dropped or crashed).
+ *
+ * @param baseline The results of the baseline
+ * @param current The results of the current run
+ * @param limits The thresholds
+ * @return The regressions
+ */
+inline std::vector<finding> compare(const std::vector<result>& baseline, const std::vector<result>& current,
+                                    const thresholds& limits) {
+    std::map<std::tuple<std::string, std::string, size_t>, const result*> base;
+    for (const auto& res : baseline) {
+        base[std::make_tuple(res.algo, res.dataset, res.cores)] = &res;
+    }
+
+    std::vector<finding> findings;
+    std::map<std::tuple<std::string, std::string, size_t>, bool> found;
+    for (const auto& cur : current) {
+        found[std::make_tuple(cur.algo, cur.dataset, cur.cores)] = true;
+    }
+    for (const auto& b : baseline) {
+        if (found.find(std::make_tuple(b.algo, b.dataset, b.cores)) == found.end()) {
+            findings.push_back(finding{b.algo, b.dataset, b.cores, "missing", 1, 0});
+        }
+    }
+    for (const auto& cur : current) {
+        auto report = [&](const std::string& metric, double b, double c) {
+            findings.push_back(finding{cur.algo, cur.dataset, cur.cores, metric, b, c});
+        };
+        if (!cur.correct) {
+            report("correct", 1, 0);
+        }
+        auto iter = base.find(std::make_tuple(cur.algo, cur.dataset, cur.cores));
+        if (iter == base.end()) {
+            continue;
+        }
+        const result& b = *iter->second;
+        if (cur.time_ms > b.time_ms * (1.0 + limits.time) && cur.time_ms - b.time_ms >= limits.min_time_ms) {
+            report("time_ms", b.time_ms, cur.time_ms);
+        }
+        if (b.memory_bytes > 0 && cur.memory_bytes > b.memory_bytes * (1.0 + limits.memory)) {
+            report("memory_bytes", b.memory_bytes, cur.memory_bytes);
+        }
+        if (cur.rlslp_size > b.rlslp_size * (1.0 + limits.size)) {
+            report("rlslp_size", b.rlslp_size, cur.rlslp_size);
+        }
+    }
+    return findings;
+}
+
+/**
+ * @brief Prints one line per regression.
+ *
+ * @param out The stream to print to
+ * @param findings The regressions
+ */
+inline void print(std::ostream& out, const std::vector<finding>& findings) {
+    for (const auto& f : findings) {
+        out << "REGRESSION algo=" << f.algo << " dataset=" << f.dataset << " cores=" << f.cores << " metric="
+            << f.metric << " baseline=" << static_cast<std::uint64_t>(f.baseline) << " current="
+            << static_cast<std::uint64_t>(f.current);
+        if (f.baseline > 0 && f.metric != "correct" && f.metric != "missing") {
+            out << " change=" << (f.current / f.baseline - 1.0) * 100.0 << "%";
+        }
+        out << std::endl;
+    }
+}
+
+}  // namespace regression
+}  // namespace recomp
@@ -14,6 +14,7 @@
 #include <tlx/simple_vector.hpp>
 
 #include "defs.hpp"
+#include "trace.hpp"
 
 namespace recomp {
 
@@ -280,6 +281,7 @@ class rlslp {
     }
 
     void compute_lengths() {
+        trace_scope trace("lengths", "rlslp", "productions", size());
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
@@ -308,12 +310,54 @@ class rlslp {
         }
     }
 
+    /**
+     * @brief Computes the height of the derivation tree, i.e. the number of non-terminals on the longest path from the
+     * root to a terminal.
+     *
+     * @return The height of the derivation tree
+     */
+    size_t height() const {
+        if (empty() || is_terminal(root)) {
+            return 0;
+        }
+        std::vector<size_t> heights(size(), 0);
+        std::vector<value_t> stack;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            const value_t nt = stack.back();
+            if (heights[nt - terminals] > 0) {
+                stack.pop_back();
+                continue;
+            }
+            const auto& rule = non_terminals[nt - terminals];
+            size_t h = 1;
+            bool ready = true;
+            for (size_t c = 0; c < (is_block(nt) ? 1 : 2); ++c) {
+                const value_t child = rule.production[c];
+                if (!is_terminal(child)) {
+                    if (heights[child - terminals] == 0) {
+                        stack.push_back(child);
+                        ready = false;
+                    } else if (heights[child - terminals] + 1 > h) {
+                        h = heights[child - terminals] + 1;
+                    }
+                }
+            }
+            if (ready) {
+                heights[nt - terminals] = h;
+                stack.pop_back();
+            }
+        }
+        return heights[root - terminals];
+    }
+
     /**
      * @brief Returns the text as a string generated by the rlslp.
      *
      * @return The text generated by the rlslp
      */
     std::string derive_text() {
+        trace_scope trace("derive", "query");
 #ifdef BENCH
         const auto startTime = recomp::timer::now();
 #endif
@@ -342,6 +386,7 @@ class rlslp {
      * @return The substring
      */
     std::string extract(size_t i, size_t len) const {
+        trace_scope trace("extract", "query", "len", len);
 #ifdef BENCH_SINGLE_EXTRACT
         const auto startTime = recomp::timer::now();
 #endif
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef BENCH
+#include <chrono>
+#endif
+
+#include "recompression/defs.hpp"
+#include "recompression/rlslp.hpp"
+
+namespace recomp {
+
+/**
+ * @brief Writes the substring of length @code{len} beginning at position @code{i} of the string derived by the
+ * variable to the buffer. The substring must be in range, i.e. @code{i + len <= rlslp.len(nt)}.
+ *
+ * In contrast to @code{rlslp.extract} the copies of a block in front of the substring are skipped in constant time,
+ * further copies of a block are copied from the first one and the characters are written directly to the buffer.
+ *
+ * @tparam variable_t The type of non-terminals
+ * @param rlslp The rlslp
+ * @param nt The variable
+ * @param i The position of the substring
+ * @param len The length of the substring
+ * @param out[in,out] The buffer to write to, points behind the written characters afterwards
+ */
+template<typename variable_t = var_t>
+inline void expand_rlslp(const rlslp<variable_t>& rlslp, variable_t nt, size_t i, size_t len, char*& out) {
+    while (len > 0) {
+        if (rlslp.is_terminal(nt)) {
+            *out++ = static_cast<char>(nt);
+            return;
+        }
+        const auto first = rlslp[nt - rlslp.terminals].first();
+        const auto second = rlslp[nt - rlslp.terminals].second();
+        const size_t first_len = rlslp.len(first);
+        if (rlslp.is_block(nt)) {
+            i %= first_len;
+            if (i + len > first_len) {
+                expand_rlslp(rlslp, first, i, first_len - i, out);
+                len -= first_len - i;
+                const char* copy = out;
+                expand_rlslp(rlslp, first, 0, std::min(len, first_len), out);
+                len -= std::min(len, first_len);
+                while (len > 0) {
+                    const size_t copy_len = std::min(len, first_len);
+                    std::memcpy(out, copy, copy_len);
+                    out += copy_len;
+                    len -= copy_len;
+                }
+                return;
+            }
+            nt = first;
+        } else if (i >= first_len) {
+            i -= first_len;
+            nt = second;
+        } else if (i + len > first_len) {
+            expand_rlslp(rlslp, first, i, first_len - i, out);
+            len -= first_len - i;
+            i = 0;
+            nt = second;
+        } else {
+            nt = first;
+        }
+    }
+}
+
+/**
+ * @brief Verifies that the rlslp derives the content of the file without materializing either of them.
+ *
+ * The file is read sequentially in chunks of @code{window * cores} bytes. The windows of a chunk are derived from the
+ * rlslp and compared in parallel, so at most two chunks are in memory at the same time.
+ *
+ * @tparam variable_t The type of non-terminals
+ * @param rlslp The rlslp (with computed lengths)
+ * @param file_name The file
+ * @param prefix The prefix of the file in bytes to compare with (0 for the whole file)
+ * @param zeroes @code{false} if the zero bytes of the file are dropped before comparing, i.e. the file was read with
+ * @code{read_file_without_zeroes}
+ * @param cores The number of cores to use
+ * @param window The number of characters a core derives and compares at once
+ * @return @code{true} if the rlslp derives the file, @code{false} otherwise
+ */
+template<typename variable_t = var_t>
+inline bool verify_rlslp(const rlslp<variable_t>& rlslp, const std::string& file_name, size_t prefix = 0,
+                         bool zeroes = true, size_t cores = std::thread::hardware_concurrency(),
+                         size_t window = 1 << 22) {
+    trace_scope trace("verify_rlslp", "query");
+#ifdef BENCH
+    const auto startTime = recomp::timer::now();
+#endif
+    std::ifstream ifs(file_name.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+    if (!ifs) {
+        std::cerr << "Failed to read file " << file_name << std::endl;
+        return false;
+    }
+    size_t file_size = ifs.tellg();
+    ifs.seekg(0, std::ios::beg);
+    if (prefix > 0) {
+        file_size = std::min(file_size, prefix);
+    }
+
+    cores = std::max(cores, static_cast<size_t>(1));
+    window = std::max(window, static_cast<size_t>(1));
+    const size_t chunk = window * cores;
+    const size_t text_size = (rlslp.empty()) ? 0 : rlslp.len(rlslp.root);
+    std::vector<char> expected(chunk);
+    std::vector<char> derived(chunk);
+
+    bool equal = true;
+    size_t pos = 0;
+    size_t read = 0;
+    while (equal && read < file_size) {
+        size_t size = 0;
+        while (size < chunk && read < file_size) {
+            const size_t bytes = std::min(chunk - size, file_size - read);
+            ifs.read(expected.data() + size, bytes);
+            if (static_cast<size_t>(ifs.gcount()) != bytes) {
+                std::cerr << "Failed to read file " << file_name << std::endl;
+                return false;
+            }
+            read += bytes;
+            if (zeroes) {
+                size += bytes;
+            } else {
+                size = std::remove(expected.begin() + size, expected.begin() + size + bytes, '\0') - expected.begin();
+            }
+        }
+        if (pos + size > text_size) {
+            equal = false;
+            break;
+        }
+
+        const size_t windows = (size + window - 1) / window;
+#pragma omp parallel for schedule(dynamic, 1) num_threads(cores) reduction(&&:equal)
+        for (size_t w = 0; w < windows; ++w) {
+            const size_t begin = w * window;
+            const size_t len = std::min(window, size - begin);
+            char* out = derived.data() + begin;
+            expand_rlslp(rlslp, rlslp.root, pos + begin, len, out);
+            equal = equal && std::memcmp(derived.data() + begin, expected.data() + begin, len) == 0;
+        }
+        pos += size;
+    }
+    equal = equal && pos == text_size;
+#ifdef BENCH
+    const auto endTime = recomp::timer::now();
+    const auto timeSpan = endTime - startTime;
+    std::cout << "RESULT algo=verify_rlslp size=" << pos << " cores=" << cores << " window=" << window
+              << " equal=" << equal
+              << " time=" << std::chrono::duration_cast<std::chrono::milliseconds>(timeSpan).count() << std::endl;
+#endif
+    return equal;
+}
+
+}  // namespace recomp
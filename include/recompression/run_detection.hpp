@@ -0,0 +1,208 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+
+namespace recomp {
+
+namespace simd {
+
+/**
+ * The instruction sets used by the run detection.
+ */
+enum isa_t {
+    SCALAR = 0,
+    AVX2 = 1,
+    AVX512 = 2
+};
+
+/**
+ * @brief Returns the best instruction set supported by the executing cpu.
+ *
+ * @return The instruction set
+ */
+inline isa_t detect_isa() {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return AVX2;
+    }
+#endif
+    return SCALAR;
+}
+
+/**
+ * @brief Returns the instruction set used by the run detection. It is detected once at runtime.
+ *
+ * @return The instruction set
+ */
+inline isa_t& active_isa() {
+    static isa_t isa = detect_isa();
+    return isa;
+}
+
+/**
+ * @brief Restricts the instruction set used by the run detection (e.g. to compare the kernels). Instruction sets
+ * that are not supported by the cpu are ignored.
+ *
+ * @param isa The instruction set
+ */
+inline void set_isa(isa_t isa) {
+    active_isa() = std::min(isa, detect_isa());
+}
+
+template<typename variable_t>
+inline std::uint64_t equal_mask_scalar(const variable_t* text, size_t len) {
+    std::uint64_t mask = 0;
+    for (size_t j = 0; j < len; ++j) {
+        mask |= static_cast<std::uint64_t>(text[j] == text[j + 1]) << j;
+    }
+    return mask;
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+__attribute__((target("avx2")))
+inline std::uint64_t equal_mask_avx2(const std::uint32_t* text, size_t len) {
+    std::uint64_t mask = 0;
+    size_t j = 0;
+    for (; j + 8 <= len; j += 8) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + j));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + j + 1));
+        auto eq = static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))));
+        mask |= static_cast<std::uint64_t>(eq) << j;
+    }
+    return j < len ? mask | (equal_mask_scalar(text + j, len - j) << j) : mask;
+}
+
+__attribute__((target("avx2")))
+inline std::uint64_t equal_mask_avx2(const std::uint64_t* text, size_t len) {
+    std::uint64_t mask = 0;
+    size_t j = 0;
+    for (; j + 4 <= len; j += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + j));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + j + 1));
+        auto eq = static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b))));
+        mask |= static_cast<std::uint64_t>(eq) << j;
+    }
+    return j < len ? mask | (equal_mask_scalar(text + j, len - j) << j) : mask;
+}
+
+__attribute__((target("avx512f")))
+inline std::uint64_t equal_mask_avx512(const std::uint32_t* text, size_t len) {
+    std::uint64_t mask = 0;
+    size_t j = 0;
+    for (; j + 16 <= len; j += 16) {
+        __m512i a = _mm512_loadu_si512(reinterpret_cast<const void*>(text + j));
+        __m512i b = _mm512_loadu_si512(reinterpret_cast<const void*>(text + j + 1));
+        mask |= static_cast<std::uint64_t>(_mm512_cmpeq_epi32_mask(a, b)) << j;
+    }
+    return j < len ? mask | (equal_mask_scalar(text + j, len - j) << j) : mask;
+}
+
+__attribute__((target("avx512f")))
+inline std::uint64_t equal_mask_avx512(const std::uint64_t* text, size_t len) {
+    std::uint64_t mask = 0;
+    size_t j = 0;
+    for (; j + 8 <= len; j += 8) {
+        __m512i a = _mm512_loadu_si512(reinterpret_cast<const void*>(text + j));
+        __m512i b = _mm512_loadu_si512(reinterpret_cast<const void*>(text + j + 1));
+        mask |= static_cast<std::uint64_t>(_mm512_cmpeq_epi64_mask(a, b)) << j;
+    }
+    return j < len ? mask | (equal_mask_scalar(text + j, len - j) << j) : mask;
+}
+
+inline std::uint64_t equal_mask_dispatch(const std::uint32_t* text, size_t len) {
+    switch (active_isa()) {
+        case AVX512:
+            return equal_mask_avx512(text, len);
+        case AVX2:
+            return equal_mask_avx2(text, len);
+        default:
+            return equal_mask_scalar(text, len);
+    }
+}
+
+inline std::uint64_t equal_mask_dispatch(const std::uint64_t* text, size_t len) {
+    switch (active_isa()) {
+        case AVX512:
+            return equal_mask_avx512(text, len);
+        case AVX2:
+            return equal_mask_avx2(text, len);
+        default:
+            return equal_mask_scalar(text, len);
+    }
+}
+#endif
+
+template<typename variable_t>
+inline std::uint64_t equal_mask_dispatch(const variable_t* text, size_t len) {
+    return equal_mask_scalar(text, len);
+}
+
+/**
+ * @brief Computes the bitmask of equal neighbors, i.e. bit j is set iff @code{text[j] == text[j + 1]}.
+ *
+ * The symbols are compared with AVX-512 or AVX2 (8/16 symbols at once) if the cpu supports them.
+ *
+ * @param text Pointer to the first symbol (@code{text[len]} must be readable)
+ * @param len The number of comparisons (at most 64)
+ * @return The bitmask
+ */
+template<typename variable_t>
+inline std::uint64_t equal_mask(const variable_t* text, size_t len) {
+    return equal_mask_dispatch(text, len);
+}
+
+/**
+ * @brief Finds the first position p in [begin, end) with @code{text[p] == text[p + 1]}, i.e. the start of the next
+ * block.
+ *
+ * @param text Pointer to the text (@code{text[end]} must be readable)
+ * @param begin The first position
+ * @param end The position after the last position
+ * @return The position or @code{end} if there is none
+ */
+template<typename variable_t>
+inline size_t next_equal(const variable_t* text, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i += 64) {
+        const size_t len = std::min(static_cast<size_t>(64), end - i);
+        const std::uint64_t mask = equal_mask(text + i, len);
+        if (mask) {
+            return i + __builtin_ctzll(mask);
+        }
+    }
+    return end;
+}
+
+/**
+ * @brief Finds the first position p in [begin, end) with @code{text[p] != text[p + 1]}, i.e. the last position of
+ * the block containing position @code{begin}.
+ *
+ * @param text Pointer to the text (@code{text[end]} must be readable)
+ * @param begin The first position
+ * @param end The position after the last position
+ * @return The position or @code{end} if there is none
+ */
+template<typename variable_t>
+inline size_t next_unequal(const variable_t* text, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i += 64) {
+        const size_t len = std::min(static_cast<size_t>(64), end - i);
+        const std::uint64_t valid = (len == 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << len) - 1;
+        const std::uint64_t mask = ~equal_mask(text + i, len) & valid;
+        if (mask) {
+            return i + __builtin_ctzll(mask);
+        }
+    }
+    return end;
+}
+
+}  // namespace simd
+
+}  // namespace recomp
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "random.hpp"
+#include "util.hpp"
+
+namespace recomp {
+
+/**
+ * @brief Generators of synthetic texts of a given size with controlled alphabet size and repetitiveness.
+ *
+ * All texts are generated in memory and only depend on the parameters and the seed, not on the number of cores. The
+ * random symbols are drawn with a @code{counter_rng}, so every position is generated independently. The alphabet of
+ * size sigma consists of the letters starting at 'a' if sigma is at most 26 and of the symbols [1, sigma] otherwise,
+ * so every text fits into the @code{CHAR_ALPHABET} and does not contain zeroes.
+ */
+namespace generator {
+
+const size_t MAX_SIGMA = 255;
+
+const std::uint64_t SYMBOL_STREAM = 0;
+const std::uint64_t MUTATION_STREAM = 1;
+const std::uint64_t REPLACEMENT_STREAM = 2;
+
+/**
+ * @param sigma The size of the alphabet
+ * @return The smallest symbol of the alphabet
+ */
+inline size_t first_symbol(size_t sigma) {
+    return (sigma <= 26) ? 'a' : 1;
+}
+
+/**
+ * @brief Generates the prefix of length n of the infinite Fibonacci word abaababaabaab... over {a, b}.
+ *
+ * The Fibonacci word f_{k+1} = f_k f_{k-1} is a prefix of all following words, so every step appends a copy of a
+ * prefix of the text.
+ *
+ * @tparam text_t The type of the text
+ * @param text[out] The text
+ * @param n The length of the text
+ * @param cores The number of cores
+ */
+template<typename text_t>
+void fibonacci(text_t& text, size_t n, size_t cores = std::thread::hardware_concurrency()) {
+    typedef typename text_t::value_type value_t;
+    text.resize(n);
+    if (n > 0) {
+        text[0] = static_cast<value_t>('a');
+    }
+    if (n > 1) {
+        text[1] = static_cast<value_t>('b');
+    }
+    size_t prev = 1;
+    size_t cur = 2;
+    while (cur < n) {
+        const size_t end = std::min(n, cur + prev);
+#pragma omp parallel for schedule(static) num_threads(cores)
+        for (size_t i = cur; i < end; ++i) {
+            text[i] = text[i - cur];
+        }
+        prev = cur;
+        cur = end;
+    }
+}
+
+/**
+ * @brief Generates the prefix of length n of the Thue-Morse sequence abbabaab... over {a, b}.
+ *
+ * @tparam text_t The type of the text
+ * @param text[out] The text
+ * @param n The length of the text
+ * @param cores The number of cores
+ */
+template<typename text_t>
+void thue_morse(text_t& text, size_t n, size_t cores = std::thread::hardware_concurrency()) {
+    typedef typename text_t::value_type value_t;
+    text.resize(n);
+#pragma omp parallel for schedule(static) num_threads(cores)
+    for (size_t i = 0; i < n; ++i) {
+        text[i] = static_cast<value_t>('a' + (__builtin_popcountll(i) & 1));
+    }
+}
+
+/**
+ * @brief Generates a text of n independent and uniformly distributed random symbols.
+ *
+ * @tparam text_t The type of the text
+ * @param text[out] The text
+ * @param n The length of the text
+ * @param sigma The size of the alphabet
+ * @param seed The seed
+ * @param cores The number of cores
+ */
+template<typename text_t>
+void random(text_t& text, size_t n, size_t sigma, std::uint64_t seed,
+            size_t cores = std::thread::hardware_concurrency()) {
+    typedef typename text_t::value_type value_t;
+    const counter_rng rng(seed, 0, SYMBOL_STREAM);
+    const size_t first = first_symbol(sigma);
+    text.resize(n);
+#pragma omp parallel for schedule(static) num_threads(cores)
+    for (size_t i = 0; i < n; ++i) {
+        text[i] = static_cast<value_t>(first + rng(i) % sigma);
+    }
+}
+
+/**
+ * @brief Generates a text consisting of copies of a random block of the given length with a fraction of mutated
+ * positions. Every position is replaced by another symbol with the probability @code{rate}. A rate of 0 yields a
+ * periodic text.
+ *
+ * @tparam text_t The type of the text
+ * @param text[out] The text
+ * @param n The length of the text
+ * @param block The length of the repeated block
+ * @param rate The probability of a mutation per position in [0, 1]
+ * @param sigma The size of the alphabet
+ * @param seed The seed
+ * @param cores The number of cores
+ */
+template<typename text_t>
+void mutated_repeats(text_t& text, size_t n, size_t block, double rate, size_t sigma, std::uint64_t seed,
+                     size_t cores = std::thread::hardware_concurrency()) {
+    typedef typename text_t::value_type value_t;
+    const counter_rng symbols(seed, 0, SYMBOL_STREAM);
+    const counter_rng mutations(seed, 0, MUTATION_STREAM);
+    const counter_rng replacements(seed, 0, REPLACEMENT_STREAM);
+    const size_t first = first_symbol(sigma);
+    block = std::max(block, static_cast<size_t>(1));
+
+    // a mutation happens if the random word is smaller than rate * 2^64
+    std::uint64_t threshold = 0;
+    bool mutate_all = rate >= 1.0;
+    if (rate > 0.0 && !mutate_all) {
+        threshold = static_cast<std::uint64_t>(rate * 18446744073709551616.0);
+    }
+
+    text.resize(n);
+#pragma omp parallel for schedule(static) num_threads(cores)
+    for (size_t i = 0; i < n; ++i) {
+        size_t symbol = symbols(i % block) % sigma;
+        if (sigma > 1 && (mutate_all || mutations(i) < threshold)) {
+            symbol = (symbol + 1 + replacements(i) % (sigma - 1)) % sigma;
+        }
+        text[i] = static_cast<value_t>(first + symbol);
+    }
+}
+
+/**
+ * @brief Generates a periodic text of copies of a random block of the given length.
+ *
+ * @tparam text_t The type of the text
+ * @param text[out] The text
+ * @param n The length of the text
+ * @param period The length of the period
+ * @param sigma The size of the alphabet
+ * @param seed The seed
+ * @param cores The number of cores
+ */
+template<typename text_t>
+void periodic(text_t& text, size_t n, size_t period, size_t sigma, std::uint64_t seed,
+              size_t cores = std::thread::hardware_concurrency()) {
+    mutated_repeats(text, n, period, 0.0, sigma, seed, cores);
+}
+
+/**
+ * @return The supported specifications of the generated texts
+ */
+inline std::string generator_options() {
+    return "fibonacci thue_morse random:<sigma> periodic:<period>:<sigma> repeats:<block>:<rate>:<sigma>";
+}
+
+/**
+ * @brief Generates a text given by a specification. The specification is the name of the generator followed by its
+ * parameters separated by colons (see @code{generator_options}). Missing parameters are set to their defaults, i.e. a
+ * sigma of 4, a period or block of 1024 and a mutation rate of 0.001.
+ *
+ * @tparam text_t The type of the text
+ * @param spec The specification
+ * @param text[out] The text
+ * @param n The length of the text
+ * @param seed The seed
+ * @param cores The number of cores
+ * @return Whether the specification is valid
+ */
+template<typename text_t>
+bool generate(const std::string& spec, text_t& text, size_t n, std::uint64_t seed,
+              size_t cores = std::thread::hardware_concurrency()) {
+    std::vector<std::string> params;
+    util::split(spec, ":", params);
+    const std::string& name = params[0];
+
+    std::vector<double> values;
+    for (size_t i = 1; i < params.size(); ++i) {
+        char* end = nullptr;
+        const double value = std::strtod(params[i].c_str(), &end);
+        if (params[i].empty() || *end != '\0' || value < 0) {
+            return false;
+        }
+        values.push_back(value);
+    }
+    auto param = [&](size_t i, double def) {
+        return (i < values.size()) ? values[i] : def;
+    };
+    auto valid_sigma = [](double sigma) {
+        return sigma >= 1 && sigma <= MAX_SIGMA;
+    };
+
+    if (name == "fibonacci" && values.empty()) {
+        fibonacci(text, n, cores);
+    } else if (name == "thue_morse" && values.empty()) {
+        thue_morse(text, n, cores);
+    } else if (name == "random" && values.size() <= 1 && valid_sigma(param(0, 4))) {
+        random(text, n, static_cast<size_t>(param(0, 4)), seed, cores);
+    } else if (name == "periodic" && values.size() <= 2 && param(0, 1024) >= 1 && valid_sigma(param(1, 4))) {
+        periodic(text, n, static_cast<size_t>(param(0, 1024)), static_cast<size_t>(param(1, 4)), seed, cores);
+    } else if (name == "repeats" && values.size() <= 3 && param(0, 1024) >= 1 && param(1, 0.001) <= 1 &&
+               valid_sigma(param(2, 4))) {
+        mutated_repeats(text, n, static_cast<size_t>(param(0, 1024)), param(1, 0.001),
+                        static_cast<size_t>(param(2, 4)), seed, cores);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the name of the dataset of a generated text. The underscores are escaped like the names of files in
+ * the benchmarks.
+ *
+ * @param spec The specification
+ * @param n The length of the text
+ * @return The name of the dataset
+ */
+inline std::string dataset_name(const std::string& spec, size_t n) {
+    std::string dataset = spec + "_n" + std::to_string(n);
+    util::replace_all(dataset, ":", "-");
+    util::replace_all(dataset, "_", "\\_");
+    return dataset;
+}
+
+}  // namespace generator
+}  // namespace recomp
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "defs.hpp"
+
+namespace recomp {
+
+/**
+ * @brief A completed span of time recorded by the @code{tracer}. The names must be string literals (or outlive the
+ * tracer), since only the pointers are stored.
+ */
+struct trace_event {
+    const char* name;            // the name of the phase
+    const char* category;        // the category, e.g. recompression, coder or query
+    const char* arg_name;        // the name of the argument or nullptr if there is none
+    std::uint64_t arg;           // the argument, e.g. the size of the text
+    std::uint64_t begin;         // the begin in nanoseconds since the start of the tracer
+    std::uint64_t duration;      // the duration in nanoseconds
+    size_t thread;               // the index of the recording thread
+};
+
+/**
+ * @brief Collects the spans recorded by @code{trace_scope}s with nanosecond resolution.
+ *
+ * Tracing is disabled by default and enabled at runtime, so no special build type is needed. A disabled tracer costs
+ * a relaxed atomic load per span. Every thread appends its events to its own buffer without synchronization. Only the
+ * first event of a thread registers its buffer under a lock. The events are exported as Chrome trace JSON (viewable
+ * in chrome://tracing or Perfetto) or as CSV. Exporting and clearing must not overlap with recording.
+ */
+class tracer {
+ public:
+    tracer() = delete;
+
+    /**
+     * @return Whether spans are recorded
+     */
+    static inline bool enabled() {
+        return state().enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Enables or disables the recording of spans.
+     *
+     * @param enable Whether to record spans
+     */
+    static inline void enable(bool enable = true) {
+        state().enabled.store(enable, std::memory_order_relaxed);
+    }
+
+    /**
+     * @return The nanoseconds since the start of the tracer
+     */
+    static inline std::uint64_t now() {
+        return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(timer::now() - state().epoch).count());
+    }
+
+    /**
+     * @brief Appends the event to the buffer of the calling thread.
+     *
+     * @param event The event
+     */
+    static inline void record(trace_event event) {
+        auto& buffer = local_buffer();
+        event.thread = buffer.thread;
+        buffer.events.push_back(event);
+    }
+
+    /**
+     * @brief Removes all recorded events.
+     */
+    static inline void clear() {
+        auto& s = state();
+        std::lock_guard<std::mutex> guard(s.mutex);
+        for (auto& buffer : s.buffers) {
+            buffer->events.clear();
+        }
+    }
+
+    /**
+     * @return The events of all threads ordered by their begin
+     */
+    static inline std::vector<trace_event> events() {
+        auto& s = state();
+        std::vector<trace_event> events;
+        {
+            std::lock_guard<std::mutex> guard(s.mutex);
+            for (const auto& buffer : s.buffers) {
+                events.insert(events.end(), buffer->events.begin(), buffer->events.end());
+            }
+        }
+        std::stable_sort(events.begin(), events.end(), [](const trace_event& a, const trace_event& b) {
+            return a.begin < b.begin;
+        });
+        return events;
+    }
+
+    /**
+     * @brief Writes the events in the Chrome trace event format. The timestamps are given in microseconds with
+     * nanosecond precision.
+     *
+     * @param out The stream to write to
+     */
+    static inline void write_chrome_trace(std::ostream& out) {
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        for (const auto& event : events()) {
+            out << (first ? "\n" : ",\n") << "{\"name\":\"";
+            write_escaped(out, event.name);
+            out << "\",\"cat\":\"";
+            write_escaped(out, event.category);
+            out << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread << ",\"ts\":";
+            write_micros(out, event.begin);
+            out << ",\"dur\":";
+            write_micros(out, event.duration);
+            if (event.arg_name) {
+                out << ",\"args\":{\"";
+                write_escaped(out, event.arg_name);
+                out << "\":" << event.arg << "}";
+            }
+            out << "}";
+            first = false;
+        }
+        out << "\n]}" << std::endl;
+    }
+
+    /**
+     * @brief Writes the events as CSV with a header line. The times are given in nanoseconds.
+     *
+     * @param out The stream to write to
+     */
+    static inline void write_csv(std::ostream& out) {
+        out << "name,category,thread,begin_ns,duration_ns,arg_name,arg\n";
+        for (const auto& event : events()) {
+            out << event.name << "," << event.category << "," << event.thread << "," << event.begin << ","
+                << event.duration << "," << (event.arg_name ? event.arg_name : "") << ",";
+            if (event.arg_name) {
+                out << event.arg;
+            }
+            out << "\n";
+        }
+        out.flush();
+    }
+
+    /**
+     * @brief Writes the events to @code{<prefix>.json} in the Chrome trace event format and to @code{<prefix>.csv}.
+     *
+     * @param prefix The path and name of the files without extension
+     * @return Whether both files have been written
+     */
+    static inline bool write(const std::string& prefix) {
+        std::ofstream json(prefix + ".json");
+        std::ofstream csv(prefix + ".csv");
+        if (!json || !csv) {
+            std::cerr << "Failed to write trace " << prefix << std::endl;
+            return false;
+        }
+        write_chrome_trace(json);
+        write_csv(csv);
+        return static_cast<bool>(json) && static_cast<bool>(csv);
+    }
+
+ private:
+    struct thread_buffer {
+        size_t thread;
+        std::vector<trace_event> events;
+    };
+
+    struct state_t {
+        std::atomic<bool> enabled{false};
+        timer::time_point epoch = timer::now();
+        std::mutex mutex;
+        std::vector<std::unique_ptr<thread_buffer>> buffers;
+    };
+
+    static inline state_t& state() {
+        static state_t s;
+        return s;
+    }
+
+    static inline thread_buffer& local_buffer() {
+        thread_local thread_buffer* buffer = nullptr;
+        if (!buffer) {
+            auto& s = state();
+            std::lock_guard<std::mutex> guard(s.mutex);
+            s.buffers.emplace_back(new thread_buffer{s.buffers.size(), std::vector<trace_event>()});
+            buffer = s.buffers.back().get();
+        }
+        return *buffer;
+    }
+
+    static inline void write_escaped(std::ostream& out, const char* str) {
+        for (; *str; ++str) {
+            if (*str == '"' || *str == '\\') {
+                out << '\\';
+            }
+            out << *str;
+        }
+    }
+
+    static inline void write_micros(std::ostream& out, std::uint64_t ns) {
+        const auto frac = std::to_string(ns % 1000);
+        out << ns / 1000 << "." << std::string(3 - frac.size(), '0') << frac;
+    }
+};
+
+/**
+ * @brief Records the time from its construction to its end or destruction as an event of the @code{tracer}. Does
+ * nothing but a check of the flag if the tracer is disabled at construction.
+ */
+class trace_scope {
+ public:
+    /**
+     * @brief Starts the span.
+     *
+     * @param name The name of the phase (a string literal)
+     * @param category The category (a string literal)
+     * @param arg_name The name of an argument (a string literal) or nullptr
+     * @param arg The argument
+     */
+    inline explicit trace_scope(const char* name, const char* category = "recompression",
+                                const char* arg_name = nullptr, std::uint64_t arg = 0)
+            : name(name), category(category), arg_name(arg_name), arg(arg), active(tracer::enabled()) {
+        if (active) {
+            begin = tracer::now();
+        }
+    }
+
+    trace_scope(const trace_scope&) = delete;
+
+    trace_scope& operator=(const trace_scope&) = delete;
+
+    inline ~trace_scope() {
+        end();
+    }
+
+    /**
+     * @brief Ends the span and records it.
+     */
+    inline void end() {
+        if (active) {
+            active = false;
+            tracer::record(trace_event{name, category, arg_name, arg, begin, tracer::now() - begin, 0});
+        }
+    }
+
+ private:
+    const char* name;
+    const char* category;
+    const char* arg_name;
+    std::uint64_t arg;
+    std::uint64_t begin = 0;
+    bool active;
+};
+
+}  // namespace recomp
@@ -8,6 +8,7 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -369,7 +370,7 @@ std::string pair_positions_to_string(const std::vector<pair_position_t>& positio
 template<typename partition_t>
 std::string partition_to_string(const partition_t& partition) {
     std::stringstream sstream;
-    std::map<var_t, bool> part;
+    std::map<typename std::decay<decltype(partition.begin()->first)>::type, bool> part;
     for (const auto& par : partition) {
         part[par.first] = par.second;
     }
@@ -564,5 +565,25 @@ inline constexpr uint8_t bits_for(size_t value) {
     return value == 0 ? (uint8_t)1 : 64 - __builtin_clzll(value);
 }
 
+/**
+ * @brief Returns the percentile of the given increasingly sorted values using the nearest rank method.
+ *
+ * @tparam T The type of the values
+ * @param sorted The increasingly sorted values
+ * @param p The percentile in [0, 100]
+ * @return The percentile (0 if there are no values)
+ */
+template<typename T>
+inline T percentile(const std::vector<T>& sorted, const double p) {
+    if (sorted.empty()) {
+        return T{};
+    }
+    size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.5);
+    if (rank > 0) {
+        rank--;
+    }
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
 }  // namespace util
 }  // namespace recomp
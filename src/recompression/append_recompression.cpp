@@ -0,0 +1 @@
+#include "recompression/append_recompression.hpp"
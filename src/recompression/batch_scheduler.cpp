@@ -0,0 +1 @@
+#include "recompression/batch_scheduler.hpp"
@@ -0,0 +1 @@
+#include "recompression/bit_partition.hpp"
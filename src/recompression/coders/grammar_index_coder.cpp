@@ -0,0 +1 @@
+#include "recompression/coders/grammar_index_coder.hpp"
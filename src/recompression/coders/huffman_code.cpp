@@ -0,0 +1 @@
+#include "recompression/coders/huffman_code.hpp"
@@ -0,0 +1 @@
+#include "recompression/coders/huffman_rlslp_coder.hpp"
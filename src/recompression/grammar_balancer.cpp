@@ -0,0 +1 @@
+#include "recompression/grammar_balancer.hpp"
@@ -0,0 +1 @@
+#include "recompression/karp_rabin.hpp"
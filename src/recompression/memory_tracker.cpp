@@ -0,0 +1 @@
+#include "recompression/memory_tracker.hpp"
@@ -0,0 +1 @@
+#include "recompression/packed_vector.hpp"
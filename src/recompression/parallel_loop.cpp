@@ -0,0 +1 @@
+#include "recompression/parallel_loop.hpp"
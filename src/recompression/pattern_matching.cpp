@@ -0,0 +1 @@
+#include "recompression/pattern_matching.hpp"
@@ -0,0 +1 @@
+#include "recompression/random.hpp"
@@ -0,0 +1 @@
+#include "recompression/regression.hpp"
@@ -0,0 +1 @@
+#include "recompression/rlslp_verifier.hpp"
@@ -0,0 +1 @@
+#include "recompression/run_detection.hpp"
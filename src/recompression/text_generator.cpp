@@ -0,0 +1 @@
+#include "recompression/text_generator.hpp"
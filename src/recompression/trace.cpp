@@ -0,0 +1 @@
+#include "recompression/trace.hpp"
@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "recompression/append_recompression.hpp"
+#include "recompression/coders/plain_rlslp_coder.hpp"
+#include "recompression/util.hpp"
+
+using namespace recomp;
+
+typedef append_recompression<var_t>::text_t text_t;
+
+namespace {
+
+text_t to_text(const std::string& str) {
+    text_t text(str.size());
+    for (size_t i = 0; i < str.size(); ++i) {
+        text[i] = static_cast<var_t>(str[i]);
+    }
+    return text;
+}
+
+/**
+ * Checks that both rlslps consist of the same rules up to the names of the non-terminals, i.e. appending only changes
+ * the order of the rules.
+ */
+void check_same_rules(const rlslp<var_t>& exp, const rlslp<var_t>& slp) {
+    ASSERT_EQ(exp.terminals, slp.terminals);
+    ASSERT_EQ(exp.size(), slp.size());
+    ASSERT_EQ(exp.blocks, slp.blocks);
+    std::vector<var_t> names(exp.size(), 0);
+    std::vector<bool> used(slp.size(), false);
+    size_t mapped = 0;
+    std::vector<std::pair<var_t, var_t>> stack{std::make_pair(exp.root, slp.root)};
+    while (!stack.empty()) {
+        const auto nts = stack.back();
+        stack.pop_back();
+        if (exp.is_terminal(nts.first)) {
+            ASSERT_EQ(nts.first, nts.second);
+            continue;
+        }
+        ASSERT_FALSE(slp.is_terminal(nts.second));
+        const size_t i = nts.first - exp.terminals;
+        if (names[i] != 0) {
+            ASSERT_EQ(names[i], nts.second);
+            continue;
+        }
+        ASSERT_FALSE(used[nts.second - slp.terminals]);
+        names[i] = nts.second;
+        used[nts.second - slp.terminals] = true;
+        mapped++;
+        ASSERT_EQ(exp.is_block(nts.first), slp.is_block(nts.second));
+        const auto& rule = exp[i];
+        const auto& other = slp[nts.second - slp.terminals];
+        if (exp.is_block(nts.first)) {
+            ASSERT_EQ(rule.second(), other.second());
+        } else {
+            stack.emplace_back(rule.second(), other.second());
+        }
+        stack.emplace_back(rule.first(), other.first());
+    }
+    ASSERT_EQ(exp.size(), mapped);
+}
+
+}  // namespace
+
+TEST(append, empty) {
+    text_t text;
+    rlslp<var_t> rlslp;
+    append_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, 5, 1);
+
+    recomp::rlslp<var_t> exp_rlslp;
+    exp_rlslp.terminals = 5;
+    ASSERT_EQ(exp_rlslp, rlslp);
+}
+
+TEST(append, single_terminal) {
+    text_t text = util::create_ui_vector(std::vector<var_t>{3});
+    rlslp<var_t> rlslp;
+    append_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, 5, 1);
+
+    ASSERT_FALSE(rlslp.empty());
+    ASSERT_EQ(3, rlslp.root);
+    ASSERT_EQ(0, rlslp.size());
+}
+
+TEST(append, recomp) {
+    std::vector<var_t> vec = {2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3,
+                              2, 1};
+    text_t text = util::create_ui_vector(vec);
+    rlslp<var_t> rlslp;
+    append_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, 5, 1);
+
+    ASSERT_EQ(vec.size(), rlslp.len(rlslp.root));
+    for (size_t i = rlslp.blocks; i < rlslp.size(); ++i) {
+        ASSERT_TRUE(rlslp.is_block(i + rlslp.terminals));
+    }
+    std::string exp;
+    for (const auto& c : vec) {
+        exp += static_cast<char>(c);
+    }
+    ASSERT_EQ(exp, rlslp.derive_text());
+}
+
+TEST(append, suffixes) {
+    std::string text = "abababbbbbabaabcabcabccccabcdeabcdeababababab";
+    std::string derived;
+    rlslp<var_t> rlslp;
+    append_recompression<var_t> recomp;
+    for (size_t i = 0; i < text.size(); i += 7) {
+        auto part = text.substr(i, 7);
+        text_t suffix(part.size());
+        for (size_t j = 0; j < part.size(); ++j) {
+            suffix[j] = static_cast<var_t>(part[j]);
+        }
+        recomp.append(suffix, rlslp);
+        derived += part;
+
+        ASSERT_EQ(derived.size(), rlslp.len(rlslp.root));
+        ASSERT_EQ(derived, rlslp.derive_text());
+        for (size_t j = 0; j < rlslp.size(); ++j) {
+            ASSERT_EQ(j >= rlslp.blocks, rlslp.is_block(j + rlslp.terminals));
+        }
+    }
+}
+
+TEST(append, single_symbols) {
+    std::string text = "aaaaaaabbbbaaaaaaaabbbbabababababcccccabcabcab";
+    std::string derived;
+    rlslp<var_t> rlslp;
+    append_recompression<var_t> recomp;
+    for (size_t i = 0; i < text.size(); ++i) {
+        text_t suffix(1);
+        suffix[0] = static_cast<var_t>(text[i]);
+        recomp.append(suffix, rlslp);
+        derived += text[i];
+        ASSERT_EQ(derived, rlslp.derive_text());
+    }
+
+    text_t full(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        full[i] = static_cast<var_t>(text[i]);
+    }
+    recomp::rlslp<var_t> exp_rlslp;
+    append_recompression<var_t> exp_recomp;
+    exp_recomp.recomp(full, exp_rlslp, CHAR_ALPHABET, 1);
+    check_same_rules(exp_rlslp, rlslp);
+}
+
+TEST(append, reuse_non_terminals) {
+    std::string part = "abcabcabcdddabcabc";
+    text_t suffix(part.size());
+    for (size_t j = 0; j < part.size(); ++j) {
+        suffix[j] = static_cast<var_t>(part[j]);
+    }
+    rlslp<var_t> rlslp;
+    append_recompression<var_t> recomp;
+    recomp.append(suffix, rlslp);
+    std::string derived = part;
+    size_t productions = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        recomp.append(suffix, rlslp);
+        derived += part;
+        ASSERT_EQ(derived, rlslp.derive_text());
+        if (i == 4) {
+            productions = rlslp.size();
+        }
+    }
+    // appending the same data again only adds rules for the upper levels
+    ASSERT_LE(rlslp.size(), productions + 2 * recomp.get_boundaries().size());
+}
+
+TEST(append, long_run) {
+    text_t suffix(1000);
+    for (size_t i = 0; i < suffix.size(); ++i) {
+        suffix[i] = 'a';
+    }
+    rlslp<var_t> rlslp;
+    append_recompression<var_t> recomp;
+    recomp.append(suffix, rlslp);
+    recomp.append(suffix, rlslp);
+    ASSERT_EQ(1, rlslp.size());
+    ASSERT_EQ(2000, rlslp.len(rlslp.root));
+    ASSERT_EQ(std::string(2000, 'a'), rlslp.derive_text());
+}
+
+TEST(append, state) {
+    std::string text = "abababbbbbabaabcabcabccccabcdeabcdeababababababcabcabcaaaaaabbbbbbabcdabcd";
+    const std::string file_name = "append_state_test";
+    for (size_t split = 1; split < text.size(); split += 5) {
+        {
+            rlslp<var_t> rlslp;
+            append_recompression<var_t> recomp;
+            text_t prefix = to_text(text.substr(0, split));
+            recomp.append(prefix, rlslp);
+            coder::PlainRLSLPCoder::Encoder enc(file_name);
+            enc.encode(rlslp);
+            recomp.write_state(file_name + ".append");
+        }
+
+        // a new instance continues the decoded rlslp
+        coder::PlainRLSLPCoder::Decoder dec(file_name);
+        rlslp<var_t> rlslp = dec.decode<var_t>();
+        append_recompression<var_t> recomp;
+        ASSERT_TRUE(recomp.read_state(file_name + ".append", rlslp));
+        text_t suffix = to_text(text.substr(split));
+        recomp.append(suffix, rlslp);
+        ASSERT_EQ(text, rlslp.derive_text());
+
+        text_t full = to_text(text);
+        recomp::rlslp<var_t> exp_rlslp;
+        append_recompression<var_t> exp_recomp;
+        exp_recomp.recomp(full, exp_rlslp, CHAR_ALPHABET, 1);
+        check_same_rules(exp_rlslp, rlslp);
+
+        // the state does not belong to a different rlslp
+        recomp.write_state(file_name + ".append");
+        rlslp.resize(rlslp.size() - 1);
+        ASSERT_FALSE(recomp.read_state(file_name + ".append", rlslp));
+    }
+    std::remove((file_name + coder::PlainRLSLPCoder::k_extension).c_str());
+    std::remove((file_name + ".append").c_str());
+}
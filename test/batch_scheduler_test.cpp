@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "recompression.hpp"
+
+using namespace recomp;
+
+TEST(batch_scheduler, plan) {
+    batch_scheduler scheduler(8);
+    scheduler.bytes_per_core = 100;
+    scheduler.memory_per_byte = 2;
+    auto jobs = scheduler.plan({50, 350, 0, 100000, 199});
+
+    ASSERT_EQ(5, jobs.size());
+    std::vector<size_t> exp_ids = {3, 1, 4, 0, 2};
+    std::vector<size_t> exp_cores = {8, 3, 1, 1, 1};
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        ASSERT_EQ(exp_ids[i], jobs[i].id);
+        ASSERT_EQ(exp_cores[i], jobs[i].cores);
+        ASSERT_EQ(2 * jobs[i].size, jobs[i].memory);
+    }
+}
+
+TEST(batch_scheduler, bounds) {
+    batch_scheduler scheduler(4, 1000);
+    scheduler.bytes_per_core = 10;
+    scheduler.memory_per_byte = 10;
+    std::vector<size_t> sizes = {5, 30, 10, 200, 1, 1, 25, 40, 12, 8, 3, 7};
+
+    std::vector<std::atomic<size_t>> runs(sizes.size());
+    for (auto& r : runs) {
+        r = 0;
+    }
+    std::atomic<size_t> used_cores{0};
+    std::atomic<size_t> used_memory{0};
+    std::atomic<bool> exceeded{false};
+    scheduler.run(sizes, [&](const batch_job& job) {
+        size_t c = used_cores += job.cores;
+        size_t m = used_memory += job.memory;
+        if (job.size != 200 && (c > 4 || m > 1000)) {
+            exceeded = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        runs[job.id]++;
+        used_cores -= job.cores;
+        used_memory -= job.memory;
+    });
+
+    ASSERT_FALSE(exceeded);
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        ASSERT_EQ(1, runs[i]) << i;
+    }
+}
+
+TEST(batch_scheduler, exception) {
+    batch_scheduler scheduler(2);
+    std::atomic<size_t> finished{0};
+    ASSERT_THROW(scheduler.run({1, 2, 3, 4}, [&](const batch_job& job) {
+        if (job.id == 2) {
+            throw std::runtime_error("job failed");
+        }
+        finished++;
+    }), std::runtime_error);
+    ASSERT_EQ(3, finished);
+}
+
+TEST(batch_scheduler, compression) {
+    std::vector<std::string> strs;
+    for (size_t k = 0; k < 6; ++k) {
+        std::string str;
+        for (size_t i = 0; i < 200 * (k + 1); ++i) {
+            str += std::string(1 + (i * 7919) % (k + 5), static_cast<char>('a' + (i * (k + 3)) % (k + 4)));
+        }
+        strs.push_back(str);
+    }
+    std::vector<size_t> sizes;
+    for (const auto& str : strs) {
+        sizes.push_back(str.size());
+    }
+
+    batch_scheduler scheduler(4);
+    scheduler.bytes_per_core = 1000;
+    memory_tracker::reset();
+    std::vector<std::string> derived(strs.size());
+    scheduler.run(sizes, [&](const batch_job& job) {
+        std::string dataset = "test";
+        auto recomp = create_recompression<var_t>("parallel_rnd", dataset, "", "");
+        recompression<var_t>::text_t text(strs[job.id].size());
+        for (size_t i = 0; i < text.size(); ++i) {
+            text[i] = static_cast<unsigned char>(strs[job.id][i]);
+        }
+        rlslp<var_t> slp;
+        recomp->recomp(text, slp, CHAR_ALPHABET, job.cores);
+        derived[job.id] = slp.derive_text();
+    });
+    for (size_t i = 0; i < strs.size(); ++i) {
+        ASSERT_EQ(strs[i], derived[i]);
+    }
+
+    // the phases of the concurrent jobs are skipped, the phases of the calling thread are not
+    ASSERT_TRUE(memory_tracker::phases().empty());
+    {
+        memory_phase phase("batch");
+    }
+    ASSERT_EQ(1U, memory_tracker::phases().count("batch"));
+}
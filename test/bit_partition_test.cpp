@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "recompression/bit_partition.hpp"
+#include "recompression/defs.hpp"
+#include "recompression/random.hpp"
+
+using namespace recomp;
+
+namespace {
+
+template<typename variable_t>
+void check_partition(size_t alphabet, size_t n, variable_t minimum) {
+    ui_vector<bool> partition(alphabet);
+    counter_rng(3, alphabet).fill(partition, 0, alphabet, 4);
+
+    ui_vector<variable_t> text(n);
+    for (size_t i = 0; i < n; ++i) {
+        text[i] = minimum + static_cast<variable_t>(counter_rng(5, n)(i) % alphabet);
+    }
+
+    bit_partition bits(partition, 3);
+    ASSERT_EQ(alphabet, bits.size());
+    for (size_t i = 0; i < alphabet; ++i) {
+        ASSERT_EQ(partition[i], bits[i]);
+    }
+
+    for (size_t len = 0; len <= 64 && len <= n; ++len) {
+        std::uint64_t exp_mask = 0;
+        for (size_t j = 0; j < len; ++j) {
+            exp_mask |= static_cast<std::uint64_t>(partition[text[j] - minimum]) << j;
+        }
+        ASSERT_EQ(exp_mask, bits.block_mask(text.data(), len, minimum));
+    }
+
+    for (size_t begin : {size_t(0), size_t(1), size_t(63), n / 3}) {
+        for (size_t end : {begin, begin + 1, begin + 64, begin + 65, n - 1}) {
+            if (end < begin || end >= n) {
+                continue;
+            }
+            size_t exp_lr = 0;
+            size_t exp_rl = 0;
+            std::vector<size_t> exp_l;
+            std::vector<size_t> exp_r;
+            for (size_t i = begin; i < end; ++i) {
+                bool b_i = partition[text[i] - minimum];
+                bool b_i1 = partition[text[i + 1] - minimum];
+                if (!b_i && b_i1) {
+                    exp_lr++;
+                    exp_l.push_back(i);
+                } else if (b_i && !b_i1) {
+                    exp_rl++;
+                    exp_r.push_back(i);
+                }
+            }
+
+            size_t lr = 0;
+            size_t rl = 0;
+            bits.count_pairs(text, begin, end, minimum, lr, rl);
+            ASSERT_EQ(exp_lr, lr);
+            ASSERT_EQ(exp_rl, rl);
+
+            std::vector<size_t> pairs;
+            bits.for_each_pair(text, begin, end, minimum, false, [&](size_t i) { pairs.push_back(i); });
+            ASSERT_EQ(exp_l, pairs);
+            pairs.clear();
+            bits.for_each_pair(text, begin, end, minimum, true, [&](size_t i) { pairs.push_back(i); });
+            ASSERT_EQ(exp_r, pairs);
+        }
+    }
+}
+
+}  // namespace
+
+TEST(bit_partition, small) {
+    check_partition<var_t>(2, 10, 0);
+    check_partition<var_t>(5, 200, 3);
+}
+
+TEST(bit_partition, large) {
+    check_partition<var_t>(100000, 5000, 256);
+    check_partition<var_t>(1000, 100000, 0);
+}
+
+TEST(bit_partition, wide) {
+    check_partition<std::uint64_t>(3000, 1000, (static_cast<std::uint64_t>(1) << 35));
+}
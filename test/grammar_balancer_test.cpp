@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "recompression.hpp"
+#include "test_util.hpp"
+
+using namespace recomp;
+using recomp::test::check_rlslp;
+using recomp::test::compress;
+
+namespace {
+
+/**
+ * Builds a left-deep (or right-deep) comb of pairs followed by a block of the comb, i.e. the text
+ * z(c_0 c_1 ... c_{n - 1})^3.
+ */
+void comb(size_t n, bool left, rlslp<var_t>& slp, std::string& str) {
+    slp.terminals = CHAR_ALPHABET;
+    slp.is_empty = false;
+    slp.resize(n + 1);
+    std::string part = "ab";
+    slp[0] = non_terminal<var_t>('a', 'b', 2);
+    for (size_t i = 1; i < n - 1; ++i) {
+        const var_t c = 'a' + (i * 7) % 5;
+        if (left) {
+            slp[i] = non_terminal<var_t>(CHAR_ALPHABET + i - 1, c, i + 2);
+            part += static_cast<char>(c);
+        } else {
+            slp[i] = non_terminal<var_t>(c, CHAR_ALPHABET + i - 1, i + 2);
+            part = static_cast<char>(c) + part;
+        }
+    }
+    slp[n - 1] = non_terminal<var_t>('z', CHAR_ALPHABET + n, 3 * n + 1);
+    slp[n] = non_terminal<var_t>(CHAR_ALPHABET + n - 2, 3, 3 * n);
+    slp.blocks = n;
+    slp.root = CHAR_ALPHABET + n - 1;
+    str = "z" + part + part + part;
+}
+
+void check(const rlslp<var_t>& slp, const std::string& str) {
+    check_rlslp(slp, str);
+    ASSERT_GE(balancer::avl_height_bound(str.size()), slp.height());
+}
+
+}  // namespace
+
+TEST(grammar_balancer, avl_height_bound) {
+    ASSERT_EQ(0U, balancer::avl_height_bound(1));
+    ASSERT_EQ(1U, balancer::avl_height_bound(2));
+    ASSERT_EQ(2U, balancer::avl_height_bound(3));
+    ASSERT_EQ(2U, balancer::avl_height_bound(4));
+    ASSERT_EQ(3U, balancer::avl_height_bound(5));
+    ASSERT_EQ(3U, balancer::avl_height_bound(7));
+    ASSERT_EQ(4U, balancer::avl_height_bound(8));
+    ASSERT_EQ(91U, balancer::avl_height_bound(static_cast<size_t>(-1)));
+}
+
+TEST(grammar_balancer, comb) {
+    for (const bool left : {true, false}) {
+        rlslp<var_t> slp;
+        std::string str;
+        comb(2000, left, slp, str);
+        ASSERT_EQ(2001U, slp.height());
+
+        rlslp<var_t> sequential;
+        comb(2000, left, sequential, str);
+
+        ASSERT_TRUE(balance_rlslp(slp, 4));
+        ASSERT_TRUE(balance_rlslp(sequential, 1));
+        ASSERT_TRUE(slp == sequential);
+        check(slp, str);
+        ASSERT_EQ(str.substr(1000, 3000), slp.extract(1000, 3000));
+
+        auto dist = compute_height_distribution(slp, 2);
+        ASSERT_EQ(slp.height(), dist.height);
+        ASSERT_FALSE(balance_rlslp(slp, 4));
+    }
+}
+
+TEST(grammar_balancer, recompressed) {
+    for (const auto& spec : {"fibonacci", "random:4", "repeats:300:0.01", "periodic:17:3"}) {
+        std::string str;
+        generator::generate(spec, str, 20000, 5, 2);
+        rlslp<var_t> slp;
+        compress(str, slp);
+
+        rlslp<var_t> sequential;
+        compress(str, sequential);
+
+        balancer::balance(slp, 4);
+        balancer::balance(sequential, 1);
+        ASSERT_TRUE(slp == sequential) << spec;
+        check(slp, str);
+    }
+}
+
+TEST(grammar_balancer, height_distribution) {
+    // 256 = ab, 257 = (256, c), 258 = (d, 259), 259 = 257^4 and the unreachable block 260 = 256^2
+    rlslp<var_t> slp;
+    slp.terminals = CHAR_ALPHABET;
+    slp.is_empty = false;
+    slp.resize(5);
+    slp[0] = non_terminal<var_t>('a', 'b', 2);
+    slp[1] = non_terminal<var_t>(256, 'c', 3);
+    slp[2] = non_terminal<var_t>('d', 259, 13);
+    slp[3] = non_terminal<var_t>(257, 4, 12);
+    slp[4] = non_terminal<var_t>(256, 2, 4);
+    slp.blocks = 3;
+    slp.root = 258;
+
+    auto dist = compute_height_distribution(slp, 2);
+    ASSERT_EQ(4U, dist.height);
+    ASSERT_EQ(5U, dist.bound);
+    ASSERT_EQ(1U, dist.unbalanced);
+    ASSERT_EQ(std::vector<size_t>({0, 1, 1, 1, 1}), dist.rules);
+
+    std::stringstream out;
+    out << dist;
+    ASSERT_EQ(" height=4 height_bound=5 unbalanced=1 heights=1:1,2:1,3:1,4:1", out.str());
+
+    slp.resize(0);
+    slp.root = 'a';
+    ASSERT_EQ(0U, compute_height_distribution(slp, 2).height);
+}
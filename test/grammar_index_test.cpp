@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "recompression/defs.hpp"
+#include "recompression/grammar_index.hpp"
+#include "recompression/pattern_matching.hpp"
+#include "recompression/rlslp.hpp"
+#include "recompression/parallel_recompression.hpp"
+#include "recompression/coders/grammar_index_coder.hpp"
+#include "recompression/util.hpp"
+
+using namespace recomp;
+
+typedef recompression<var_t>::text_t text_t;
+
+TEST(wavelet_matrix, count_report) {
+    std::vector<size_t> values = {5, 2, 7, 0, 3, 3, 6, 1, 4, 2};
+    index::wavelet_matrix wm{values};
+    ASSERT_EQ(values.size(), wm.size());
+
+    for (size_t lo = 0; lo <= values.size(); ++lo) {
+        for (size_t hi = lo; hi <= values.size(); ++hi) {
+            for (size_t a = 0; a <= 8; ++a) {
+                for (size_t b = a; b <= 8; ++b) {
+                    std::vector<size_t> exp_pos;
+                    for (size_t i = lo; i < hi; ++i) {
+                        if (values[i] >= a && values[i] < b) {
+                            exp_pos.push_back(i);
+                        }
+                    }
+                    std::vector<size_t> pos;
+                    wm.report(lo, hi, a, b, pos);
+                    std::sort(pos.begin(), pos.end());
+                    ASSERT_EQ(exp_pos.size(), wm.count(lo, hi, a, b));
+                    ASSERT_EQ(exp_pos, pos);
+                }
+            }
+        }
+    }
+}
+
+TEST(grammar_index, empty) {
+    text_t text = util::create_ui_vector(std::vector<var_t>{});
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    index::grammar_index<var_t> index{rlslp};
+    ASSERT_EQ(0, index.count(std::string{1, 2}));
+    ASSERT_EQ(0, index.count(std::string{1}));
+    ASSERT_TRUE(index.locate(std::string{1, 2}).empty());
+}
+
+TEST(grammar_index, terminal) {
+    text_t text = util::create_ui_vector(std::vector<var_t>{3});
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    index::grammar_index<var_t> index{rlslp};
+    ASSERT_EQ(1, index.count(std::string{3}));
+    ASSERT_EQ(0, index.count(std::string{3, 3}));
+    ASSERT_EQ(std::vector<size_t>{0}, index.locate(std::string{3}));
+}
+
+TEST(grammar_index, pattern) {
+    text_t text = util::create_ui_vector(std::vector<var_t>{2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 2, 1});
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    index::grammar_index<var_t> index{rlslp, 4};
+    std::string pattern{4, 1, 3};
+    std::vector<size_t> exp_occ = {6, 14, 19, 27};
+    ASSERT_EQ(4, index.count(pattern));
+    ASSERT_EQ(exp_occ, index.locate(pattern));
+
+    pattern = std::string{3, 2, 3, 1, 1, 4, 1, 3};
+    exp_occ = {9, 22};
+    ASSERT_EQ(2, index.count(pattern));
+    ASSERT_EQ(exp_occ, index.locate(pattern));
+
+    exp_occ = {4, 5, 6, 14, 19, 27};
+    ASSERT_EQ(6, index.count(std::string{4}));
+    ASSERT_EQ(exp_occ, index.locate(std::string{4}));
+
+    ASSERT_EQ(0, index.count(std::string{4, 4, 4, 4}));
+    ASSERT_EQ(0, index.count(std::string{2, 2}));
+    ASSERT_EQ(rlslp.extract(3, 10), index.extract(3, 10));
+}
+
+TEST(grammar_index, runs) {
+    std::string str(100, 'a');
+    str += std::string(37, 'b') + std::string(100, 'a');
+    text_t text(str.size());
+    for (size_t i = 0; i < str.size(); ++i) {
+        text[i] = static_cast<var_t>(str[i]);
+    }
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 4);
+
+    index::grammar_index<var_t> index{rlslp, 4};
+    for (size_t m = 1; m <= str.size(); m += 5) {
+        for (const auto& pattern : {std::string(m, 'a'), std::string(m, 'b'), str.substr(90, m)}) {
+            auto exp_occ = pattern_matching::find_occurrences_naive(str, pattern);
+            ASSERT_EQ(exp_occ.size(), index.count(pattern));
+            ASSERT_EQ(exp_occ, index.locate(pattern));
+        }
+    }
+}
+
+TEST(grammar_index, naive) {
+    std::string str = "abracadabraabracadabrabracadabracadabraxxabrabracadabra";
+    text_t text(str.size());
+    for (size_t i = 0; i < str.size(); ++i) {
+        text[i] = static_cast<var_t>(str[i]);
+    }
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 4);
+
+    index::grammar_index<var_t> index{rlslp, 4};
+    for (size_t i = 0; i < str.size(); ++i) {
+        for (size_t m = 1; i + m <= str.size(); ++m) {
+            auto pattern = str.substr(i, m);
+            auto exp_occ = pattern_matching::find_occurrences_naive(str, pattern);
+            ASSERT_EQ(exp_occ.size(), index.count(pattern));
+            ASSERT_EQ(exp_occ, index.locate(pattern));
+        }
+    }
+    ASSERT_EQ(0, index.count("abray"));
+    ASSERT_EQ(0, index.count(str + "a"));
+}
+
+TEST(grammar_index, coder) {
+    std::string str = "abracadabraabracadabrabracadabracadabraxxabrabracadabraaaaaaaaaaaaaaaaa";
+    text_t text(str.size());
+    for (size_t i = 0; i < str.size(); ++i) {
+        text[i] = static_cast<var_t>(str[i]);
+    }
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 4);
+
+    index::grammar_index<var_t> index{rlslp, 4};
+
+    std::string file_name = "grammar_index";
+    coder::GrammarIndexCoder::Encoder enc{file_name};
+    enc.encode<var_t>(index);
+
+    coder::GrammarIndexCoder::Decoder dec{file_name};
+    std::unique_ptr<index::grammar_index<var_t>> in_index = dec.decode<var_t>();
+
+    ASSERT_EQ(index.get_rlslp(), in_index->get_rlslp());
+    ASSERT_EQ(index.get_rows(), in_index->get_rows());
+    ASSERT_EQ(index.get_columns(), in_index->get_columns());
+    for (size_t i = 0; i < str.size(); i += 3) {
+        for (size_t m = 1; i + m <= str.size(); m += 2) {
+            auto pattern = str.substr(i, m);
+            ASSERT_EQ(index.count(pattern), in_index->count(pattern));
+            ASSERT_EQ(index.locate(pattern), in_index->locate(pattern));
+        }
+    }
+
+    file_name += coder::GrammarIndexCoder::k_extension;
+    remove(file_name.c_str());
+}
+
+TEST(grammar_index, coder_empty) {
+    text_t text = util::create_ui_vector(std::vector<var_t>{});
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 4);
+
+    index::grammar_index<var_t> index{rlslp};
+
+    std::string file_name = "grammar_index_empty";
+    coder::GrammarIndexCoder::Encoder enc{file_name};
+    enc.encode<var_t>(index);
+
+    coder::GrammarIndexCoder::Decoder dec{file_name};
+    auto in_index = dec.decode<var_t>();
+
+    ASSERT_TRUE(in_index->get_rlslp().empty());
+    ASSERT_EQ(0, in_index->count("ab"));
+
+    file_name += coder::GrammarIndexCoder::k_extension;
+    remove(file_name.c_str());
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "recompression.hpp"
+#include "test_util.hpp"
+
+using namespace recomp;
+using recomp::test::check_rlslp;
+using recomp::test::compress;
+
+namespace {
+
+/**
+ * Builds the left-deep comb (((s_0 s_1) s_2) ...) of the string, i.e. every pair is used exactly once.
+ */
+void left_comb(const std::string& str, rlslp<var_t>& slp) {
+    slp.terminals = CHAR_ALPHABET;
+    slp.is_empty = false;
+    slp.resize(str.size() - 1);
+    var_t prev = static_cast<unsigned char>(str[0]);
+    for (size_t i = 1; i < str.size(); ++i) {
+        slp[i - 1] = non_terminal<var_t>(prev, static_cast<unsigned char>(str[i]), i + 1);
+        prev = CHAR_ALPHABET + i - 1;
+    }
+    slp.blocks = slp.size();
+    slp.root = prev;
+}
+
+}  // namespace
+
+TEST(grammar_optimizer, merge_and_prune) {
+    // ab is defined twice, (ab)^3 is defined twice and 259 and 260 are unreachable
+    rlslp<var_t> slp;
+    slp.terminals = CHAR_ALPHABET;
+    slp.is_empty = false;
+    slp.resize(7);
+    slp[0] = non_terminal<var_t>('a', 'b', 2);
+    slp[1] = non_terminal<var_t>('a', 'b', 2);
+    slp[2] = non_terminal<var_t>(261, 262, 12);
+    slp[3] = non_terminal<var_t>(256, 'c', 3);
+    slp[4] = non_terminal<var_t>(258, 259, 15);
+    slp[5] = non_terminal<var_t>(256, 3, 6);
+    slp[6] = non_terminal<var_t>(257, 3, 6);
+    slp.blocks = 5;
+    slp.root = 258;
+    const std::string str = "abababababab";
+    check_rlslp(slp, str);
+    const size_t size = slp.size();
+
+    optimizer_config config;
+    config.inline_rules = false;
+    optimize_rlslp(slp, config, 2);
+    ASSERT_LT(slp.size(), size);
+    ASSERT_EQ(3U, slp.size());
+    ASSERT_EQ(2U, slp.blocks);
+    check_rlslp(slp, str);
+
+    slp.resize(0);
+    slp.root = 'a';
+    optimize_rlslp(slp, config, 2);
+    ASSERT_EQ('a', slp.root);
+}
+
+TEST(grammar_optimizer, inline_shrinks) {
+    // abcd is derived twice with different structures, (a, (b, c)), d and (a, b), (c, d), that only become equivalent
+    // after inlining the pairs used once into the root and rebuilding it as ((ab)(cd))((ab)(cd))
+    auto build = [](rlslp<var_t>& slp) {
+        slp.terminals = CHAR_ALPHABET;
+        slp.is_empty = false;
+        slp.resize(7);
+        slp[0] = non_terminal<var_t>('b', 'c', 2);
+        slp[1] = non_terminal<var_t>('a', 256, 3);
+        slp[2] = non_terminal<var_t>(257, 'd', 4);
+        slp[3] = non_terminal<var_t>('a', 'b', 2);
+        slp[4] = non_terminal<var_t>('c', 'd', 2);
+        slp[5] = non_terminal<var_t>(259, 260, 4);
+        slp[6] = non_terminal<var_t>(258, 261, 8);
+        slp.blocks = 7;
+        slp.root = 262;
+    };
+    const std::string str = "abcdabcd";
+    rlslp<var_t> slp;
+    build(slp);
+    check_rlslp(slp, str);
+
+    rlslp<var_t> merged;
+    build(merged);
+    optimizer_config config;
+    config.inline_rules = false;
+    optimize_rlslp(merged, config, 2);
+    ASSERT_EQ(7U, merged.size());
+
+    optimize_rlslp(slp, optimizer_config(), 2);
+    ASSERT_LT(slp.size(), merged.size());
+    ASSERT_EQ(4U, slp.size());
+    check_rlslp(slp, str);
+}
+
+TEST(grammar_optimizer, repair_shrinks) {
+    // the pair ab occurs four times in the text but never as a rule of the balanced right-hand side of the root
+    const std::string str = "abxabyabzabw";
+    rlslp<var_t> slp;
+    left_comb(str, slp);
+    const size_t size = slp.size();
+
+    rlslp<var_t> inlined;
+    left_comb(str, inlined);
+    optimize_rlslp(inlined, optimizer_config(), 2);
+    ASSERT_EQ(size, inlined.size());
+
+    optimizer_config config;
+    config.repair_rounds = 1;
+    optimize_rlslp(slp, config, 2);
+    ASSERT_LT(slp.size(), inlined.size());
+    ASSERT_EQ(8U, slp.size());
+    check_rlslp(slp, str);
+}
+
+TEST(grammar_optimizer, inline_rules) {
+    std::string str;
+    for (size_t i = 0; i < 3000; ++i) {
+        str += static_cast<char>('a' + (i * i + i / 7) % 11);
+    }
+    rlslp<var_t> slp;
+    compress(str, slp);
+    const size_t size = slp.size();
+
+    optimize_rlslp(slp, optimizer_config(), 3);
+    ASSERT_GE(size, slp.size());
+    check_rlslp(slp, str);
+    ASSERT_EQ(str.substr(100, 500), slp.extract(100, 500));
+}
+
+TEST(grammar_optimizer, repair) {
+    for (const auto& spec : {"fibonacci", "random:4", "repeats:300:0.01", "repeats:50:0.05:2"}) {
+        std::string str;
+        generator::generate(spec, str, 20000, 3, 2);
+        rlslp<var_t> slp;
+        compress(str, slp);
+        const size_t size = slp.size();
+
+        rlslp<var_t> sequential;
+        compress(str, sequential);
+
+        optimizer_config config;
+        config.repair_rounds = 8;
+        optimize_rlslp(slp, config, 4);
+        optimize_rlslp(sequential, config, 1);
+        ASSERT_GE(size, slp.size()) << spec;
+        ASSERT_TRUE(slp == sequential) << spec;
+        check_rlslp(slp, str);
+        ASSERT_EQ(str, slp.derive_text()) << spec;
+    }
+}
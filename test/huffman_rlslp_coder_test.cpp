@@ -0,0 +1,332 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include "recompression/defs.hpp"
+#include "recompression/rlslp.hpp"
+#include "recompression/parallel_recompression.hpp"
+#include "recompression/coders/huffman_code.hpp"
+#include "recompression/coders/huffman_rlslp_coder.hpp"
+#include "recompression/io/bitistream.hpp"
+#include "recompression/io/bitostream.hpp"
+#include "recompression/util.hpp"
+
+using namespace recomp;
+
+typedef recompression<var_t>::text_t text_t;
+
+TEST(huffman_rlslp_coder, empty) {
+    recomp::rlslp<var_t> rlslp;
+    text_t text = util::create_ui_vector(std::vector<var_t>{});
+    parallel::parallel_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, CHAR_ALPHABET, 4);
+
+    std::cout << "recomp finished" << std::endl;
+
+    std::string file_name = "empty";
+    coder::HuffmanRLSLPCoder::Encoder enc = {file_name};
+    enc.encode<var_t>(rlslp);
+
+    coder::HuffmanRLSLPCoder::Decoder dec = {file_name};
+    recomp::rlslp<var_t> in_rlslp = dec.decode();
+
+    ASSERT_EQ(rlslp, in_rlslp);
+    ASSERT_EQ(rlslp.derive_text(), in_rlslp.derive_text());
+
+    file_name += coder::HuffmanRLSLPCoder::k_extension;
+    remove(file_name.c_str());
+}
+
+TEST(huffman_rlslp_coder, terminal) {
+    recomp::rlslp<var_t> rlslp;
+    text_t text = util::create_ui_vector(std::vector<var_t>{112});
+    parallel::parallel_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, CHAR_ALPHABET, 4);
+
+    std::string file_name = "terminal";
+    coder::HuffmanRLSLPCoder::Encoder enc = {file_name};
+    enc.encode<var_t>(rlslp);
+
+    coder::HuffmanRLSLPCoder::Decoder dec = {file_name};
+    recomp::rlslp<var_t> in_rlslp = dec.decode();
+
+    ASSERT_EQ(rlslp, in_rlslp);
+    ASSERT_EQ(rlslp.derive_text(), in_rlslp.derive_text());
+
+    file_name += coder::HuffmanRLSLPCoder::k_extension;
+    remove(file_name.c_str());
+}
+
+TEST(huffman_rlslp_coder, short_block) {
+    recomp::rlslp<var_t> rlslp;
+    text_t text = util::create_ui_vector(std::vector<var_t>{112, 112});
+    parallel::parallel_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, 113, 4);
+
+    std::string file_name = "short_block";
+    coder::HuffmanRLSLPCoder::Encoder enc = {file_name};
+    enc.encode<var_t>(rlslp);
+
+    coder::HuffmanRLSLPCoder::Decoder dec = {file_name};
+    recomp::rlslp<var_t> in_rlslp = dec.decode();
+
+    ASSERT_EQ(rlslp, in_rlslp);
+    ASSERT_EQ(rlslp.derive_text(), in_rlslp.derive_text());
+
+    file_name += coder::HuffmanRLSLPCoder::k_extension;
+    remove(file_name.c_str());
+}
+
+TEST(huffman_rlslp_coder, short_block3) {
+    recomp::rlslp<var_t> rlslp;
+    text_t text = util::create_ui_vector(std::vector<var_t>{112, 112, 112});
+    parallel::parallel_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, 113, 4);
+
+    std::string file_name = "short_block3";
+    coder::HuffmanRLSLPCoder::Encoder enc = {file_name};
+    enc.encode<var_t>(rlslp);
+
+    coder::HuffmanRLSLPCoder::Decoder dec = {file_name};
+    recomp::rlslp<var_t> in_rlslp = dec.decode();
+
+    ASSERT_EQ(rlslp, in_rlslp);
+    ASSERT_EQ(rlslp.derive_text(), in_rlslp.derive_text());
+
+    file_name += coder::HuffmanRLSLPCoder::k_extension;
+    remove(file_name.c_str());
+}
+
+TEST(huffman_rlslp_coder, recompression) {
+    recomp::rlslp<var_t> rlslp;
+    text_t text = util::create_ui_vector(std::vector<var_t>{2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 2, 1});
+    parallel::parallel_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    std::string file_name = "recompression";
+    coder::HuffmanRLSLPCoder::Encoder enc = {file_name};
+    enc.encode<var_t>(rlslp);
+
+    coder::HuffmanRLSLPCoder::Decoder dec = {file_name};
+    recomp::rlslp<var_t> in_rlslp = dec.decode();
+
+    ASSERT_EQ(rlslp, in_rlslp);
+    ASSERT_EQ(rlslp.derive_text(), in_rlslp.derive_text());
+
+    file_name += coder::HuffmanRLSLPCoder::k_extension;
+    remove(file_name.c_str());
+}
+
+TEST(huffman_rlslp_coder, one_block) {
+    recomp::rlslp<var_t> rlslp;
+    text_t text = util::create_ui_vector(std::vector<var_t>{2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2});
+    parallel::parallel_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, 3, 4);
+
+    std::string file_name = "one_block";
+    coder::HuffmanRLSLPCoder::Encoder enc = {file_name};
+    enc.encode<var_t>(rlslp);
+
+    coder::HuffmanRLSLPCoder::Decoder dec = {file_name};
+    recomp::rlslp<var_t> in_rlslp = dec.decode();
+
+    ASSERT_EQ(rlslp, in_rlslp);
+    ASSERT_EQ(rlslp.derive_text(), in_rlslp.derive_text());
+
+    file_name += coder::HuffmanRLSLPCoder::k_extension;
+    remove(file_name.c_str());
+}
+
+TEST(huffman_rlslp_coder, two_blocks) {
+    recomp::rlslp<var_t> rlslp;
+    text_t text = util::create_ui_vector(std::vector<var_t>{2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1});
+    parallel::parallel_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, 3, 4);
+
+    std::string file_name = "two_blocks";
+    coder::HuffmanRLSLPCoder::Encoder enc = {file_name};
+    enc.encode<var_t>(rlslp);
+
+    coder::HuffmanRLSLPCoder::Decoder dec = {file_name};
+    recomp::rlslp<var_t> in_rlslp = dec.decode();
+
+    ASSERT_EQ(rlslp, in_rlslp);
+    ASSERT_EQ(rlslp.derive_text(), in_rlslp.derive_text());
+
+    file_name += coder::HuffmanRLSLPCoder::k_extension;
+    remove(file_name.c_str());
+}
+
+TEST(huffman_rlslp_coder, three_blocks) {
+    recomp::rlslp<var_t> rlslp;
+    text_t text = util::create_ui_vector(std::vector<var_t>{2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2});
+    parallel::parallel_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, 3, 4);
+
+    std::string file_name = "three_blocks";
+    coder::HuffmanRLSLPCoder::Encoder enc = {file_name};
+    enc.encode<var_t>(rlslp);
+
+    coder::HuffmanRLSLPCoder::Decoder dec = {file_name};
+    recomp::rlslp<var_t> in_rlslp = dec.decode();
+
+    ASSERT_EQ(rlslp, in_rlslp);
+    ASSERT_EQ(rlslp.derive_text(), in_rlslp.derive_text());
+
+    file_name += coder::HuffmanRLSLPCoder::k_extension;
+    remove(file_name.c_str());
+}
+
+TEST(huffman_rlslp_coder, four_blocks) {
+    recomp::rlslp<var_t> rlslp;
+    text_t text = util::create_ui_vector(std::vector<var_t>{2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0});
+    parallel::parallel_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, 3, 4);
+
+    std::string file_name = "four_blocks";
+    coder::HuffmanRLSLPCoder::Encoder enc = {file_name};
+    enc.encode<var_t>(rlslp);
+
+    coder::HuffmanRLSLPCoder::Decoder dec = {file_name};
+    recomp::rlslp<var_t> in_rlslp = dec.decode();
+
+    ASSERT_EQ(rlslp, in_rlslp);
+    ASSERT_EQ(rlslp.derive_text(), in_rlslp.derive_text());
+
+    file_name += coder::HuffmanRLSLPCoder::k_extension;
+    remove(file_name.c_str());
+}
+
+TEST(huffman_rlslp_coder, repeated_pair) {
+    recomp::rlslp<var_t> rlslp;
+    text_t text = util::create_ui_vector(std::vector<var_t>{2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1});
+    parallel::parallel_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, 3, 4);
+
+    std::string file_name = "repeated_pair";
+    coder::HuffmanRLSLPCoder::Encoder enc = {file_name};
+    enc.encode<var_t>(rlslp);
+
+    coder::HuffmanRLSLPCoder::Decoder dec = {file_name};
+    recomp::rlslp<var_t> in_rlslp = dec.decode();
+
+    ASSERT_EQ(rlslp, in_rlslp);
+    ASSERT_EQ(rlslp.derive_text(), in_rlslp.derive_text());
+
+    file_name += coder::HuffmanRLSLPCoder::k_extension;
+    remove(file_name.c_str());
+}
+
+TEST(huffman_rlslp_coder, repeated_pair_same_occ) {
+    recomp::rlslp<var_t> rlslp;
+    text_t text = util::create_ui_vector(std::vector<var_t>{2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2});
+    parallel::parallel_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, 3, 4);
+
+    std::string file_name = "repeated_pair_same";
+    coder::HuffmanRLSLPCoder::Encoder enc = {file_name};
+    enc.encode<var_t>(rlslp);
+
+    coder::HuffmanRLSLPCoder::Decoder dec = {file_name};
+    recomp::rlslp<var_t> in_rlslp = dec.decode();
+
+    ASSERT_EQ(rlslp, in_rlslp);
+    ASSERT_EQ(rlslp.derive_text(), in_rlslp.derive_text());
+
+    file_name += coder::HuffmanRLSLPCoder::k_extension;
+    remove(file_name.c_str());
+}
+
+TEST(huffman_rlslp_coder, left_end) {
+    recomp::rlslp<var_t> rlslp;
+    text_t text = util::create_ui_vector(std::vector<var_t>{1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 3, 1, 2, 1, 2, 1, 2, 1, 2, 1, 3, 1});
+    parallel::parallel_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, 4, 4);
+
+    std::string file_name = "left_end";
+    coder::HuffmanRLSLPCoder::Encoder enc = {file_name};
+    enc.encode<var_t>(rlslp);
+
+    coder::HuffmanRLSLPCoder::Decoder dec = {file_name};
+    recomp::rlslp<var_t> in_rlslp = dec.decode();
+
+    ASSERT_EQ(rlslp, in_rlslp);
+    ASSERT_EQ(rlslp.derive_text(), in_rlslp.derive_text());
+
+    file_name += coder::HuffmanRLSLPCoder::k_extension;
+    remove(file_name.c_str());
+}
+
+TEST(huffman_rlslp_coder, text) {
+    std::vector<var_t> values;
+    for (size_t i = 0; i < 20000; ++i) {
+        values.push_back(static_cast<var_t>(97 + (i * i + i / 7) % 13));
+        if (i % 97 == 0) {
+            for (size_t j = 0; j < i % 11; ++j) {
+                values.push_back(98);
+            }
+        }
+    }
+    recomp::rlslp<var_t> rlslp;
+    text_t text = util::create_ui_vector(values);
+    parallel::parallel_recompression<var_t> recomp;
+    recomp.recomp(text, rlslp, CHAR_ALPHABET, 4);
+
+    std::string file_name = "text";
+    coder::HuffmanRLSLPCoder::Encoder enc = {file_name};
+    enc.encode<var_t>(rlslp);
+
+    coder::HuffmanRLSLPCoder::Decoder dec = {file_name};
+    recomp::rlslp<var_t> in_rlslp = dec.decode();
+
+    ASSERT_EQ(rlslp, in_rlslp);
+    ASSERT_EQ(rlslp.derive_text(), in_rlslp.derive_text());
+
+    file_name += coder::HuffmanRLSLPCoder::k_extension;
+    remove(file_name.c_str());
+}
+
+TEST(huffman_code, integers) {
+    std::vector<std::uint64_t> values = {0, 1, 1, 1, 15, 16, 17, 31, 32, 1000, 1, 1, 0, 123456789, 2, 2,
+                                         std::uint64_t(1) << 40, ~std::uint64_t(0), 3, 1};
+    for (size_t i = 0; i < 1000; ++i) {
+        values.push_back((i * 7919) % (i + 3));
+    }
+    coder::huffman_integer_code code{coder::huffman_integer_code::frequencies(values)};
+    coder::bit_buffer buffer;
+    for (const auto& value : values) {
+        code.encode(buffer, value);
+    }
+    ASSERT_EQ(code.cost(coder::huffman_integer_code::frequencies(values)), buffer.size);
+
+    code.code.build_table();
+    size_t pos = 0;
+    for (const auto& value : values) {
+        ASSERT_EQ(value, code.decode(buffer, pos));
+    }
+    ASSERT_EQ(buffer.size, pos);
+}
+
+TEST(huffman_code, max_length) {
+    std::vector<size_t> freqs;
+    size_t freq = 1;
+    for (size_t i = 0; i < 40; ++i) {
+        freqs.push_back(freq);
+        freq = std::min(freq * 2, static_cast<size_t>(1) << 50);
+    }
+    coder::huffman_code code{freqs};
+    for (size_t i = 0; i < freqs.size(); ++i) {
+        ASSERT_GT(code.lengths[i], 0);
+        ASSERT_LE(code.lengths[i], static_cast<size_t>(coder::huffman_code::MAX_LENGTH));
+    }
+
+    code.build_table();
+    coder::bit_buffer buffer;
+    for (size_t i = 0; i < freqs.size(); ++i) {
+        code.encode(buffer, i);
+    }
+    size_t pos = 0;
+    for (size_t i = 0; i < freqs.size(); ++i) {
+        ASSERT_EQ(i, code.decode(buffer, pos));
+    }
+}
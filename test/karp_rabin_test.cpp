@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "recompression/defs.hpp"
+#include "recompression/karp_rabin.hpp"
+#include "recompression/lce_query.hpp"
+#include "recompression/rlslp.hpp"
+#include "recompression/parallel_recompression.hpp"
+#include "recompression/util.hpp"
+
+using namespace recomp;
+
+typedef recompression<var_t>::text_t text_t;
+typedef karp_rabin<var_t>::fp_t fp_t;
+
+fp_t fingerprint_naive(const std::vector<var_t>& text, size_t i, size_t len, fp_t base) {
+    fp_t fp = 0;
+    for (size_t k = i; k < i + len; ++k) {
+        fp = karp_rabin<var_t>::add(karp_rabin<var_t>::mul(fp, base), text[k]);
+    }
+    return fp;
+}
+
+TEST(karp_rabin, empty) {
+    text_t text = util::create_ui_vector(std::vector<var_t>{});
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    karp_rabin<var_t> kr{rlslp, 4};
+    ASSERT_EQ(0, kr.fingerprint(0, 10));
+    ASSERT_EQ(0, lce_query::lce_query_fingerprint(kr, 0, 10));
+}
+
+TEST(karp_rabin, geometric) {
+    fp_t power;
+    fp_t sum;
+    karp_rabin<var_t>::geometric(7, 0, power, sum);
+    ASSERT_EQ(1, power);
+    ASSERT_EQ(0, sum);
+    karp_rabin<var_t>::geometric(7, 5, power, sum);
+    ASSERT_EQ(16807, power);
+    ASSERT_EQ(1 + 7 + 49 + 343 + 2401, sum);
+    karp_rabin<var_t>::geometric(karp_rabin<var_t>::k_default_base, 1000, power, sum);
+    ASSERT_EQ(karp_rabin<var_t>::pow(karp_rabin<var_t>::k_default_base, 1000), power);
+}
+
+TEST(karp_rabin, fingerprint) {
+    std::vector<var_t> vec = {2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 2, 1};
+    text_t text = util::create_ui_vector(vec);
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    karp_rabin<var_t> kr{rlslp, 4};
+    ASSERT_EQ(fingerprint_naive(vec, 0, vec.size(), karp_rabin<var_t>::k_default_base), kr.fingerprint(rlslp.root));
+    for (size_t i = 0; i < vec.size(); ++i) {
+        for (size_t len = 1; i + len <= vec.size(); ++len) {
+            ASSERT_EQ(fingerprint_naive(vec, i, len, karp_rabin<var_t>::k_default_base), kr.fingerprint(i, len));
+        }
+    }
+    ASSERT_EQ(kr.fingerprint(30, 2), kr.fingerprint(30, 10));
+}
+
+TEST(karp_rabin, equal) {
+    std::vector<var_t> vec = {2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 2, 1};
+    text_t text = util::create_ui_vector(vec);
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    karp_rabin<var_t> kr{rlslp, 1, 1000003};
+    ASSERT_TRUE(kr.equal(6, 14, 4));
+    ASSERT_FALSE(kr.equal(6, 14, 5));
+    ASSERT_TRUE(kr.equal(6, 19, 11));
+    ASSERT_FALSE(kr.equal(6, 19, 12));
+    ASSERT_FALSE(kr.equal(30, 0, 3));
+}
+
+TEST(karp_rabin, lce_query) {
+    std::vector<var_t> vec = {2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 2, 1};
+    text_t text = util::create_ui_vector(vec);
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    karp_rabin<var_t> kr{rlslp, 4};
+    ASSERT_EQ(4, lce_query::lce_query_fingerprint(kr, 6, 14));
+    ASSERT_EQ(11, lce_query::lce_query_fingerprint(kr, 6, 19));
+    ASSERT_EQ(0, lce_query::lce_query_fingerprint(kr, 1, 0));
+    ASSERT_EQ(0, lce_query::lce_query_fingerprint(kr, 32, 5));
+    ASSERT_EQ(27, lce_query::lce_query_fingerprint(kr, 5, 5));
+    for (size_t i = 0; i < vec.size(); ++i) {
+        for (size_t j = 0; j < vec.size(); ++j) {
+            ASSERT_EQ(lce_query::lce_query_naive(vec, i, j), lce_query::lce_query_fingerprint(kr, i, j));
+        }
+    }
+}
+
+TEST(karp_rabin, runs) {
+    std::vector<var_t> vec(1000, 3);
+    vec[500] = 2;
+    text_t text = util::create_ui_vector(vec);
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    karp_rabin<var_t> kr{rlslp, 4};
+    for (size_t i = 0; i < vec.size(); i += 37) {
+        for (size_t j = 0; j < vec.size(); j += 41) {
+            ASSERT_EQ(lce_query::lce_query_naive(vec, i, j), lce_query::lce_query_fingerprint(kr, i, j));
+        }
+    }
+}
@@ -211,3 +211,61 @@ TEST(lcequery, block) {
         }
     }
 }
+
+TEST(lcequery_iterative, empty) {
+    text_t text = util::create_ui_vector(std::vector<var_t>{});
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    lce_query::lce_engine<var_t> engine{rlslp};
+    ASSERT_EQ(0, lce_query::lce_query_iterative(engine, 0, 10));
+}
+
+TEST(lcequery_iterative, lcequery) {
+    text_t text = util::create_ui_vector(std::vector<var_t>{2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 2, 1});
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    lce_query::lce_engine<var_t> engine{rlslp};
+    ASSERT_EQ(0, engine.query(1, 0));
+    ASSERT_EQ(0, engine.query(32, 5));
+    ASSERT_EQ(0, engine.query(5, 32));
+    ASSERT_EQ(4, engine.query(6, 14));
+    ASSERT_EQ(4, engine.query(14, 6));
+    ASSERT_EQ(11, engine.query(6, 19));
+    ASSERT_EQ(27, engine.query(5, 5));
+}
+
+TEST(lcequery_iterative, complete) {
+    text_t text = util::create_ui_vector(std::vector<var_t>{2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 2, 1});
+    text_t text_naive = util::create_ui_vector(std::vector<var_t>{2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 2, 1});
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    lce_query::lce_engine<var_t> engine{rlslp};
+    for (size_t i = 0; i < text_naive.size(); ++i) {
+        for (size_t j = 0; j < text_naive.size(); ++j) {
+            ASSERT_EQ(lce_query_naive(i, j, text_naive), engine.query(i, j));
+        }
+    }
+}
+
+TEST(lcequery_iterative, block) {
+    std::vector<var_t> vec(200, 2);
+    vec[97] = 1;
+    text_t text = util::create_ui_vector(vec);
+    text_t text_naive = util::create_ui_vector(vec);
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 3, 4);
+
+    lce_query::lce_engine<var_t> engine{rlslp};
+    for (size_t i = 0; i < text_naive.size(); ++i) {
+        for (size_t j = 0; j < text_naive.size(); ++j) {
+            ASSERT_EQ(lce_query_naive(i, j, text_naive), engine.query(i, j));
+        }
+    }
+}
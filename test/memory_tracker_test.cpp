@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "recompression.hpp"
+
+using namespace recomp;
+
+typedef allocator_vector<std::uint64_t, tracking_allocator<std::uint64_t>> tracked_vector;
+
+TEST(memory_tracker, tracking_allocator) {
+    const size_t base = memory_tracker::current();
+    {
+        tracked_vector vec(100);
+        ASSERT_EQ(base + 100 * sizeof(std::uint64_t), memory_tracker::current());
+        vec.resize(10);
+        ASSERT_EQ(base + 10 * sizeof(std::uint64_t), memory_tracker::current());
+    }
+    ASSERT_EQ(base, memory_tracker::current());
+}
+
+TEST(memory_tracker, peak_reset) {
+    const size_t base = memory_tracker::current();
+    memory_tracker::reset();
+    ASSERT_EQ(base, memory_tracker::peak());
+    {
+        tracked_vector vec(1000);
+    }
+    ASSERT_EQ(base, memory_tracker::current());
+    ASSERT_EQ(base + 1000 * sizeof(std::uint64_t), memory_tracker::peak());
+    memory_tracker::reset();
+    ASSERT_EQ(base, memory_tracker::peak());
+    ASSERT_TRUE(memory_tracker::phases().empty());
+}
+
+TEST(memory_tracker, set_current) {
+    const size_t base = memory_tracker::current();
+    memory_tracker::reset();
+    memory_tracker::set_current(base + 4096);
+    ASSERT_EQ(base + 4096, memory_tracker::current());
+    ASSERT_EQ(base + 4096, memory_tracker::peak());
+    memory_tracker::set_current(base);
+    ASSERT_EQ(base, memory_tracker::current());
+    ASSERT_EQ(base + 4096, memory_tracker::peak());
+}
+
+TEST(memory_tracker, nested_phases) {
+    const size_t base = memory_tracker::current();
+    memory_tracker::reset();
+    {
+        tracked_vector before(2000);
+    }
+    {
+        memory_phase outer("outer");
+        ASSERT_EQ(base, outer.peak());
+        tracked_vector vec(100);
+        {
+            memory_phase inner("inner");
+            ASSERT_EQ(base + 100 * sizeof(std::uint64_t), inner.peak());
+            {
+                tracked_vector tmp(50);
+            }
+            inner.end();
+            ASSERT_EQ(base + 150 * sizeof(std::uint64_t), inner.peak());
+            tracked_vector after(10);
+            ASSERT_EQ(base + 150 * sizeof(std::uint64_t), inner.peak());
+        }
+        ASSERT_EQ(base + 150 * sizeof(std::uint64_t), outer.peak());
+        memory_phase inner("inner");
+        inner.end();
+        ASSERT_EQ(base + 100 * sizeof(std::uint64_t), inner.peak());
+    }
+    ASSERT_EQ(base + 2000 * sizeof(std::uint64_t), memory_tracker::peak());
+
+    auto phases = memory_tracker::phases();
+    ASSERT_EQ(2U, phases.size());
+    ASSERT_EQ(1U, phases["outer"].calls);
+    ASSERT_EQ(base, phases["outer"].current);
+    ASSERT_EQ(base + 150 * sizeof(std::uint64_t), phases["outer"].peak);
+    ASSERT_EQ(2U, phases["inner"].calls);
+    ASSERT_EQ(base + 100 * sizeof(std::uint64_t), phases["inner"].current);
+    ASSERT_EQ(base + 150 * sizeof(std::uint64_t), phases["inner"].peak);
+}
+
+TEST(memory_tracker, print) {
+    memory_tracker::reset();
+    {
+        memory_phase phase("phase");
+    }
+    std::stringstream out;
+    memory_tracker::print(out, "algo", "data");
+    const std::string str = out.str();
+    ASSERT_NE(std::string::npos, str.find("RESULT algo=algo_memory dataset=data phase=phase calls=1 current="));
+    ASSERT_NE(std::string::npos, str.find("RESULT algo=algo_memory dataset=data phase=total current="));
+
+    memory_phase phase("phase");
+    std::stringstream fields;
+    fields << phase;
+    ASSERT_EQ(0U, fields.str().find(" phase_mem="));
+    ASSERT_NE(std::string::npos, fields.str().find(" phase_mem_peak="));
+}
+
+TEST(allocator_vector, resize_move_swap) {
+    tracked_vector vec(5);
+    for (size_t i = 0; i < vec.size(); ++i) {
+        vec[i] = i;
+    }
+    vec.resize(8);
+    ASSERT_EQ(8U, vec.size());
+    for (size_t i = 0; i < 5; ++i) {
+        ASSERT_EQ(i, vec[i]);
+    }
+    vec.resize(3);
+    ASSERT_EQ(3U, vec.size());
+    ASSERT_EQ(2U, vec[2]);
+
+    tracked_vector moved(std::move(vec));
+    ASSERT_EQ(0U, vec.size());
+    ASSERT_TRUE(vec.empty());
+    ASSERT_EQ(3U, moved.size());
+    ASSERT_EQ(1U, moved[1]);
+
+    tracked_vector other(2);
+    other.fill(7);
+    std::swap(moved, other);
+    ASSERT_EQ(2U, moved.size());
+    ASSERT_EQ(7U, moved[0]);
+    ASSERT_EQ(7U, moved[1]);
+    ASSERT_EQ(3U, other.size());
+
+    vec = std::move(other);
+    ASSERT_EQ(3U, vec.size());
+    ASSERT_EQ(0U, other.size());
+    ASSERT_EQ(2U, vec[2]);
+
+    tracked_vector empty;
+    empty.resize(0);
+    ASSERT_TRUE(empty.empty());
+    ASSERT_EQ(empty.begin(), empty.end());
+}
+
+TEST(memory_tracker, recompression_phases) {
+    std::string str = "abababababbabababaabababaabaabababbbabababababaaaabababbaabababbaaababababbababab";
+    recompression<var_t>::text_t text(str.size());
+    for (size_t i = 0; i < str.size(); ++i) {
+        text[i] = static_cast<var_t>(str[i]);
+    }
+
+    memory_tracker::reset();
+    rlslp<var_t> slp;
+    parallel::parallel_recompression<var_t> recomp;
+    recomp.recomp(text, slp, CHAR_ALPHABET, 1);
+    ASSERT_EQ(str, slp.derive_text());
+
+    auto phases = memory_tracker::phases();
+    for (const auto& name : {"bcomp", "pcomp", "sort", "rules", "compact", "adj_list", "partition", "rename_rlslp"}) {
+        ASSERT_NE(phases.end(), phases.find(name)) << name;
+        ASSERT_LT(0U, phases[name].calls) << name;
+#ifdef RECOMPRESSION_TRACK_MEMORY
+        ASSERT_LT(0U, phases[name].peak) << name;
+#endif
+    }
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "recompression/defs.hpp"
+#include "recompression/fast_recompression.hpp"
+#include "recompression/packed_vector.hpp"
+#include "recompression/parallel_ls_recompression.hpp"
+#include "recompression/parallel_recompression.hpp"
+#include "recompression/rlslp.hpp"
+#include "recompression/text_generator.hpp"
+#include "recompression/util.hpp"
+
+using namespace recomp;
+
+TEST(packed_vector, empty) {
+    packed_vector<var_t> vec;
+    ASSERT_TRUE(vec.empty());
+    ASSERT_EQ(0, vec.size());
+    ASSERT_EQ(0, vec.bytes());
+
+    ui_vector<var_t> text;
+    vec.unpack(text, 4);
+    ASSERT_EQ(0, text.size());
+}
+
+TEST(packed_vector, width_for) {
+    ASSERT_EQ(1, packed_vector<var_t>::width_for(0));
+    ASSERT_EQ(1, packed_vector<var_t>::width_for(1));
+    ASSERT_EQ(8, packed_vector<var_t>::width_for(255));
+    ASSERT_EQ(9, packed_vector<var_t>::width_for(256));
+    ASSERT_EQ(40, packed_vector<std::uint64_t>::width_for((static_cast<size_t>(1) << 40) - 1));
+}
+
+TEST(packed_vector, get_set) {
+    for (uint8_t width = 1; width <= 64; ++width) {
+        const std::uint64_t mask = (width == 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << width) - 1;
+        packed_vector<std::uint64_t> vec{300, width};
+        ASSERT_EQ(width, vec.width());
+        ASSERT_EQ((300 * width + 63) / 64 * 8, vec.bytes());
+
+        std::vector<std::uint64_t> exp(300);
+        for (size_t i = 0; i < exp.size(); ++i) {
+            exp[i] = (i * 0x9E3779B97F4A7C15ULL) & mask;
+            vec.set(i, exp[i]);
+        }
+        vec.set(7, mask);
+        exp[7] = mask;
+        vec.set(8, 0);
+        exp[8] = 0;
+        for (size_t i = 0; i < exp.size(); ++i) {
+            ASSERT_EQ(exp[i], vec[i]) << "width " << static_cast<size_t>(width) << " index " << i;
+        }
+    }
+}
+
+TEST(packed_vector, pack_unpack) {
+    const size_t n = 10007;
+    for (uint8_t width : {3, 8, 17, 32, 40}) {
+        ui_vector<std::uint64_t> text(n);
+        for (size_t i = 0; i < n; ++i) {
+            text[i] = (i * 2654435761ULL) & ((std::uint64_t(1) << width) - 1);
+        }
+
+        packed_vector<std::uint64_t> vec;
+        vec.pack(text, width, 4);
+        ASSERT_EQ(n, vec.size());
+
+        ui_vector<std::uint64_t> unpacked;
+        vec.unpack(unpacked, 3);
+        ASSERT_EQ(text, unpacked);
+    }
+}
+
+TEST(packed_vector, recomp) {
+    std::vector<var_t> vec = {2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1};
+    ui_vector<var_t> text = util::create_ui_vector(vec);
+    packed_vector<var_t> packed;
+    packed.pack(text, packed_vector<var_t>::width_for(4), 4);
+    ASSERT_EQ(16, packed.bytes());
+
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> slp;
+    recomp.recomp(packed, slp, 5, 4);
+
+    ui_vector<var_t> exp_text = util::create_ui_vector(vec);
+    parallel::parallel_recompression<var_t> exp_recomp;
+    rlslp<var_t> exp_slp;
+    exp_recomp.recomp(exp_text, exp_slp, 5, 4);
+
+    ASSERT_EQ(exp_slp, slp);
+    ASSERT_EQ(1, packed.size());
+    ASSERT_EQ(packed_vector<var_t>::width_for(slp.size() + slp.terminals), packed.width());
+    ASSERT_EQ(slp.root, packed[0]);
+}
+
+TEST(packed_vector, recomp_generated) {
+    ui_vector<var_t> text;
+    generator::generate("repeats:300:0.01", text, 20000, 5, 2);
+    packed_vector<var_t> packed;
+    packed.pack(text, packed_vector<var_t>::width_for(CHAR_ALPHABET - 1), 4);
+
+    parallel::parallel_ls_recompression<var_t> recomp;
+    rlslp<var_t> slp;
+    recomp.recomp(packed, slp, CHAR_ALPHABET, 4);
+
+    parallel::parallel_ls_recompression<var_t> exp_recomp;
+    rlslp<var_t> exp_slp;
+    exp_recomp.recomp(text, exp_slp, CHAR_ALPHABET, 4);
+
+    ASSERT_EQ(exp_slp, slp);
+    ASSERT_EQ(1, packed.size());
+    ASSERT_EQ(packed_vector<var_t>::width_for(slp.size() + slp.terminals), packed.width());
+    ASSERT_EQ(slp.root, packed[0]);
+}
+
+TEST(packed_vector, recomp_sequential) {
+    std::vector<var_t> vec = {2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1};
+    ui_vector<var_t> text = util::create_ui_vector(vec);
+    packed_vector<var_t> packed;
+    packed.pack(text, packed_vector<var_t>::width_for(4), 1);
+
+    recompression_fast<var_t> recomp;
+    rlslp<var_t> slp;
+    recomp.recomp(packed, slp, 5, 1);
+
+    recompression_fast<var_t> exp_recomp;
+    rlslp<var_t> exp_slp;
+    exp_recomp.recomp(text, exp_slp, 5, 1);
+
+    ASSERT_EQ(exp_slp, slp);
+    ASSERT_EQ(1, packed.size());
+    ASSERT_EQ(slp.root, packed[0]);
+}
@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "recompression.hpp"
+
+using namespace recomp;
+
+TEST(parallel_loop, recompression) {
+    std::string str;
+    for (size_t i = 0; i < 3000; ++i) {
+        str += std::string(1 + (i * 7919) % 37, static_cast<char>('a' + i % 5));
+    }
+    for (const std::string variant : {"parallel", "parallel_lp", "parallel_rnd", "parallel_ls"}) {
+        std::vector<rlslp<var_t>> rlslps;
+        for (auto schedule : {STATIC, WORK_STEALING}) {
+            std::string dataset = "test";
+            auto recomp = create_recompression<var_t>(variant, dataset, "", "");
+            recomp->loop_schedule = schedule;
+            recompression<var_t>::text_t text(str.size());
+            for (size_t i = 0; i < str.size(); ++i) {
+                text[i] = static_cast<unsigned char>(str[i]);
+            }
+            rlslp<var_t> slp;
+            recomp->recomp(text, slp, CHAR_ALPHABET, 4);
+            ASSERT_EQ(str, slp.derive_text()) << variant;
+            rlslps.emplace_back(std::move(slp));
+        }
+        ASSERT_EQ(rlslps[0], rlslps[1]) << variant;
+    }
+}
+
+TEST(parallel_loop, part_scheduler) {
+    for (auto schedule : {STATIC, WORK_STEALING}) {
+        for (size_t cores : {1, 3, 4}) {
+            part_scheduler scheduler(cores, schedule);
+            ASSERT_EQ((schedule == WORK_STEALING && cores > 1) ? cores * part_scheduler::PARTS_PER_THREAD : cores,
+                      scheduler.parts(cores));
+            const size_t loops = 20;
+            std::vector<std::atomic<size_t>> visits(loops * 100);
+            for (auto& v : visits) {
+                v.store(0);
+            }
+#pragma omp parallel num_threads(cores)
+            {
+                for (size_t loop = 0; loop < loops; ++loop) {
+                    // skewed parts: the first part of every loop is much more expensive
+                    scheduler.for_each(loop + 1, [&](size_t part) {
+                        if (part == 0) {
+                            volatile size_t sum = 0;
+                            for (size_t i = 0; i < 100000; ++i) {
+                                sum = sum + i;
+                            }
+                        }
+                        visits[loop * 100 + part]++;
+                    });
+                }
+            }
+            for (size_t loop = 0; loop < loops; ++loop) {
+                for (size_t part = 0; part < 100; ++part) {
+                    ASSERT_EQ(part <= loop ? 1U : 0U, visits[loop * 100 + part].load()) << loop << " " << part;
+                }
+            }
+        }
+    }
+}
+
+TEST(parallel_loop, skewed_text) {
+    // one very long block and a few long runs, so the parts of the text contain most of the deleted symbols
+    std::string str(20000, 'a');
+    for (size_t i = 0; i < 2000; ++i) {
+        str += std::string(1 + (i * 31) % 7, static_cast<char>('b' + i % 3));
+        if (i % 500 == 0) {
+            str += std::string(3000, 'c');
+        }
+    }
+    for (const std::string variant : {"parallel", "parallel_rnd", "parallel_rnddir", "parallel_ls"}) {
+        std::vector<rlslp<var_t>> rlslps;
+        for (size_t cores : {1, 4}) {
+            for (auto schedule : {STATIC, WORK_STEALING}) {
+                std::string dataset = "test";
+                auto recomp = create_recompression<var_t>(variant, dataset, "", "");
+                recomp->loop_schedule = schedule;
+                recompression<var_t>::text_t text(str.size());
+                for (size_t i = 0; i < str.size(); ++i) {
+                    text[i] = static_cast<unsigned char>(str[i]);
+                }
+                rlslp<var_t> slp;
+                recomp->recomp(text, slp, CHAR_ALPHABET, cores);
+                ASSERT_EQ(str, slp.derive_text()) << variant;
+                rlslps.emplace_back(std::move(slp));
+            }
+        }
+        for (size_t i = 1; i < rlslps.size(); ++i) {
+            ASSERT_EQ(rlslps[0], rlslps[i]) << variant << " " << i;
+        }
+    }
+}
+
+TEST(parallel_loop, sync_timer) {
+    sync_timer sync;
+    std::vector<size_t> values(4, 0);
+    std::vector<size_t> sums(4, 0);
+    for (const bool active : {false, true}) {
+        sync.reset(active);
+        sync.begin();
+#pragma omp parallel num_threads(4)
+        {
+            sync.enter();
+            values[omp_get_thread_num()] = 1;
+            sync.barrier();
+            size_t sum = 0;
+            for (size_t i = 0; i < static_cast<size_t>(omp_get_num_threads()); ++i) {
+                sum += values[i];
+            }
+            sums[omp_get_thread_num()] = sum;
+            sync.barrier();
+            values[omp_get_thread_num()] = 0;
+            sync.leave();
+        }
+        sync.end();
+        ASSERT_EQ(active ? 1U : 0U, sync.regions);
+        ASSERT_EQ(active ? 2U : 0U, sync.barriers);
+        ASSERT_EQ(std::vector<size_t>(4, 4), sums);
+    }
+    sync.reset(false);
+    ASSERT_EQ(0U, sync.regions);
+    ASSERT_EQ(0U, sync.fork_ns + sync.barrier_ns + sync.join_ns);
+}
+
+TEST(parallel_loop, cores_guard) {
+    std::string dataset = "test";
+    auto recomp = create_recompression<var_t>("parallel_rnd", dataset, "", "");
+    try {
+        recompression<var_t>::cores_guard guard(*recomp, 4);
+        ASSERT_EQ(4U, recomp->cores);
+        recomp->cores = 1;
+        throw std::runtime_error("round failed");
+    } catch (const std::runtime_error&) {
+    }
+    ASSERT_EQ(4U, recomp->cores);
+}
+
+TEST(parallel_loop, round_cores) {
+    std::string dataset = "test";
+    auto recomp = create_recompression<var_t>("parallel_rnd", dataset, "", "");
+    ASSERT_EQ(8, recomp->round_cores(10, 8));
+    recomp->min_round_work = 100;
+    ASSERT_EQ(1, recomp->round_cores(0, 8));
+    ASSERT_EQ(1, recomp->round_cores(199, 8));
+    ASSERT_EQ(3, recomp->round_cores(350, 8));
+    ASSERT_EQ(8, recomp->round_cores(100000, 8));
+}
+
+TEST(parallel_loop, min_round_work) {
+    std::string str;
+    for (size_t i = 0; i < 3000; ++i) {
+        str += std::string(1 + (i * 7919) % 37, static_cast<char>('a' + i % 5));
+    }
+    for (const std::string variant : {"parallel", "parallel_rnd", "parallel_rnddir", "parallel_ls"}) {
+        std::vector<rlslp<var_t>> rlslps;
+        for (size_t min_round_work : {0, 1000, 100000}) {
+            std::string dataset = "test";
+            auto recomp = create_recompression<var_t>(variant, dataset, "", "");
+            recomp->min_round_work = min_round_work;
+            recompression<var_t>::text_t text(str.size());
+            for (size_t i = 0; i < str.size(); ++i) {
+                text[i] = static_cast<unsigned char>(str[i]);
+            }
+            rlslp<var_t> slp;
+            recomp->recomp(text, slp, CHAR_ALPHABET, 4);
+            ASSERT_EQ(str, slp.derive_text()) << variant;
+            ASSERT_EQ(4, recomp->cores) << variant;
+            rlslps.emplace_back(std::move(slp));
+        }
+        ASSERT_EQ(rlslps[0], rlslps[1]) << variant;
+        ASSERT_EQ(rlslps[0], rlslps[2]) << variant;
+    }
+}
+
+TEST(parallel_loop, region_sort) {
+    sync_timer sync;
+    sync.reset(false);
+    for (size_t cores : {1, 3, 4, 7}) {
+        for (size_t n : {0, 1, 5, 1000, 4099}) {
+            std::vector<size_t> values(n);
+            for (size_t i = 0; i < n; ++i) {
+                values[i] = (i * 7919) % 101;
+            }
+            std::vector<size_t> expected = values;
+            std::sort(expected.begin(), expected.end());
+            std::vector<size_t> buffer(n);
+#pragma omp parallel num_threads(cores)
+            {
+                region_sort(values.data(), buffer.data(), n, [](size_t a, size_t b) {
+                    return a < b;
+                }, sync);
+            }
+            ASSERT_EQ(expected, values) << cores << " " << n;
+        }
+    }
+}
+
+TEST(parallel_loop, single_region) {
+    std::string str(5000, 'a');
+    for (size_t i = 0; i < 3000; ++i) {
+        str += std::string(1 + (i * 7919) % 37, static_cast<char>('a' + i % 5));
+    }
+    for (const std::string variant : {"parallel", "parallel_lp", "parallel_rnd", "parallel_rnd3"}) {
+        std::vector<rlslp<var_t>> rlslps;
+        for (size_t cores : {4, 1, 3, 4}) {
+            std::string dataset = "test";
+            auto recomp = create_recompression<var_t>(variant, dataset, "", "");
+            recomp->single_region = rlslps.size() > 0;
+            recomp->min_round_work = 1000;
+            recompression<var_t>::text_t text(str.size());
+            for (size_t i = 0; i < str.size(); ++i) {
+                text[i] = static_cast<unsigned char>(str[i]);
+            }
+            rlslp<var_t> slp;
+            recomp->recomp(text, slp, CHAR_ALPHABET, cores);
+            ASSERT_EQ(str, slp.derive_text()) << variant;
+            ASSERT_EQ(cores, recomp->cores) << variant;
+            rlslps.emplace_back(std::move(slp));
+        }
+        for (size_t i = 1; i < rlslps.size(); ++i) {
+            ASSERT_EQ(rlslps[0], rlslps[i]) << variant << " " << i;
+        }
+    }
+}
@@ -3,6 +3,7 @@
 #define private public
 #define protected public
 
+#include "recompression.hpp"
 #include "recompression/parallel_ls_recompression.hpp"
 #include "recompression/util.hpp"
 
@@ -433,6 +434,28 @@ TEST(parallel_ls_adj_list, less_productions) {
     ASSERT_EQ(exp_adj_list, adj_list);
 }
 
+TEST(parallel_ls_gains, 212181623541741623541321) {
+    text_t text = util::create_ui_vector(std::vector<var_t>{2, 1, 2, 1, 8, 1, 6, 2, 3, 5, 4, 1, 7, 4, 1, 6, 2, 3, 5, 4, 1, 3, 2, 1});
+    adj_list_t adj_list(text.size() - 1);
+    partition_t partition = util::create_ui_vector(std::vector<bool>{0, 1, 0, 1, 1, 0, 0, 1, 1});
+    parallel::parallel_ls_recompression<var_t> recomp;
+    ui_vector<std::int64_t> gain;
+
+    for (size_t cores = 1; cores <= 5; ++cores) {
+        recomp.cores = cores;
+        recomp.compute_adj_list(text, adj_list);
+        recomp.compute_gains(text, adj_list, partition, gain);
+
+        std::vector<std::int64_t> exp_gain(partition.size(), 0);
+        for (size_t i = 0; i < text.size() - 1; ++i) {
+            std::int64_t val = (partition[text[i]] != partition[text[i + 1]]) ? 1 : -1;
+            exp_gain[text[i]] += val;
+            exp_gain[text[i + 1]] += val;
+        }
+        ASSERT_EQ(util::create_ui_vector(exp_gain), gain);
+    }
+}
+
 
 //TEST(parallel_ls_reverse_adj_list, left_end) {
 //    text_t text = util::create_ui_vector(std::vector<var_t>{1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 3, 1, 2, 1, 2, 1, 2, 1, 2, 1, 3, 1});
@@ -830,3 +853,99 @@ TEST(parallel_ls_recomp, pair) {
     ASSERT_EQ(exp_text, text);
     ASSERT_EQ(exp_rlslp, rlslp);
 }
+
+TEST(parallel_ls_local_search, passes) {
+    std::vector<var_t> vec = {2, 1, 2, 1, 8, 1, 6, 2, 3, 5, 4, 1, 7, 4, 1, 6, 2, 3, 5, 4, 1, 3, 2, 1, 0, 3, 7, 7, 5, 1, 8, 2};
+    text_t text = util::create_ui_vector(vec);
+    adj_list_t adj_list(text.size() - 1);
+    ui_vector<std::int64_t> gain;
+
+    for (const auto& mode : {parallel::local_search_config::JACOBI, parallel::local_search_config::RESIDUE_CLASSES}) {
+        parallel::local_search_config config;
+        config.passes = 10;
+        config.mode = mode;
+        config.classes = 3;
+        std::string dataset = "test";
+        parallel::parallel_ls_recompression<var_t> recomp{dataset, config};
+        recomp.cores = 4;
+        recomp.compute_adj_list(text, adj_list);
+
+        partition_t partition = util::create_ui_vector(std::vector<bool>{0, 0, 0, 0, 0, 0, 0, 0, 1});
+        recomp.compute_gains(text, adj_list, partition, gain);
+        size_t cut = recomp.cut_size(gain, adj_list.size());
+        recomp.improve_partition(text, adj_list, partition);
+        recomp.compute_gains(text, adj_list, partition, gain);
+        size_t improved_cut = recomp.cut_size(gain, adj_list.size());
+        if (mode == parallel::local_search_config::JACOBI) {
+            ASSERT_LE(cut, improved_cut);  // all symbols flip at once, so this start cannot be improved
+        } else {
+            ASSERT_LT(cut, improved_cut);
+        }
+
+        size_t exp_cut = 0;
+        for (size_t i = 0; i < text.size() - 1; ++i) {
+            if (partition[text[i]] != partition[text[i + 1]]) {
+                exp_cut++;
+            }
+        }
+        ASSERT_EQ(exp_cut, improved_cut);
+    }
+}
+
+TEST(parallel_ls_local_search, recomp) {
+    std::vector<var_t> vec = {2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 2, 1};
+    std::string exp_text;
+    for (const auto& c : vec) {
+        exp_text += static_cast<char>(c);
+    }
+
+    for (const auto& name : {"parallel_ls5", "parallel_ls10_rc", "parallel_ls8_rc4_eps0.01_ms100"}) {
+        parallel::local_search_config config;
+        ASSERT_TRUE(parse_local_search_config(name, config));
+        std::string dataset = "test";
+        parallel::parallel_ls_recompression<var_t> recomp{dataset, config};
+        text_t text = util::create_ui_vector(vec);
+        rlslp<var_t> rlslp;
+        recomp.recomp(text, rlslp, 5, 4);
+
+        ASSERT_EQ(exp_text, rlslp.derive_text());
+    }
+}
+
+TEST(parallel_ls_local_search, parse_config) {
+    parallel::local_search_config config;
+    ASSERT_TRUE(parse_local_search_config("parallel_ls", config));
+    ASSERT_EQ(1, config.passes);
+    ASSERT_EQ(parallel::local_search_config::JACOBI, config.mode);
+
+    config = parallel::local_search_config();
+    ASSERT_TRUE(parse_local_search_config("parallel_ls12_rc4_eps0.5_ms250", config));
+    ASSERT_EQ(12, config.passes);
+    ASSERT_EQ(parallel::local_search_config::RESIDUE_CLASSES, config.mode);
+    ASSERT_EQ(4, config.classes);
+    ASSERT_DOUBLE_EQ(0.5, config.min_gain);
+    ASSERT_EQ(250, config.time_budget);
+
+    config = parallel::local_search_config();
+    ASSERT_TRUE(parse_local_search_config("parallel_ls_rc", config));
+    ASSERT_EQ(1, config.passes);
+    ASSERT_EQ(2, config.classes);
+
+    ASSERT_FALSE(parse_local_search_config("parallel_lsx", config));
+    ASSERT_FALSE(parse_local_search_config("parallel_ls3_foo", config));
+    ASSERT_FALSE(parse_local_search_config("parallel_gr", config));
+
+    // only digits are numbers, malformed options are rejected instead of throwing or being truncated
+    config = parallel::local_search_config();
+    ASSERT_FALSE(parse_local_search_config("parallel_ls.", config));
+    ASSERT_FALSE(parse_local_search_config("parallel_ls1.5", config));
+    ASSERT_FALSE(parse_local_search_config("parallel_ls_rc2.5", config));
+    ASSERT_FALSE(parse_local_search_config("parallel_ls_ms1.", config));
+    ASSERT_FALSE(parse_local_search_config("parallel_ls_ms", config));
+    ASSERT_FALSE(parse_local_search_config("parallel_ls_eps.", config));
+    ASSERT_FALSE(parse_local_search_config("parallel_ls_eps0.1.2", config));
+    ASSERT_FALSE(parse_local_search_config("parallel_ls99999999999999999999999", config));
+    ASSERT_EQ(1, config.passes);
+    ASSERT_TRUE(parse_local_search_config("parallel_ls_eps.5", config));
+    ASSERT_DOUBLE_EQ(0.5, config.min_gain);
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "recompression/defs.hpp"
+#include "recompression/pattern_matching.hpp"
+#include "recompression/rlslp.hpp"
+#include "recompression/parallel_recompression.hpp"
+#include "recompression/util.hpp"
+
+using namespace recomp;
+
+typedef recompression<var_t>::text_t text_t;
+
+TEST(pattern_matching, empty) {
+    text_t text = util::create_ui_vector(std::vector<var_t>{});
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    ASSERT_EQ(0, pattern_matching::count(rlslp, std::string{1, 2}));
+    ASSERT_TRUE(pattern_matching::find_occurrences(rlslp, std::string{1, 2}).empty());
+}
+
+TEST(pattern_matching, empty_pattern) {
+    text_t text = util::create_ui_vector(std::vector<var_t>{2, 1, 2, 1, 4, 4, 4, 1});
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    ASSERT_EQ(0, pattern_matching::count(rlslp, ""));
+    ASSERT_TRUE(pattern_matching::find_occurrences(rlslp, "").empty());
+}
+
+TEST(pattern_matching, single_symbol) {
+    text_t text = util::create_ui_vector(std::vector<var_t>{2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 2, 1});
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    std::vector<size_t> exp_occ = {4, 5, 6, 14, 19, 27};
+    ASSERT_EQ(6, pattern_matching::count(rlslp, std::string{4}));
+    ASSERT_EQ(exp_occ, pattern_matching::find_occurrences(rlslp, std::string{4}));
+}
+
+TEST(pattern_matching, pattern) {
+    text_t text = util::create_ui_vector(std::vector<var_t>{2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 2, 1});
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    std::string pattern{4, 1, 3};
+    std::vector<size_t> exp_occ = {6, 14, 19, 27};
+    ASSERT_EQ(4, pattern_matching::count(rlslp, pattern));
+    ASSERT_EQ(exp_occ, pattern_matching::find_occurrences(rlslp, pattern));
+
+    pattern = std::string{3, 2, 3, 1, 1, 4, 1, 3};
+    exp_occ = {9, 22};
+    ASSERT_EQ(2, pattern_matching::count(rlslp, pattern));
+    ASSERT_EQ(exp_occ, pattern_matching::find_occurrences(rlslp, pattern));
+}
+
+TEST(pattern_matching, no_occurrence) {
+    text_t text = util::create_ui_vector(std::vector<var_t>{2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 2, 1});
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    ASSERT_EQ(0, pattern_matching::count(rlslp, std::string{4, 4, 4, 4}));
+    ASSERT_EQ(0, pattern_matching::count(rlslp, std::string{2, 2}));
+    ASSERT_TRUE(pattern_matching::find_occurrences(rlslp, std::string{1, 2, 3}).empty());
+}
+
+TEST(pattern_matching, whole_text) {
+    std::vector<var_t> vec = {2, 1, 2, 1, 4, 4, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 3, 3, 4, 1, 3, 3, 2, 3, 1, 1, 4, 1, 3, 2, 1};
+    text_t text = util::create_ui_vector(vec);
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 5, 4);
+
+    std::string pattern;
+    for (const auto& c : vec) {
+        pattern += static_cast<char>(c);
+    }
+    ASSERT_EQ(1, pattern_matching::count(rlslp, pattern));
+    ASSERT_EQ(0, pattern_matching::count(rlslp, pattern + std::string{1}));
+}
+
+TEST(pattern_matching, overlapping_runs) {
+    std::string str(100, 'a');
+    text_t text(str.size());
+    for (size_t i = 0; i < str.size(); ++i) {
+        text[i] = static_cast<var_t>(str[i]);
+    }
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 4);
+
+    pattern_matching::pattern_matcher<var_t> matcher{rlslp};
+    for (size_t m = 1; m <= str.size(); m += 7) {
+        std::string pattern(m, 'a');
+        ASSERT_EQ(str.size() - m + 1, matcher.count(pattern));
+        ASSERT_EQ(pattern_matching::find_occurrences_naive(str, pattern), matcher.find_occurrences(pattern));
+    }
+}
+
+TEST(pattern_matching, naive) {
+    std::string str = "abracadabraabracadabrabracadabracadabraxxabrabracadabra";
+    text_t text(str.size());
+    for (size_t i = 0; i < str.size(); ++i) {
+        text[i] = static_cast<var_t>(str[i]);
+    }
+    parallel::parallel_recompression<var_t> recomp;
+    rlslp<var_t> rlslp;
+    recomp.recomp(text, rlslp, 4);
+
+    pattern_matching::pattern_matcher<var_t> matcher{rlslp};
+    for (size_t i = 0; i < str.size(); ++i) {
+        for (size_t m = 1; i + m <= str.size(); m += 3) {
+            auto pattern = str.substr(i, m);
+            auto exp_occ = pattern_matching::find_occurrences_naive(str, pattern);
+            ASSERT_EQ(exp_occ.size(), matcher.count(pattern));
+            ASSERT_EQ(exp_occ, matcher.find_occurrences(pattern));
+        }
+    }
+}
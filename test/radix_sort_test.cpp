@@ -1218,3 +1218,27 @@ TEST(pprs, blocks_2222222221111111222200) {
 
     ASSERT_EQ(exp_blocks, blocks);
 }
+
+TEST(radix_sort_by_key, stable) {
+    std::vector<size_t> values;
+    for (size_t i = 0; i < 100000; ++i) {
+        values.push_back((i * 7919) % 100003);
+    }
+    auto key = [](size_t value) {
+        return value % 1000;
+    };
+    for (size_t cores : {1, 3, 8}) {
+        ui_vector<size_t> sorted = util::create_ui_vector(values);
+        parallel::radix_sort_by_key(sorted, key, util::bits_for(999), cores);
+
+        std::vector<size_t> exp_sorted = values;
+        std::stable_sort(exp_sorted.begin(), exp_sorted.end(), [&](size_t a, size_t b) {
+            return key(a) < key(b);
+        });
+        ASSERT_EQ(util::create_ui_vector(exp_sorted), sorted) << cores;
+    }
+
+    ui_vector<size_t> empty;
+    parallel::radix_sort_by_key(empty, key, 10, 4);
+    ASSERT_EQ(0, empty.size());
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "recompression.hpp"
+
+using namespace recomp;
+
+typedef recompression<var_t>::text_t text_t;
+
+namespace {
+
+text_t create_text(const std::string& str) {
+    text_t text(str.size());
+    for (size_t i = 0; i < str.size(); ++i) {
+        text[i] = static_cast<unsigned char>(str[i]);
+    }
+    return text;
+}
+
+std::string create_string() {
+    std::string str;
+    for (size_t i = 0; i < 5000; ++i) {
+        str += static_cast<char>('a' + counter_rng(1, 2)(i) % 26);
+        if (i % 100 == 99) {
+            str += str.substr(i / 2, 70);
+        }
+    }
+    return str;
+}
+
+}  // namespace
+
+TEST(counter_rng, deterministic) {
+    counter_rng rng{42, 3};
+    counter_rng same{42, 3};
+    ASSERT_EQ(rng(0), same(0));
+    ASSERT_EQ(rng(12345), same(12345));
+    ASSERT_NE(rng(0), rng(1));
+    ASSERT_NE(rng(0), counter_rng(43, 3)(0));
+    ASSERT_NE(rng(0), counter_rng(42, 4)(0));
+    ASSERT_NE(rng(0), counter_rng(42, 3, 1)(0));
+}
+
+TEST(counter_rng, fill) {
+    const size_t n = 1000;
+    counter_rng rng{7, 1};
+    size_t ones = 0;
+    for (size_t cores : {1, 2, 3, 8}) {
+        ui_vector<bool> bits(n);
+        bits[0] = false;
+        bits[n - 1] = true;
+        rng.fill(bits, 1, n - 1, cores);
+        ASSERT_FALSE(bits[0]);
+        ASSERT_TRUE(bits[n - 1]);
+        ones = 0;
+        for (size_t i = 1; i < n - 1; ++i) {
+            ASSERT_EQ(rng.bit(i), bits[i]) << i;
+            ones += bits[i];
+        }
+    }
+    ASSERT_GT(ones, 400);
+    ASSERT_LT(ones, 600);
+
+    ui_vector<bool> empty(1);
+    rng.fill(empty, 1, 0, 4);
+}
+
+TEST(counter_rng, reproducible_recompression) {
+    std::string str = create_string();
+    std::vector<std::string> variants = {"parallel_rnd", "parallel_rnd5", "parallel_rnddir", "parallel_rnddir5",
+                                         "parallel_ls"};
+    for (const auto& variant : variants) {
+        std::string dataset = "test";
+        rlslp<var_t> exp_rlslp;
+        for (size_t cores : {1, 2, 4}) {
+            auto recomp = create_recompression<var_t>(variant, dataset, "", "");
+            ASSERT_TRUE(recomp != nullptr) << variant;
+            recomp->seed = 12345;
+            text_t text = create_text(str);
+            rlslp<var_t> slp;
+            recomp->recomp(text, slp, CHAR_ALPHABET, cores);
+            ASSERT_EQ(str, slp.derive_text()) << variant;
+
+            if (cores == 1) {
+                exp_rlslp = std::move(slp);
+            } else {
+                ASSERT_EQ(exp_rlslp, slp) << variant << " cores " << cores;
+            }
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "recompression.hpp"
+
+using namespace recomp;
+
+namespace {
+
+regression::result make_result(const std::string& algo, std::uint64_t time, size_t memory, size_t size) {
+    regression::result res;
+    res.algo = algo;
+    res.dataset = "data_\"set\\";
+    res.cores = 4;
+    res.time_ms = time;
+    res.memory_bytes = memory;
+    res.rlslp_size = size;
+    return res;
+}
+
+}  // namespace
+
+TEST(regression, json) {
+    std::vector<regression::result> results;
+    results.push_back(make_result("parallel", 100, 4096, 42));
+    results.push_back(make_result("parallel_ls", 0, 0, 7));
+    results[1].correct = false;
+
+    std::stringstream json;
+    regression::write_json(json, results);
+
+    std::vector<regression::result> read;
+    ASSERT_TRUE(regression::read_json(json, read));
+    ASSERT_EQ(2U, read.size());
+    for (size_t i = 0; i < read.size(); ++i) {
+        ASSERT_EQ(results[i].algo, read[i].algo);
+        ASSERT_EQ(results[i].dataset, read[i].dataset);
+        ASSERT_EQ(results[i].cores, read[i].cores);
+        ASSERT_EQ(results[i].time_ms, read[i].time_ms);
+        ASSERT_EQ(results[i].memory_bytes, read[i].memory_bytes);
+        ASSERT_EQ(results[i].rlslp_size, read[i].rlslp_size);
+        ASSERT_EQ(results[i].correct, read[i].correct);
+    }
+
+    std::stringstream empty;
+    regression::write_json(empty, std::vector<regression::result>());
+    ASSERT_TRUE(regression::read_json(empty, read));
+    ASSERT_TRUE(read.empty());
+
+    std::stringstream other("{\"results\": [{\"algo\": \"x\", \"unknown\": 1.5, \"time_ms\": 3}]}");
+    ASSERT_TRUE(regression::read_json(other, read));
+    ASSERT_EQ(1U, read.size());
+    ASSERT_EQ("x", read[0].algo);
+    ASSERT_EQ(3U, read[0].time_ms);
+
+    std::stringstream invalid("{\"results\": [{\"algo\": \"x\"");
+    ASSERT_FALSE(regression::read_json(invalid, read));
+}
+
+TEST(regression, compare) {
+    std::vector<regression::result> baseline;
+    baseline.push_back(make_result("a", 100, 1000, 50));
+    baseline.push_back(make_result("b", 100, 0, 50));
+    baseline.push_back(make_result("c", 5, 1000, 50));
+
+    std::vector<regression::result> current;
+    current.push_back(make_result("a", 109, 1049, 50));
+    current.push_back(make_result("b", 200, 5000, 50));
+    current.push_back(make_result("c", 14, 1000, 51));
+    current.push_back(make_result("d", 1000, 1000, 1000));
+
+    regression::thresholds limits;
+    auto findings = regression::compare(baseline, current, limits);
+    ASSERT_EQ(2U, findings.size());
+    ASSERT_EQ("b", findings[0].algo);
+    ASSERT_EQ("time_ms", findings[0].metric);
+    ASSERT_EQ(100, findings[0].baseline);
+    ASSERT_EQ(200, findings[0].current);
+    ASSERT_EQ("c", findings[1].algo);
+    ASSERT_EQ("rlslp_size", findings[1].metric);
+
+    current[0] = make_result("a", 111, 1051, 49);
+    current[3].correct = false;
+    findings = regression::compare(baseline, current, limits);
+    ASSERT_EQ(5U, findings.size());
+    ASSERT_EQ("time_ms", findings[0].metric);
+    ASSERT_EQ("memory_bytes", findings[1].metric);
+    ASSERT_EQ("d", findings[4].algo);
+    ASSERT_EQ("correct", findings[4].metric);
+
+    limits.time = 1.0;
+    limits.memory = 0.1;
+    limits.size = 0.1;
+    findings = regression::compare(baseline, current, limits);
+    ASSERT_EQ(1U, findings.size());
+    ASSERT_EQ("correct", findings[0].metric);
+
+    std::stringstream out;
+    regression::print(out, findings);
+    ASSERT_EQ(0U, out.str().find("REGRESSION algo=d dataset=data_\"set\\ cores=4 metric=correct"));
+
+    // a variant of the baseline that is missing (dropped or crashed) in the current run
+    current.erase(current.begin() + 1);
+    current[2].correct = true;
+    findings = regression::compare(baseline, current, limits);
+    ASSERT_EQ(1U, findings.size());
+    ASSERT_EQ("b", findings[0].algo);
+    ASSERT_EQ("missing", findings[0].metric);
+
+    baseline.back().cores = 8;
+    findings = regression::compare(baseline, current, limits);
+    ASSERT_EQ(2U, findings.size());
+    ASSERT_EQ("c", findings[1].algo);
+    ASSERT_EQ(8U, findings[1].cores);
+
+    out.str("");
+    regression::print(out, findings);
+    ASSERT_EQ("REGRESSION algo=b dataset=data_\"set\\ cores=4 metric=missing baseline=1 current=0\n"
+              "REGRESSION algo=c dataset=data_\"set\\ cores=8 metric=missing baseline=1 current=0\n", out.str());
+}
@@ -1,11 +1,75 @@
 #include <gtest/gtest.h>
 
-#include "recompression/defs.hpp"
-#include "recompression/rlslp.hpp"
-#include "recompression/coders/rlslp_rule_sorter.hpp"
+#include <string>
+#include <vector>
+
+#include "recompression.hpp"
 
 using namespace recomp;
 
+namespace {
+
+/**
+ * Builds three chains of first symbols with the given number of levels. Every tenth variable of a chain has a second
+ * child (z) and every 37th variable is a block. The pairs are named in front of the blocks.
+ */
+void deep_forest(size_t levels, rlslp<var_t>& slp) {
+    struct rule {
+        bool block;
+        var_t first;
+        var_t second;
+    };
+    std::vector<rule> rules;
+    std::vector<var_t> tops;
+    for (size_t c = 0; c < 3; ++c) {
+        var_t prev = 'a' + c;
+        for (size_t d = 0; d < levels; ++d) {
+            if (d % 10 == 0) {
+                rules.push_back(rule{false, prev, 'z'});
+            }
+            if (d % 37 == 3) {
+                rules.push_back(rule{true, prev, static_cast<var_t>(2 + d % 2)});
+            } else {
+                rules.push_back(rule{false, prev, static_cast<var_t>('a' + (d * c) % 5)});
+            }
+            prev = CHAR_ALPHABET + rules.size() - 1;
+        }
+        tops.push_back(prev);
+    }
+    rules.push_back(rule{false, tops[0], tops[1]});
+    rules.push_back(rule{false, static_cast<var_t>(CHAR_ALPHABET + rules.size() - 1), tops[2]});
+
+    std::vector<var_t> names(rules.size());
+    size_t pairs = 0;
+    for (size_t i = 0; i < rules.size(); ++i) {
+        if (!rules[i].block) {
+            names[i] = CHAR_ALPHABET + pairs++;
+        }
+    }
+    size_t blocks = pairs;
+    for (size_t i = 0; i < rules.size(); ++i) {
+        if (rules[i].block) {
+            names[i] = CHAR_ALPHABET + blocks++;
+        }
+    }
+    auto rename = [&](var_t x) -> var_t {
+        return x < CHAR_ALPHABET ? x : names[x - CHAR_ALPHABET];
+    };
+
+    slp.terminals = CHAR_ALPHABET;
+    slp.is_empty = false;
+    slp.resize(rules.size());
+    slp.blocks = pairs;
+    for (size_t i = 0; i < rules.size(); ++i) {
+        slp[names[i] - CHAR_ALPHABET] = non_terminal<var_t>(
+                rename(rules[i].first), rules[i].block ? rules[i].second : rename(rules[i].second));
+    }
+    slp.root = names.back();
+    slp.compute_lengths();
+}
+
+}  // namespace
+
 TEST(sort_rlslp_rules, empty) {
     rlslp<var_t> rlslp;
     term_t alphabet_size = 0;
@@ -408,3 +472,71 @@ TEST(sort_rlslp_rules, less_productions) {
 
     ASSERT_EQ(exp_rlslp, rlslp);
 }
+
+TEST(sort_rlslp_rules, sequential) {
+    std::string str;
+    for (size_t i = 0; i < 5000; ++i) {
+        str += std::string(1 + (i * 7919) % 5, static_cast<char>('a' + (i * i + 3 * i) % 7));
+    }
+    for (const std::string variant : {"parallel_ls", "parallel_rnd", "fast_seq"}) {
+        std::string dataset = "test";
+        auto recomp = create_recompression<var_t>(variant, dataset, "", "");
+        recompression<var_t>::text_t text(str.size());
+        for (size_t i = 0; i < str.size(); ++i) {
+            text[i] = static_cast<unsigned char>(str[i]);
+        }
+        rlslp<var_t> slp;
+        recomp->recomp(text, slp, CHAR_ALPHABET, 4);
+
+        recomp::rlslp<var_t> exp_rlslp;
+        exp_rlslp.terminals = slp.terminals;
+        exp_rlslp.root = slp.root;
+        exp_rlslp.blocks = slp.blocks;
+        exp_rlslp.is_empty = slp.is_empty;
+        exp_rlslp.resize(slp.size());
+        for (size_t i = 0; i < slp.size(); ++i) {
+            exp_rlslp[i] = slp[i];
+        }
+        sequential_sort_rlslp_rules(exp_rlslp);
+
+        for (size_t cores : {1, 4}) {
+            sort_rlslp_rules(slp, cores);
+            ASSERT_EQ(exp_rlslp, slp) << variant;
+            ASSERT_EQ(str, slp.derive_text()) << variant;
+            for (size_t i = 1; i < slp.blocks; ++i) {
+                ASSERT_LE(slp[i - 1].first(), slp[i].first()) << variant;
+            }
+            for (size_t i = slp.blocks + 1; i < slp.size(); ++i) {
+                ASSERT_LE(slp[i - 1].first(), slp[i].first()) << variant;
+            }
+        }
+    }
+}
+
+TEST(sort_rlslp_rules, deep_forest) {
+    // 75 levels do not fit into 32 packed levels, so the class paths are ranked by two rounds of prefix doubling
+    rlslp<var_t> exp_rlslp;
+    deep_forest(75, exp_rlslp);
+    const std::string str = exp_rlslp.derive_text();
+    sequential_sort_rlslp_rules(exp_rlslp);
+
+    for (size_t cores : {1, 4}) {
+        rlslp<var_t> slp;
+        deep_forest(75, slp);
+        sort_rlslp_rules(slp, cores);
+        ASSERT_EQ(exp_rlslp, slp);
+        ASSERT_EQ(str, slp.derive_text());
+    }
+
+    // three nested blocks on a path, the sequential version does not sort these first symbols
+    rlslp<var_t> slp;
+    deep_forest(150, slp);
+    const std::string deep_str = slp.derive_text();
+    sort_rlslp_rules(slp, 4);
+    ASSERT_EQ(deep_str, slp.derive_text());
+    for (size_t i = 1; i < slp.size(); ++i) {
+        if (i != slp.blocks) {
+            ASSERT_LE(slp[i - 1].first(), slp[i].first()) << i;
+        }
+    }
+}
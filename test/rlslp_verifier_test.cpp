@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "recompression.hpp"
+#include "test_util.hpp"
+
+using namespace recomp;
+
+typedef parallel::parallel_recompression<var_t> recompression_t;
+using recomp::test::compress;
+
+namespace {
+
+std::string verifier_text() {
+    std::string str;
+    for (size_t i = 0; i < 5000; ++i) {
+        str += static_cast<char>('a' + (i * i + i / 5) % 7);
+        if (i % 113 == 0) {
+            str += std::string(1 + i % 29, 'c');
+        }
+    }
+    return str;
+}
+
+void write_file(const std::string& file_name, const std::string& str) {
+    std::ofstream out(file_name, std::ios::binary);
+    out.write(str.data(), str.size());
+}
+
+}  // namespace
+
+TEST(rlslp_verifier, expand) {
+    std::string str = verifier_text();
+    rlslp<var_t> slp;
+    compress<recompression_t>(str, slp);
+
+    std::vector<char> buffer(str.size());
+    for (size_t i = 0; i < str.size(); i += 37) {
+        for (size_t len : {1, 2, 7, 64, 1000}) {
+            len = std::min(len, str.size() - i);
+            char* out = buffer.data();
+            expand_rlslp(slp, slp.root, i, len, out);
+            ASSERT_EQ(len, static_cast<size_t>(out - buffer.data()));
+            ASSERT_EQ(str.substr(i, len), std::string(buffer.data(), len)) << i << " " << len;
+        }
+    }
+}
+
+TEST(rlslp_verifier, verify) {
+    std::string str = verifier_text();
+    std::string file_name = "verifier_text";
+    write_file(file_name, str);
+    rlslp<var_t> slp;
+    compress<recompression_t>(str, slp);
+
+    ASSERT_TRUE(verify_rlslp(slp, file_name));
+    ASSERT_TRUE(verify_rlslp(slp, file_name, 0, true, 4, 100));
+    ASSERT_TRUE(verify_rlslp(slp, file_name, 0, true, 3, 1));
+    ASSERT_FALSE(verify_rlslp(slp, file_name, str.size() - 1, true, 4, 100));
+
+    std::string changed = str;
+    changed[3001] = 'z';
+    write_file(file_name, changed);
+    ASSERT_FALSE(verify_rlslp(slp, file_name, 0, true, 4, 100));
+
+    write_file(file_name, str + "a");
+    ASSERT_FALSE(verify_rlslp(slp, file_name, 0, true, 4, 100));
+    ASSERT_TRUE(verify_rlslp(slp, file_name, str.size(), true, 4, 100));
+
+    remove(file_name.c_str());
+}
+
+TEST(rlslp_verifier, zeroes) {
+    std::string str = verifier_text();
+    std::string with_zeroes;
+    for (size_t i = 0; i < str.size(); ++i) {
+        with_zeroes += str[i];
+        if (i % 10 == 0) {
+            with_zeroes += std::string(i % 3, '\0');
+        }
+    }
+    std::string file_name = "verifier_zeroes";
+    write_file(file_name, with_zeroes);
+    rlslp<var_t> slp;
+    compress<recompression_t>(str, slp);
+
+    ASSERT_TRUE(verify_rlslp(slp, file_name, 0, false, 4, 64));
+    ASSERT_FALSE(verify_rlslp(slp, file_name, 0, true, 4, 64));
+
+    remove(file_name.c_str());
+}
+
+TEST(rlslp_verifier, empty) {
+    std::string file_name = "verifier_empty";
+    write_file(file_name, "");
+    rlslp<var_t> slp;
+    compress<recompression_t>("", slp);
+    ASSERT_TRUE(verify_rlslp(slp, file_name));
+
+    write_file(file_name, "a");
+    ASSERT_FALSE(verify_rlslp(slp, file_name));
+
+    rlslp<var_t> terminal;
+    compress<recompression_t>("a", terminal);
+    ASSERT_TRUE(verify_rlslp(terminal, file_name));
+
+    remove(file_name.c_str());
+}
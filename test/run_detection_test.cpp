@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#define private public
+#define protected public
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "recompression/defs.hpp"
+#include "recompression/parallel_recompression.hpp"
+#include "recompression/random.hpp"
+#include "recompression/rlslp.hpp"
+#include "recompression/run_detection.hpp"
+
+using namespace recomp;
+
+namespace {
+
+template<typename variable_t>
+std::vector<variable_t> create_runs(size_t n, variable_t offset) {
+    std::vector<variable_t> text;
+    counter_rng rng{11, n};
+    size_t k = 0;
+    while (text.size() < n) {
+        auto r = rng(k++);
+        size_t len = (r % 4 == 0) ? 1 + (r >> 8) % 100 : 1;
+        text.insert(text.end(), std::min(len, n - text.size()), offset + static_cast<variable_t>((r >> 32) % 3));
+    }
+    return text;
+}
+
+template<typename variable_t>
+void check_masks(variable_t offset) {
+    auto text = create_runs<variable_t>(1000, offset);
+    for (auto isa : {simd::SCALAR, simd::AVX2, simd::AVX512}) {
+        simd::set_isa(isa);
+        for (size_t i = 0; i + 1 < text.size(); i += 7) {
+            const size_t len = std::min(static_cast<size_t>(64), text.size() - 1 - i);
+            std::uint64_t exp_mask = 0;
+            for (size_t j = 0; j < len; ++j) {
+                exp_mask |= static_cast<std::uint64_t>(text[i + j] == text[i + j + 1]) << j;
+            }
+            ASSERT_EQ(exp_mask, simd::equal_mask(text.data() + i, len)) << "isa " << isa << " pos " << i;
+
+            size_t exp_eq = i;
+            while (exp_eq < text.size() - 1 && text[exp_eq] != text[exp_eq + 1]) {
+                exp_eq++;
+            }
+            size_t exp_uneq = i;
+            while (exp_uneq < text.size() - 1 && text[exp_uneq] == text[exp_uneq + 1]) {
+                exp_uneq++;
+            }
+            ASSERT_EQ(exp_eq, simd::next_equal(text.data(), i, text.size() - 1));
+            ASSERT_EQ(exp_uneq, simd::next_unequal(text.data(), i, text.size() - 1));
+        }
+    }
+    simd::set_isa(simd::AVX512);
+}
+
+}  // namespace
+
+TEST(run_detection, masks) {
+    check_masks<std::uint32_t>(5);
+    check_masks<std::uint64_t>(static_cast<std::uint64_t>(1) << 40);
+}
+
+TEST(run_detection, set_isa) {
+    simd::set_isa(simd::SCALAR);
+    ASSERT_EQ(simd::SCALAR, simd::active_isa());
+    simd::set_isa(simd::AVX512);
+    ASSERT_EQ(simd::detect_isa(), simd::active_isa());
+}
+
+TEST(run_detection, bcomp) {
+    auto vec = create_runs<var_t>(20000, 0);
+    ui_vector<var_t> exp_text = util::create_ui_vector(vec);
+    rlslp<var_t> exp_rlslp;
+    simd::set_isa(simd::SCALAR);
+    parallel::parallel_recompression<var_t> exp_recomp;
+    exp_recomp.cores = 1;
+    std::vector<bool> exp_bv;
+    exp_rlslp.terminals = 3;
+    exp_recomp.bcomp(exp_text, exp_rlslp, exp_bv);
+
+    for (auto isa : {simd::SCALAR, simd::AVX2, simd::AVX512}) {
+        for (size_t cores : {1, 3, 8}) {
+            simd::set_isa(isa);
+            ui_vector<var_t> text = util::create_ui_vector(vec);
+            rlslp<var_t> slp;
+            slp.terminals = 3;
+            parallel::parallel_recompression<var_t> recomp;
+            recomp.cores = cores;
+            std::vector<bool> bv;
+            recomp.bcomp(text, slp, bv);
+
+            ASSERT_EQ(exp_text, text) << "isa " << isa << " cores " << cores;
+            ASSERT_EQ(exp_rlslp, slp);
+            ASSERT_EQ(exp_bv, bv);
+        }
+    }
+    simd::set_isa(simd::AVX512);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "recompression.hpp"
+
+namespace recomp {
+namespace test {
+
+/**
+ * @brief Compresses the string with the given recompression using 4 cores.
+ *
+ * @tparam recompression_t The recompression
+ * @param str The string
+ * @param slp[out] The rlslp
+ */
+template<typename recompression_t = parallel::parallel_ls_recompression<var_t>>
+inline void compress(const std::string& str, rlslp<var_t>& slp) {
+    typename recompression_t::text_t text(str.size());
+    for (size_t i = 0; i < str.size(); ++i) {
+        text[i] = static_cast<unsigned char>(str[i]);
+    }
+    recompression_t recomp;
+    recomp.recomp(text, slp, CHAR_ALPHABET, 4);
+}
+
+/**
+ * @brief Checks the layout of the rlslp, i.e. the pairs in front of the blocks, the lengths of the rules and that the
+ * rlslp derives the string.
+ *
+ * @param slp The rlslp
+ * @param str The expected string
+ */
+inline void check_rlslp(const rlslp<var_t>& slp, const std::string& str) {
+    for (size_t i = 0; i < slp.size(); ++i) {
+        const var_t nt = i + slp.terminals;
+        const auto& rule = slp[i];
+        if (slp.is_block(nt)) {
+            ASSERT_LT(1U, rule.second());
+            ASSERT_EQ(slp.len(rule.first()) * rule.second(), rule.len);
+        } else {
+            ASSERT_EQ(slp.len(rule.first()) + slp.len(rule.second()), rule.len);
+        }
+    }
+    ASSERT_EQ(str.size(), slp.len(slp.root));
+    std::vector<char> buffer(str.size());
+    char* out = buffer.data();
+    expand_rlslp(slp, slp.root, 0, str.size(), out);
+    ASSERT_EQ(str, std::string(buffer.data(), str.size()));
+}
+
+}  // namespace test
+}  // namespace recomp
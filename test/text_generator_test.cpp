@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+
+#include "recompression.hpp"
+
+using namespace recomp;
+
+TEST(text_generator, fibonacci) {
+    std::string text;
+    generator::fibonacci(text, 21, 1);
+    ASSERT_EQ("abaababaabaababaababa", text);
+
+    std::string parallel;
+    generator::fibonacci(parallel, 10000, 4);
+    generator::fibonacci(text, 10000, 1);
+    ASSERT_EQ(text, parallel);
+
+    generator::fibonacci(text, 1, 1);
+    ASSERT_EQ("a", text);
+    generator::fibonacci(text, 0, 1);
+    ASSERT_TRUE(text.empty());
+}
+
+TEST(text_generator, thue_morse) {
+    std::string text;
+    generator::thue_morse(text, 16, 2);
+    ASSERT_EQ("abbabaabbaababba", text);
+}
+
+TEST(text_generator, random) {
+    std::string text;
+    generator::random(text, 10000, 4, 42, 1);
+    ASSERT_EQ(10000U, text.size());
+    std::set<char> alphabet(text.begin(), text.end());
+    ASSERT_EQ((std::set<char>{'a', 'b', 'c', 'd'}), alphabet);
+
+    std::string parallel;
+    generator::random(parallel, 10000, 4, 42, 4);
+    ASSERT_EQ(text, parallel);
+
+    generator::random(parallel, 10000, 4, 43, 4);
+    ASSERT_NE(text, parallel);
+
+    recompression<var_t>::text_t large;
+    generator::random(large, 10000, 200, 42, 2);
+    for (size_t i = 0; i < large.size(); ++i) {
+        ASSERT_LE(1U, large[i]);
+        ASSERT_GE(200U, large[i]);
+    }
+}
+
+TEST(text_generator, mutated_repeats) {
+    std::string text;
+    generator::periodic(text, 1000, 7, 4, 42, 2);
+    for (size_t i = 7; i < text.size(); ++i) {
+        ASSERT_EQ(text[i - 7], text[i]);
+    }
+
+    std::string mutated;
+    generator::mutated_repeats(mutated, 100000, 7, 0.01, 4, 42, 2);
+    generator::periodic(text, 100000, 7, 4, 42, 1);
+    size_t mutations = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        mutations += (text[i] != mutated[i]);
+    }
+    ASSERT_LT(500U, mutations);
+    ASSERT_GT(1500U, mutations);
+
+    generator::mutated_repeats(mutated, 1000, 7, 1.0, 4, 42, 2);
+    generator::periodic(text, 1000, 7, 4, 42, 2);
+    for (size_t i = 0; i < text.size(); ++i) {
+        ASSERT_NE(text[i], mutated[i]);
+    }
+}
+
+TEST(text_generator, generate) {
+    std::string text;
+    std::string expected;
+    ASSERT_TRUE(generator::generate("fibonacci", text, 100, 1, 1));
+    generator::fibonacci(expected, 100, 1);
+    ASSERT_EQ(expected, text);
+
+    ASSERT_TRUE(generator::generate("random:16", text, 100, 5, 1));
+    generator::random(expected, 100, 16, 5, 1);
+    ASSERT_EQ(expected, text);
+
+    ASSERT_TRUE(generator::generate("repeats:64:0.1", text, 1000, 5, 1));
+    generator::mutated_repeats(expected, 1000, 64, 0.1, 4, 5, 1);
+    ASSERT_EQ(expected, text);
+
+    ASSERT_TRUE(generator::generate("periodic:3:2", text, 100, 5, 1));
+    generator::periodic(expected, 100, 3, 2, 5, 1);
+    ASSERT_EQ(expected, text);
+
+    ASSERT_FALSE(generator::generate("fibonacci:2", text, 100, 1, 1));
+    ASSERT_FALSE(generator::generate("random:0", text, 100, 1, 1));
+    ASSERT_FALSE(generator::generate("random:256", text, 100, 1, 1));
+    ASSERT_FALSE(generator::generate("repeats:64:2", text, 100, 1, 1));
+    ASSERT_FALSE(generator::generate("periodic:x", text, 100, 1, 1));
+    ASSERT_FALSE(generator::generate("unknown", text, 100, 1, 1));
+
+    ASSERT_EQ("repeats-64-0.1\\_n1000", generator::dataset_name("repeats:64:0.1", 1000));
+}
+
+TEST(text_generator, recompression) {
+    for (const auto& spec : {"fibonacci", "thue_morse", "random:4", "repeats:100:0.01"}) {
+        std::string str;
+        generator::generate(spec, str, 5000, 7, 2);
+        recompression<var_t>::text_t text;
+        generator::generate(spec, text, 5000, 7, 2);
+
+        rlslp<var_t> slp;
+        parallel::parallel_ls_recompression<var_t> recomp;
+        recomp.recomp(text, slp, CHAR_ALPHABET, 2);
+        ASSERT_EQ(str, slp.derive_text()) << spec;
+    }
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "recompression.hpp"
+
+using namespace recomp;
+
+namespace {
+
+size_t count_events(const std::vector<trace_event>& events, const std::string& name) {
+    return std::count_if(events.begin(), events.end(), [&](const trace_event& event) {
+        return name == event.name;
+    });
+}
+
+}  // namespace
+
+TEST(trace, disabled) {
+    tracer::enable(false);
+    tracer::clear();
+    {
+        trace_scope trace("disabled");
+    }
+    ASSERT_FALSE(tracer::enabled());
+    ASSERT_TRUE(tracer::events().empty());
+}
+
+TEST(trace, nested) {
+    tracer::clear();
+    tracer::enable();
+    {
+        trace_scope outer("outer", "test", "size", 42);
+        trace_scope inner("inner", "test");
+        inner.end();
+        inner.end();
+    }
+    tracer::enable(false);
+
+    auto events = tracer::events();
+    ASSERT_EQ(2U, events.size());
+    ASSERT_EQ(std::string("outer"), events[0].name);
+    ASSERT_EQ(std::string("test"), events[0].category);
+    ASSERT_EQ(std::string("size"), events[0].arg_name);
+    ASSERT_EQ(42U, events[0].arg);
+    ASSERT_EQ(std::string("inner"), events[1].name);
+    ASSERT_EQ(nullptr, events[1].arg_name);
+    ASSERT_LE(events[0].begin, events[1].begin);
+    ASSERT_GE(events[0].begin + events[0].duration, events[1].begin + events[1].duration);
+    ASSERT_EQ(events[0].thread, events[1].thread);
+
+    tracer::clear();
+    ASSERT_TRUE(tracer::events().empty());
+}
+
+TEST(trace, threads) {
+    tracer::clear();
+    tracer::enable();
+#pragma omp parallel num_threads(4)
+    {
+        trace_scope trace("thread", "test", "id", static_cast<size_t>(omp_get_thread_num()));
+    }
+    tracer::enable(false);
+
+    auto events = tracer::events();
+    ASSERT_EQ(4U, events.size());
+    std::set<size_t> threads;
+    std::set<size_t> ids;
+    for (const auto& event : events) {
+        threads.insert(event.thread);
+        ids.insert(event.arg);
+    }
+    ASSERT_EQ(4U, threads.size());
+    ASSERT_EQ(4U, ids.size());
+    tracer::clear();
+}
+
+TEST(trace, export) {
+    tracer::clear();
+    tracer::record(trace_event{"phase", "test", "text", 7, 1234567, 5, 0});
+    tracer::record(trace_event{"quote\"d", "test", nullptr, 0, 2000000, 1000, 0});
+
+    std::stringstream json;
+    tracer::write_chrome_trace(json);
+    const std::string str = json.str();
+    ASSERT_EQ(0U, str.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+    ASSERT_NE(std::string::npos, str.find("{\"name\":\"phase\",\"cat\":\"test\",\"ph\":\"X\",\"pid\":0,\"tid\":"));
+    ASSERT_NE(std::string::npos, str.find("\"ts\":1234.567,\"dur\":0.005,\"args\":{\"text\":7}}"));
+    ASSERT_NE(std::string::npos, str.find("\"name\":\"quote\\\"d\""));
+    ASSERT_NE(std::string::npos, str.find("\"ts\":2000.000,\"dur\":1.000}"));
+    ASSERT_NE(std::string::npos, str.find("\n]}"));
+
+    std::stringstream csv;
+    tracer::write_csv(csv);
+    std::string line;
+    std::vector<std::string> lines;
+    while (std::getline(csv, line)) {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(3U, lines.size());
+    ASSERT_EQ("name,category,thread,begin_ns,duration_ns,arg_name,arg", lines[0]);
+    ASSERT_EQ(0U, lines[1].find("phase,test,"));
+    ASSERT_NE(std::string::npos, lines[1].find(",1234567,5,text,7"));
+    ASSERT_NE(std::string::npos, lines[2].find(",2000000,1000,,"));
+    tracer::clear();
+}
+
+TEST(trace, recompression_phases) {
+    std::string str = "abababababbabababaabababaabaabababbbabababababaaaabababbaabababbaaababababbababab";
+    recompression<var_t>::text_t text(str.size());
+    for (size_t i = 0; i < str.size(); ++i) {
+        text[i] = static_cast<var_t>(str[i]);
+    }
+
+    tracer::clear();
+    tracer::enable();
+    rlslp<var_t> slp;
+    parallel::parallel_ls_recompression<var_t> recomp;
+    recomp.recomp(text, slp, CHAR_ALPHABET, 1);
+    ASSERT_EQ(str.substr(3, 10), slp.extract(3, 10));
+    ASSERT_EQ(8U, lce_query::lce_query(slp, 0, 2));
+    tracer::enable(false);
+
+    auto events = tracer::events();
+    ASSERT_EQ(1U, count_events(events, "recompression"));
+    ASSERT_EQ(1U, count_events(events, "rename_rlslp"));
+    ASSERT_EQ(1U, count_events(events, "extract"));
+    ASSERT_EQ(1U, count_events(events, "lce_query"));
+    for (const auto& name : {"bcomp", "pcomp", "sort", "rules", "compact", "adj_list", "partition"}) {
+        ASSERT_LT(0U, count_events(events, name)) << name;
+    }
+    ASSERT_EQ(count_events(events, "pcomp"), count_events(events, "partition"));
+    tracer::clear();
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "recompression.hpp"
+
+using namespace recomp;
+
+typedef std::uint64_t wide_t;
+typedef recompression<wide_t>::text_t text_t;
+
+namespace {
+
+std::string create_text() {
+    std::string str;
+    std::srand(7);
+    for (size_t i = 0; i < 20000; ++i) {
+        if (i > 100 && std::rand() % 4 == 0) {
+            str += str.substr(std::rand() % (str.size() - 60), 1 + std::rand() % 50);
+        } else {
+            str += static_cast<char>('a' + std::rand() % 4);
+        }
+    }
+    return str;
+}
+
+text_t to_text(const std::string& str) {
+    text_t text(str.size());
+    for (size_t i = 0; i < str.size(); ++i) {
+        text[i] = static_cast<unsigned char>(str[i]);
+    }
+    return text;
+}
+
+}  // namespace
+
+TEST(variable_width, parallel_variants) {
+    std::vector<std::string> variants;
+    parallel_variants(variants);
+    std::string str = create_text();
+
+    for (const auto& variant : variants) {
+        std::string dataset = "test";
+        auto recomp = create_recompression<wide_t>(variant, dataset, "", "");
+        ASSERT_TRUE(recomp != nullptr) << variant;
+
+        text_t text = to_text(str);
+        rlslp<wide_t> rlslp;
+        recomp->recomp(text, rlslp, CHAR_ALPHABET, 4);
+        ASSERT_EQ(str, rlslp.derive_text()) << variant;
+    }
+}
+
+TEST(variable_width, large_symbols) {
+    // symbols beyond 2^32 can only be represented with 64 bit non-terminals
+    const wide_t base = static_cast<wide_t>(1) << 33;
+    std::vector<wide_t> vec = {base + 2, base + 1, base + 2, base + 1, base + 4, base + 4, base + 4, base + 1, base + 3,
+                               base + 3, base + 2, base + 3, base + 1, base + 1, base + 4, base + 1, base + 3};
+    text_t text = util::create_ui_vector(vec);
+    parallel::parallel_recompression<wide_t> recomp;
+    rlslp<wide_t> rlslp;
+    recomp.recomp(text, rlslp, base + 5, 4);
+
+    ASSERT_EQ(base + 5, rlslp.terminals);
+    ASSERT_GT(rlslp.root, base + 5);
+
+    std::vector<wide_t> derived;
+    std::vector<wide_t> stack = {rlslp.root};
+    while (!stack.empty()) {
+        wide_t nt = stack.back();
+        stack.pop_back();
+        if (rlslp.is_terminal(nt)) {
+            derived.push_back(nt);
+        } else if (rlslp.is_block(nt)) {
+            for (wide_t i = 0; i < rlslp[nt - rlslp.terminals].second(); ++i) {
+                stack.push_back(rlslp[nt - rlslp.terminals].first());
+            }
+        } else {
+            stack.push_back(rlslp[nt - rlslp.terminals].second());
+            stack.push_back(rlslp[nt - rlslp.terminals].first());
+        }
+    }
+    ASSERT_EQ(vec, derived);
+}
+
+TEST(variable_width, coders) {
+    std::string str = create_text();
+    text_t text = to_text(str);
+    parallel::parallel_ls_recompression<wide_t> recomp;
+    rlslp<wide_t> rlslp;
+    recomp.recomp(text, rlslp, CHAR_ALPHABET, 4);
+
+    for (const std::string coder : {"plain", "fixed", "sorted", "sorted_dr"}) {
+        std::string file_name = "variable_width";
+        recomp::rlslp<wide_t> slp;
+        slp.resize(rlslp.size());
+        for (size_t i = 0; i < rlslp.size(); ++i) {
+            slp[i] = rlslp[i];
+        }
+        slp.root = rlslp.root;
+        slp.terminals = rlslp.terminals;
+        slp.blocks = rlslp.blocks;
+        slp.is_empty = rlslp.is_empty;
+
+        coder::encode<wide_t>(coder, file_name, slp);
+        recomp::rlslp<wide_t> in_rlslp = coder::decode<wide_t>(coder, file_name);
+        ASSERT_EQ(str, in_rlslp.derive_text()) << coder;
+
+        file_name += coder::get_coder_extension(coder);
+        remove(file_name.c_str());
+    }
+}
+
+TEST(variable_width, lce_query) {
+    std::string str = create_text();
+    text_t text = to_text(str);
+    parallel::parallel_gr_recompression<wide_t> recomp;
+    rlslp<wide_t> rlslp;
+    recomp.recomp(text, rlslp, CHAR_ALPHABET, 4);
+
+    lce_query::lce_engine<wide_t> engine{rlslp};
+    for (size_t k = 0; k < 2000; ++k) {
+        size_t i = std::rand() % str.size();
+        size_t j = std::rand() % str.size();
+        size_t exp_lce = 0;
+        while (i + exp_lce < str.size() && j + exp_lce < str.size() && str[i + exp_lce] == str[j + exp_lce]) {
+            exp_lce++;
+        }
+        ASSERT_EQ(exp_lce, lce_query::lce_query<wide_t>(rlslp, i, j));
+        ASSERT_EQ(exp_lce, lce_query::lce_query_iterative(engine, i, j));
+    }
+}